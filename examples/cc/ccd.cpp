@@ -129,10 +129,25 @@ int main(int argc, char** argv) {
 
     double energy = 0.0;
 
+    TiledArray::TSpArrayD r_aa_vvoo;
+    TiledArray::TSpArrayD r_ab_vvoo;
+    TiledArray::TSpArrayD r_bb_vvoo;
+
+    // The amplitude updates are evaluated with the same structure in every
+    // iteration, so their evaluation plans are reused.
+    auto t_aa_update = make_plan(
+        D_vvoo("a,b,i,j") * r_aa_vvoo("a,b,i,j") + t_aa_vvoo("a,b,i,j"),
+        t_aa_vvoo("a,b,i,j"));
+    auto t_ab_update = make_plan(
+        D_vvoo("a,b,i,j") * r_ab_vvoo("a,b,i,j") + t_ab_vvoo("a,b,i,j"),
+        t_ab_vvoo("a,b,i,j"));
+    auto t_bb_update = make_plan(
+        D_vvoo("a,b,i,j") * r_bb_vvoo("a,b,i,j") + t_bb_vvoo("a,b,i,j"),
+        t_bb_vvoo("a,b,i,j"));
+
     for (unsigned int i = 0ul; i < 100; ++i) {
       if (world.rank() == 0) std::cout << "Iteration " << i << "\n";
 
-      TiledArray::TSpArrayD r_aa_vvoo;
       r_aa_vvoo("p1a,p2a,h1a,h2a") =
           v_aa_vvoo("p1a,p2a,h1a,h2a") -
           f_a_vv("p1a,p3a") * t_aa_vvoo("p2a,p3a,h1a,h2a") +
@@ -186,7 +201,6 @@ int main(int argc, char** argv) {
 
       world.gop.fence();
 
-      TiledArray::TSpArrayD r_ab_vvoo;
       r_ab_vvoo("p1a,p2b,h1a,h2b") =
           v_ab_vvoo("p1a,p2b,h1a,h2b") +
           f_a_vv("p1a,p3a") * t_ab_vvoo("p3a,p2b,h1a,h2b") +
@@ -232,7 +246,6 @@ int main(int argc, char** argv) {
 
       world.gop.fence();
 
-      TiledArray::TSpArrayD r_bb_vvoo;
       r_bb_vvoo("p1b,p2b,h1b,h2b") =
           v_bb_vvoo("p1b,p2b,h1b,h2b") -
           f_b_vv("p1b,p3b") * t_bb_vvoo("p2b,p3b,h1b,h2b") +
@@ -286,14 +299,9 @@ int main(int argc, char** argv) {
 
       world.gop.fence();
 
-      t_aa_vvoo("a,b,i,j") =
-          D_vvoo("a,b,i,j") * r_aa_vvoo("a,b,i,j") + t_aa_vvoo("a,b,i,j");
-
-      t_ab_vvoo("a,b,i,j") =
-          D_vvoo("a,b,i,j") * r_ab_vvoo("a,b,i,j") + t_ab_vvoo("a,b,i,j");
-
-      t_bb_vvoo("a,b,i,j") =
-          D_vvoo("a,b,i,j") * r_bb_vvoo("a,b,i,j") + t_bb_vvoo("a,b,i,j");
+      t_aa_update.eval();
+      t_ab_update.eval();
+      t_bb_update.eval();
 
       const double error =
           (r_aa_vvoo("a,b,i,j") + r_ab_vvoo("a,b,i,j") + r_bb_vvoo("a,b,i,j"))
@@ -42,6 +42,35 @@ class BlockRange : public Range {
 
   friend inline bool operator==(const BlockRange& r1, const BlockRange& r2);
 
+  /// Convert an ordinal index of this block to an ordinal index of the range
+
+  /// \tparam N The rank of this range, or 0 if it is not known at compile
+  /// time (see \c detail::with_static_rank() )
+  /// \param index The ordinal index in this block
+  /// \return The ordinal index of \c index in the enclosing range
+  template <unsigned int N>
+  ordinal_type block_ordinal(ordinal_type index) const {
+    TA_ASSERT(N == 0u || N == rank_);
+    const unsigned int rank = (N ? N : rank_);
+
+    // Get pointers to the data
+    const auto* MADNESS_RESTRICT const size = data_ + rank + rank;
+    const auto* MADNESS_RESTRICT const stride = size + rank;
+
+    // Compute the coordinate index of o in range.
+    ordinal_type result = 0ul;
+    for (unsigned int i = rank; i > 0u; --i) {
+      const auto size_i = size[i - 1u];
+      const auto stride_i = stride[i - 1u];
+
+      // Compute result index element i
+      result += (index % size_i) * stride_i;
+      index /= size_i;
+    }
+
+    return result + block_offset_ - offset_;
+  }
+
   template <typename Index1, typename Index2,
             typename = std::enable_if_t<detail::is_integral_range_v<Index1> &&
                                         detail::is_integral_range_v<Index2>>>
@@ -50,7 +79,7 @@ class BlockRange : public Range {
     TA_ASSERT(range.rank());
 
     // Initialize the block range data members
-    data_ = new index1_type[range.rank() << 2];
+    alloc_data(range.rank());
     offset_ = range.offset();
     volume_ = 1ul;
     rank_ = range.rank();
@@ -102,7 +131,7 @@ class BlockRange : public Range {
     TA_ASSERT(range.rank());
 
     // Initialize the block range data members
-    data_ = new index1_type[range.rank() << 2];
+    alloc_data(range.rank());
     offset_ = range.offset();
     volume_ = 1ul;
     rank_ = range.rank();
@@ -329,24 +358,9 @@ class BlockRange : public Range {
     // Check that index is contained by range.
     TA_ASSERT(includes(index));
 
-    // Construct result coordinate index object and allocate its memory.
-    ordinal_type result = 0ul;
-
-    // Get pointers to the data
-    const auto* MADNESS_RESTRICT const size = data_ + rank_ + rank_;
-    const auto* MADNESS_RESTRICT const stride = size + rank_;
-
-    // Compute the coordinate index of o in range.
-    for (int i = int(rank_) - 1; i >= 0; --i) {
-      const auto size_i = size[i];
-      const auto stride_i = stride[i];
-
-      // Compute result index element i
-      result += (index % size_i) * stride_i;
-      index /= size_i;
-    }
-
-    return result + block_offset_ - offset_;
+    return detail::with_static_rank(rank_, [&](auto rank) {
+      return this->block_ordinal<decltype(rank)::value>(index);
+    });
   }
 
   /// Resize of block range is not supported
@@ -117,6 +117,25 @@ class BinaryEvalImpl : public DistEvalImpl<typename Op::result_type, Policy>,
   virtual void discard_tile(ordinal_type i) const { get_tile(i); }
 
  private:
+  /// Pass a task argument tile to the tile operation
+
+  /// The tiles of the arguments are retrieved once, so the task owns them.
+  /// A tile that the operation does not consume by construction is passed
+  /// as an rvalue when it is non-const, which allows the operation to reuse
+  /// it for the result if its data is not shared (see
+  /// \c TiledArray::is_unique() ).
+  /// \tparam Consumable The consumable flag of the operation for \c tile
+  /// \tparam T The tile type
+  /// \param tile The task argument tile
+  /// \return \c tile as an rvalue if it may be reused, otherwise as an
+  /// lvalue
+  template <bool Consumable, typename T>
+  static std::conditional_t<Consumable || std::is_const<T>::value, T&, T&&>
+  arg_tile(T& tile) {
+    return static_cast<std::conditional_t<
+        Consumable || std::is_const<T>::value, T&, T&&> >(tile);
+  }
+
   /// Task function for evaluating tiles
 
 #ifdef TILEDARRAY_HAS_CUDA
@@ -126,7 +145,9 @@ class BinaryEvalImpl : public DistEvalImpl<typename Op::result_type, Policy>,
   template <typename L, typename R, typename U = value_type>
   std::enable_if_t<!detail::is_cuda_tile<U>::value, void> eval_tile(
       const ordinal_type i, L left, R right) {
-    DistEvalImpl_::set_tile(i, op_(left, right));
+    DistEvalImpl_::set_tile(
+        i, op_(arg_tile<op_type::left_is_consumable>(left),
+               arg_tile<op_type::right_is_consumable>(right)));
   }
 
   /// \param i The tile index
@@ -146,7 +167,9 @@ class BinaryEvalImpl : public DistEvalImpl<typename Op::result_type, Policy>,
   /// \param right The right-hand tile
   template <typename L, typename R>
   void eval_tile(const ordinal_type i, L left, R right) {
-    DistEvalImpl_::set_tile(i, op_(left, right));
+    DistEvalImpl_::set_tile(
+        i, op_(arg_tile<op_type::left_is_consumable>(left),
+               arg_tile<op_type::right_is_consumable>(right)));
   }
 #endif
   /// Evaluate the tiles of this tensor
@@ -161,12 +184,17 @@ class BinaryEvalImpl : public DistEvalImpl<typename Op::result_type, Policy>,
     left_.eval();
     right_.eval();
 
-    // Task function argument types
+    // Task function argument types, non-lazy tiles are non-const so they
+    // may be reused by the tile operation
     typedef typename std::conditional<
-        op_type::left_is_consumable, typename left_type::value_type,
+        op_type::left_is_consumable ||
+            is_consumable_tile<typename left_type::value_type>::value,
+        typename left_type::value_type,
         const typename left_type::value_type>::type& left_argument_type;
     typedef typename std::conditional<
-        op_type::right_is_consumable, typename right_type::value_type,
+        op_type::right_is_consumable ||
+            is_consumable_tile<typename right_type::value_type>::value,
+        typename right_type::value_type,
         const typename right_type::value_type>::type& right_argument_type;
 
     ordinal_type task_count = 0ul;
@@ -20,6 +20,10 @@
 #ifndef TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 #define TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <vector>
 
 #include <TiledArray/config.h>
@@ -27,17 +31,43 @@
 #include <TiledArray/proc_grid.h>
 #include <TiledArray/reduce_task.h>
 #include <TiledArray/shape.h>
+#include <TiledArray/tile_interface/clone.h>
+#include <TiledArray/tile_interface/permute.h>
+#include <TiledArray/tile_op/contract_reduce.h>
 #include <TiledArray/type_traits.h>
-
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_STEP 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE 1
+#include <TiledArray/util/summa_trace.h>
 
 namespace TiledArray {
 namespace detail {
 
+/// Screened tile contraction counter
+
+/// \return A reference to the number of tile contractions skipped by SUMMA
+/// screening on this process (see \c Summa::set_screening() ); the counter
+/// may be reset by the caller
+inline std::atomic<std::size_t>& summa_screened_contractions() {
+  static std::atomic<std::size_t> count{0ul};
+  return count;
+}
+
+/// A term of a sum of contractions evaluated by SUMMA
+
+/// The contractions of a sum that share a process grid are evaluated
+/// together: each term adds its tile contractions to the partial result
+/// tiles of the preceding terms, which are forwarded to it on the same
+/// process (see \c Summa::forward_tiles() and \c Summa::set_preceding() ).
+/// \tparam Tile The result tile type
+/// \tparam Policy The tensor policy class
+template <typename Tile, typename Policy>
+struct SummaLink {
+  std::shared_ptr<DistEvalImpl<Tile, Policy> >
+      eval;  ///< The evaluator of the term (null before the first term)
+  std::vector<Future<Tile> >
+      tiles;  ///< The partial result tiles of this process, in the order of
+              ///< the local tiles of the process grid (empty for the last
+              ///< term)
+};  // struct SummaLink
+
 /// \brief Distributed contraction evaluator implementation
 
 /// \tparam Left The left-hand argument evaluator type
@@ -48,7 +78,10 @@ namespace detail {
 /// dimensional cyclic distribution, and that the row phase of the left-hand
 /// argument and the column phase of the right-hand argument are equal to
 /// the number of rows and columns, respectively, in the \c ProcGrid object
-/// passed to the constructor.
+/// passed to the constructor. If the process grid has more than one layer,
+/// each layer iterates over its own block of the inner dimension (see
+/// \c ProcGrid::layer_range() ) and the partial result tiles of all layers
+/// are summed on the first layer.
 template <typename Left, typename Right, typename Op, typename Policy>
 class Summa
     : public DistEvalImpl<typename Op::result_type, Policy>,
@@ -74,9 +107,26 @@ class Summa
   typedef Op op_type;  ///< Tile evaluation operator type
 
  private:
-  static ordinal_type max_memory_;  ///< Maximum memory used per node
+  static ordinal_type max_memory_;  ///< Default maximum memory used per node
   static ordinal_type
-      max_depth_;  ///< Maximum number of concurrent SUMMA iterations
+      max_depth_;  ///< Default maximum number of concurrent SUMMA iterations
+  static ordinal_type batch_tile_size_;  ///< Default largest tile extent for
+                                         ///< batched tile contractions
+
+  // Memory and depth limits of this contraction
+  ordinal_type memory_limit_;  ///< Maximum memory used by SUMMA iterations
+  ordinal_type depth_limit_;   ///< Maximum number of concurrent iterations
+  ordinal_type depth_;         ///< Target number of concurrent iterations
+  ordinal_type batch_limit_;   ///< Largest tile extent for batched tile
+                               ///< contractions (0 = no batching)
+  bool batch_;  ///< \c true if the tile contractions of each SUMMA iteration
+                ///< are evaluated in batches
+  float screening_;  ///< Norm estimate below which tile contractions are
+                     ///< skipped (0 = no screening)
+  std::vector<std::size_t>
+      step_memory_;  ///< Memory required by the arguments of the first n
+                     ///< local SUMMA iterations (empty if memory is not
+                     ///< limited)
 
   // Arguments and operation
   left_type left_;    ///< The left-hand argument
@@ -88,24 +138,36 @@ class Summa
   madness::Group col_group_;  ///< The column process group for this rank
 
   // Dimension information
-  const ordinal_type k_;      ///< Number of tiles in the inner dimension
-  const ProcGrid proc_grid_;  ///< Process grid for this contraction
+  const ordinal_type k_;        ///< Number of tiles in the inner dimension
+  const ProcGrid proc_grid_;    ///< Process grid for this contraction
+  const ordinal_type k_begin_;  ///< First inner tile of this layer
+  const ordinal_type k_end_;    ///< Last inner tile + 1 of this layer
 
   // Contraction results
   ReducePairTask<op_type>* reduce_tasks_;  ///< A pointer to the reduction tasks
+  std::function<bool(ordinal_type)>
+      initial_is_zero_;  ///< Zero flags of the initial result tiles (see
+                         ///< \c set_initial_tiles() )
+  std::function<Future<value_type>(ordinal_type, ordinal_type)>
+      initial_tile_;  ///< Initial result tiles, by permuted index and local
+                      ///< ordinal (see \c set_initial_tiles() )
+  std::shared_ptr<DistEvalImpl_>
+      preceding_;  ///< The preceding terms of a sum of contractions (see
+                   ///< \c set_preceding() )
+  std::vector<Future<value_type> >
+      forward_;  ///< Result tiles forwarded to the next term of a sum of
+                 ///< contractions (see \c forward_tiles() )
 
   // Constants used to iterate over columns and rows of left_ and right_,
   // respectively.
-  const ordinal_type
-      left_start_local_;  ///< The starting point of left column iterator ranges
-                          ///< (just add k for specific columns)
   const ordinal_type left_end_;  ///< The end of the left column iterator ranges
-  const ordinal_type left_stride_;  ///< Stride for left column iterators
-  const ordinal_type
-      left_stride_local_;            ///< Stride for local left column iterators
+  const ordinal_type left_stride_;   ///< Stride for left column iterators
   const ordinal_type right_stride_;  ///< Stride for right row iterators
-  const ordinal_type
-      right_stride_local_;  ///< stride for local right row iterators
+  const std::vector<ordinal_type>
+      local_rows_;  ///< Rows of left_, and of the result, held by this process
+  const std::vector<ordinal_type>
+      local_cols_;  ///< Columns of right_, and of the result, held by this
+                    ///< process
 
   typedef Future<typename right_type::eval_type>
       right_future;  ///< Future to a right-hand argument tile
@@ -116,6 +178,11 @@ class Summa
   typedef std::pair<ordinal_type, left_future>
       col_datum;  ///< Datum element type for a left-hand argument column
 
+  /// \c true if tile contractions may be screened, i.e. if the shape holds
+  /// tile norms and zero result tiles can be constructed
+  static constexpr const bool screening_enabled =
+      !is_dense_v<shape_type> && is_tensor_v<value_type>;
+
   static constexpr const bool trace_tasks =
 #ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
       true
@@ -172,6 +239,46 @@ class Summa
     return 0ul;
   }
 
+  /// Initialize batch_tile_size_ for SUMMA
+
+  /// Batching is opt-in: tile contractions are batched only if
+  /// \c TA_SUMMA_BATCH_TILE_SIZE is set to a non-zero limit and no fused
+  /// matrix dimension of the tiles exceeds it.
+  static ordinal_type init_batch_tile_size() {
+    const char* batch_tile_size = getenv("TA_SUMMA_BATCH_TILE_SIZE");
+    if (batch_tile_size) return std::stoul(batch_tile_size);
+    return 0ul;
+  }
+
+  /// Construct the list of rows or columns held by a process
+
+  /// \tparam PhaseOp The phase operation type
+  /// \param n The number of rows or columns
+  /// \param rank The process row or column, or -1 if the process is not
+  /// included in the process grid
+  /// \param phase The operation that maps a row or column to its process row
+  /// or column
+  /// \return The ordered list of rows or columns with phase \c rank
+  template <typename PhaseOp>
+  static std::vector<ordinal_type> make_local_list(const ordinal_type n,
+                                                   const ProcessID rank,
+                                                   const PhaseOp& phase) {
+    std::vector<ordinal_type> result;
+    if (rank >= 0)
+      for (ordinal_type i = 0ul; i < n; ++i)
+        if (phase(i) == ordinal_type(rank)) result.push_back(i);
+    return result;
+  }
+
+  /// Copy an initial result tile
+
+  /// \param tile The tile to be copied
+  /// \return A deep copy of \c tile
+  static value_type clone_tile(const value_type& tile) {
+    using TiledArray::clone;
+    return clone(tile);
+  }
+
   // Process groups --------------------------------------------------------
 
   /// Process group factory function
@@ -195,16 +302,19 @@ class Summa
   /// \param key_offset The key that will be used to identify the process group
   /// \param proc_map The operator that will convert a process row/column
   /// index into the absolute process index (ProcessID)
+  /// \param phase The operator that will convert the position of a tile in
+  /// the row or column range into the process row/column index that holds it
   /// \return A sparse process group that includes process in the row or
   /// column of this process as defined by \c proc_grid_.
-  template <typename Shape, typename ProcMap>
+  template <typename Shape, typename ProcMap, typename PhaseOp>
   madness::Group make_group(const Shape& shape,
                             const std::vector<bool>& process_mask,
                             ordinal_type index, const ordinal_type end,
                             const ordinal_type stride,
                             const ordinal_type max_group_size,
                             const ordinal_type k, const ordinal_type key_offset,
-                            const ProcMap& proc_map) const {
+                            const ProcMap& proc_map,
+                            const PhaseOp& phase) const {
     // Generate the list of processes in rank_row
     std::vector<ProcessID> proc_list(max_group_size, -1);
 
@@ -215,8 +325,9 @@ class Summa
     ordinal_type count = 1ul;
 
     // Flag all processes that have non-zero tiles
-    for (p = 0ul; (index < end) && (count < max_group_size);
-         index += stride, p = (p + 1u) % max_group_size) {
+    for (ordinal_type x = 0ul; (index < end) && (count < max_group_size);
+         index += stride, ++x) {
+      p = phase(x);
       if ((proc_list[p] != -1) || (shape.is_zero(index)) || !process_mask.at(p))
         continue;
 
@@ -252,11 +363,13 @@ class Summa
 
     // return empty group if I am not in this group, otherwise make a group
     if (result_row_mask_k[proc_grid_.rank_col()])
-      return make_group(right_.shape(), result_row_mask_k, right_begin_k,
-                        right_end_k, right_stride_, proc_grid_.proc_cols(), k,
-                        k_, [&](const ProcGrid::size_type col) {
-                          return proc_grid_.map_col(col);
-                        });
+      return make_group(
+          right_.shape(), result_row_mask_k, right_begin_k, right_end_k,
+          right_stride_, proc_grid_.proc_cols(), k, k_,
+          [&](const ProcGrid::size_type col) {
+            return proc_grid_.map_col(col);
+          },
+          [&](const ordinal_type col) { return proc_grid_.col_phase(col); });
     else
       return madness::Group();
   }
@@ -275,7 +388,8 @@ class Summa
       return make_group(
           left_.shape(), result_col_mask_k, k, left_end_, left_stride_,
           proc_grid_.proc_rows(), k, 0ul,
-          [&](const ordinal_type row) { return proc_grid_.map_row(row); });
+          [&](const ordinal_type row) { return proc_grid_.map_row(row); },
+          [&](const ordinal_type row) { return proc_grid_.row_phase(row); });
     else
       return madness::Group();
   }
@@ -292,7 +406,6 @@ class Summa
     // whether there are any nonzero C[i][*] located on that node
 
     const auto nproc_cols = proc_grid_.proc_cols();
-    const auto my_proc_row = proc_grid_.rank_row();
 
     // result shape
     const auto& result_shape = TensorImpl_::shape();
@@ -309,35 +422,19 @@ class Summa
     const auto nk = k_;
 
     // for each i assigned to my row of processes ...
-    ordinal_type i_start, i_fence, i_stride;
-    std::tie(i_start, i_fence, i_stride) = result_row_range(my_proc_row);
-    const auto ik_stride = i_stride * nk;
-    for (ordinal_type i = i_start, ik = i_start * nk + k; i < i_fence;
-         i += i_stride, ik += ik_stride) {
+    for (const ordinal_type i : local_rows_) {
       // ... such that A[i][k] exists ...
-      if (!left_.shape().is_zero(ik)) {
+      if (!left_.shape().is_zero(i * nk + k)) {
         // ... the owner of А[i][k] is always in the group ...
-        const auto k_proc_col = k % nproc_cols;
-        mask[k_proc_col] = true;
-        // ... loop over processes in my row ...
-        for (ordinal_type proc_col = 0; proc_col != nproc_cols; ++proc_col) {
-          // ... that are not the owner of A[i][k] ...
-          if (proc_col != k_proc_col) {
-            // ... loop over all C[i][j] tiles that belong to this process ...
-            ordinal_type j_start, j_fence, j_stride;
-            std::tie(j_start, j_fence, j_stride) = result_col_range(proc_col);
-            const auto ij_stride = j_stride;
-            for (ordinal_type j = j_start, ij = i * nj + j_start; j < j_fence;
-                 j += j_stride, ij += ij_stride) {
-              // ... if any such C[i][j] exists, update the mask, and move
-              // on to next process
-              if (!result_shape.is_zero(
-                      DistEvalImpl_::perm_index_to_target(ij))) {
-                mask[proc_col] = true;
-                break;
-              }
-            }
-          }
+        mask[k % nproc_cols] = true;
+        // ... loop over all C[i][j] tiles that belong to processes in my row
+        // that are not yet in the group ...
+        for (ordinal_type j = 0ul, ij = i * nj; j < nj; ++j, ++ij) {
+          const auto proc_col = proc_grid_.col_phase(j);
+          if (mask[proc_col]) continue;
+          // ... if any such C[i][j] exists, update the mask
+          if (!result_shape.is_zero(DistEvalImpl_::perm_index_to_target(ij)))
+            mask[proc_col] = true;
         }
       }
     }
@@ -359,7 +456,6 @@ class Summa
     // nonzero C[*][j] located on that node
 
     const auto nproc_rows = proc_grid_.proc_rows();
-    const auto my_proc_col = proc_grid_.rank_col();
 
     // result shape
     const auto& result_shape = TensorImpl_::shape();
@@ -370,39 +466,24 @@ class Summa
     // initialize the mask
     std::vector<bool> mask(nproc_rows, false);
 
-    // number of tiles in col dim of the result
+    // number of tiles in the row and col dims of the result
+    const auto ni = proc_grid_.rows();
     const auto nj = proc_grid_.cols();
 
     // for each j assigned to my column of processes ...
-    ordinal_type j_start, j_fence, j_stride;
-    std::tie(j_start, j_fence, j_stride) = result_col_range(my_proc_col);
-    const auto kj_stride = j_stride;
-    for (ordinal_type j = j_start, kj = k * nj + j_start; j < j_fence;
-         j += j_stride, kj += kj_stride) {
+    for (const ordinal_type j : local_cols_) {
       // ... such that B[k][j] exists ...
-      if (!right_.shape().is_zero(kj)) {
+      if (!right_.shape().is_zero(k * nj + j)) {
         // ... the owner of B[k][j] is always in the group ...
-        auto k_proc_row = k % nproc_rows;
-        mask[k_proc_row] = true;
-        // ... loop over processes in my col ...
-        for (ordinal_type proc_row = 0; proc_row != nproc_rows; ++proc_row) {
-          // ... that are not the owner of B[k][j] ...
-          if (proc_row != k_proc_row) {
-            // ... loop over all C[i][j] tiles that belong to this process
-            ordinal_type i_start, i_fence, i_stride;
-            std::tie(i_start, i_fence, i_stride) = result_row_range(proc_row);
-            const auto ij_stride = i_stride * nj;
-            for (ordinal_type i = i_start, ij = i_start * nj + j; i < i_fence;
-                 i += i_stride, ij += ij_stride) {
-              // ... if any such C[i][j] exists, update the mask, and move
-              // on to next process
-              if (!result_shape.is_zero(
-                      DistEvalImpl_::perm_index_to_target(ij))) {
-                mask[proc_row] = true;
-                break;
-              }
-            }
-          }
+        mask[k % nproc_rows] = true;
+        // ... loop over all C[i][j] tiles that belong to processes in my col
+        // that are not yet in the group ...
+        for (ordinal_type i = 0ul, ij = j; i < ni; ++i, ij += nj) {
+          const auto proc_row = proc_grid_.row_phase(i);
+          if (mask[proc_row]) continue;
+          // ... if any such C[i][j] exists, update the mask
+          if (!result_shape.is_zero(DistEvalImpl_::perm_index_to_target(ij)))
+            mask[proc_row] = true;
         }
       }
     }
@@ -410,34 +491,6 @@ class Summa
     return mask;
   }
 
-  /// computes the result row iteration range for a particular processor
-
-  /// \param proc_row the process row in \c this->proc_grid_
-  /// \return the {start,fence,stride} tuple which defines the iteration
-  ///         range for the row indices of the result tiles residing on
-  ///         process in row \c proc_row
-  inline std::tuple<ordinal_type, ordinal_type, ordinal_type> result_row_range(
-      ordinal_type proc_row) const {
-    const ordinal_type start = proc_row;
-    const ordinal_type fence = proc_grid_.rows();
-    const ordinal_type stride = proc_grid_.proc_rows();
-    return std::make_tuple(start, fence, stride);
-  }
-
-  /// computes the result column iteration range for a particular processor
-
-  /// \param proc_col the process column in \c this->proc_grid_
-  /// \return the {start,fence,stride} tuple which defines the iteration
-  ///         range for the column indices of the result tiles residing on
-  ///         process in column \c proc_col
-  std::tuple<ordinal_type, ordinal_type, ordinal_type> result_col_range(
-      ordinal_type proc_col) const {
-    const ordinal_type start = proc_col;
-    const ordinal_type fence = proc_grid_.cols();
-    const ordinal_type stride = proc_grid_.proc_cols();
-    return std::make_tuple(start, fence, stride);
-  }
-
   // Broadcast kernels -----------------------------------------------------
 
   /// Tile conversion task function
@@ -510,29 +563,50 @@ class Summa
   }
 #endif
 
+  /// Index of a local tile in column \c k of \c left_
+
+  /// \param k The column of \c left_
+  /// \param i The position of the tile in the list of local rows
+  /// \return The index of the tile in \c left_
+  ordinal_type left_index(const ordinal_type k, const ordinal_type i) const {
+    return local_rows_[i] * left_stride_ + k;
+  }
+
+  /// Index of a local tile in row \c k of \c right_
+
+  /// \param k The row of \c right_
+  /// \param j The position of the tile in the list of local columns
+  /// \return The index of the tile in \c right_
+  ordinal_type right_index(const ordinal_type k, const ordinal_type j) const {
+    return k * proc_grid_.cols() + local_cols_[j];
+  }
+
   /// Collect non-zero tiles from \c arg
 
   /// \tparam Arg The argument type
   /// \tparam Datum The vector datum type
+  /// \tparam IndexOp The index operation type
   /// \param[in] arg The owner of the input tiles
-  /// \param[in] index The index of the first tile to be broadcast
-  /// \param[in] end The end of the range of tiles to be broadcast
-  /// \param[in] stride The stride between tile indices to be broadcast
+  /// \param[in] n The number of tiles to be collected
+  /// \param[in] index_op The operation that maps the position of a tile,
+  /// in [0, n), to its index in \c arg
   /// \param[out] vec The vector that will hold broadcast tiles
-  template <typename Arg, typename Datum>
-  void get_vector(Arg& arg, ordinal_type index, const ordinal_type end,
-                  const ordinal_type stride, std::vector<Datum>& vec) const {
+  template <typename Arg, typename Datum, typename IndexOp>
+  void get_vector(Arg& arg, const ordinal_type n, const IndexOp& index_op,
+                  std::vector<Datum>& vec) const {
     TA_ASSERT(vec.size() == 0ul);
+    TA_ASSERT(n > 0ul);
 
     // Iterate over vector of tiles
-    if (arg.is_local(index)) {
-      for (ordinal_type i = 0ul; index < end; ++i, index += stride) {
+    if (arg.is_local(index_op(0ul))) {
+      for (ordinal_type i = 0ul; i < n; ++i) {
+        const ordinal_type index = index_op(i);
         if (arg.shape().is_zero(index)) continue;
         vec.emplace_back(i, get_tile(arg, index));
       }
     } else {
-      for (ordinal_type i = 0ul; index < end; ++i, index += stride) {
-        if (arg.shape().is_zero(index)) continue;
+      for (ordinal_type i = 0ul; i < n; ++i) {
+        if (arg.shape().is_zero(index_op(i))) continue;
         vec.emplace_back(i, Future<typename Arg::eval_type>());
       }
     }
@@ -545,9 +619,10 @@ class Summa
   /// \param[in] k The column to be retrieved
   /// \param[out] col The column vector that will hold the tiles
   void get_col(const ordinal_type k, std::vector<col_datum>& col) const {
-    col.reserve(proc_grid_.local_rows());
-    get_vector(left_, left_start_local_ + k, left_end_, left_stride_local_,
-               col);
+    col.reserve(local_rows_.size());
+    get_vector(
+        left_, local_rows_.size(),
+        [this, k](const ordinal_type i) { return left_index(k, i); }, col);
   }
 
   /// Collect non-zero tiles from row \c k of \c right_
@@ -555,63 +630,87 @@ class Summa
   /// \param[in] k The row to be retrieved
   /// \param[out] row The row vector that will hold the tiles
   void get_row(const ordinal_type k, std::vector<row_datum>& row) const {
-    row.reserve(proc_grid_.local_cols());
-
-    // Compute local iteration limits for row k of right_.
-    ordinal_type begin = k * proc_grid_.cols();
-    const ordinal_type end = begin + proc_grid_.cols();
-    begin += proc_grid_.rank_col();
-
-    get_vector(right_, begin, end, right_stride_local_, row);
+    row.reserve(local_cols_.size());
+    get_vector(
+        right_, local_cols_.size(),
+        [this, k](const ordinal_type j) { return right_index(k, j); }, row);
   }
 
   /// Broadcast tiles from \c arg
 
-  /// \param[in] start The index of the first tile to be broadcast
-  /// \param[in] stride The stride between tile indices to be broadcast
+  /// \tparam Datum The vector datum type
+  /// \tparam IndexOp The index operation type
+  /// \param[in] index_op The operation that maps the position of a tile to
+  /// its index
   /// \param[in] group The process group where the tiles will be broadcast
   /// \param[in] group_root The root process of the broadcast
   /// \param[in] key_offset The broadcast key offset value
   /// \param[out] vec The vector that will hold broadcast tiles
-  template <typename Datum>
-  void bcast(const ordinal_type start, const ordinal_type stride,
-             const madness::Group& group, const ProcessID group_root,
-             const ordinal_type key_offset, std::vector<Datum>& vec) const {
+  template <typename Datum, typename IndexOp>
+  void bcast(const IndexOp& index_op, const madness::Group& group,
+             const ProcessID group_root, const ordinal_type key_offset,
+             std::vector<Datum>& vec) const {
     TA_ASSERT(vec.size() != 0ul);
     TA_ASSERT(group.size() > 0);
     TA_ASSERT(group_root < group.size());
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-    std::stringstream ss;
-    ss << "bcast: rank=" << TensorImpl_::world().rank()
-       << " root=" << group.world_rank(group_root) << " groupid=("
-       << group.id().first << "," << group.id().second
-       << ") keyoffset=" << key_offset << " group={ ";
-    for (ProcessID group_proc = 0; group_proc < group.size(); ++group_proc)
-      ss << group.world_rank(group_proc) << " ";
-    ss << "} tiles={ ";
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-
     // Iterate over tiles to be broadcast
     for (typename std::vector<Datum>::iterator it = vec.begin();
          it != vec.end(); ++it) {
-      const ordinal_type index = it->first * stride + start;
+      const ordinal_type index = index_op(it->first);
 
       // Broadcast the tile
       const madness::DistributedID key(DistEvalImpl_::id(), index + key_offset);
       TensorImpl_::world().gop.bcast(key, it->second, group_root, group);
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-      ss << index << " ";
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
     }
 
     TA_ASSERT(vec.size() > 0ul);
+  }
+
+  /// Broadcast trace callback
+
+  /// Records the end of the broadcast of the argument tiles of a SUMMA
+  /// iteration when all of its tiles are available on this process.
+  class BcastTraceCallback : public madness::CallbackInterface {
+    std::atomic<std::size_t> count_;  ///< Number of pending notifications
+    const ordinal_type k_;            ///< The SUMMA iteration
+    const std::uint64_t id_;          ///< The trace event id
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-    ss << "}\n";
-    printf(ss.str().c_str());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
+   public:
+    BcastTraceCallback(const std::size_t count, const ordinal_type k,
+                       const std::uint64_t id)
+        : count_(count), k_(k), id_(id) {}
+
+    virtual ~BcastTraceCallback() {}
+
+    virtual void notify() {
+      if (--count_ == 0ul) {
+        SummaTrace::record(SummaTrace::Event::bcast,
+                           SummaTrace::Phase::async_end, k_, id_);
+        delete this;
+      }
+    }
+  };  // class BcastTraceCallback
+
+  /// Trace the broadcast of the argument tiles of a SUMMA iteration
+
+  /// \param k The SUMMA iteration
+  /// \param col The column of tiles from the left-hand argument
+  /// \param row The row of tiles from the right-hand argument
+  void trace_bcast(const ordinal_type k, std::vector<col_datum>& col,
+                   std::vector<row_datum>& row) const {
+    const std::uint64_t id =
+        (std::uint64_t(DistEvalImpl_::id().get_obj_id()) << 32) ^ k;
+    SummaTrace::record(SummaTrace::Event::bcast,
+                       SummaTrace::Phase::async_begin, k, id);
+
+    // The extra notification keeps the callback alive until all futures
+    // are registered
+    BcastTraceCallback* const callback =
+        new BcastTraceCallback(col.size() + row.size() + 1ul, k, id);
+    for (auto& datum : col) datum.second.register_callback(callback);
+    for (auto& datum : row) datum.second.register_callback(callback);
+    callback->notify();
   }
 
   // Broadcast specialization for left and right arguments -----------------
@@ -621,8 +720,7 @@ class Summa
     ProcessID group_root = k % proc_grid_.proc_cols();
     if (!right_.shape().is_dense() &&
         row_group.size() < static_cast<ProcessID>(proc_grid_.proc_cols())) {
-      const ProcessID world_root =
-          proc_grid_.rank_row() * proc_grid_.proc_cols() + group_root;
+      const ProcessID world_root = proc_grid_.map_col(group_root);
       group_root = row_group.rank(world_root);
     }
     return group_root;
@@ -633,8 +731,7 @@ class Summa
     ProcessID group_root = k % proc_grid_.proc_rows();
     if (!left_.shape().is_dense() &&
         col_group.size() < static_cast<ProcessID>(proc_grid_.proc_rows())) {
-      const ProcessID world_root =
-          group_root * proc_grid_.proc_cols() + proc_grid_.rank_col();
+      const ProcessID world_root = proc_grid_.map_row(group_root);
       group_root = col_group.rank(world_root);
     }
     return group_root;
@@ -650,8 +747,8 @@ class Summa
     if (!row_group.empty()) {
       // Broadcast column k of left_.
       ProcessID group_root = get_row_group_root(k, row_group);
-      bcast(left_start_local_ + k, left_stride_local_, row_group, group_root,
-            0ul, col);
+      bcast([this, k](const ordinal_type i) { return left_index(k, i); },
+            row_group, group_root, 0ul, col);
     }
   }
 
@@ -667,7 +764,7 @@ class Summa
       ProcessID group_root = get_col_group_root(k, col_group);
 
       // Broadcast row k of right_.
-      bcast(k * proc_grid_.cols() + proc_grid_.rank_col(), right_stride_local_,
+      bcast([this, k](const ordinal_type j) { return right_index(k, j); },
             col_group, group_root, left_.size(), row);
     }
   }
@@ -678,9 +775,6 @@ class Summa
     k += (Pcols - ((k + Pcols - proc_grid_.rank_col()) % Pcols)) % Pcols;
 
     for (; k < end; k += Pcols) {
-      // Compute local iteration limits for column k of left_.
-      ordinal_type index = left_start_local_ + k;
-
       // will create broadcast group only if needed
       bool have_group = false;
       madness::Group row_group;
@@ -688,7 +782,8 @@ class Summa
       bool do_broadcast;
 
       // Search column k of left for non-zero tiles
-      for (; index < left_end_; index += left_stride_local_) {
+      for (ordinal_type i = 0ul; i < local_rows_.size(); ++i) {
+        const ordinal_type index = left_index(k, i);
         if (left_.shape().is_zero(index)) continue;
 
         // Construct broadcast group, if needed
@@ -719,11 +814,6 @@ class Summa
     k += (Prows - ((k + Prows - proc_grid_.rank_row()) % Prows)) % Prows;
 
     for (; k < end; k += Prows) {
-      // Compute local iteration limits for row k of right_.
-      ordinal_type index = k * proc_grid_.cols();
-      const ordinal_type row_end = index + proc_grid_.cols();
-      index += proc_grid_.rank_col();
-
       // will create broadcast group only if needed
       bool have_group = false;
       madness::Group col_group;
@@ -731,7 +821,8 @@ class Summa
       bool do_broadcast;
 
       // Search for and broadcast non-zero row
-      for (; index < row_end; index += right_stride_local_) {
+      for (ordinal_type j = 0ul; j < local_cols_.size(); ++j) {
+        const ordinal_type index = right_index(k, j);
         if (right_.shape().is_zero(index)) continue;
 
         // Construct broadcast group
@@ -766,18 +857,14 @@ class Summa
   /// non-zero tiles in this processes column.
   /// \param k The first row to search
   /// \return The first row, greater than or equal to \c k with non-zero
-  /// tiles, or \c k_ if none is found.
+  /// tiles, or \c k_end_ if none is found.
   ordinal_type iterate_row(ordinal_type k) const {
     // Iterate over k's until a non-zero tile is found or the end of the
     // matrix is reached.
-    ordinal_type end = k * proc_grid_.cols();
-    for (; k < k_; ++k) {
+    for (; k < k_end_; ++k)
       // Search for non-zero tiles in row k of right
-      ordinal_type i = end + proc_grid_.rank_col();
-      end += proc_grid_.cols();
-      for (; i < end; i += right_stride_local_)
-        if (!right_.shape().is_zero(i)) return k;
-    }
+      for (ordinal_type j = 0ul; j < local_cols_.size(); ++j)
+        if (!right_.shape().is_zero(right_index(k, j))) return k;
 
     return k;
   }
@@ -789,31 +876,26 @@ class Summa
   /// checks for non-zero tiles in this process's row.
   /// \param k The first column to test for non-zero tiles
   /// \return The first column, greater than or equal to \c k, that contains
-  /// a non-zero tile. If no non-zero tile is not found, return \c k_.
+  /// a non-zero tile. If no non-zero tile is not found, return \c k_end_.
   ordinal_type iterate_col(ordinal_type k) const {
     // Iterate over k's until a non-zero tile is found or the end of the
     // matrix is reached.
-    for (; k < k_; ++k)
+    for (; k < k_end_; ++k)
       // Search row k for non-zero tiles
-      for (ordinal_type i = left_start_local_ + k; i < left_end_;
-           i += left_stride_local_)
-        if (!left_.shape().is_zero(i)) return k;
+      for (ordinal_type i = 0ul; i < local_rows_.size(); ++i)
+        if (!left_.shape().is_zero(left_index(k, i))) return k;
 
     return k;
   }
 
-  /// Find the next k where the left- and right-hand argument have non-zero
-  /// tiles
+  /// Search for the next k where the left- and right-hand argument have
+  /// non-zero tiles
 
-  /// Search for the next k-th column and row of the left- and right-hand
-  /// arguments, respectively, that both contain non-zero tiles. This search
-  /// only checks for non-zero tiles in this process's row or column. If a
-  /// non-zero, local tile is found that does not contribute to local
-  /// contractions, the tiles will be immediately broadcast.
+  /// Same as \c iterate_sparse() , but skipped tiles are not broadcast.
   /// \param k The first row/column to check
   /// \return The next k-th column and row of the left- and right-hand
   /// arguments, respectively, that both have non-zero tiles
-  ordinal_type iterate_sparse(const ordinal_type k) const {
+  ordinal_type search_sparse(const ordinal_type k) const {
     // Initial step for k_col and k_row.
     ordinal_type k_col = iterate_col(k);
     ordinal_type k_row = iterate_row(k_col);
@@ -827,19 +909,36 @@ class Summa
       }
     }
 
-    if (k < k_row) {
+    return k_col;
+  }
+
+  /// Find the next k where the left- and right-hand argument have non-zero
+  /// tiles
+
+  /// Search for the next k-th column and row of the left- and right-hand
+  /// arguments, respectively, that both contain non-zero tiles. This search
+  /// only checks for non-zero tiles in this process's row or column. If a
+  /// non-zero, local tile is found that does not contribute to local
+  /// contractions, the tiles will be immediately broadcast.
+  /// \param k The first row/column to check
+  /// \return The next k-th column and row of the left- and right-hand
+  /// arguments, respectively, that both have non-zero tiles
+  ordinal_type iterate_sparse(const ordinal_type k) const {
+    const ordinal_type k_next = search_sparse(k);
+
+    if (k < k_next) {
       // Spawn a task to broadcast any local columns of left that were skipped
       TensorImpl_::world().taskq.add(shared_from_this(),
-                                     &Summa_::bcast_col_range_task, k, k_row,
+                                     &Summa_::bcast_col_range_task, k, k_next,
                                      madness::TaskAttributes::hipri());
 
       // Spawn a task to broadcast any local rows of right that were skipped
       TensorImpl_::world().taskq.add(shared_from_this(),
-                                     &Summa_::bcast_row_range_task, k, k_col,
+                                     &Summa_::bcast_row_range_task, k, k_next,
                                      madness::TaskAttributes::hipri());
     }
 
-    return k_col;
+    return k_next;
   }
 
   /// Find the next k where the left- and right-hand argument have non-zero
@@ -869,130 +968,199 @@ class Summa
     const madness::DistributedID row_did(DistEvalImpl_::id(), k_);
     row_group_ = proc_grid_.make_row_group(row_did);
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-    std::stringstream ss;
-    ss << "init: rank=" << TensorImpl_::world().rank() << "\n    col_group_=("
-       << col_did.first << ", " << col_did.second << ") { ";
-    for (ProcessID gproc = 0ul; gproc < col_group_.size(); ++gproc)
-      ss << col_group_.world_rank(gproc) << " ";
-    ss << "}\n    row_group_=(" << row_did.first << ", " << row_did.second
-       << ") { ";
-    for (ProcessID gproc = 0ul; gproc < row_group_.size(); ++gproc)
-      ss << row_group_.world_rank(gproc) << " ";
-    ss << "}\n";
-    printf(ss.str().c_str());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-
     // Allocate memory for the reduce pair tasks.
     std::allocator<ReducePairTask<op_type> > alloc;
     reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
 
     // Iterate over all local tiles
-    const ordinal_type n = proc_grid_.local_size();
-    for (ordinal_type t = 0ul; t < n; ++t) {
-      // Initialize the reduction task
-      ReducePairTask<op_type>* MADNESS_RESTRICT const reduce_task =
-          reduce_tasks_ + t;
-      new (reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+    ReducePairTask<op_type>* MADNESS_RESTRICT reduce_task = reduce_tasks_;
+    for (const ordinal_type row : local_rows_) {
+      const ordinal_type row_start = row * proc_grid_.cols();
+      for (const ordinal_type col : local_cols_) {
+        // Initialize the reduction task
+        new (reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+        add_initial_tile(DistEvalImpl_::perm_index_to_target(row_start + col),
+                         *reduce_task);
+        ++reduce_task;
+      }
     }
 
-    return proc_grid_.local_size();
+    // Only the first layer sets result tiles, unless they are forwarded
+    return ((proc_grid_.rank_layer() == 0) && forward_.empty()
+                ? proc_grid_.local_size()
+                : 0ul);
   }
 
   /// Initialize reduce tasks
   template <typename Shape>
   ordinal_type initialize(const Shape& shape) {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-    std::stringstream ss;
-    ss << "    initialize rank=" << TensorImpl_::world().rank() << " tiles={ ";
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-
     // Allocate memory for the reduce pair tasks.
     std::allocator<ReducePairTask<op_type> > alloc;
     reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
 
-    // Initialize iteration variables
-    ordinal_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
-    ordinal_type row_end = row_start + proc_grid_.cols();
-    row_start += proc_grid_.rank_col();
-    const ordinal_type col_stride =  // The stride to iterate down a column
-        proc_grid_.proc_rows() * proc_grid_.cols();
-    const ordinal_type row_stride =  // The stride to iterate across a row
-        proc_grid_.proc_cols();
-    const ordinal_type end = TensorImpl_::size();
-
     // Iterate over all local tiles
     ordinal_type tile_count = 0ul;
     ReducePairTask<op_type>* MADNESS_RESTRICT reduce_task = reduce_tasks_;
-    // this loops over result tiles arranged in block-cyclic order
+    // this loops over local result tiles in row-major order
     // index = tile index (row major)
-    for (; row_start < end; row_start += col_stride, row_end += col_stride) {
-      for (ordinal_type index = row_start; index < row_end;
-           index += row_stride, ++reduce_task) {
+    for (const ordinal_type row : local_rows_) {
+      const ordinal_type row_start = row * proc_grid_.cols();
+      for (const ordinal_type col : local_cols_) {
+        const ordinal_type index = row_start + col;
+
         // Initialize the reduction task
 
         // Skip zero tiles
-        if (!shape.is_zero(DistEvalImpl_::perm_index_to_target(index))) {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-          ss << index << " ";
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-
+        const ordinal_type perm_index =
+            DistEvalImpl_::perm_index_to_target(index);
+        if (!shape.is_zero(perm_index)) {
           new (reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
+          add_initial_tile(perm_index, *reduce_task);
           ++tile_count;
         } else {
           // Construct an empty task to represent zero tiles.
           new (reduce_task) ReducePairTask<op_type>();
         }
+        ++reduce_task;
       }
     }
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-    ss << "}\n";
-    printf(ss.str().c_str());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+    // Only the first layer sets result tiles, unless they are forwarded
+    return ((proc_grid_.rank_layer() == 0) && forward_.empty() ? tile_count
+                                                                : 0ul);
+  }
 
-    return tile_count;
+  /// Add the initial value of a result tile to its reduction task
+
+  /// Only the first layer of the process grid adds initial values, so they
+  /// are included once in the sum of the partial results of all layers.
+  /// \param perm_index The permuted (target) index of the result tile
+  /// \param reduce_task The reduction task for the result tile
+  void add_initial_tile(const ordinal_type perm_index,
+                        ReducePairTask<op_type>& reduce_task) const {
+    if (initial_tile_ && (proc_grid_.rank_layer() == 0) &&
+        !initial_is_zero_(perm_index))
+      reduce_task.add_result(
+          initial_tile_(perm_index, &reduce_task - reduce_tasks_));
   }
 
   ordinal_type initialize() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-    printf("init: start rank=%i\n", TensorImpl_::world().rank());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+    SummaTrace::Scope trace(SummaTrace::Event::initialize);
+    return initialize(TensorImpl_::shape());
+  }
 
-    const ordinal_type result = initialize(TensorImpl_::shape());
+  // Finalize functions ----------------------------------------------------
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-    printf("init: finish rank=%i\n", TensorImpl_::world().rank());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+  /// Sum the partial result tiles of all process grid layers
+
+  /// \param perm_index The permuted (target) index of the result tile
+  /// \param result The partial result tile of the first layer
+  /// \param partials The partial result tiles of the other layers
+  /// \return The sum of the non-empty partial result tiles, or a zero tile
+  /// if all contributions to the tile were screened out
+  value_type reduce_layers(
+      const ordinal_type perm_index, value_type result,
+      const std::vector<Future<value_type> >& partials) const {
+    SummaTrace::Scope trace(SummaTrace::Event::reduce);
+    using TiledArray::empty;
+    for (const auto& partial : partials) {
+      const value_type& tile = partial.get();
+      if (empty(tile)) continue;
+      if (empty(result))
+        result = tile;
+      else
+        op_(result, tile);
+    }
 
+    if (empty(result)) return make_zero_tile(perm_index);
     return result;
   }
 
-  // Finalize functions ----------------------------------------------------
+  /// Construct a zero result tile
+
+  /// Used for result tiles whose tile contractions were all skipped by
+  /// screening (see \c set_screening() ).
+  /// \param perm_index The permuted (target) index of the result tile
+  /// \return A zero-filled tile with the range of tile \c perm_index
+  value_type make_zero_tile(const ordinal_type perm_index) const {
+    if constexpr (screening_enabled) {
+      return value_type(TensorImpl_::trange().make_tile_range(perm_index),
+                        numeric_t<value_type>(0));
+    } else {
+      TA_EXCEPTION("A SUMMA result tile has no contributions");
+      return value_type();
+    }
+  }
+
+  /// Set a result tile with the result of a reduction task
+
+  /// If the process grid has a single layer, the result of \c reduce_task is
+  /// the result tile. Otherwise, the partial result of this layer is sent to
+  /// the process with the same grid coordinate in the first layer, where the
+  /// partial results of all layers are summed. Layers that did not compute
+  /// any contribution to the tile provide an empty partial result. The
+  /// result tiles of a term of a sum of contractions are forwarded to the
+  /// next term instead (see \c forward_tiles() ).
+  /// \param perm_index The permuted (target) index of the result tile
+  /// \param reduce_task The reduction task for the result tile
+  void set_result_tile(const ordinal_type perm_index,
+                       ReducePairTask<op_type>& reduce_task) {
+    if (!forward_.empty()) {
+      forward_[&reduce_task - reduce_tasks_].set(
+          reduce_task.count() ? reduce_task.submit()
+                              : Future<value_type>(make_zero_tile(perm_index)));
+      return;
+    }
+
+    if (proc_grid_.layers() == 1u) {
+      if (reduce_task.count())
+        DistEvalImpl_::set_tile(perm_index, reduce_task.submit());
+      else
+        DistEvalImpl_::set_tile(perm_index, make_zero_tile(perm_index));
+      return;
+    }
+
+    Future<value_type> partial =
+        (reduce_task.count() ? reduce_task.submit()
+                             : Future<value_type>(value_type()));
+
+    // The key offset avoids collisions with the broadcast and result keys
+    const madness::DistributedID key(
+        DistEvalImpl_::id(),
+        left_.size() + right_.size() + TensorImpl_::size() + perm_index);
+    if (proc_grid_.rank_layer() != 0) {
+      TensorImpl_::world().gop.send(proc_grid_.map_layer(0), key, partial);
+    } else {
+      std::vector<Future<value_type> > partials;
+      partials.reserve(proc_grid_.layers() - 1u);
+      for (ordinal_type layer = 1ul; layer < proc_grid_.layers(); ++layer)
+        partials.push_back(TensorImpl_::world().gop.template recv<value_type>(
+            proc_grid_.map_layer(layer), key));
+
+      DistEvalImpl_::set_tile(
+          perm_index, TensorImpl_::world().taskq.add(
+                          shared_from_this(), &Summa_::reduce_layers,
+                          perm_index, partial, partials,
+                          madness::TaskAttributes::hipri()));
+    }
+  }
 
   /// Set the result tiles, destroy reduce tasks, and destroy broadcast groups
   void finalize(const DenseShape&) {
-    // Initialize iteration variables
-    ordinal_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
-    ordinal_type row_end = row_start + proc_grid_.cols();
-    row_start += proc_grid_.rank_col();
-    const ordinal_type col_stride =  // The stride to iterate down a column
-        proc_grid_.proc_rows() * proc_grid_.cols();
-    const ordinal_type row_stride =  // The stride to iterate across a row
-        proc_grid_.proc_cols();
-    const ordinal_type end = TensorImpl_::size();
-
     // Iterate over all local tiles
-    for (ReducePairTask<op_type>* reduce_task = reduce_tasks_; row_start < end;
-         row_start += col_stride, row_end += col_stride) {
-      for (ordinal_type index = row_start; index < row_end;
-           index += row_stride, ++reduce_task) {
+    ReducePairTask<op_type>* reduce_task = reduce_tasks_;
+    for (const ordinal_type row : local_rows_) {
+      const ordinal_type row_start = row * proc_grid_.cols();
+      for (const ordinal_type col : local_cols_) {
+        const ordinal_type index = row_start + col;
+
         // Set the result tile
-        DistEvalImpl_::set_tile(DistEvalImpl_::perm_index_to_target(index),
-                                reduce_task->submit());
+        set_result_tile(DistEvalImpl_::perm_index_to_target(index),
+                        *reduce_task);
 
         // Destroy the reduce task
         reduce_task->~ReducePairTask<op_type>();
+        ++reduce_task;
       }
     }
 
@@ -1004,64 +1172,36 @@ class Summa
   /// Set the result tiles and destroy reduce tasks
   template <typename Shape>
   void finalize(const Shape& shape) {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-    std::stringstream ss;
-    ss << "    finalize rank=" << TensorImpl_::world().rank() << " tiles={ ";
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-
-    // Initialize iteration variables
-    ordinal_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
-    ordinal_type row_end = row_start + proc_grid_.cols();
-    row_start += proc_grid_.rank_col();
-    const ordinal_type col_stride =  // The stride to iterate down a column
-        proc_grid_.proc_rows() * proc_grid_.cols();
-    const ordinal_type row_stride =  // The stride to iterate across a row
-        proc_grid_.proc_cols();
-    const ordinal_type end = TensorImpl_::size();
-
     // Iterate over all local tiles
-    for (ReducePairTask<op_type>* reduce_task = reduce_tasks_; row_start < end;
-         row_start += col_stride, row_end += col_stride) {
-      for (ordinal_type index = row_start; index < row_end;
-           index += row_stride, ++reduce_task) {
+    ReducePairTask<op_type>* reduce_task = reduce_tasks_;
+    for (const ordinal_type row : local_rows_) {
+      const ordinal_type row_start = row * proc_grid_.cols();
+      for (const ordinal_type col : local_cols_) {
+        const ordinal_type index = row_start + col;
+
         // Compute the permuted index
         const ordinal_type perm_index =
             DistEvalImpl_::perm_index_to_target(index);
 
         // Skip zero tiles
         if (!shape.is_zero(perm_index)) {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-          ss << index << " ";
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-
           // Set the result tile
-          DistEvalImpl_::set_tile(perm_index, reduce_task->submit());
+          set_result_tile(perm_index, *reduce_task);
         }
 
         // Destroy the reduce task
         reduce_task->~ReducePairTask<op_type>();
+        ++reduce_task;
       }
     }
     // Deallocate the memory for the reduce pair tasks.
     std::allocator<ReducePairTask<op_type> >().deallocate(
         reduce_tasks_, proc_grid_.local_size());
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-    ss << "}\n";
-    printf(ss.str().c_str());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
   }
 
   void finalize() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-    printf("finalize: start rank=%i\n", TensorImpl_::world().rank());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-
+    SummaTrace::Scope trace(SummaTrace::Event::finalize);
     finalize(TensorImpl_::shape());
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-    printf("finalize: finish rank=%i\n", TensorImpl_::world().rank());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
   }
 
   /// SUMMA finalization task
@@ -1082,6 +1222,130 @@ class Summa
 
   };  // class FinalizeTask
 
+  /// Batched tile contraction task
+
+  /// This task evaluates a chunk of the tile contractions of a SUMMA
+  /// iteration with batched GEMMs (see \c ContractReduce::batch() ) once the
+  /// column and row tiles of the chunk are available. The products are
+  /// accumulated in place into the partial results of the reduction tasks
+  /// that are ready, and reduced by the reduction tasks otherwise.
+  class BatchContractTask : public madness::TaskInterface {
+   private:
+    typedef typename ReducePairTask<op_type>::ResultTarget
+        target_type;  ///< The accumulation target type
+
+    std::shared_ptr<Summa_> owner_;  ///< The parent object for this task
+    std::shared_ptr<std::vector<col_datum> >
+        col_;  ///< Column of left-hand tiles
+    std::shared_ptr<std::vector<row_datum> >
+        row_;  ///< Row of right-hand tiles
+    std::vector<std::pair<ordinal_type, ordinal_type> >
+        pairs_;  ///< Positions of the tile pairs in \c col_ and \c row_
+    std::vector<target_type>
+        targets_;  ///< The accumulation target of each tile pair
+    madness::TaskInterface* const task_;  ///< The task that depends on the
+                                          ///< tile contractions
+
+    /// Register a tile as a dependency of this task
+
+    /// \tparam T The tile type
+    /// \param tile The tile that this task depends on
+    template <typename T>
+    void register_tile(Future<T>& tile) {
+      if (!tile.probe()) {
+        madness::DependencyInterface::inc();
+        tile.register_callback(this);
+      }
+    }
+
+   public:
+    /// Constructor
+
+    /// \param owner The parent object for this task
+    /// \param col A column of tiles from the left-hand argument
+    /// \param row A row of tiles from the right-hand argument
+    /// \param task The task that depends on the tile contractions
+    BatchContractTask(const std::shared_ptr<Summa_>& owner,
+                      const std::shared_ptr<std::vector<col_datum> >& col,
+                      const std::shared_ptr<std::vector<row_datum> >& row,
+                      madness::TaskInterface* const task)
+        : madness::TaskInterface(1, madness::TaskAttributes::hipri()),
+          owner_(owner),
+          col_(col),
+          row_(row),
+          pairs_(),
+          targets_(),
+          task_(task) {}
+
+    virtual ~BatchContractTask() {}
+
+    /// Add a tile pair to the batch
+
+    /// \param i The position of the left-hand tile in the column
+    /// \param j The position of the right-hand tile in the row
+    /// \param reduce_task The reduction task of the result tile
+    void add(const ordinal_type i, const ordinal_type j,
+             ReducePairTask<op_type>& reduce_task) {
+      pairs_.emplace_back(i, j);
+      targets_.push_back(reduce_task.add_target());
+    }
+
+    /// Submit this task
+
+    /// The task will run once all tiles of the batch are available.
+    void submit() {
+      std::vector<bool> col_used(col_->size(), false),
+          row_used(row_->size(), false);
+      for (const auto& pair : pairs_) {
+        col_used[pair.first] = true;
+        row_used[pair.second] = true;
+      }
+      for (ordinal_type i = 0ul; i < col_used.size(); ++i)
+        if (col_used[i]) register_tile((*col_)[i].second);
+      for (ordinal_type j = 0ul; j < row_used.size(); ++j)
+        if (row_used[j]) register_tile((*row_)[j].second);
+      owner_->world().taskq.add(this);
+      madness::DependencyInterface::notify();
+    }
+
+    /// Number of tile pairs in the batch
+    std::size_t size() const { return pairs_.size(); }
+
+    virtual void run(const madness::TaskThreadEnv&) {
+      if constexpr (is_batchable_contract<op_type>::value) {
+        const std::size_t count = pairs_.size();
+        std::vector<const typename left_type::eval_type*> left(count);
+        std::vector<const typename right_type::eval_type*> right(count);
+        std::vector<std::shared_ptr<value_type> > results(count);
+        std::vector<value_type*> result(count);
+        for (std::size_t p = 0ul; p < count; ++p) {
+          left[p] = &(*col_)[pairs_[p].first].second.get();
+          right[p] = &(*row_)[pairs_[p].second].second.get();
+
+          // Accumulate into the partial result of the reduction task, unless
+          // it is being reduced
+          results[p] = targets_[p].take();
+          if (!results[p]) results[p] = std::make_shared<value_type>();
+          result[p] = results[p].get();
+        }
+
+        owner_->op_.batch(count, left.data(), right.data(), result.data());
+        for (std::size_t p = 0ul; p < count; ++p)
+          targets_[p].reduce(std::move(results[p]));
+      } else {
+        TA_ASSERT(false);
+      }
+
+      if (task_) {
+        if (trace_tasks)
+          task_->notify_debug("BatchContractTask");
+        else
+          task_->notify();
+      }
+    }
+
+  };  // class BatchContractTask
+
   // Contraction functions -------------------------------------------------
 
   /// Schedule local contraction tasks for \c col and \c row tile pairs
@@ -1100,7 +1364,7 @@ class Summa
     for (ordinal_type i = 0ul; i < col.size(); ++i) {
       // Compute the local, result-tile offset
       const ordinal_type reduce_task_offset =
-          col[i].first * proc_grid_.local_cols();
+          col[i].first * local_cols_.size();
 
       // Iterate over columns
       for (ordinal_type j = 0ul; j < row.size(); ++j) {
@@ -1133,7 +1397,7 @@ class Summa
     for (ordinal_type i = 0ul; i < col.size(); ++i) {
       // Compute the local, result-tile offset
       const ordinal_type reduce_task_offset =
-          col[i].first * proc_grid_.local_cols();
+          col[i].first * local_cols_.size();
 
       // Iterate over columns
       for (ordinal_type j = 0ul; j < row.size(); ++j) {
@@ -1157,67 +1421,222 @@ class Summa
     }
   }
 
-#define TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
-#ifndef TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
+  /// Screening threshold of the tile norm products of a SUMMA iteration
+
+  /// \param k The SUMMA iteration
+  /// \return The norm product below which the contraction of a tile pair of
+  /// iteration \c k is skipped, i.e. the screening threshold divided by the
+  /// volume of inner tile \c k ; zero if there is no screening
+  float screening_threshold(const ordinal_type k) const {
+    if (!screening_enabled || (screening_ == 0.0f)) return 0.0f;
+
+    // Compute the volume of inner tile k from the first tile of row k of
+    // right_
+    const math::GemmHelper& gemm_helper = op_.gemm_helper();
+    const auto range = right_.trange().make_tile_range(k * proc_grid_.cols());
+    float volume = 1.0f;
+    for (unsigned int d = gemm_helper.right_inner_begin();
+         d < gemm_helper.right_inner_end(); ++d)
+      volume *= range.extent(d);
+
+    return screening_ / volume;
+  }
+
   /// Schedule local contraction tasks for \c col and \c row tile pairs
 
   /// Schedule tile contractions for each tile pair of \c row and \c col. A
   /// callback to \c task will be registered with each tile contraction
   /// task. This version of contract is used when shape_type is
-  /// \c SparseShape. It skips tile contractions that have a negligible
-  /// contribution to the result tile.
+  /// \c SparseShape. It skips tile contractions whose contribution to the
+  /// result tile is negligible (see \c set_screening() ).
   /// \tparam T The shape value type
   /// \param k The k step for this contraction set
   /// \param col A column of tiles from the left-hand argument
   /// \param row A row of tiles from the right-hand argument
   /// \param task The task that depends on the tile contraction tasks
   template <typename T>
-  typename std::enable_if<std::is_floating_point<T>::value>::type contract(
-      const SparseShape<T>&, const ordinal_type k,
-      const std::vector<col_datum>& col, const std::vector<row_datum>& row,
-      madness::TaskInterface* const task) {
+  void contract(const SparseShape<T>&, const ordinal_type k,
+                const std::vector<col_datum>& col,
+                const std::vector<row_datum>& row,
+                madness::TaskInterface* const task) {
+    const float threshold_k = screening_threshold(k);
+
     // Cache row shape data.
     std::vector<typename SparseShape<T>::value_type> row_shape_values;
-    row_shape_values.reserve(row.size());
-    const ordinal_type row_start =
-        k * proc_grid_.cols() + proc_grid_.rank_col();
-    for (ordinal_type j = 0ul; j < row.size(); ++j)
-      row_shape_values.push_back(
-          right_.shape()[row_start + (row[j].first * right_stride_local_)]);
-
-    const ordinal_type col_start = left_start_local_ + k;
-    const float threshold_k = TensorImpl_::shape().threshold() /
-                              typename SparseShape<T>::value_type(k_);
+    if (threshold_k > 0.0f) {
+      row_shape_values.reserve(row.size());
+      for (ordinal_type j = 0ul; j < row.size(); ++j)
+        row_shape_values.push_back(
+            right_.shape()[right_index(k, row[j].first)]);
+    }
+
+    std::size_t screened = 0ul;
+
     // Iterate over the row
-    for (ordinal_type i = 0ul; i != col.size(); ++i) {
+    for (ordinal_type i = 0ul; i < col.size(); ++i) {
       // Compute the local, result-tile offset
-      const ordinal_type offset = col[i].first * proc_grid_.local_cols();
+      const ordinal_type reduce_task_offset =
+          col[i].first * local_cols_.size();
 
       // Get the shape data for col_it tile
       const typename SparseShape<T>::value_type col_shape_value =
-          left_.shape()[col_start + (col[i].first * left_stride_local_)];
+          (threshold_k > 0.0f ? left_.shape()[left_index(k, col[i].first)]
+                              : 0);
 
       // Iterate over columns
       for (ordinal_type j = 0ul; j < row.size(); ++j) {
-        if ((col_shape_value * row_shape_values[j]) < threshold_k) continue;
+        const ordinal_type reduce_task_index =
+            reduce_task_offset + row[j].first;
+
+        // Skip zero tiles
+        if (!reduce_tasks_[reduce_task_index]) continue;
 
-        const ordinal_type reduce_task_index = offset + row[j].first;
+        // Skip negligible contributions
+        if ((threshold_k > 0.0f) &&
+            ((col_shape_value * row_shape_values[j]) < threshold_k)) {
+          ++screened;
+          continue;
+        }
+
+        // Schedule task for contraction pairs
+        if (task) {
+          if (trace_tasks)
+            task->inc_debug("destroy(*ReduceObject)");
+          else
+            task->inc();
+        }
+        const left_future left = col[i].second;
+        const right_future right = row[j].second;
+        reduce_tasks_[reduce_task_index].add(left, right, task);
+      }
+    }
+
+    if (screened) summa_screened_contractions() += screened;
+  }
+
+  /// Schedule batched contraction tasks for \c col and \c row tile pairs
+
+  /// The non-zero tile pairs of \c row and \c col that are not screened
+  /// out (see \c set_screening() ) are split into one chunk per thread, and
+  /// each chunk is contracted by a single task (see \c BatchContractTask ).
+  /// A callback to \c task will be registered with each batch task.
+  /// \param k The k step for this contraction set
+  /// \param col A column of tiles from the left-hand argument
+  /// \param row A row of tiles from the right-hand argument
+  /// \param task The task that depends on tile contraction tasks
+  void contract_batch(const ordinal_type k, const std::vector<col_datum>& col,
+                      const std::vector<row_datum>& row,
+                      madness::TaskInterface* const task) {
+    const float threshold_k = screening_threshold(k);
+    std::size_t screened = 0ul;
+
+    // The column and row positions and the result tile of each tile pair
+    std::vector<std::array<ordinal_type, 3> > pairs;
+
+    // Iterate over the row
+    for (ordinal_type i = 0ul; i < col.size(); ++i) {
+      // Compute the local, result-tile offset
+      const ordinal_type reduce_task_offset =
+          col[i].first * local_cols_.size();
+
+      // Iterate over columns
+      for (ordinal_type j = 0ul; j < row.size(); ++j) {
+        const ordinal_type reduce_task_index =
+            reduce_task_offset + row[j].first;
 
         // Skip zero tiles
         if (!reduce_tasks_[reduce_task_index]) continue;
 
-        if (task) task->inc();
-        reduce_tasks_[reduce_task_index].add(col[i].second, row[j].second,
-                                             task);
+        // Skip negligible contributions
+        if constexpr (screening_enabled) {
+          if ((threshold_k > 0.0f) &&
+              ((left_.shape()[left_index(k, col[i].first)] *
+                right_.shape()[right_index(k, row[j].first)]) <
+               threshold_k)) {
+            ++screened;
+            continue;
+          }
+        }
+
+        pairs.push_back({{i, j, reduce_task_index}});
+      }
+    }
+
+    if (screened) summa_screened_contractions() += screened;
+    if (pairs.empty()) return;
+
+    // Split the tile pairs into one chunk per thread, so the products of
+    // each iteration are evaluated concurrently
+    const std::size_t chunks = std::min<std::size_t>(
+        pairs.size(), std::max(madness::ThreadPool::size(), 1));
+    auto col_ptr = std::make_shared<std::vector<col_datum> >(col);
+    auto row_ptr = std::make_shared<std::vector<row_datum> >(row);
+    for (std::size_t chunk = 0ul; chunk < chunks; ++chunk) {
+      BatchContractTask* const batch_task =
+          new BatchContractTask(shared_from_this(), col_ptr, row_ptr, task);
+      const std::size_t first = chunk * pairs.size() / chunks;
+      const std::size_t last = (chunk + 1ul) * pairs.size() / chunks;
+      for (std::size_t p = first; p < last; ++p)
+        batch_task->add(pairs[p][0], pairs[p][1], reduce_tasks_[pairs[p][2]]);
+
+      if (task) {
+        if (trace_tasks)
+          task->inc_debug("BatchContractTask");
+        else
+          task->inc();
       }
+      batch_task->submit();
     }
   }
-#endif  // TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
 
+  /// Schedule the contraction of \c col and \c row tile pairs
+
+  /// \param k The k step for this contraction set
+  /// \param col A column of tiles from the left-hand argument
+  /// \param row A row of tiles from the right-hand argument
+  /// \param task The task that depends on tile contraction tasks
   void contract(const ordinal_type k, const std::vector<col_datum>& col,
                 const std::vector<row_datum>& row,
                 madness::TaskInterface* const task) {
-    contract(TensorImpl_::shape(), k, col, row, task);
+    if (batch_)
+      contract_batch(k, col, row, task);
+    else
+      contract(TensorImpl_::shape(), k, col, row, task);
+  }
+
+  /// Check if the tile contractions may be evaluated in batches
+
+  /// \return \c true if the tile operation supports batched contractions
+  /// (see \c is_batchable_contract ) and no fused row, column, or inner
+  /// dimension of the argument tiles exceeds \c batch_limit_ elements
+  bool init_batch() const {
+    if (!is_batchable_contract<op_type>::value || !batch_limit_) return false;
+
+    const math::GemmHelper& gemm_helper = op_.gemm_helper();
+    const unsigned int inner_rank = gemm_helper.num_contract_ranks();
+    const unsigned int left_rank = gemm_helper.left_rank();
+    const unsigned int right_rank = gemm_helper.right_rank();
+
+    // The largest tile extent of the matrix dimension formed by fusing
+    // dimensions [first, last) of trange
+    auto max_extent = [](const auto& trange, const unsigned int first,
+                         const unsigned int last) {
+      std::size_t result = 1ul;
+      for (unsigned int d = first; d < last; ++d) {
+        std::size_t extent = 0ul;
+        for (const auto& tile : trange.data()[d])
+          extent = std::max<std::size_t>(extent, tile.second - tile.first);
+        result *= extent;
+      }
+      return result;
+    };
+
+    return (max_extent(left_.trange(), 0u, left_rank - inner_rank) <=
+            batch_limit_) &&
+           (max_extent(left_.trange(), left_rank - inner_rank, left_rank) <=
+            batch_limit_) &&
+           (max_extent(right_.trange(), inner_rank, right_rank) <=
+            batch_limit_);
   }
 
   // SUMMA step task -------------------------------------------------------
@@ -1237,6 +1656,7 @@ class Summa
     StepTask* next_step_task_ = nullptr;  ///< The next SUMMA step task
     StepTask* tail_step_task_ =
         nullptr;  ///< The last SUMMA step task that currently exists
+    const ordinal_type step_;  ///< The position of this task in the pipeline
 
     void get_col(const ordinal_type k) {
       owner_->get_col(k, col_);
@@ -1265,7 +1685,8 @@ class Summa
 #endif
           owner_(owner),
           world_(owner->world()),
-          finalize_task_(new FinalizeTask(owner, finalize_ndep)) {
+          finalize_task_(new FinalizeTask(owner, finalize_ndep)),
+          step_(0ul) {
       TA_ASSERT(owner_);
       owner_->world().taskq.add(finalize_task_);
     }
@@ -1284,7 +1705,8 @@ class Summa
 #endif
           owner_(parent->owner_),
           world_(parent->world_),
-          finalize_task_(parent->finalize_task_) {
+          finalize_task_(parent->finalize_task_),
+          step_(parent->step_ + 1ul) {
       TA_ASSERT(parent);
       parent->next_step_task_ = this;
     }
@@ -1313,7 +1735,8 @@ class Summa
     void make_next_step_tasks(Derived* task, ordinal_type depth) {
       TA_ASSERT(depth > 0);
       // Set the depth to be no greater than the maximum number steps
-      if (depth > owner_->k_) depth = owner_->k_;
+      const ordinal_type steps = owner_->k_end_ - owner_->k_begin_;
+      if (depth > steps) depth = steps;
 
       // Spawn n=depth step tasks
       for (; depth > 0ul; --depth) {
@@ -1330,38 +1753,58 @@ class Summa
     template <typename Derived, typename GroupType>
     void run(const ordinal_type k, const GroupType& row_group,
              const GroupType& col_group) {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
-      printf("step:  start rank=%i k=%lu\n", owner_->world().rank(), k);
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
+      SummaTrace::Scope trace(SummaTrace::Event::step, k);
 
-      if (k < owner_->k_) {
-        // Initialize next tail task and submit next task
+      if (k < owner_->k_end_) {
+        // Initialize next tail task(s) and submit next task. The number of
+        // new tail tasks adapts the pipeline depth to the memory required by
+        // the steps in flight; when no task is added the current tail is
+        // handed over to the next task, which will add its successor.
         TA_ASSERT(next_step_task_);
-        next_step_task_->tail_step_task_ = new Derived(
-            static_cast<Derived*>(tail_step_task_),
-            1);  // <- ndep=1, will control its scheduling by this task
+        StepTask* const tail_step_task = tail_step_task_;
+        const ordinal_type extend =
+            owner_->pipeline_extension(step_, tail_step_task->step_);
+        if (extend > 0ul) {
+          Derived* parent = static_cast<Derived*>(tail_step_task);
+          if (extend > 1ul) parent = new Derived(parent, 0);
+          next_step_task_->tail_step_task_ = new Derived(
+              parent, 1);  // <- ndep=1, will control its scheduling by this
+                           // task
+        } else {
+          // Hold the tail until the contractions of this step are scheduled
+          if (trace_tasks)
+            tail_step_task->inc_debug("StepTask nth ctor");
+          else
+            tail_step_task->inc();
+          next_step_task_->tail_step_task_ = tail_step_task;
+        }
         // submit next step task ... even if it's same as tail_step_task_ it is
         // safe to submit because its ndep > 0 (see
         // StepTask::make_next_step_tasks)
         TA_ASSERT(tail_step_task_->ndep() > 0);
+        if (SummaTrace::enabled())
+          SummaTrace::record(SummaTrace::Event::depth,
+                             SummaTrace::Phase::counter,
+                             next_step_task_->tail_step_task_->step_ - step_);
         world_.taskq.add(next_step_task_);
         next_step_task_ = nullptr;
 
         // Start broadcast of column and row tiles for this step
+        if (SummaTrace::enabled()) owner_->trace_bcast(k, col_, row_);
         world_.taskq.add(owner_, &Summa_::bcast_col, k, col_, row_group,
                          madness::TaskAttributes::hipri());
         world_.taskq.add(owner_, &Summa_::bcast_row, k, row_, col_group,
                          madness::TaskAttributes::hipri());
 
         // Submit tasks for the contraction of col and row tiles.
-        owner_->contract(k, col_, row_, tail_step_task_);
+        owner_->contract(k, col_, row_, tail_step_task);
 
         // Notify task dependencies
-        TA_ASSERT(tail_step_task_);
+        TA_ASSERT(tail_step_task);
         if (trace_tasks)
-          tail_step_task_->notify_debug("StepTask nth ctor");
+          tail_step_task->notify_debug("StepTask nth ctor");
         else
-          tail_step_task_->notify();
+          tail_step_task->notify();
         finalize_task_->notify();
 
       } else if (finalize_task_) {
@@ -1384,10 +1827,6 @@ class Summa
         else
           tail_step_task_->notify();
       }
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
-      printf("step: finish rank=%i k=%lu\n", owner_->world().rank(), k);
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
     }
 
   };  // class StepTask
@@ -1400,7 +1839,8 @@ class Summa
    public:
     DenseStepTask(const std::shared_ptr<Summa_>& owner,
                   const ordinal_type depth)
-        : StepTask(owner, owner->k_ + 1ul), k_(0) {
+        : StepTask(owner, owner->k_end_ - owner->k_begin_ + 1ul),
+          k_(owner->k_begin_) {
       StepTask::make_next_step_tasks(this, depth);
       StepTask::spawn_get_row_col_tasks(k_);
     }
@@ -1408,7 +1848,7 @@ class Summa
     DenseStepTask(DenseStepTask* const parent, const int ndep)
         : StepTask(parent, ndep), k_(parent->k_ + 1ul) {
       // Spawn tasks to get k-th row and column tiles
-      if (k_ < owner_->k_) StepTask::spawn_get_row_col_tasks(k_);
+      if (k_ < owner_->k_end_) StepTask::spawn_get_row_col_tasks(k_);
     }
 
     virtual ~DenseStepTask() {}
@@ -1436,7 +1876,7 @@ class Summa
       k = owner_->iterate_sparse(k + offset);
       k_.set(k);
 
-      if (k < owner_->k_) {
+      if (k < owner_->k_end_) {
         // NOTE: The order of task submissions is dependent on the order in
         // which we want the tasks to complete.
 
@@ -1471,13 +1911,13 @@ class Summa
         madness::DependencyInterface::inc_debug("SparseStepTask ctor");
       else
         madness::DependencyInterface::inc();
-      world_.taskq.add(this, &SparseStepTask::iterate_task, 0ul, 0ul,
-                       madness::TaskAttributes::hipri());
+      world_.taskq.add(this, &SparseStepTask::iterate_task, owner->k_begin_,
+                       0ul, madness::TaskAttributes::hipri());
     }
 
     SparseStepTask(SparseStepTask* const parent, const int ndep)
         : StepTask(parent, ndep) {
-      if (parent->k_.probe() && (parent->k_.get() >= owner_->k_)) {
+      if (parent->k_.probe() && (parent->k_.get() >= owner_->k_end_)) {
         // Avoid running extra tasks if not needed.
         k_.set(parent->k_.get());
         TA_ASSERT(ndep ==
@@ -1513,7 +1953,9 @@ class Summa
   /// \param op The tile transform operation
   /// \param k The number of tiles in the inner dimension
   /// \param proc_grid The process grid that defines the layout of the tiles
-  ///                  during the contraction evaluation
+  ///                  during the contraction evaluation; with more than one
+  ///                  layer the arguments must be distributed with the
+  ///                  process maps generated by \c proc_grid
   /// \note The trange, shape, and pmap refer to the final,
   ///       permuted, state for the result, NOT to the result during
   ///       the SUMMA evaluation.
@@ -1522,6 +1964,13 @@ class Summa
         const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
         const op_type& op, const ordinal_type k, const ProcGrid& proc_grid)
       : DistEvalImpl_(world, trange, shape, pmap, perm),
+        memory_limit_(max_memory_),
+        depth_limit_(max_depth_),
+        depth_(0ul),
+        batch_limit_(batch_tile_size_),
+        batch_(false),
+        screening_(0.0f),
+        step_memory_(),
         left_(left),
         right_(right),
         op_(op),
@@ -1529,16 +1978,178 @@ class Summa
         col_group_(),
         k_(k),
         proc_grid_(proc_grid),
+        k_begin_(proc_grid.layer_range(k).first),
+        k_end_(proc_grid.layer_range(k).second),
         reduce_tasks_(NULL),
-        left_start_local_(proc_grid_.rank_row() * k),
+        initial_is_zero_(),
+        initial_tile_(),
+        preceding_(),
+        forward_(),
         left_end_(left.size()),
         left_stride_(k),
-        left_stride_local_(proc_grid.proc_rows() * k),
         right_stride_(1ul),
-        right_stride_local_(proc_grid.proc_cols()) {}
+        local_rows_(make_local_list(proc_grid.rows(), proc_grid.rank_row(),
+                                    [&](const ordinal_type row) {
+                                      return proc_grid.row_phase(row);
+                                    })),
+        local_cols_(make_local_list(proc_grid.cols(), proc_grid.rank_col(),
+                                    [&](const ordinal_type col) {
+                                      return proc_grid.col_phase(col);
+                                    })) {}
 
   virtual ~Summa() {}
 
+  /// Memory limit accessor
+
+  /// \return The maximum memory, in bytes, that SUMMA may use per process, as
+  /// set by the \c TA_SUMMA_MAX_MEMORY environment variable; zero if no limit
+  /// was set.
+  static ordinal_type max_memory() { return max_memory_; }
+
+  /// Set the memory limit of this contraction
+
+  /// Overrides the default limit given by \c TA_SUMMA_MAX_MEMORY . The
+  /// limit bounds the memory used by the argument tiles of the SUMMA
+  /// iterations that are in flight on this process.
+  /// \param max_memory The maximum memory, in bytes, that may be used by
+  /// the SUMMA iterations of this process; zero removes the limit
+  /// \note This must be called before the evaluation is started.
+  void set_max_memory(const ordinal_type max_memory) {
+    memory_limit_ = max_memory;
+  }
+
+  /// Set the iteration depth limit of this contraction
+
+  /// Overrides the default limit given by \c TA_SUMMA_MAX_DEPTH .
+  /// \param max_depth The maximum number of concurrent SUMMA iterations;
+  /// zero removes the limit
+  /// \note This must be called before the evaluation is started.
+  void set_max_depth(const ordinal_type max_depth) { depth_limit_ = max_depth; }
+
+  /// Batched contraction tile size accessor
+
+  /// \return The default largest tile extent for which the tile contractions
+  /// of a SUMMA iteration are evaluated in batches, as set by the
+  /// \c TA_SUMMA_BATCH_TILE_SIZE environment variable; zero (the default)
+  /// disables batching
+  static ordinal_type batch_tile_size() { return batch_tile_size_; }
+
+  /// Set the batched contraction tile size of this contraction
+
+  /// Overrides the default given by \c TA_SUMMA_BATCH_TILE_SIZE . If no
+  /// fused row, column, or inner dimension of the argument tiles exceeds
+  /// \c batch_tile_size elements, the tile contractions of a SUMMA
+  /// iteration are evaluated by one task per thread with batched GEMMs,
+  /// instead of one task per tile pair.
+  /// \param batch_tile_size The largest tile extent for batched tile
+  /// contractions; zero disables batching
+  /// \note This must be called before the evaluation is started.
+  void set_batch_tile_size(const ordinal_type batch_tile_size) {
+    batch_limit_ = batch_tile_size;
+  }
+
+  /// Set the screening threshold of this contraction
+
+  /// The contraction of tiles \f$ A_{ik} \f$ and \f$ B_{kj} \f$ is skipped
+  /// if the estimate of its contribution to the result tile,
+  /// \f$ ||A_{ik}|| ||B_{kj}|| V_k \f$, where the norms are the (per
+  /// element) shape norms and \f$ V_k \f$ is the volume of inner tile
+  /// \f$ k \f$, is less than \c screening . Skipped contractions are counted
+  /// by \c summa_screened_contractions() . Screening only applies to sparse
+  /// shapes and tensor tiles; a result tile whose contractions are all
+  /// skipped is set to zero.
+  /// \param screening The screening threshold; zero disables screening
+  /// \note This must be called before the evaluation is started.
+  void set_screening(const float screening) {
+    TA_ASSERT(screening >= 0.0f);
+    screening_ = screening;
+  }
+
+  /// Set the initial values of the result tiles
+
+  /// The contraction is accumulated into the tiles of \c array , i.e. this
+  /// evaluates <tt>array + A * B</tt> without a temporary for the product:
+  /// each non-zero tile of \c array is the initial value of the reduction
+  /// task of the result tile, to which the tile contractions are added.
+  /// \tparam A The array type, which must have the tiles of this evaluator
+  /// \param array The array that holds the initial result tiles, with the
+  /// tiled range of the result; its shape must be included in the shape of
+  /// the result
+  /// \param consume If \c true , the result is accumulated in the tiles of
+  /// \c array , which may not be referenced elsewhere; otherwise the tiles
+  /// are copied first
+  /// \note The result may not be permuted, and this must be called before
+  /// the evaluation is started.
+  template <typename A>
+  void set_initial_tiles(const A& array, const bool consume) {
+    static_assert(std::is_same_v<typename A::value_type, value_type>,
+                  "The initial tiles must have the result tile type");
+    TA_ASSERT(!op_.perm());
+    TA_ASSERT(array.trange() == TensorImpl_::trange());
+
+    initial_is_zero_ = [array](const ordinal_type i) {
+      return array.is_zero(i);
+    };
+    World* const world = &TensorImpl_::world();
+    initial_tile_ = [array, consume, world](
+                        const ordinal_type i,
+                        const ordinal_type) -> Future<value_type> {
+      Future<value_type> tile = array.find(i);
+      if (consume) return tile;
+      return world->taskq.add(&Summa_::clone_tile, tile,
+                              madness::TaskAttributes::hipri());
+    };
+  }
+
+  /// Forward the result tiles to the next term of a sum of contractions
+
+  /// The result tiles of this process are not set; instead, the futures
+  /// returned by this function are set to the result tiles, which are added
+  /// to the result tiles of the next term by the same process (see
+  /// \c set_preceding() ). The next term must be evaluated with the same
+  /// process grid, and it evaluates this term.
+  /// \return The futures of the result tiles of this process, in the order
+  /// of the local tiles of the process grid
+  /// \note The result may not be permuted, the process grid must have a
+  /// single layer, and this must be called before the evaluation is started.
+  std::vector<Future<value_type> > forward_tiles() {
+    TA_ASSERT(!op_.perm());
+    TA_ASSERT(proc_grid_.layers() == 1u);
+    TA_ASSERT(forward_.empty());
+
+    forward_.resize(proc_grid_.local_size());
+    return forward_;
+  }
+
+  /// Set the preceding terms of a sum of contractions
+
+  /// The forwarded result tiles of the preceding terms (see
+  /// \c forward_tiles() ) are the initial values of the reduction tasks of
+  /// this contraction, so that the SUMMA iterations of all terms are
+  /// interleaved and the sum is reduced without temporary arrays. The
+  /// preceding terms are evaluated by this evaluator.
+  /// \param preceding The last of the preceding terms, which must have the
+  /// process grid and the tiled range of this contraction; its shape must be
+  /// included in the shape of the result
+  /// \note The result may not be permuted, and this must be called before
+  /// the evaluation is started.
+  void set_preceding(const SummaLink<value_type, Policy>& preceding) {
+    TA_ASSERT(preceding.eval);
+    TA_ASSERT(!op_.perm());
+    TA_ASSERT(proc_grid_.layers() == 1u);
+    TA_ASSERT(preceding.tiles.size() == proc_grid_.local_size());
+    TA_ASSERT(preceding.eval->trange() == TensorImpl_::trange());
+
+    preceding_ = preceding.eval;
+    initial_is_zero_ = [eval = preceding.eval](const ordinal_type i) {
+      return eval->is_zero(i);
+    };
+    initial_tile_ = [tiles = preceding.tiles](const ordinal_type,
+                                              const ordinal_type t) {
+      return tiles[t];
+    };
+  }
+
   /// Get tile at index \c i
 
   /// \param i The index of the tile
@@ -1555,8 +2166,8 @@ class Summa
     const ordinal_type tile_row = source_index / proc_grid_.cols();
     const ordinal_type tile_col = source_index % proc_grid_.cols();
     // Compute process coordinate of tile in the process grid
-    const ordinal_type proc_row = tile_row % proc_grid_.proc_rows();
-    const ordinal_type proc_col = tile_col % proc_grid_.proc_cols();
+    const ordinal_type proc_row = proc_grid_.row_phase(tile_row);
+    const ordinal_type proc_col = proc_grid_.col_phase(tile_col);
     // Compute the process that owns tile
     const ProcessID source = proc_row * proc_grid_.proc_cols() + proc_col;
 
@@ -1572,57 +2183,121 @@ class Summa
   virtual void discard_tile(ordinal_type i) const { get_tile(i); }
 
  private:
-  /// Adjust iteration depth based on memory constraints
+  /// Compute the memory required by the local SUMMA iterations
+
+  /// For each SUMMA iteration of this process, in the order they are
+  /// executed, the memory required to hold the non-zero tiles of column k of
+  /// the left-hand argument in this process row and row k of the right-hand
+  /// argument in this process column is accumulated into \c step_memory_ ,
+  /// such that <tt>step_memory_[n]</tt> is the memory required by the first
+  /// \c n iterations. The tile volumes are taken from the tiled ranges of the
+  /// arguments, so uneven tilings and sparse shapes are accounted for.
+  /// \param dense \c true if every k is iterated, otherwise only k with
+  /// non-zero rows and columns are iterated (see \c iterate_sparse() )
+  void init_step_memory(const bool dense) {
+    typedef typename numeric_type<typename left_type::eval_type>::type
+        left_numeric_type;
+    typedef typename numeric_type<typename right_type::eval_type>::type
+        right_numeric_type;
+
+    step_memory_.clear();
+    step_memory_.push_back(0ul);
+    ordinal_type k = (dense ? k_begin_ : search_sparse(k_begin_));
+    while (k < k_end_) {
+      std::size_t memory = 0ul;
+
+      // Sum the volume of the non-zero tiles of column k of left
+      for (ordinal_type i = 0ul; i < local_rows_.size(); ++i) {
+        const ordinal_type index = left_index(k, i);
+        if (!left_.shape().is_zero(index))
+          memory += left_.trange().make_tile_range(index).volume() *
+                    sizeof(left_numeric_type);
+      }
 
-  /// \param depth The unbounded iteration depth
-  /// \param left_sparsity The fraction of zero tiles in the left-hand matrix
-  /// \param right_sparsity The fraction of zero tiles in the right-hand matrix
-  /// \return The memory bounded iteration depth
-  /// \thorw TiledArray::Exception When the memory bounded iteration depth
-  /// is less than 1.
-  ordinal_type mem_bound_depth(ordinal_type depth, const float left_sparsity,
-                               const float right_sparsity) {
-    // Check if a memory bound has been set
-    const ordinal_type available_memory = max_memory_;
-    if (available_memory) {
-      // Compute the average memory requirement per iteration of this process
-      const std::size_t local_memory_per_iter_left =
-          (left_.trange().elements_range().volume() /
-           left_.trange().tiles_range().volume()) *
-          sizeof(typename numeric_type<typename left_type::eval_type>::type) *
-          proc_grid_.local_rows() * (1.0f - left_sparsity);
-      const std::size_t local_memory_per_iter_right =
-          (right_.trange().elements_range().volume() /
-           right_.trange().tiles_range().volume()) *
-          sizeof(typename numeric_type<typename right_type::eval_type>::type) *
-          proc_grid_.local_cols() * (1.0f - right_sparsity);
-
-      // Compute the maximum number of iterations based on available memory
-      const ordinal_type mem_bound_depth =
-          ((local_memory_per_iter_left + local_memory_per_iter_right) /
-           available_memory);
-
-      // Check if the memory bounded depth is less than the optimal depth
-      if (depth > mem_bound_depth) {
-        // Adjust the depth based on the available memory
-        switch (mem_bound_depth) {
-          case 0:
-            // When memory bound depth is
-            TA_EXCEPTION("Insufficient memory available for SUMMA");
-            break;
-          case 1:
-            if (TensorImpl_::world().rank() == 0)
-              printf(
-                  "!! WARNING TiledArray: Memory constraints limit the SUMMA "
-                  "depth depth to 1.\n"
-                  "!! WARNING TiledArray: Performance may be slow.\n");
-          default:
-            depth = mem_bound_depth;
-        }
+      // Sum the volume of the non-zero tiles of row k of right
+      for (ordinal_type j = 0ul; j < local_cols_.size(); ++j) {
+        const ordinal_type index = right_index(k, j);
+        if (!right_.shape().is_zero(index))
+          memory += right_.trange().make_tile_range(index).volume() *
+                    sizeof(right_numeric_type);
       }
+
+      step_memory_.push_back(step_memory_.back() + memory);
+      k = (dense ? k + 1ul : search_sparse(k + 1ul));
     }
+  }
+
+  /// Memory required by a sequence of local SUMMA iterations
+
+  /// \param first The position of the first iteration in the sequence
+  /// \param n The number of iterations in the sequence
+  /// \return The memory required by iterations [first, first + n), where
+  /// positions past the last iteration require no memory
+  std::size_t step_memory(const ordinal_type first,
+                          const ordinal_type n) const {
+    TA_ASSERT(!step_memory_.empty());
+    const ordinal_type steps = step_memory_.size() - 1ul;
+    return step_memory_[std::min(first + n, steps)] -
+           step_memory_[std::min(first, steps)];
+  }
 
-    return depth;
+  /// Number of step tasks to append to the SUMMA pipeline
+
+  /// When the iteration at position \c step is run, the iterations in
+  /// (step, tail] have already been started. If the memory required by the
+  /// iterations in flight after appending one step task exceeds the memory
+  /// limit no task is appended, so the pipeline shrinks by one; if there is
+  /// room for an additional iteration and the pipeline is shorter than the
+  /// target depth, two tasks are appended. Otherwise the depth is kept.
+  /// \param step The position of the running step task
+  /// \param tail The position of the last step task in the pipeline
+  /// \return The number of step tasks, 0, 1, or 2, to be appended
+  ordinal_type pipeline_extension(const ordinal_type step,
+                                  const ordinal_type tail) const {
+    if (step_memory_.empty()) return 1ul;
+
+    TA_ASSERT(tail > step);
+    const ordinal_type depth = tail - step;
+    if ((depth > 1ul) && (step_memory(step + 2ul, depth) > memory_limit_))
+      return 0ul;
+    if ((depth < depth_) && ((tail + 1ul) < (step_memory_.size() - 1ul)) &&
+        (step_memory(step + 2ul, depth + 1ul) <= memory_limit_))
+      return 2ul;
+    return 1ul;
+  }
+
+  /// Adjust iteration depth based on memory constraints
+
+  /// \param depth The unbounded iteration depth
+  /// \return The largest depth, no greater than \c depth , for which the
+  /// memory required by the first iterations does not exceed the memory
+  /// limit
+  /// \throw TiledArray::Exception When a single iteration requires more
+  /// memory than is available.
+  ordinal_type mem_bound_depth(ordinal_type depth) const {
+    // Check if a memory bound has been set
+    if (step_memory_.empty()) return depth;
+
+    // Check that every iteration fits in the available memory
+    const ordinal_type steps = step_memory_.size() - 1ul;
+    for (ordinal_type step = 0ul; step < steps; ++step)
+      if (step_memory(step, 1ul) > memory_limit_)
+        TA_EXCEPTION("Insufficient memory available for SUMMA");
+
+    // Compute the maximum number of iterations based on available memory
+    ordinal_type mem_bound_depth = 1ul;
+    while ((mem_bound_depth < depth) &&
+           (step_memory(1ul, mem_bound_depth + 1ul) <= memory_limit_))
+      ++mem_bound_depth;
+
+    if ((mem_bound_depth == 1ul) && (depth > 1ul) &&
+        (TensorImpl_::world().rank() == 0))
+      printf(
+          "!! WARNING TiledArray: Memory constraints limit the SUMMA "
+          "depth to 1.\n"
+          "!! WARNING TiledArray: Performance may be slow.\n");
+
+    return std::min(depth, mem_bound_depth);
   }
 
   /// Evaluate the tiles of this tensor
@@ -1633,22 +2308,19 @@ class Summa
   /// this object).
   /// \return The number of tiles that will be set by this process
   virtual int internal_eval() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-    printf("eval: start eval children rank=%i\n", TensorImpl_::world().rank());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
+    SummaTrace::Scope trace(SummaTrace::Event::eval);
+    if (SummaTrace::enabled())
+      SummaTrace::set_rank(TensorImpl_::world().rank());
 
-    // Start evaluate child tensors
+    // Start evaluate the preceding terms and the child tensors
+    if (preceding_) preceding_->eval();
     left_.eval();
     right_.eval();
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-    printf("eval: finished eval children rank=%i\n",
-           TensorImpl_::world().rank());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-
     ordinal_type tile_count = 0ul;
     if (proc_grid_.local_size() > 0ul) {
       tile_count = initialize();
+      batch_ = init_batch();
 
       // depth controls the number of simultaneous SUMMA iterations
       // that are scheduled.
@@ -1662,15 +2334,17 @@ class Summa
       // Construct the first SUMMA iteration task
       if (TensorImpl_::shape().is_dense()) {
         // We cannot have more iterations than there are blocks in the k
-        // dimension
-        if (depth > k_) depth = k_;
-
-        // Modify the number of concurrent iterations based on the available
-        // memory.
-        depth = mem_bound_depth(depth, 0.0f, 0.0f);
+        // dimension of this layer
+        if (depth > (k_end_ - k_begin_)) depth = k_end_ - k_begin_;
 
         // Enforce user defined depth bound
-        if (max_depth_) depth = std::min(depth, max_depth_);
+        if (depth_limit_) depth = std::min(depth, depth_limit_);
+        depth_ = depth;
+
+        // Modify the number of concurrent iterations based on the memory
+        // required by the first iterations.
+        if (memory_limit_) init_step_memory(true);
+        depth = mem_bound_depth(depth);
 
         TensorImpl_::world().taskq.add(
             new DenseStepTask(shared_from_this(), depth));
@@ -1691,33 +2365,27 @@ class Summa
             float(depth) * (1.0f - 1.35638f * std::log2(frac_non_zero)) + 0.5f;
 
         // We cannot have more iterations than there are blocks in the k
-        // dimension
-        if (depth > k_) depth = k_;
-
-        // Modify the number of concurrent iterations based on the available
-        // memory and sparsity of the argument tensors.
-        depth = mem_bound_depth(depth, left_sparsity, right_sparsity);
+        // dimension of this layer
+        if (depth > (k_end_ - k_begin_)) depth = k_end_ - k_begin_;
 
         // Enforce user defined depth bound
-        if (max_depth_) depth = std::min(depth, max_depth_);
+        if (depth_limit_) depth = std::min(depth, depth_limit_);
+        depth_ = depth;
+
+        // Modify the number of concurrent iterations based on the memory
+        // required by the non-zero tiles of the first iterations.
+        if (memory_limit_) init_step_memory(false);
+        depth = mem_bound_depth(depth);
 
         TensorImpl_::world().taskq.add(
             new SparseStepTask(shared_from_this(), depth));
       }
     }
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-    printf("eval: start wait children rank=%i\n", TensorImpl_::world().rank());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-
     // Wait for child tensors to be evaluated, and process tasks while waiting.
     left_.wait();
     right_.wait();
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-    printf("eval: finished wait children rank=%i\n",
-           TensorImpl_::world().rank());
-#endif  // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
+    if (preceding_) preceding_->wait();
 
     return tile_count;
   }
@@ -1735,6 +2403,11 @@ template <typename Left, typename Right, typename Op, typename Policy>
 typename Summa<Left, Right, Op, Policy>::ordinal_type
     Summa<Left, Right, Op, Policy>::max_memory_ =
         Summa<Left, Right, Op, Policy>::init_max_memory();
+
+template <typename Left, typename Right, typename Op, typename Policy>
+typename Summa<Left, Right, Op, Policy>::ordinal_type
+    Summa<Left, Right, Op, Policy>::batch_tile_size_ =
+        Summa<Left, Right, Op, Policy>::init_batch_tile_size();
 }  // namespace detail
 }  // namespace TiledArray
 
@@ -24,7 +24,11 @@
 #include <TiledArray/perm_index.h>
 #include <TiledArray/permutation.h>
 #include <TiledArray/tensor_impl.h>
+#include <TiledArray/tile_op/tile_interface.h>
 #include <TiledArray/type_traits.h>
+
+#include <atomic>
+
 #ifdef TILEDARRAY_HAS_CUDA
 #include <TiledArray/cuda/cuda_task_fn.h>
 #include <TiledArray/external/cuda.h>
@@ -76,6 +80,16 @@ class DistEvalImpl : public TensorImpl<Policy>,
 
   volatile int task_count_;         ///< Total number of local tasks
   madness::AtomicInt set_counter_;  ///< The number of tiles set by this node
+  std::atomic<bool> completed_;     ///< \c true if \c completion_ was set
+  Future<bool> completion_;  ///< Set when all local tiles were set
+
+  // If truncation is enabled, the norms of the tiles set by this node are
+  // recorded as the tiles are set, and are used to construct a tightened
+  // shape after the evaluation (see truncated_shape() ).
+  static constexpr const bool truncatable =
+      !is_dense_v<shape_type> && !is_lazy_tile<value_type>::value;
+  bool truncate_;  ///< \c true if the norms of the result tiles are recorded
+  std::vector<float> tile_norms_;  ///< The norms of the tiles set by this node
 
  protected:
   /// Permute \c index from a source index to a target index
@@ -114,7 +128,11 @@ class DistEvalImpl : public TensorImpl<Policy>,
         source_to_target_(),
         target_to_source_(),
         task_count_(-1),
-        set_counter_() {
+        set_counter_(),
+        completed_(false),
+        completion_(),
+        truncate_(false),
+        tile_norms_() {
     set_counter_ = 0;
 
     if (perm) {
@@ -152,6 +170,9 @@ class DistEvalImpl : public TensorImpl<Policy>,
   /// \param i The index in the result space where value will be stored
   /// \param value The value to be stored at index \c i
   void set_tile(ordinal_type i, const value_type& value) {
+    // Record the norm of the tile
+    if (truncate_) set_tile_norm(i, value);
+
     // Store value
     madness::DistributedID id(id_, i);
     TensorImpl_::world().gop.send(TensorImpl_::owner(i), id, value);
@@ -171,12 +192,68 @@ class DistEvalImpl : public TensorImpl<Policy>,
     madness::DistributedID id(id_, i);
     TensorImpl_::world().gop.send(TensorImpl_::owner(i), id, f);
 
-    // Record the assignment of a tile
-    f.register_callback(this);
+    // Record the assignment of a tile, after its norm is recorded
+    if (truncate_) {
+      TensorImpl_::world().taskq.add(
+          [this, i](const value_type& tile) {
+            set_tile_norm(i, tile);
+            DistEvalImpl_::notify();
+          },
+          f, madness::TaskAttributes::hipri());
+    } else {
+      f.register_callback(this);
+    }
   }
 
   /// Tile set notification
-  virtual void notify() { set_counter_++; }
+  virtual void notify() {
+    set_counter_++;
+    complete();
+  }
+
+  /// Enable runtime truncation of the result
+
+  /// The norms of the result tiles are computed as the tiles are set, so
+  /// that a shape that is tightened to the actual tile norms can be
+  /// constructed with \c truncated_shape() , without a separate truncation
+  /// pass over the result. This has no effect for dense shapes or lazy
+  /// tiles (i.e. for evaluators that do not evaluate tiles).
+  /// \note This must be called before the evaluation is started.
+  void set_truncate() {
+    TA_ASSERT(task_count_ == -1);
+    if constexpr (truncatable) {
+      truncate_ = true;
+      tile_norms_.assign(TensorImpl_::size(), 0.0f);
+    }
+  }
+
+  /// Truncated shape
+
+  /// Construct the shape of the result from the norms of the tiles
+  /// computed during the evaluation; tiles whose norms are below the shape
+  /// threshold are zero in the new shape. This function is collective and
+  /// waits for the local tiles to be set.
+  /// \return The shape of the result, tightened to the actual tile norms if
+  /// truncation is enabled (see \c set_truncate() ), otherwise the shape of
+  /// this tensor
+  shape_type truncated_shape() const {
+    if constexpr (truncatable) {
+      if (truncate_) {
+        wait();
+        const Tensor<typename shape_type::value_type> tile_norms(
+            TensorImpl_::trange().tiles_range(), tile_norms_.data());
+        return shape_type(TensorImpl_::world(), tile_norms,
+                          TensorImpl_::trange());
+      }
+    }
+    return TensorImpl_::shape();
+  }
+
+  /// Completion of the local tiles
+
+  /// Unlike \c wait() , this does not block, so tasks may depend on it.
+  /// \return A future that is set when all tiles of this node were set
+  Future<bool> completion() const { return completion_; }
 
   /// Wait for all tiles to be assigned
   void wait() const {
@@ -212,6 +289,28 @@ class DistEvalImpl : public TensorImpl<Policy>,
   }
 
  private:
+  /// Set the completion future, if all tiles of this node were set
+
+  /// This is called when a tile is set and when the evaluation was started,
+  /// since tiles may be set before the number of local tiles is known.
+  void complete() {
+    const int task_count = task_count_;
+    if (task_count >= 0 && set_counter_ == task_count &&
+        !completed_.exchange(true))
+      completion_.set(true);
+  }
+
+  /// Record the norm of a tile
+
+  /// \param i The index of the tile
+  /// \param tile The tile
+  void set_tile_norm(const ordinal_type i, const value_type& tile) {
+    if constexpr (truncatable) {
+      using TiledArray::norm;
+      norm(tile, tile_norms_[i]);
+    }
+  }
+
   /// Evaluate the tiles of this tensor
 
   /// This function will evaluate the children of this distributed evaluator
@@ -232,6 +331,7 @@ class DistEvalImpl : public TensorImpl<Policy>,
     TA_ASSERT(task_count_ == -1);
     task_count_ = this->internal_eval();
     TA_ASSERT(task_count_ >= 0);
+    complete();
   }
 
 };  // class DistEvalImpl
@@ -373,6 +473,25 @@ class DistEval {
   /// Wait for all local tiles to be evaluated
   void wait() const { pimpl_->wait(); }
 
+  /// Completion of the local tiles
+
+  /// \return A future that is set when all local tiles were evaluated
+  Future<bool> completion() const { return pimpl_->completion(); }
+
+  /// Enable runtime truncation of the result
+
+  /// \note This must be called before the evaluation is started.
+  /// \sa DistEvalImpl::set_truncate()
+  void set_truncate() { pimpl_->set_truncate(); }
+
+  /// Truncated shape accessor
+
+  /// This function is collective.
+  /// \return The shape of the result, tightened to the actual tile norms if
+  /// truncation is enabled
+  /// \sa DistEvalImpl::truncated_shape()
+  shape_type truncated_shape() const { return pimpl_->truncated_shape(); }
+
 };  // class DistEval
 
 }  // namespace detail
@@ -0,0 +1,242 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  dist_eval/fused_eval.h
+ *  Nov 9, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
+
+#include <TiledArray/dist_eval/array_eval.h>
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/tile_op/fused.h>
+#include <TiledArray/tile_op/noop.h>
+#include <TiledArray/tile_op/unary_wrapper.h>
+
+#include <algorithm>
+
+namespace TiledArray {
+namespace detail {
+
+/// The distributed evaluator type of the arguments of a fused evaluator
+
+/// The arguments pass the array tiles through unmodified; the fused tile
+/// operation applies their permutations and scaling factors.
+/// \tparam Tile The array tile type
+/// \tparam Policy The tensor policy class
+template <typename Tile, typename Policy>
+using fused_arg_eval_t =
+    DistEval<LazyArrayTile<Tile, UnaryWrapper<Noop<Tile, Tile, true> > >,
+             Policy>;
+
+/// Fused, distributed tensor evaluator
+
+/// This object is used to evaluate the tiles of a distributed expression
+/// made of element-wise operations on array arguments with a single fused
+/// tile operation (see \c Fused ) per result tile. The argument tile indices
+/// are given in the index space of the result.
+/// \tparam Arg The argument type (see \c fused_arg_eval_t )
+/// \tparam Op The fused tile operation type
+/// \tparam Policy The tensor policy class
+template <typename Arg, typename Op, typename Policy>
+class FusedEvalImpl
+    : public DistEvalImpl<typename Op::result_type, Policy>,
+      public std::enable_shared_from_this<FusedEvalImpl<Arg, Op, Policy> > {
+ public:
+  typedef FusedEvalImpl<Arg, Op, Policy> FusedEvalImpl_;  ///< This object type
+  typedef DistEvalImpl<typename Op::result_type, Policy>
+      DistEvalImpl_;  ///< The base class type
+  typedef typename DistEvalImpl_::TensorImpl_
+      TensorImpl_;         ///< The base, base class type
+  typedef Arg arg_type;  ///< The argument type
+  typedef typename DistEvalImpl_::ordinal_type ordinal_type;  ///< Ordinal type
+  typedef typename DistEvalImpl_::range_type range_type;      ///< Range type
+  typedef typename DistEvalImpl_::shape_type shape_type;      ///< Shape type
+  typedef typename DistEvalImpl_::pmap_interface
+      pmap_interface;  ///< Process map interface type
+  typedef
+      typename DistEvalImpl_::trange_type trange_type;    ///< Tiled range type
+  typedef typename DistEvalImpl_::value_type value_type;  ///< Tile type
+  typedef Op op_type;  ///< Tile evaluation operator type
+
+  using std::enable_shared_from_this<FusedEvalImpl_>::shared_from_this;
+
+ private:
+  std::vector<arg_type> args_;  ///< Arguments
+  op_type op_;                  ///< Fused tile operation
+
+  /// Tile evaluation task
+
+  /// This task evaluates a result tile once all of its argument tiles are
+  /// available.
+  class EvalTask : public madness::TaskInterface {
+   private:
+    std::shared_ptr<FusedEvalImpl_> owner_;  ///< The parent object
+    ordinal_type index_;                     ///< The result tile index
+    std::vector<Future<typename arg_type::value_type> >
+        tiles_;  ///< The argument tiles
+
+   public:
+    /// Constructor
+
+    /// \param owner The parent object for this task
+    /// \param index The result tile index
+    /// \param tiles The argument tiles
+    EvalTask(const std::shared_ptr<FusedEvalImpl_>& owner,
+             const ordinal_type index,
+             std::vector<Future<typename arg_type::value_type> >&& tiles)
+        : madness::TaskInterface(1, madness::TaskAttributes()),
+          owner_(owner),
+          index_(index),
+          tiles_(std::move(tiles)) {}
+
+    virtual ~EvalTask() {}
+
+    /// Submit this task
+
+    /// The task will run once all argument tiles are available.
+    void submit() {
+      for (auto& tile : tiles_) {
+        if (!tile.probe()) {
+          madness::DependencyInterface::inc();
+          tile.register_callback(this);
+        }
+      }
+      owner_->world().taskq.add(this);
+      madness::DependencyInterface::notify();
+    }
+
+    virtual void run(const madness::TaskThreadEnv&) {
+      owner_->eval_tile(index_, tiles_);
+    }
+
+  };  // class EvalTask
+
+ public:
+  /// Construct a fused evaluator
+
+  /// \param args The arguments, which must have the same tiled range and
+  /// process map as the result
+  /// \param world The world where the tensor lives
+  /// \param trange The tiled range object
+  /// \param shape The tensor shape object
+  /// \param pmap The tile-process map
+  /// \param op The fused tile operation
+  FusedEvalImpl(const std::vector<arg_type>& args, World& world,
+                const trange_type& trange, const shape_type& shape,
+                const std::shared_ptr<pmap_interface>& pmap,
+                const op_type& op)
+      : DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        args_(args),
+        op_(op) {
+    TA_ASSERT(args_.size() == op_type::size);
+    TA_ASSERT(std::all_of(args_.begin(), args_.end(), [&](const Arg& arg) {
+      return arg.trange() == trange;
+    }));
+  }
+
+  virtual ~FusedEvalImpl() {}
+
+  /// Get tile at index \c i
+
+  /// \param i The index of the tile
+  /// \return A \c Future to the tile at index i
+  /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+  /// \throw TiledArray::Exception When tile \c i a zero tile.
+  virtual Future<value_type> get_tile(ordinal_type i) const {
+    TA_ASSERT(TensorImpl_::is_local(i));
+    TA_ASSERT(!TensorImpl_::is_zero(i));
+
+    const ProcessID source = args_.front().owner(i);
+
+    const madness::DistributedID key(DistEvalImpl_::id(), i);
+    return TensorImpl_::world().gop.template recv<value_type>(source, key);
+  }
+
+  /// Discard a tile that is not needed
+
+  /// This function handles the cleanup for tiles that are not needed in
+  /// subsequent computation.
+  /// \param i The index of the tile
+  virtual void discard_tile(ordinal_type i) const { get_tile(i); }
+
+ private:
+  /// Evaluate a result tile
+
+  /// \param i The tile index
+  /// \param tiles The argument tiles
+  void eval_tile(
+      const ordinal_type i,
+      const std::vector<Future<typename arg_type::value_type> >& tiles) {
+    std::vector<const value_type*> args;
+    args.reserve(tiles.size());
+    for (const auto& tile : tiles) args.push_back(&tile.get().tile());
+    DistEvalImpl_::set_tile(i, op_(args));
+  }
+
+  /// Evaluate the tiles of this tensor
+
+  /// This function will evaluate the children of this distributed evaluator
+  /// and evaluate the tiles for this distributed evaluator. It will block
+  /// until the tasks for the children are evaluated (not for the tasks of
+  /// this object).
+  /// \return The number of tiles that will be set by this process
+  virtual int internal_eval() {
+    typedef typename arg_type::value_type arg_value_type;
+
+    // Evaluate child tensors
+    for (auto& arg : args_) arg.eval();
+
+    ordinal_type task_count = 0ul;
+
+    std::shared_ptr<FusedEvalImpl_> self = shared_from_this();
+    const std::shared_ptr<pmap_interface>& pmap = args_.front().pmap();
+    for (const auto index : *pmap) {
+      if (!TensorImpl_::is_zero(index)) {
+        // Zero argument tiles are passed as empty tiles
+        std::vector<Future<arg_value_type> > tiles;
+        tiles.reserve(args_.size());
+        for (auto& arg : args_)
+          tiles.push_back(arg.is_zero(index) ? Future<arg_value_type>(
+                                                   arg_value_type())
+                                             : arg.get(index));
+
+        // Schedule tile evaluation task
+        (new EvalTask(self, index, std::move(tiles)))->submit();
+
+        ++task_count;
+      } else {
+        // Cleanup unused tiles
+        for (auto& arg : args_)
+          if (!arg.is_zero(index)) arg.discard(index);
+      }
+    }
+
+    // Wait for child tensors to be evaluated, and process tasks while waiting.
+    for (auto& arg : args_) arg.wait();
+
+    return task_count;
+  }
+
+};  // class FusedEvalImpl
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
@@ -99,10 +99,26 @@ class UnaryEvalImpl
 
   /// The argument must be a non-const reference if the input tile is
   /// a consumable resource, otherwise a const reference is sufficient.
+  /// Non-lazy tiles are also non-const, so they may be reused by the tile
+  /// operation.
   typedef typename std::conditional<
-      op_type::is_consumable, typename arg_type::value_type&,
+      op_type::is_consumable ||
+          is_consumable_tile<typename arg_type::value_type>::value,
+      typename arg_type::value_type&,
       const typename arg_type::value_type&>::type tile_argument_type;
 
+  /// Tile operation argument type
+
+  /// The tiles of the argument are retrieved once, so the task owns them.
+  /// A non-const tile that the operation does not consume by construction
+  /// is passed as an rvalue, which allows the operation to reuse it for the
+  /// result if its data is not shared (see \c TiledArray::is_unique() ).
+  typedef typename std::conditional<
+      !op_type::is_consumable &&
+          is_consumable_tile<typename arg_type::value_type>::value,
+      typename arg_type::value_type&&, tile_argument_type>::type
+      op_argument_type;
+
   /// Task function for evaluating tiles
 
 #ifdef TILEDARRAY_HAS_CUDA
@@ -122,13 +138,13 @@ class UnaryEvalImpl
   template <typename U = value_type>
   std::enable_if_t<!detail::is_cuda_tile<U>::value, void> eval_tile(
       const ordinal_type i, tile_argument_type tile) {
-    DistEvalImpl_::set_tile(i, op_(tile));
+    DistEvalImpl_::set_tile(i, op_(static_cast<op_argument_type>(tile)));
   }
 #else
   /// \param i The tile index
   /// \param tile The tile to be evaluated
   void eval_tile(const ordinal_type i, tile_argument_type tile) {
-    DistEvalImpl_::set_tile(i, op_(tile));
+    DistEvalImpl_::set_tile(i, op_(static_cast<op_argument_type>(tile)));
   }
 #endif
   /// Evaluate the tiles of this tensor
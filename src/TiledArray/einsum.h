@@ -0,0 +1,813 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  einsum.h
+ *  Nov 18, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_EINSUM_H__INCLUDED
+#define TILEDARRAY_EINSUM_H__INCLUDED
+
+#include <TiledArray/conversions/make_array.h>
+#include <TiledArray/dist_array.h>
+#include <TiledArray/error.h>
+#include <TiledArray/math/blas.h>
+#include <TiledArray/tensor.h>
+#include <TiledArray/tiled_range.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray {
+
+/// Options of \c einsum()
+struct EinsumOptions {
+  /// The maximum estimated size, in bytes, of an intermediate result
+
+  /// Contraction paths with larger intermediates are discarded, unless no
+  /// path satisfies the limit; the process fences after each pairwise step,
+  /// so that the intermediates are released as soon as they were used. Zero
+  /// means that the size of the intermediates is unbounded.
+  double max_intermediate_size = 0.0;
+};
+
+/// Pairwise step of an \c einsum() contraction path
+struct EinsumStep {
+  std::size_t left;   ///< The left-hand operand; operands \c 0 to \c n-1
+                      ///< are the \c n arrays, operand \c n+k is the result
+                      ///< of step \c k
+  std::size_t right;  ///< The right-hand operand
+  std::string indices;  ///< The indices of the result of this step
+  double flops;         ///< The estimated number of floating point operations
+  double size;  ///< The estimated size, in bytes, of the result of this step
+};
+
+/// Contraction path of \c einsum()
+struct EinsumPath {
+  std::vector<EinsumStep> steps;  ///< The pairwise steps, in evaluation order
+  double flops = 0.0;      ///< The estimated number of floating point
+                           ///< operations of all steps
+  double peak_size = 0.0;  ///< The estimated size, in bytes, of the largest
+                           ///< intermediate, i.e. excluding the result
+};
+
+namespace detail {
+
+/// Parsed \c einsum() expression
+struct EinsumExpr {
+  std::vector<std::string> terms;  ///< The indices of each argument
+  std::string result;              ///< The indices of the result
+};
+
+/// Parse an \c einsum() expression
+
+/// Indices are single letters; white space is ignored.
+/// \param expr The expression, e.g. <tt>"aijb,bk,kcd->acd"</tt>
+/// \return The parsed expression
+/// \throw TiledArray::Exception if \c expr is not a valid expression
+inline EinsumExpr einsum_parse(const std::string& expr) {
+  const auto arrow = expr.find("->");
+  if (arrow == std::string::npos)
+    TA_EXCEPTION("einsum: the expression must have the form \"ab,bc->ac\"");
+
+  auto check_term = [](const std::string& term) {
+    if (term.empty()) TA_EXCEPTION("einsum: empty term");
+    for (std::size_t i = 0ul; i < term.size(); ++i)
+      if (term.find(term[i], i + 1ul) != std::string::npos)
+        TA_EXCEPTION("einsum: repeated index in a term");
+  };
+
+  EinsumExpr result;
+  result.terms.emplace_back();
+  for (std::size_t i = 0ul; i < expr.size(); ++i) {
+    const char c = expr[i];
+    if (i == arrow) {
+      ++i;  // skip "->"
+      continue;
+    }
+    if (std::isspace(static_cast<unsigned char>(c))) continue;
+    if (i < arrow && c == ',') {
+      check_term(result.terms.back());
+      result.terms.emplace_back();
+    } else if (std::isalpha(static_cast<unsigned char>(c))) {
+      (i < arrow ? result.terms.back() : result.result).push_back(c);
+    } else {
+      TA_EXCEPTION("einsum: indices must be letters");
+    }
+  }
+  check_term(result.terms.back());
+  if (result.result.empty())
+    TA_EXCEPTION("einsum: scalar results are not supported");
+  check_term(result.result);
+
+  return result;
+}
+
+/// Index set of an \c einsum() expression
+
+/// The indices are numbered in the order they appear in the expression, so
+/// that a set of indices is a bit mask.
+class EinsumIndices {
+ public:
+  typedef std::uint64_t mask_type;  ///< Index set type
+
+ private:
+  std::string indices_;              ///< The distinct indices
+  std::vector<TiledRange1> ranges_;  ///< The tiled range of each index
+
+ public:
+  /// Constructor
+
+  /// \param expr The parsed expression
+  /// \param tranges The tiled range of each argument
+  /// \throw TiledArray::Exception if the ranks of the arguments do not match
+  /// the terms, or the tiled ranges of an index differ
+  EinsumIndices(const EinsumExpr& expr,
+                const std::vector<TiledRange>& tranges) {
+    TA_ASSERT(expr.terms.size() == tranges.size());
+    for (std::size_t t = 0ul; t < tranges.size(); ++t) {
+      const auto& term = expr.terms[t];
+      if (term.size() != tranges[t].rank())
+        TA_EXCEPTION("einsum: the rank of an array does not match its term");
+      for (std::size_t d = 0ul; d < term.size(); ++d) {
+        const auto i = indices_.find(term[d]);
+        if (i == std::string::npos) {
+          indices_.push_back(term[d]);
+          ranges_.push_back(tranges[t].dim(d));
+        } else if (ranges_[i] != tranges[t].dim(d)) {
+          TA_EXCEPTION("einsum: the tiled ranges of an index do not match");
+        }
+      }
+    }
+  }
+
+  /// Index set of a term
+
+  /// \param term The indices of a term
+  /// \return The set of the indices of \c term
+  mask_type mask(const std::string& term) const {
+    mask_type result = 0ul;
+    for (const char c : term) {
+      const auto i = indices_.find(c);
+      TA_ASSERT(i != std::string::npos);
+      result |= mask_type(1) << i;
+    }
+    return result;
+  }
+
+  /// Check if an index occurs in the expression
+
+  /// \param c The index
+  /// \return \c true if \c c occurs in a term
+  bool contains(const char c) const {
+    return indices_.find(c) != std::string::npos;
+  }
+
+  /// Tiled range of an index
+
+  /// \param c The index
+  /// \return The tiled range of \c c
+  const TiledRange1& range(const char c) const {
+    const auto i = indices_.find(c);
+    TA_ASSERT(i != std::string::npos);
+    return ranges_[i];
+  }
+
+  /// Tiled range of a term
+
+  /// \param term The indices of a term
+  /// \return The tiled range of \c term
+  TiledRange trange(const std::string& term) const {
+    std::vector<TiledRange1> ranges;
+    ranges.reserve(term.size());
+    for (const char c : term) ranges.push_back(range(c));
+    return TiledRange(ranges);
+  }
+
+  /// Number of elements of an index set
+
+  /// \param indices The index set
+  /// \return The product of the element extents of \c indices
+  double extent(const mask_type indices) const {
+    double result = 1.0;
+    for (std::size_t i = 0ul; i < indices_.size(); ++i)
+      if (indices & (mask_type(1) << i)) result *= double(ranges_[i].extent());
+    return result;
+  }
+
+  /// Number of tiles of an index set
+
+  /// \param indices The index set
+  /// \return The product of the tile extents of \c indices
+  double tile_extent(const mask_type indices) const {
+    double result = 1.0;
+    for (std::size_t i = 0ul; i < indices_.size(); ++i)
+      if (indices & (mask_type(1) << i))
+        result *= double(ranges_[i].tile_extent());
+    return result;
+  }
+
+};  // class EinsumIndices
+
+/// Pairwise indices of an \c einsum() step
+
+/// The indices of a pair of operands are classified as Hadamard (batch)
+/// indices, which occur in both operands and in the result, contracted
+/// indices, which occur in both operands only, and outer indices, which
+/// occur in one operand only.
+struct EinsumPair {
+  std::string hadamard;    ///< Indices of both operands and of the result
+  std::string contracted;  ///< Indices of both operands only
+  std::string left;        ///< Outer indices of the left-hand operand
+  std::string right;       ///< Outer indices of the right-hand operand
+
+  /// Constructor
+
+  /// \param left_indices The indices of the left-hand operand
+  /// \param right_indices The indices of the right-hand operand
+  /// \param kept The indices that occur in the result of the step
+  EinsumPair(const std::string& left_indices, const std::string& right_indices,
+             const std::string& kept) {
+    for (const char c : left_indices) {
+      if (right_indices.find(c) == std::string::npos)
+        left.push_back(c);
+      else if (kept.find(c) != std::string::npos)
+        hadamard.push_back(c);
+      else
+        contracted.push_back(c);
+    }
+    for (const char c : right_indices)
+      if (left_indices.find(c) == std::string::npos) right.push_back(c);
+  }
+
+  /// Natural result indices of the step
+
+  /// \return The Hadamard indices, followed by the outer indices of the
+  /// left- and right-hand operands
+  std::string indices() const { return hadamard + left + right; }
+
+};  // struct EinsumPair
+
+/// Find the contraction path of an \c einsum() expression
+
+/// The path is the sequence of pairwise steps with the lowest estimated
+/// number of floating point operations, found by dynamic programming over
+/// the subsets of the terms; ties are broken by the size of the largest
+/// intermediate. The cost of a step is
+/// <tt>2 * (product of the extents of its indices) * d_left * d_right</tt>,
+/// where \c d is the estimated fraction of non-zero tiles of an operand,
+/// i.e. <tt>1 - sparsity()</tt> of the shape for arguments and
+/// <tt>min(1, d_left * d_right * (number of contracted tiles))</tt> for
+/// intermediates.
+/// \param expr The parsed expression
+/// \param indices The indices of \c expr
+/// \param densities The estimated fraction of non-zero tiles of each argument
+/// \param element_size The size of an element, in bytes
+/// \param max_size The maximum size, in bytes, of an intermediate, or zero
+/// \return The contraction path
+/// \throw TiledArray::Exception if \c expr has more than 16 terms, or it
+/// requires an intermediate without indices
+inline EinsumPath einsum_path(const EinsumExpr& expr,
+                              const EinsumIndices& indices,
+                              const std::vector<double>& densities,
+                              const std::size_t element_size,
+                              const double max_size) {
+  typedef EinsumIndices::mask_type mask_type;
+  typedef std::uint32_t set_type;
+
+  const std::size_t n = expr.terms.size();
+  if (n > 16ul) TA_EXCEPTION("einsum: at most 16 terms are supported");
+  const set_type all = (set_type(1) << n) - 1u;
+
+  // Indices of the terms and of the result
+  std::vector<mask_type> term_masks;
+  for (const auto& term : expr.terms) term_masks.push_back(indices.mask(term));
+  const mask_type result_mask = indices.mask(expr.result);
+
+  // Indices of each subset of terms that are needed outside of it
+  std::vector<mask_type> kept(all + 1u, 0ul);
+  for (set_type s = 1u; s <= all; ++s) {
+    mask_type inside = 0ul, outside = result_mask;
+    for (std::size_t t = 0ul; t < n; ++t)
+      (s & (set_type(1) << t) ? inside : outside) |= term_masks[t];
+    kept[s] = inside & outside;
+  }
+
+  const double infinity = std::numeric_limits<double>::infinity();
+  struct Node {
+    double flops = std::numeric_limits<double>::infinity();
+    double peak = 0.0;
+    double density = 1.0;
+    set_type split = 0u;
+  };
+
+  auto search = [&](const double limit) {
+    std::vector<Node> nodes(all + 1u);
+    for (std::size_t t = 0ul; t < n; ++t) {
+      auto& leaf = nodes[set_type(1) << t];
+      leaf.flops = 0.0;
+      leaf.density = densities[t];
+    }
+
+    for (set_type s = 1u; s <= all; ++s) {
+      if (!(s & (s - 1u))) continue;  // leaf
+      if (s != all && kept[s] == 0ul) continue;  // scalar intermediate
+
+      auto& node = nodes[s];
+      const set_type low = s & (~s + 1u);
+      for (set_type a = (s - 1u) & s; a != 0u; a = (a - 1u) & s) {
+        if (!(a & low)) continue;  // visit each split once
+        const set_type b = s ^ a;
+        const auto& left = nodes[a];
+        const auto& right = nodes[b];
+        if (left.flops == infinity || right.flops == infinity) continue;
+
+        const mask_type contracted = kept[a] & kept[b] & ~kept[s];
+        const double density =
+            std::min(1.0, left.density * right.density *
+                              indices.tile_extent(contracted));
+        const double flops = left.flops + right.flops +
+                             2.0 * indices.extent(kept[a] | kept[b]) *
+                                 left.density * right.density;
+        double peak = std::max(left.peak, right.peak);
+        if (s != all) {
+          const double size =
+              indices.extent(kept[s]) * density * double(element_size);
+          if (limit > 0.0 && size > limit) continue;
+          peak = std::max(peak, size);
+        }
+
+        if (flops < node.flops || (flops == node.flops && peak < node.peak)) {
+          node.flops = flops;
+          node.peak = peak;
+          node.density = density;
+          node.split = a;
+        }
+      }
+    }
+
+    return nodes;
+  };
+
+  auto nodes = search(max_size);
+  if (nodes[all].flops == infinity && max_size > 0.0) nodes = search(0.0);
+  if (nodes[all].flops == infinity)
+    TA_EXCEPTION("einsum: the terms do not form a connected contraction");
+
+  // Collect the steps in evaluation order
+  EinsumPath path;
+  path.flops = nodes[all].flops;
+  path.peak_size = nodes[all].peak;
+  std::vector<std::string> operands(expr.terms);
+  auto collect = [&](auto& self, const set_type s) -> std::size_t {
+    if (!(s & (s - 1u))) {
+      std::size_t t = 0ul;
+      while (!(s & (set_type(1) << t))) ++t;
+      return t;
+    }
+
+    const set_type a = nodes[s].split, b = s ^ a;
+    const std::size_t left = self(self, a);
+    const std::size_t right = self(self, b);
+
+    std::string kept_indices;
+    for (const char c : operands[left] + operands[right])
+      if ((indices.mask(std::string(1, c)) & kept[s]) &&
+          kept_indices.find(c) == std::string::npos)
+        kept_indices.push_back(c);
+    EinsumPair pair(operands[left], operands[right],
+                    s == all ? expr.result : kept_indices);
+
+    EinsumStep step;
+    step.left = left;
+    step.right = right;
+    step.indices = (s == all ? expr.result : pair.indices());
+    step.flops = nodes[s].flops - nodes[a].flops - nodes[b].flops;
+    step.size = indices.extent(indices.mask(step.indices)) *
+                nodes[s].density * double(element_size);
+    path.steps.push_back(step);
+    operands.push_back(step.indices);
+    return operands.size() - 1ul;
+  };
+  if (n > 1ul) collect(collect, all);
+
+  return path;
+}
+
+/// Convert \c einsum() indices to an annotation
+
+/// \param indices The indices, e.g. <tt>"abc"</tt>
+/// \return The annotation of \c indices , e.g. <tt>"a,b,c"</tt>
+inline std::string einsum_annotation(const std::string& indices) {
+  std::string result;
+  for (const char c : indices) {
+    if (!result.empty()) result.push_back(',');
+    result.push_back(c);
+  }
+  return result;
+}
+
+/// Checks if \c einsum() batch steps are supported for a tile type
+
+/// Steps with batch (Hadamard) indices that are contracted with other
+/// indices are evaluated with \c einsum_batch() , which requires
+/// \c TiledArray::Tensor tiles.
+template <typename T>
+struct is_einsum_batch_tile : public std::false_type {};
+
+template <typename T, typename A>
+struct is_einsum_batch_tile<Tensor<T, A>>
+    : public std::integral_constant<bool, is_numeric_v<T>> {};
+
+/// Evaluate an \c einsum() step with batch indices
+
+/// Each result tile is the sum over the tiles of the contracted indices of
+/// the products of the argument tiles, which are permuted to the
+/// <tt>(hadamard, left, contracted)</tt> and
+/// <tt>(hadamard, contracted, right)</tt> orders, so that each element of the
+/// Hadamard indices is a matrix multiplication. Each argument tile used by
+/// the local result tiles is fetched and permuted once, and the task that
+/// evaluates a result tile depends on the futures of its argument tiles.
+/// \tparam Array The array type
+/// \param left The left-hand operand
+/// \param left_indices The indices of \c left
+/// \param right The right-hand operand
+/// \param right_indices The indices of \c right
+/// \param pair The indices of the step
+/// \param indices The indices of the expression
+/// \return The result, with the indices <tt>pair.indices()</tt>
+template <typename Array>
+Array einsum_batch(const Array& left, const std::string& left_indices,
+                   const Array& right, const std::string& right_indices,
+                   const EinsumPair& pair, const EinsumIndices& indices) {
+  typedef typename Array::value_type value_type;
+
+  if constexpr (!is_einsum_batch_tile<value_type>::value) {
+    TA_EXCEPTION(
+        "einsum: batch indices that are contracted with other indices "
+        "require TiledArray::Tensor tiles");
+    return Array();
+  } else {
+    typedef typename value_type::value_type element_type;
+    typedef typename Array::ordinal_type ordinal_type;
+    typedef std::vector<std::size_t> index_type;
+    typedef std::vector<Future<value_type>> tiles_type;
+
+    World& world = left.world();
+    const std::string result_indices = pair.indices();
+    const std::string left_order = pair.hadamard + pair.left + pair.contracted;
+    const std::string right_order =
+        pair.hadamard + pair.contracted + pair.right;
+    const TiledRange trange = indices.trange(result_indices);
+    const TiledRange contracted_trange =
+        (pair.contracted.empty() ? TiledRange()
+                                 : indices.trange(pair.contracted));
+    const std::size_t contracted_tiles =
+        (pair.contracted.empty() ? 1ul
+                                 : contracted_trange.tiles_range().volume());
+
+    // Position of the argument indices in the result tile index followed by
+    // the contracted tile index
+    auto sources = [&](const std::string& arg_indices) {
+      const std::string all_indices = result_indices + pair.contracted;
+      index_type result;
+      for (const char c : arg_indices) result.push_back(all_indices.find(c));
+      return result;
+    };
+    const index_type left_sources = sources(left_indices);
+    const index_type right_sources = sources(right_indices);
+
+    const bool permute_left = (left_order != left_indices);
+    const bool permute_right = (right_order != right_indices);
+    const Permutation left_perm =
+        expressions::VariableList(einsum_annotation(left_order))
+            .permutation(
+                expressions::VariableList(einsum_annotation(left_indices)));
+    const Permutation right_perm =
+        expressions::VariableList(einsum_annotation(right_order))
+            .permutation(
+                expressions::VariableList(einsum_annotation(right_indices)));
+    const std::size_t rank_h = pair.hadamard.size();
+    const std::size_t rank_l = pair.left.size();
+
+    // Fetch and permute an argument tile, once for all local result tiles
+    typedef std::unordered_map<ordinal_type, Future<value_type>> cache_type;
+    cache_type left_cache, right_cache;
+    auto fetch = [&world](const Array& array, const index_type& index,
+                          const bool permute, const Permutation& perm,
+                          cache_type& cache) {
+      const ordinal_type ord = array.trange().tiles_range().ordinal(index);
+      auto it = cache.find(ord);
+      if (it == cache.end()) {
+        Future<value_type> tile = array.find(ord);
+        if (permute)
+          tile = world.taskq.add(
+              [perm](const value_type& arg) { return arg.permute(perm); },
+              tile);
+        it = cache.emplace(ord, tile).first;
+      }
+      return it->second;
+    };
+
+    // Evaluate a result tile from the pairs of argument tiles
+    auto op = [rank_h, rank_l](const Range& range, const tiles_type& lefts,
+                               const tiles_type& rights) {
+      value_type tile(range, element_type(0));
+
+      // Matrix dimensions of each element of the Hadamard indices
+      std::size_t h = 1ul, m = 1ul, n = 1ul;
+      for (std::size_t d = 0ul; d < range.rank(); ++d)
+        (d < rank_h ? h : (d < rank_h + rank_l ? m : n)) *= range.extent(d);
+
+      for (std::size_t p = 0ul; p < lefts.size(); ++p) {
+        const value_type& left_tile = lefts[p].get();
+        const value_type& right_tile = rights[p].get();
+        const std::size_t k = left_tile.size() / (h * m);
+        for (std::size_t b = 0ul; b < h; ++b)
+          math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, m, n,
+                     k, element_type(1), left_tile.data() + b * m * k, k,
+                     right_tile.data() + b * k * n, n, element_type(1),
+                     tile.data() + b * m * n, n);
+      }
+
+      return tile;
+    };
+
+    const auto pmap = detail::policy_t<Array>::default_pmap(
+        world, trange.tiles_range().volume());
+    std::vector<std::pair<ordinal_type, Future<value_type>>> tiles;
+    tiles.reserve(pmap->size());
+    index_type left_index(left_sources.size());
+    index_type right_index(right_sources.size());
+    for (const auto ord : *pmap) {
+      // Tile index of the result tile followed by the contracted tile index
+      index_type index(trange.rank() + pair.contracted.size());
+      const auto result_index = trange.tiles_range().idx(ord);
+      std::copy(result_index.begin(), result_index.end(), index.begin());
+
+      tiles_type lefts, rights;
+      for (std::size_t c = 0ul; c < contracted_tiles; ++c) {
+        if (!pair.contracted.empty()) {
+          const auto contracted_index = contracted_trange.tiles_range().idx(c);
+          std::copy(contracted_index.begin(), contracted_index.end(),
+                    index.begin() + trange.rank());
+        }
+        for (std::size_t i = 0ul; i < left_sources.size(); ++i)
+          left_index[i] = index[left_sources[i]];
+        for (std::size_t i = 0ul; i < right_sources.size(); ++i)
+          right_index[i] = index[right_sources[i]];
+        if (left.is_zero(left_index) || right.is_zero(right_index)) continue;
+
+        lefts.push_back(
+            fetch(left, left_index, permute_left, left_perm, left_cache));
+        rights.push_back(
+            fetch(right, right_index, permute_right, right_perm, right_cache));
+      }
+
+      // Tiles without contributions are zero; they are omitted from sparse
+      // arrays
+      if (lefts.empty() && !is_dense<Array>::value) continue;
+      tiles.emplace_back(ord, world.taskq.add(op, trange.make_tile_range(ord),
+                                              std::move(lefts),
+                                              std::move(rights)));
+    }
+
+    if constexpr (is_dense<Array>::value) {
+      Array result(world, trange, pmap);
+      for (auto& tile : tiles) result.set(tile.first, tile.second);
+      return result;
+    } else {
+      // The shape of the result requires the norms of the result tiles
+      typedef typename detail::shape_t<Array>::value_type norm_type;
+      Tensor<norm_type> tile_norms(trange.tiles_range(), norm_type(0));
+      madness::AtomicInt counter;
+      counter = 0;
+      for (auto& tile : tiles)
+        world.taskq.add(
+            [&tile_norms, &counter, ord = tile.first](const value_type& arg) {
+              tile_norms[ord] = arg.norm();
+              ++counter;
+            },
+            tile.second);
+      const int task_count = tiles.size();
+      if (task_count > 0)
+        world.await(
+            [&counter, task_count]() -> bool { return counter == task_count; });
+
+      Array result(world, trange,
+                   typename Array::shape_type(world, tile_norms, trange), pmap);
+      for (auto& tile : tiles)
+        if (!result.is_zero(tile.first)) result.set(tile.first, tile.second);
+      return result;
+    }
+  }
+}
+
+/// Evaluate an \c einsum() step
+
+/// \tparam Array The array type
+/// \param left The left-hand operand
+/// \param left_indices The indices of \c left
+/// \param right The right-hand operand
+/// \param right_indices The indices of \c right
+/// \param result_indices The indices of the result
+/// \param indices The indices of the expression
+/// \return The result, with the indices \c result_indices
+template <typename Array>
+Array einsum_step(const Array& left, const std::string& left_indices,
+                  const Array& right, const std::string& right_indices,
+                  const std::string& result_indices,
+                  const EinsumIndices& indices) {
+  const EinsumPair pair(left_indices, right_indices, result_indices);
+  const std::string target = einsum_annotation(result_indices);
+
+  Array result;
+  if (pair.hadamard.empty() ||
+      (pair.contracted.empty() && pair.left.empty() && pair.right.empty())) {
+    // Contraction, outer product, or Hadamard product
+    result(target) = left(einsum_annotation(left_indices)) *
+                     right(einsum_annotation(right_indices));
+  } else {
+    result = einsum_batch(left, left_indices, right, right_indices, pair,
+                          indices);
+    if (pair.indices() != result_indices) {
+      const Array batch = result;
+      result = Array();
+      result(target) = batch(einsum_annotation(pair.indices()));
+    }
+  }
+
+  return result;
+}
+
+}  // namespace detail
+
+/// Find the contraction path of an Einstein summation
+
+/// See \c einsum() for the form of \c expr and the cost model.
+/// \tparam Tile The tile type of the arrays
+/// \tparam Policy The policy type of the arrays
+/// \tparam Arrays The types of the other arrays
+/// \param expr The expression, e.g. <tt>"aijb,bk,kcd->acd"</tt>
+/// \param options The evaluation options
+/// \param array The first array
+/// \param arrays The other arrays
+/// \return The contraction path that \c einsum() evaluates
+template <typename Tile, typename Policy, typename... Arrays>
+EinsumPath einsum_path(const std::string& expr, const EinsumOptions& options,
+                       const DistArray<Tile, Policy>& array,
+                       const Arrays&... arrays) {
+  static_assert(
+      (std::is_same<Arrays, DistArray<Tile, Policy>>::value && ...),
+      "einsum: the arrays must have the same type");
+
+  const detail::EinsumExpr parsed = detail::einsum_parse(expr);
+  if (parsed.terms.size() != 1ul + sizeof...(Arrays))
+    TA_EXCEPTION("einsum: the number of terms does not match the arrays");
+
+  const detail::EinsumIndices indices(parsed,
+                                      {array.trange(), arrays.trange()...});
+  for (const char c : parsed.result)
+    if (!indices.contains(c))
+      TA_EXCEPTION("einsum: a result index does not occur in any term");
+  for (std::size_t t = 0ul; t < parsed.terms.size(); ++t) {
+    for (const char c : parsed.terms[t]) {
+      std::size_t count = parsed.result.find(c) == std::string::npos ? 0 : 1;
+      for (const auto& term : parsed.terms)
+        count += term.find(c) == std::string::npos ? 0 : 1;
+      if (count < 2ul)
+        TA_EXCEPTION(
+            "einsum: indices that occur in a single term must occur in the "
+            "result");
+    }
+  }
+
+  return detail::einsum_path(
+      parsed, indices,
+      {1.0 - double(array.shape().sparsity()),
+       (1.0 - double(arrays.shape().sparsity()))...},
+      sizeof(detail::numeric_t<Tile>), options.max_intermediate_size);
+}
+
+/// Find the contraction path of an Einstein summation
+
+/// \tparam Tile The tile type of the arrays
+/// \tparam Policy The policy type of the arrays
+/// \tparam Arrays The types of the other arrays
+/// \param expr The expression, e.g. <tt>"aijb,bk,kcd->acd"</tt>
+/// \param array The first array
+/// \param arrays The other arrays
+/// \return The contraction path that \c einsum() evaluates
+template <typename Tile, typename Policy, typename... Arrays>
+EinsumPath einsum_path(const std::string& expr,
+                       const DistArray<Tile, Policy>& array,
+                       const Arrays&... arrays) {
+  return einsum_path(expr, EinsumOptions(), array, arrays...);
+}
+
+/// Einstein summation of arrays
+
+/// Evaluates an expression in the notation of \c numpy.einsum , e.g.
+/// \code
+/// auto D = TiledArray::einsum("aijb,bk,kcd->acd", A, B, C);
+/// \endcode
+/// where each term lists the indices of an array, and the indices after
+/// \c "->" are the indices of the result. Indices are single letters. An
+/// index that occurs in several terms but not in the result is contracted;
+/// an index that occurs in several terms and in the result is a Hadamard
+/// (batch) index; an index that occurs in a single term must occur in the
+/// result (outer product). Indices of the same name must have the same
+/// tiled range.
+///
+/// The expression is evaluated as a sequence of pairwise steps, selected by
+/// a cost model over the tiled ranges and shapes of the arrays (see
+/// \c einsum_path() ). Steps without Hadamard indices, and pure Hadamard
+/// products, are evaluated as array expressions; the other steps are
+/// evaluated tile by tile, which requires \c TiledArray::Tensor tiles.
+/// \tparam Tile The tile type of the arrays
+/// \tparam Policy The policy type of the arrays
+/// \tparam Arrays The types of the other arrays
+/// \param expr The expression
+/// \param options The evaluation options
+/// \param array The first array
+/// \param arrays The other arrays
+/// \return The result of \c expr
+/// \throw TiledArray::Exception if \c expr is not a valid expression for the
+/// arrays
+template <typename Tile, typename Policy, typename... Arrays>
+DistArray<Tile, Policy> einsum(const std::string& expr,
+                               const EinsumOptions& options,
+                               const DistArray<Tile, Policy>& array,
+                               const Arrays&... arrays) {
+  typedef DistArray<Tile, Policy> array_type;
+
+  const EinsumPath path = einsum_path(expr, options, array, arrays...);
+  const detail::EinsumExpr parsed = detail::einsum_parse(expr);
+  const detail::EinsumIndices indices(parsed,
+                                      {array.trange(), arrays.trange()...});
+
+  std::vector<array_type> operands{array, arrays...};
+  std::vector<std::string> operand_indices(parsed.terms);
+  if (path.steps.empty()) {
+    array_type result;
+    result(detail::einsum_annotation(parsed.result)) =
+        array(detail::einsum_annotation(parsed.terms.front()));
+    return result;
+  }
+
+  for (const auto& step : path.steps) {
+    operands.push_back(detail::einsum_step(
+        operands[step.left], operand_indices[step.left], operands[step.right],
+        operand_indices[step.right], step.indices, indices));
+    operand_indices.push_back(step.indices);
+
+    // Release the operands of this step
+    operands[step.left] = array_type();
+    operands[step.right] = array_type();
+    if (options.max_intermediate_size > 0.0) array.world().gop.fence();
+  }
+
+  return operands.back();
+}
+
+/// Einstein summation of arrays
+
+/// See \c einsum(const std::string&, const EinsumOptions&, ...)
+/// \tparam Tile The tile type of the arrays
+/// \tparam Policy The policy type of the arrays
+/// \tparam Arrays The types of the other arrays
+/// \param expr The expression, e.g. <tt>"aijb,bk,kcd->acd"</tt>
+/// \param array The first array
+/// \param arrays The other arrays
+/// \return The result of \c expr
+template <typename Tile, typename Policy, typename... Arrays>
+DistArray<Tile, Policy> einsum(const std::string& expr,
+                               const DistArray<Tile, Policy>& array,
+                               const Arrays&... arrays) {
+  return einsum(expr, EinsumOptions(), array, arrays...);
+}
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_EINSUM_H__INCLUDED
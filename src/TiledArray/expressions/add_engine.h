@@ -26,10 +26,13 @@
 #ifndef TILEDARRAY_EXPRESSIONS_ADD_ENGINE_H__INCLUDED
 #define TILEDARRAY_EXPRESSIONS_ADD_ENGINE_H__INCLUDED
 
+#include <TiledArray/dist_eval/contraction_eval.h>
 #include <TiledArray/expressions/binary_engine.h>
 #include <TiledArray/tile_op/add.h>
 #include <TiledArray/tile_op/binary_wrapper.h>
 
+#include <functional>
+
 namespace TiledArray {
 namespace expressions {
 
@@ -162,13 +165,131 @@ class AddEngine : public BinaryEngine<AddEngine<Left, Right, Result> > {
   typedef typename EngineTrait<AddEngine_>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// \c true if this expression may be evaluated by a fused tile operation
+  static constexpr bool fusable = BinaryEngine_::fusable_args;
+  typedef value_type fused_tile_type;  ///< The tile type of fused evaluation
+
+  /// \c true if this expression may be a sum of contractions
+  static constexpr bool chainable =
+      left_type::chainable && right_type::chainable &&
+      std::is_same<typename left_type::value_type, value_type>::value &&
+      std::is_same<typename right_type::value_type, value_type>::value;
+  typedef TiledArray::detail::SummaLink<value_type, policy>
+      summa_link_type;  ///< The term type of a sum of contractions
+
+ private:
+  bool chained_;  ///< \c true if this expression is evaluated as a sum of
+                  ///< contractions
+
+ public:
   /// Constructor
 
   /// \tparam L The left-hand argument expression type
   /// \tparam R The right-hand argument expression type
   /// \param expr The parent expression
   template <typename L, typename R>
-  AddEngine(const AddExpr<L, R>& expr) : BinaryEngine_(expr) {}
+  AddEngine(const AddExpr<L, R>& expr)
+      : BinaryEngine_(expr), chained_(false) {}
+
+  /// Initialize result tensor distribution
+
+  /// Sums of contractions with unpermuted results are evaluated by a single
+  /// distributed evaluator: all terms are evaluated with the process grid
+  /// of the first term, and the tile contractions of each term are added
+  /// to the result tiles of the preceding terms (see \c make_summa_link() ).
+  /// This is not done if the process grid of the first term has more than
+  /// one layer.
+  /// \param world The world were the result will be distributed
+  /// \param pmap The process map for the result tensor tiles
+  void init_distribution(World* world,
+                         const std::shared_ptr<pmap_interface>& pmap) {
+    if constexpr (chainable) {
+      if (can_chain()) {
+        BinaryEngine_::left_.init_distribution(world, pmap);
+        const std::shared_ptr<pmap_interface>& left_pmap =
+            BinaryEngine_::left_.pmap();
+        chained_ = (proc_grid().layers() == 1u);
+        if (chained_)
+          BinaryEngine_::right_.init_distribution(world, left_pmap,
+                                                  proc_grid());
+        else
+          BinaryEngine_::right_.init_distribution(world, left_pmap);
+        ExprEngine_::init_distribution(world, left_pmap);
+        return;
+      }
+    }
+
+    BinaryEngine_::init_distribution(world, pmap);
+  }
+
+  /// Initialize result tensor distribution with a given process grid
+
+  /// \param world The world were the result will be distributed
+  /// \param pmap The process map for the result tensor tiles
+  /// \param proc_grid The process grid of the contractions
+  /// \note This requires that \c can_chain() is \c true .
+  void init_distribution(World* world,
+                         const std::shared_ptr<pmap_interface>& pmap,
+                         const TiledArray::detail::ProcGrid& proc_grid) {
+    BinaryEngine_::left_.init_distribution(world, pmap, proc_grid);
+    const std::shared_ptr<pmap_interface>& left_pmap =
+        BinaryEngine_::left_.pmap();
+    BinaryEngine_::right_.init_distribution(world, left_pmap, proc_grid);
+    chained_ = true;
+    ExprEngine_::init_distribution(world, left_pmap);
+  }
+
+  /// Check if this expression may be evaluated as a sum of contractions
+
+  /// \return \c true if both arguments are contractions, or sums of
+  /// contractions, with unpermuted results, and the result of this
+  /// expression is not permuted or masked
+  bool can_chain() const {
+    if constexpr (chainable) {
+      return !ExprEngine_::perm_ &&
+             !(ExprEngine_::override_ptr_ &&
+               ExprEngine_::override_ptr_->shape) &&
+             BinaryEngine_::left_.can_chain() &&
+             BinaryEngine_::right_.can_chain();
+    } else {
+      return false;
+    }
+  }
+
+  /// Process grid accessor
+
+  /// \return A const reference to the process grid of the first contraction
+  /// of this sum
+  /// \note This requires that \c can_chain() is \c true .
+  const TiledArray::detail::ProcGrid& proc_grid() const {
+    return BinaryEngine_::left_.proc_grid();
+  }
+
+  /// Construct the distributed evaluator of the terms of this sum
+
+  /// \param preceding The last of the preceding terms (empty for the first
+  /// term)
+  /// \param forward \c true if the result tiles are forwarded to a
+  /// subsequent term, \c false if this is the last term
+  /// \return The evaluator of the terms up to the last term of this sum
+  summa_link_type make_summa_link(const summa_link_type& preceding,
+                                  const bool forward) const {
+    TA_ASSERT(chained_);
+    return BinaryEngine_::right_.make_summa_link(
+        BinaryEngine_::left_.make_summa_link(preceding, true), forward);
+  }
+
+  /// Construct the distributed evaluator for this expression
+
+  /// \return The distributed evaluator that will evaluate this expression
+  dist_eval_type make_dist_eval() const {
+    if constexpr (chainable) {
+      if (chained_)
+        return dist_eval_type(make_summa_link(summa_link_type(), false).eval);
+    }
+
+    return BinaryEngine_::make_dist_eval();
+  }
 
   /// Non-permuting shape factory function
 
@@ -199,6 +320,15 @@ class AddEngine : public BinaryEngine<AddEngine<Left, Right, Result> > {
     return op_type(op_base_type(), perm);
   }
 
+  /// Fused element expression factory function
+
+  /// \tparam I The position of the first leaf of this expression
+  /// \return The element expression of this expression
+  template <std::size_t I>
+  auto make_fused_op() const {
+    return BinaryEngine_::template make_fused_binary<std::plus<>, I>();
+  }
+
   /// Expression identification tag
 
   /// \return An expression tag used to identify this expression
@@ -254,6 +384,10 @@ class ScalAddEngine
   typedef typename EngineTrait<ScalAddEngine_>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// \c true if this expression may be evaluated by a fused tile operation
+  static constexpr bool fusable = BinaryEngine_::fusable_args;
+  typedef value_type fused_tile_type;  ///< The tile type of fused evaluation
+
  private:
   scalar_type factor_;  ///< Scaling factor
 
@@ -298,6 +432,16 @@ class ScalAddEngine
     return op_type(op_base_type(factor_), perm);
   }
 
+  /// Fused element expression factory function
+
+  /// \tparam I The position of the first leaf of this expression
+  /// \return The element expression of this expression
+  template <std::size_t I>
+  auto make_fused_op() const {
+    return BinaryEngine_::template make_fused_binary<std::plus<>, I>(
+        factor_);
+  }
+
   /// Scaling factor accessor
 
   /// \return The scaling factor
@@ -0,0 +1,183 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  expressions/async_eval.h
+ *  Nov 19, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_ASYNC_EVAL_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_ASYNC_EVAL_H__INCLUDED
+
+#include <TiledArray/external/madness.h>
+#include <TiledArray/util/record_log.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace TiledArray {
+namespace expressions {
+
+/// Asynchronous evaluation of expressions
+
+/// By default, the assignment of an expression to an array returns when the
+/// local tiles of the result were evaluated, so that consecutive
+/// assignments are serialized even if they are independent. When
+/// asynchronous evaluation is enabled, the assignment returns as soon as
+/// the evaluation tasks were submitted: the tiles of the result are futures,
+/// so expressions that read the result depend on its tiles only, and
+/// independent expressions are evaluated concurrently. The process blocks
+/// only when tiles are consumed, e.g. by <tt>find(i).get()</tt> , or before
+/// the tiles of an array are updated in place (see
+/// \c Expr::eval_add_to() ), until the pending evaluations that read them
+/// are complete:
+/// \code
+/// AsyncEval::enable();
+/// x("i,j") = a("i,k") * b("k,j");
+/// y("i,j") = c("i,k") * d("k,j");  // overlaps with x
+/// z("i,j") = x("i,j") + y("i,j");  // depends on the tiles of x and y
+/// AsyncEval::completion(z).get();  // blocks until z is evaluated
+/// AsyncEval::disable();
+/// \endcode
+/// Evaluations are tracked by the implementation objects of the arrays they
+/// read and write, on each process independently.
+class AsyncEval {
+ public:
+  /// Check if asynchronous evaluation is enabled
+
+  /// \return \c true if assignments do not wait for their evaluation
+  static bool enabled() { return evaluations().enabled(); }
+
+  /// Enable asynchronous evaluation
+
+  /// \note This must be called on all processes.
+  static void enable() { evaluations().enable(); }
+
+  /// Disable asynchronous evaluation
+
+  /// Pending evaluations are not waited for (see \c wait_all() ).
+  /// \note This must be called on all processes.
+  static void disable() { evaluations().disable(); }
+
+  /// Completion of the evaluation of an array
+
+  /// \tparam A The array type
+  /// \param array The array
+  /// \return A future that is set when the local tiles of the last pending
+  /// evaluation that assigned \c array were evaluated; it is already set if
+  /// no such evaluation is pending
+  template <typename A>
+  static Future<bool> completion(const A& array) {
+    if (array.is_initialized()) {
+      const void* const id = array.pimpl().get();
+      return evaluations().locked([id](const std::vector<Evaluation>& evals) {
+        for (auto it = evals.rbegin(); it != evals.rend(); ++it)
+          if (it->write == id) return it->done;
+        return Future<bool>(true);
+      });
+    }
+    return Future<bool>(true);
+  }
+
+  /// Wait for the pending evaluations that read or write an array
+
+  /// \tparam A The array type
+  /// \param array The array
+  template <typename A>
+  static void wait(const A& array) {
+    if (array.is_initialized()) wait_for(array.pimpl().get());
+  }
+
+  /// Wait for all pending evaluations of this process
+  static void wait_all() { wait_for(nullptr); }
+
+  /// Record a pending evaluation
+
+  /// The evaluation is complete when the local tiles of \c result were set
+  /// and the distributed evaluator finished, which is kept alive until then.
+  /// \tparam DistEval The distributed evaluator type
+  /// \tparam A The result array type
+  /// \param dist_eval The distributed evaluator of the expression
+  /// \param result The result array
+  /// \param reads The implementation objects of the arrays read by the
+  /// expression
+  /// \return The completion future of the evaluation
+  template <typename DistEval, typename A>
+  static Future<bool> record(const DistEval& dist_eval, const A& result,
+                             std::vector<const void*> reads) {
+    typedef Future<typename A::value_type> future_type;
+
+    std::vector<future_type> tiles;
+    for (const auto index : *result.pmap())
+      if (!result.is_zero(index)) tiles.push_back(result.find(index));
+
+    // The task depends on the tiles and on the completion of the evaluator,
+    // so it runs without blocking once both are ready
+    Future<bool> done = result.world().taskq.add(
+        [](const DistEval&, const std::vector<future_type>&, bool) {
+          return true;
+        },
+        dist_eval, tiles, dist_eval.completion());
+
+    const void* const write = result.pimpl().get();
+    evaluations().locked([&](std::vector<Evaluation>& evals) {
+      evals.erase(std::remove_if(evals.begin(), evals.end(),
+                                 [](const Evaluation& eval) {
+                                   return eval.done.probe();
+                                 }),
+                  evals.end());
+      evals.push_back(Evaluation{std::move(reads), write, done});
+    });
+
+    return done;
+  }
+
+ private:
+  /// Pending evaluation
+  struct Evaluation {
+    std::vector<const void*> reads;  ///< The arrays read by the evaluation
+    const void* write;               ///< The array assigned by the evaluation
+    Future<bool> done;               ///< The completion of the evaluation
+  };
+
+  /// Wait for pending evaluations
+
+  /// \param id The array whose readers and writers are waited for, or
+  /// \c nullptr to wait for all pending evaluations
+  static void wait_for(const void* const id) {
+    std::vector<Future<bool>> pending;
+    evaluations().locked([&](const std::vector<Evaluation>& evals) {
+      for (const auto& eval : evals)
+        if (id == nullptr || eval.write == id ||
+            std::find(eval.reads.begin(), eval.reads.end(), id) !=
+                eval.reads.end())
+          pending.push_back(eval.done);
+    });
+    for (auto& done : pending) done.get();
+  }
+
+  /// The pending evaluations, and the switch of asynchronous evaluation
+  static TiledArray::detail::RecordLog<Evaluation>& evaluations() {
+    static TiledArray::detail::RecordLog<Evaluation> evals;
+    return evals;
+  }
+};  // class AsyncEval
+
+}  // namespace expressions
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_EXPRESSIONS_ASYNC_EVAL_H__INCLUDED
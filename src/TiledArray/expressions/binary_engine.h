@@ -27,8 +27,11 @@
 #define TILEDARRAY_EXPRESSIONS_BINARY_ENGINE_H__INCLUDED
 
 #include <TiledArray/dist_eval/binary_eval.h>
+#include <TiledArray/dist_eval/fused_eval.h>
 #include <TiledArray/expressions/expr_engine.h>
 
+#include <algorithm>
+
 namespace TiledArray {
 namespace expressions {
 
@@ -72,6 +75,14 @@ class BinaryEngine : public ExprEngine<Derived> {
   static constexpr bool consumable = EngineTrait<Derived>::consumable;
   static constexpr unsigned int leaves = EngineTrait<Derived>::leaves;
 
+  /// \c true if both arguments may be evaluated by fused tile operations
+  /// that produce \c value_type tiles
+  static constexpr bool fusable_args =
+      left_type::fusable && right_type::fusable &&
+      std::is_same<typename left_type::fused_tile_type, value_type>::value &&
+      std::is_same<typename right_type::fused_tile_type, value_type>::value &&
+      TiledArray::detail::is_fusable_tile_v<value_type>;
+
  protected:
   // Import base class variables to this scope
   using ExprEngine_::perm_;
@@ -84,11 +95,18 @@ class BinaryEngine : public ExprEngine<Derived> {
 
   left_type left_;    ///< The left-hand argument
   right_type right_;  ///< The right-hand argument
+  bool fused_;  ///< \c true if this expression is evaluated with a fused
+                ///< tile operation
+  VariableList fused_vars_;  ///< The variable list of the fused result tiles
 
  public:
   template <typename D>
   BinaryEngine(const BinaryExpr<D>& expr)
-      : ExprEngine_(expr), left_(expr.left()), right_(expr.right()) {}
+      : ExprEngine_(expr),
+        left_(expr.left()),
+        right_(expr.right()),
+        fused_(false),
+        fused_vars_() {}
 
   /// Set the variable list for this expression
 
@@ -113,10 +131,26 @@ class BinaryEngine : public ExprEngine<Derived> {
     if (left_right) {
       vars_ = left_.vars();
     } else {
-      // Determine which argument will be permuted
+      // Determine which argument will be permuted. If neither argument is in
+      // the target order, the result is permuted as well, and the smaller
+      // argument is permuted.
+      const double left_size = left_.size_estimate();
+      const double right_size = right_.size_estimate();
+      const bool cost_based = !(left_target || right_target) &&
+                              (left_size > 0.0) && (right_size > 0.0) &&
+                              (left_size != right_size);
       const bool perm_left =
-          (right_target || ((!(left_target || right_target)) &&
-                            (left_type::leaves <= right_type::leaves)));
+          (right_target ||
+           (!(left_target || right_target) &&
+            (cost_based ? left_size < right_size
+                        : left_type::leaves <= right_type::leaves)));
+      if (PermPlacementLog::enabled())
+        PermPlacementLog::record(
+            {left_.vars(), right_.vars(), target_vars, false,
+             (perm_left ? PermOperand::left : PermOperand::right),
+             (perm_left ? PermOperand::right : PermOperand::left),
+             (perm_left ? left_size : right_size),
+             (perm_left ? right_size : left_size), cost_based});
 
       if (perm_left) {
         vars_ = right_.vars();
@@ -174,6 +208,93 @@ class BinaryEngine : public ExprEngine<Derived> {
     }
 #endif  // NDEBUG
     ExprEngine_::init_struct(target_vars);
+
+    // Nested element-wise expressions are evaluated with a single fused tile
+    // operation that reads the leaf tiles directly, so the leaves are
+    // reinitialized with the tile index space of the result. Results whose
+    // tiles are permuted by the consumer (e.g. contraction arguments) are
+    // not fused, since the fused tiles are always in the result layout.
+    if constexpr (Derived::fusable) {
+      fused_ = (leaves > 2u) && (permute_tiles_ || !perm_) &&
+               ExprEngine_::derived().can_fuse();
+      if (fused_) {
+        fused_vars_ = target_vars;
+        init_fused_struct(target_vars);
+      }
+    }
+  }
+
+  /// Bind the leaves of this engine to the current arrays of an expression
+
+  /// \tparam D The expression type
+  /// \param expr The expression from which this engine was constructed
+  /// \return The change of the arrays since they were last bound
+  template <typename D>
+  ArgChange rebind(const BinaryExpr<D>& expr) {
+    const ArgChange left_change = left_.rebind(expr.left());
+    const ArgChange right_change = right_.rebind(expr.right());
+    return std::max(left_change, right_change);
+  }
+
+  /// Collect the arrays read by this expression
+
+  /// \param ids The implementation objects of the arrays of the leaves are
+  /// appended to this list
+  void leaf_arrays(std::vector<const void*>& ids) const {
+    left_.leaf_arrays(ids);
+    right_.leaf_arrays(ids);
+  }
+
+  /// Check if this expression may be evaluated by a fused tile operation
+
+  /// \return \c true if both arguments may be fused
+  bool can_fuse() const { return left_.can_fuse() && right_.can_fuse(); }
+
+  /// Initialize the leaves of a fused expression
+
+  /// \param target_vars The variable list of the result tile indices
+  void init_fused_struct(const VariableList& target_vars) {
+    left_.init_fused_struct(target_vars);
+    right_.init_fused_struct(target_vars);
+  }
+
+  /// Collect the arguments of a fused expression
+
+  /// \tparam Arg The argument distributed evaluator type
+  /// \param[out] args The distributed evaluators of the leaves
+  /// \param[out] perms The permutations of the leaf tiles
+  /// \param vars The variable list of the result tiles
+  template <typename Arg>
+  void make_fused_args(std::vector<Arg>& args, std::vector<Permutation>& perms,
+                       const VariableList& vars) const {
+    left_.make_fused_args(args, perms, vars);
+    right_.make_fused_args(args, perms, vars);
+  }
+
+  /// Fused binary element expression factory function
+
+  /// \tparam Op The element operation type
+  /// \tparam I The position of the first leaf of this expression
+  /// \return The element expression of this expression
+  template <typename Op, std::size_t I>
+  auto make_fused_binary() const {
+    return TiledArray::detail::make_fused_binary<Op>(
+        left_.template make_fused_op<I>(),
+        right_.template make_fused_op<I + left_type::leaves>());
+  }
+
+  /// Scaled fused binary element expression factory function
+
+  /// \tparam Op The element operation type
+  /// \tparam I The position of the first leaf of this expression
+  /// \tparam Scalar The scaling factor type
+  /// \param factor The scaling factor
+  /// \return The element expression of this expression
+  template <typename Op, std::size_t I, typename Scalar>
+  auto make_fused_binary(const Scalar factor) const {
+    return TiledArray::detail::make_fused_binary<Op>(
+        left_.template make_fused_op<I>(),
+        right_.template make_fused_op<I + left_type::leaves>(), factor);
   }
 
   /// Initialize result tensor distribution
@@ -189,6 +310,24 @@ class BinaryEngine : public ExprEngine<Derived> {
     ExprEngine_::init_distribution(world, left_.pmap());
   }
 
+  /// Element extent of an index of the result
+
+  /// \param var The index variable
+  /// \return The element extent of \c var in the left- or right-hand
+  /// argument, or zero if it is unknown
+  std::size_t var_extent(const std::string& var) const {
+    const std::size_t extent = left_.var_extent(var);
+    return (extent ? extent : right_.var_extent(var));
+  }
+
+  /// Estimate the fraction of non-zero tiles of the result
+
+  /// \return The larger of the estimated fractions of non-zero tiles of the
+  /// arguments
+  double density_estimate() const {
+    return std::max(left_.density_estimate(), right_.density_estimate());
+  }
+
   /// Non-permuting tiled range factory function
 
   /// \return The result tiled range
@@ -206,6 +345,10 @@ class BinaryEngine : public ExprEngine<Derived> {
 
   /// \return The distributed evaluator that will evaluate this expression
   dist_eval_type make_dist_eval() const {
+    if constexpr (Derived::fusable) {
+      if (fused_) return make_fused_dist_eval();
+    }
+
     typedef TiledArray::detail::BinaryEvalImpl<
         typename left_type::dist_eval_type, typename right_type::dist_eval_type,
         op_type, policy>
@@ -223,6 +366,34 @@ class BinaryEngine : public ExprEngine<Derived> {
     return dist_eval_type(pimpl);
   }
 
+  /// Construct the fused distributed evaluator for this expression
+
+  /// \return The distributed evaluator that evaluates each result tile of
+  /// this expression with a single fused tile operation
+  dist_eval_type make_fused_dist_eval() const {
+    typedef TiledArray::detail::fused_arg_eval_t<value_type, policy> arg_type;
+    typedef decltype(ExprEngine_::derived().template make_fused_op<0ul>())
+        expr_type;
+    typedef TiledArray::detail::Fused<value_type, expr_type> fused_op_type;
+    typedef TiledArray::detail::FusedEvalImpl<arg_type, fused_op_type, policy>
+        impl_type;
+
+    // Construct the distributed evaluators of the leaves
+    std::vector<arg_type> args;
+    std::vector<Permutation> perms;
+    args.reserve(leaves);
+    perms.reserve(leaves);
+    make_fused_args(args, perms, fused_vars_);
+
+    // Construct the distributed evaluator type
+    std::shared_ptr<impl_type> pimpl = std::make_shared<impl_type>(
+        args, *world_, trange_, shape_, pmap_,
+        fused_op_type(ExprEngine_::derived().template make_fused_op<0ul>(),
+                      perms));
+
+    return dist_eval_type(pimpl);
+  }
+
   /// Expression print
 
   /// \param os The output stream
@@ -56,11 +56,14 @@ struct EngineTrait<BlkTsrEngine<DistArray<Tile, Policy>, Result, Alias> > {
   typedef
       typename TiledArray::detail::scalar_type<DistArray<Tile, Policy> >::type
           scalar_type;
+  // Note: tiles that are not consumed share their data with the array
+  // tiles, so the result consumable flag must be that of the operation.
   typedef TiledArray::detail::Shift<
       Result,
       typename TiledArray::eval_trait<typename array_type::value_type>::type,
       (!Alias) || TiledArray::eval_trait<
-                      typename array_type::value_type>::is_consumable>
+                      typename array_type::value_type>::is_consumable,
+      true>
       op_base_type;  ///< The base tile operation
   typedef TiledArray::detail::UnaryWrapper<op_base_type>
       op_type;  ///< The tile operation
@@ -80,7 +83,7 @@ struct EngineTrait<BlkTsrEngine<DistArray<Tile, Policy>, Result, Alias> > {
   typedef typename policy::pmap_interface
       pmap_interface;  ///< Process map interface type
 
-  static constexpr bool consumable = true;
+  static constexpr bool consumable = op_base_type::is_consumable;
   static constexpr unsigned int leaves = 1;
 };
 
@@ -183,6 +186,22 @@ class BlkTsrEngineBase : public LeafEngine<Derived> {
         lower_bound_(expr.lower_bound()),
         upper_bound_(expr.upper_bound()) {}
 
+  /// Element extent of an index of the block
+
+  /// \param var The index variable
+  /// \return The number of elements of the block along \c var , or zero if
+  /// \c var is not an index of the block
+  std::size_t var_extent(const std::string& var) const {
+    for (unsigned int d = 0u; d < vars_.dim(); ++d) {
+      if (vars_[d] != var) continue;
+      if (lower_bound_[d] >= upper_bound_[d]) return 0ul;
+      const auto& trange1 = array_.trange().data()[d];
+      return trange1.tile(upper_bound_[d] - 1).second -
+             trange1.tile(lower_bound_[d]).first;
+    }
+    return 0ul;
+  }
+
   /// Non-permuting tiled range factory function
 
   /// \return The result tiled range
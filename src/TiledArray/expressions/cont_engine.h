@@ -32,6 +32,8 @@
 #include <TiledArray/tensor/utility.h>
 #include <TiledArray/tile_op/contract_reduce.h>
 
+#include <functional>
+
 namespace TiledArray {
 namespace expressions {
 
@@ -81,6 +83,21 @@ class ContEngine : public BinaryEngine<Derived> {
   typedef typename EngineTrait<Derived>::shape_type shape_type;  ///< Shape type
   typedef typename EngineTrait<Derived>::pmap_interface
       pmap_interface;  ///< Process map interface type
+  typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
+                                    typename right_type::dist_eval_type,
+                                    op_type, policy>
+      summa_type;  ///< The distributed contraction evaluator type
+  typedef TiledArray::detail::SummaLink<value_type, policy>
+      summa_link_type;  ///< The term type of a sum of contractions
+
+  /// Contractions may be accumulated into existing arrays (see
+  /// \c accumulate_to() )
+  static constexpr bool accumulable = true;
+
+  /// Contractions may be evaluated as terms of a sum of contractions, unless
+  /// the result is conjugated (see \c make_summa_link() )
+  static constexpr bool chainable =
+      TiledArray::detail::is_numeric_v<scalar_type>;
 
  protected:
   // Import base class variables to this scope
@@ -113,6 +130,13 @@ class ContEngine : public BinaryEngine<Derived> {
   TiledArray::detail::ProcGrid
       proc_grid_;  ///< Process grid for the contraction
   size_type K_;    ///< Inner dimension size
+  std::function<void(summa_type&)>
+      accumulate_;  ///< Sets the initial result tiles of the distributed
+                    ///< evaluator (see \c accumulate_to() )
+  trange_type accumulate_trange_;  ///< The tiled range of the array that
+                                   ///< holds the initial result tiles
+  shape_type accumulate_shape_;  ///< The shape of the array that holds the
+                                 ///< initial result tiles
 
   static unsigned int find(const VariableList& vars, std::string var,
                            unsigned int i, const unsigned int n) {
@@ -139,7 +163,10 @@ class ContEngine : public BinaryEngine<Derived> {
         right_op_(permute_to_no_trans),
         op_(),
         proc_grid_(),
-        K_(1u) {}
+        K_(1u),
+        accumulate_(),
+        accumulate_trange_(),
+        accumulate_shape_() {}
 
   /// Constructor
 
@@ -157,7 +184,10 @@ class ContEngine : public BinaryEngine<Derived> {
         right_op_(permute_to_no_trans),
         op_(),
         proc_grid_(),
-        K_(1u) {}
+        K_(1u),
+        accumulate_(),
+        accumulate_trange_(),
+        accumulate_shape_() {}
 
   // Pull base class functions into this class.
   using ExprEngine_::derived;
@@ -171,64 +201,132 @@ class ContEngine : public BinaryEngine<Derived> {
   /// result of this expression will be permuted to match \c target_vars.
   /// \param target_vars The target variable list for this expression
   void perm_vars(const VariableList& target_vars) {
+    // Compute ranks
+    const unsigned int result_rank = target_vars.dim();
+    const unsigned int inner_rank =
+        (left_.vars().dim() + right_.vars().dim() - result_rank) >> 1;
+    const unsigned int left_outer_rank = left_.vars().dim() - inner_rank;
+
+    // Check that the left- and right-hand outer variables are correctly
+    // partitioned in the target variable list.
+    bool target_partitioned = true;
+    for (unsigned int i = 0u; i < left_outer_rank; ++i)
+      target_partitioned =
+          target_partitioned &&
+          (find(target_vars, left_vars_[i], 0u, left_outer_rank) <
+           left_outer_rank);
+
+    // If target is properly partitioned, then arguments can be permuted
+    // to fit the target.
+    if (!target_partitioned) return;
+
+    // Arguments in matrix layout are permuted instead of the result if that
+    // is cheaper.
+    place_result_perm(target_vars, left_outer_rank, inner_rank);
+
     // Only permute if the arguments can be permuted
-    if ((left_op_ == permute_to_no_trans) ||
-        (right_op_ == permute_to_no_trans)) {
-      // Compute ranks
-      const unsigned int result_rank = target_vars.dim();
-      const unsigned int inner_rank =
-          (left_.vars().dim() + right_.vars().dim() - result_rank) >> 1;
-      const unsigned int left_outer_rank = left_.vars().dim() - inner_rank;
-
-      // Check that the left- and right-hand outer variables are correctly
-      // partitioned in the target variable list.
-      bool target_partitioned = true;
+    if (left_op_ == permute_to_no_trans) {
+      // Copy left-hand target variables to left and result variable lists.
+      for (unsigned int i = 0u; i < left_outer_rank; ++i) {
+        const std::string& var = target_vars[i];
+        const_cast<std::string&>(left_vars_[i]) = var;
+        const_cast<std::string&>(vars_[i]) = var;
+      }
+
+      // Permute the left argument with the new variable list.
+      left_.perm_vars(left_vars_);
+    } else {
+      // Copy left-hand outer variables to that of result.
       for (unsigned int i = 0u; i < left_outer_rank; ++i)
-        target_partitioned =
-            target_partitioned && (find(target_vars, left_vars_[i], 0u,
-                                        left_outer_rank) < left_outer_rank);
-
-      // If target is properly partitioned, then arguments can be permuted
-      // to fit the target.
-      if (target_partitioned) {
-        if (left_op_ == permute_to_no_trans) {
-          // Copy left-hand target variables to left and result variable lists.
-          for (unsigned int i = 0u; i < left_outer_rank; ++i) {
-            const std::string& var = target_vars[i];
-            const_cast<std::string&>(left_vars_[i]) = var;
-            const_cast<std::string&>(vars_[i]) = var;
-          }
-
-          // Permute the left argument with the new variable list.
-          left_.perm_vars(left_vars_);
-        } else {
-          // Copy left-hand outer variables to that of result.
-          for (unsigned int i = 0u; i < left_outer_rank; ++i)
-            const_cast<std::string&>(vars_[i]) = left_vars_[i];
-        }
+        const_cast<std::string&>(vars_[i]) = left_vars_[i];
+    }
 
-        if (right_op_ == permute_to_no_trans) {
-          // Copy right-hand target variables to right and result variable
-          // lists.
-          for (unsigned int i = left_outer_rank, j = inner_rank;
-               i < result_rank; ++i, ++j) {
-            const std::string& var = target_vars[i];
-            const_cast<std::string&>(right_vars_[j]) = var;
-            const_cast<std::string&>(vars_[i]) = var;
-          }
-
-          // Permute the left argument with the new variable list.
-          right_.perm_vars(right_vars_);
-        } else {
-          // Copy right-hand outer variables to that of result.
-          for (unsigned int i = left_outer_rank, j = inner_rank;
-               i < result_rank; ++i, ++j)
-            const_cast<std::string&>(vars_[i]) = right_vars_[j];
-        }
+    if (right_op_ == permute_to_no_trans) {
+      // Copy right-hand target variables to right and result variable
+      // lists.
+      for (unsigned int i = left_outer_rank, j = inner_rank; i < result_rank;
+           ++i, ++j) {
+        const std::string& var = target_vars[i];
+        const_cast<std::string&>(right_vars_[j]) = var;
+        const_cast<std::string&>(vars_[i]) = var;
+      }
+
+      // Permute the left argument with the new variable list.
+      right_.perm_vars(right_vars_);
+    } else {
+      // Copy right-hand outer variables to that of result.
+      for (unsigned int i = left_outer_rank, j = inner_rank; i < result_rank;
+           ++i, ++j)
+        const_cast<std::string&>(vars_[i]) = right_vars_[j];
+    }
+  }
+
+ private:
+  /// Place the permutation of the outer indices of arguments in matrix layout
+
+  /// If the outer indices of an argument that is contracted in its stored
+  /// layout (i.e. \c no_trans or \c trans ) are not in the target order, the
+  /// result must be permuted. Instead, such arguments are permuted to the
+  /// target order if their estimated sizes are smaller than that of the
+  /// result (see \c PermPlacement ), where the result is assumed to be dense.
+  /// The arguments are always permuted if the result is accumulated into an
+  /// array (see \c accumulate_to() ).
+  /// \param target_vars The target variable list for this expression
+  /// \param left_outer_rank The number of outer indices of the left-hand
+  /// argument
+  /// \param inner_rank The number of contracted indices
+  void place_result_perm(const VariableList& target_vars,
+                         const unsigned int left_outer_rank,
+                         const unsigned int inner_rank) {
+    bool left_mismatch = false, right_mismatch = false;
+    if (left_op_ != permute_to_no_trans)
+      for (unsigned int i = 0u; i < left_outer_rank; ++i)
+        left_mismatch = left_mismatch || (left_vars_[i] != target_vars[i]);
+    if (right_op_ != permute_to_no_trans)
+      for (unsigned int i = left_outer_rank, j = inner_rank;
+           i < target_vars.dim(); ++i, ++j)
+        right_mismatch = right_mismatch || (right_vars_[j] != target_vars[i]);
+    if (!(left_mismatch || right_mismatch)) return;
+
+    const double result_size = ExprEngine_::derived().size_estimate();
+    const double left_size = (left_mismatch ? left_.size_estimate() : 0.0);
+    const double right_size = (right_mismatch ? right_.size_estimate() : 0.0);
+    const bool cost_based = (result_size > 0.0) &&
+                            (!left_mismatch || (left_size > 0.0)) &&
+                            (!right_mismatch || (right_size > 0.0));
+    const bool perm_args =
+        accumulate_ || (cost_based && ((left_size + right_size) < result_size));
+
+    if (perm_args) {
+      if (left_mismatch) {
+        left_op_ = permute_to_no_trans;
+        left_.permute_tiles(true);
       }
+      if (right_mismatch) {
+        right_op_ = permute_to_no_trans;
+        right_.permute_tiles(true);
+      }
+    }
+
+    if (PermPlacementLog::enabled()) {
+      const PermOperand arg =
+          (left_mismatch ? PermOperand::left : PermOperand::right);
+      PermPlacementLog::record(
+          {left_.vars(), right_.vars(), target_vars, true,
+           (perm_args ? arg : PermOperand::result),
+           (perm_args ? PermOperand::result : arg),
+           (perm_args ? left_size + right_size : result_size),
+           (perm_args ? result_size : left_size + right_size),
+           cost_based && !accumulate_});
     }
   }
 
+ public:
+  /// Estimate the fraction of non-zero tiles of the result
+
+  /// \return 1, i.e. the result of a contraction is assumed to be dense
+  double density_estimate() const { return 1.0; }
+
   /// Initialize the variable list of this expression
 
   /// \note This function does not initialize the child data as is done in
@@ -291,12 +389,20 @@ class ContEngine : public BinaryEngine<Derived> {
     // If the inner variable lists of the arguments are not in the same
     // order, one of them will need to be permuted. Here, we determine which
     // argument, left or right, will be permuted if a permutation is
-    // required. The argument with the lowest rank is preferred since it is
-    // likely to have the smaller memory footprint, or the fewest leaves to
-    // minimize the number of permutations in the expression.
+    // required. The argument with the smallest estimated size is preferred
+    // (see PermPlacement). If the sizes are unknown or equal, the argument
+    // with the lowest rank is preferred since it is likely to have the
+    // smaller memory footprint, or the fewest leaves to minimize the number
+    // of permutations in the expression.
+    const double left_size = left_.size_estimate();
+    const double right_size = right_.size_estimate();
+    const bool cost_based =
+        (left_size > 0.0) && (right_size > 0.0) && (left_size != right_size);
     const bool perm_left =
-        (left_rank < right_rank) || ((left_rank == right_rank) &&
-                                     (left_type::leaves <= right_type::leaves));
+        (cost_based ? left_size < right_size
+                    : (left_rank < right_rank) ||
+                          ((left_rank == right_rank) &&
+                           (left_type::leaves <= right_type::leaves)));
 
     // Extract variables from the right-hand argument, collect information
     // about the layout of the variable lists, and ensure the inner variable
@@ -337,6 +443,14 @@ class ContEngine : public BinaryEngine<Derived> {
       }
     }
 
+    if (!inner_vars_ordered && PermPlacementLog::enabled())
+      PermPlacementLog::record(
+          {left_.vars(), right_.vars(), vars_, true,
+           (perm_left ? PermOperand::left : PermOperand::right),
+           (perm_left ? PermOperand::right : PermOperand::left),
+           (perm_left ? left_size : right_size),
+           (perm_left ? right_size : left_size), cost_based});
+
     // Here we set the type of permutation that will be applied to the
     // argument tensors. If an argument is in matrix form, permutation of
     // the tiles is disabled.
@@ -397,6 +511,13 @@ class ContEngine : public BinaryEngine<Derived> {
     if (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape) {
       shape_ = shape_.mask(*ExprEngine_::override_ptr_->shape);
     }
+
+    // The result is added to the tiles of the array (see accumulate_to() )
+    if (accumulate_) {
+      TA_ASSERT(!perm_);
+      TA_ASSERT(trange_ == accumulate_trange_);
+      shape_ = shape_.add(accumulate_shape_);
+    }
   }
 
   /// Initialize result tensor distribution
@@ -435,7 +556,11 @@ class ContEngine : public BinaryEngine<Derived> {
     }
 
     // Construct the process grid.
-    proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+    proc_grid_ = make_proc_grid(*world, M, N, m, n);
+
+    // Balance the work of block-sparse contractions among processes
+    if (!shape_type::is_dense() && (proc_grid_.proc_size() > 1u))
+      balance_proc_grid(M, N);
 
     // Initialize children
     left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
@@ -446,6 +571,271 @@ class ContEngine : public BinaryEngine<Derived> {
     ExprEngine_::init_distribution(world, pmap);
   }
 
+  /// Initialize result tensor distribution with a given process grid
+
+  /// This is used by the terms of a sum of contractions, which are evaluated
+  /// with the process grid of the first term (see \c make_summa_link() ).
+  /// \param world The world were the result will be distributed
+  /// \param pmap The process map for the result tensor tiles
+  /// \param proc_grid The process grid of the contraction, which must have
+  /// the tile rows and columns of the result
+  void init_distribution(World* world, std::shared_ptr<pmap_interface> pmap,
+                         const TiledArray::detail::ProcGrid& proc_grid) {
+    const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
+    const unsigned int left_rank = op_.gemm_helper().left_rank();
+    const unsigned int left_outer_rank = left_rank - inner_rank;
+    TA_ASSERT(proc_grid.size() == trange_.tiles_range().volume());
+
+    // Compute the inner size of the contraction
+    const auto* MADNESS_RESTRICT const left_tiles_size =
+        left_.trange().tiles_range().extent_data();
+    for (unsigned int i = left_outer_rank; i < left_rank; ++i)
+      K_ *= left_tiles_size[i];
+
+    proc_grid_ = proc_grid;
+
+    // Initialize children
+    left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
+    right_.init_distribution(world, proc_grid_.make_col_phase_pmap(K_));
+
+    // Initialize the process map in not already defined
+    if (!pmap) pmap = proc_grid_.make_pmap();
+    ExprEngine_::init_distribution(world, pmap);
+  }
+
+  /// Check if this contraction may be evaluated as a term of a sum
+
+  /// \return \c true if the result is not permuted and not accumulated into
+  /// an array (see \c accumulate_to() )
+  bool can_chain() const { return chainable && !perm_ && !accumulate_; }
+
+  /// Process grid accessor
+
+  /// \return A const reference to the process grid of the contraction
+  const TiledArray::detail::ProcGrid& proc_grid() const { return proc_grid_; }
+
+  /// Construct the process grid of the contraction
+
+  /// The process grid determines which operand of the contraction stays in
+  /// place (see \c SummaStationary ). The result (C) is stationary on the
+  /// grid with \c summa_layers() layers. The left-hand (right-hand) argument
+  /// is stationary on a layered grid with a single process column (row): it
+  /// is never broadcast, while the partial results of the layers are reduced.
+  /// Unless the stationary operand is set by the expression parameters, the
+  /// grid with the smallest communication volume
+  /// \f[
+  ///   V = V_A (P_{\rm col} - 1) + V_B (P_{\rm row} - 1) + V_C (c - 1)
+  /// \f]
+  /// is selected among the grids that use at least as many processes as the
+  /// stationary-C grid, where \f$ V_A \f$, \f$ V_B \f$, and \f$ V_C \f$
+  /// are the number of elements in the non-zero tiles of the arguments and
+  /// the result, and \f$ c \f$ is the number of layers. The number of layers
+  /// is limited by the SUMMA memory limit, as in \c summa_layers() . Unless
+  /// automatic layers were requested or a memory limit is set, the automatic
+  /// selection keeps the number of layers of the stationary-C grid (one by
+  /// default).
+  /// \param world The world where the result will be distributed
+  /// \param M The number of tile rows of the result matrix
+  /// \param N The number of tile columns of the result matrix
+  /// \param m The number of element rows of the result matrix
+  /// \param n The number of element columns of the result matrix
+  /// \return The process grid of the contraction
+  TiledArray::detail::ProcGrid make_proc_grid(World& world, const size_type M,
+                                              const size_type N,
+                                              const size_type m,
+                                              const size_type n) const {
+    typedef TiledArray::detail::ProcGrid proc_grid_type;
+
+    const size_type nprocs = world.size();
+    const SummaStationary stationary =
+        (ExprEngine_::override_ptr_
+             ? ExprEngine_::override_ptr_->summa_stationary
+             : SummaStationary::automatic);
+
+    proc_grid_type result_grid(world, M, N, m, n,
+                               summa_layers(nprocs, m, n));
+    if ((nprocs == 1ul) || (stationary == SummaStationary::result))
+      return result_grid;
+
+    // Compute the communication volume of a process grid
+    const double left_volume = nonzero_volume(left_.trange(), left_.shape());
+    const double right_volume =
+        nonzero_volume(right_.trange(), right_.shape());
+    const double result_volume = nonzero_volume(trange_, shape_);
+    auto comm_volume = [=](const proc_grid_type& grid) {
+      return left_volume * double(grid.proc_cols() - 1ul) +
+             right_volume * double(grid.proc_rows() - 1ul) +
+             result_volume * double(grid.layers() - 1ul);
+    };
+    auto used_procs = [](const proc_grid_type& grid) {
+      return grid.layers() * grid.proc_size();
+    };
+
+    // The automatic selection compares grids that use at least as many
+    // processes as the stationary-C grid. A requested stationary operand
+    // selects the grid that uses the most processes.
+    const bool automatic = (stationary == SummaStationary::automatic);
+    proc_grid_type best = result_grid;
+    double best_volume = comm_volume(result_grid);
+    size_type best_procs = (automatic ? used_procs(result_grid) : 0ul);
+    auto select = [&](const proc_grid_type& grid) {
+      const double volume = comm_volume(grid);
+      const size_type procs = used_procs(grid);
+      if (automatic ? ((procs >= best_procs) && (volume < best_volume))
+                    : ((procs > best_procs) ||
+                       ((procs == best_procs) && (volume < best_volume)))) {
+        best = grid;
+        best_volume = volume;
+        if (!automatic) best_procs = procs;
+      }
+    };
+
+    // Grids with more layers than the stationary-C grid hold partial copies
+    // of the result, so the automatic selection only considers them if 2.5D
+    // SUMMA was requested (see summa_layers() ) or if their memory is bounded
+    // by a SUMMA memory limit
+    const bool any_layers =
+        !automatic || summa_max_memory() ||
+        (ExprEngine_::override_ptr_ &&
+         (ExprEngine_::override_ptr_->summa_layers == 0ul));
+    const size_type min_layers = (any_layers ? 1ul : result_grid.layers());
+    const size_type max_layers =
+        (any_layers ? std::min<size_type>(nprocs, K_) : result_grid.layers());
+    for (size_type layers = min_layers; layers <= max_layers; ++layers) {
+      if (!layers_fit_memory(layers, nprocs, m, n)) break;
+
+      const size_type layer_stride = nprocs / layers;
+      if (stationary != SummaStationary::right) {
+        // Stationary A: one process column per layer
+        proc_grid_type grid(world, M, N, m, n, layers, layer_stride);
+        if (grid.proc_cols() == 1ul) select(grid);
+      }
+      if (stationary != SummaStationary::left) {
+        // Stationary B: one process row per layer
+        proc_grid_type grid(world, M, N, m, n, layers, 1ul);
+        if (grid.proc_rows() == 1ul) select(grid);
+      }
+    }
+
+    return best;
+  }
+
+  /// Number of elements in the non-zero tiles of a tensor
+
+  /// \param trange The tiled range of the tensor
+  /// \param shape The shape of the tensor
+  /// \return The number of elements in the non-zero tiles
+  template <typename TRange, typename Shape>
+  static double nonzero_volume(const TRange& trange, const Shape& shape) {
+    if (shape.is_dense()) return trange.elements_range().volume();
+
+    double volume = 0.0;
+    const auto ntiles = trange.tiles_range().volume();
+    for (std::decay_t<decltype(ntiles)> i = 0ul; i < ntiles; ++i)
+      if (!shape.is_zero(i)) volume += trange.make_tile_range(i).volume();
+    return volume;
+  }
+
+  /// Check that the partial results of process grid layers fit in memory
+
+  /// \param layers The number of process grid layers
+  /// \param nprocs The number of processes
+  /// \param m The number of element rows of the result matrix
+  /// \param n The number of element columns of the result matrix
+  /// \return \c true if the \c layers partial copies of the result fit in
+  /// half of the SUMMA memory limit, or if there is no limit
+  bool layers_fit_memory(const size_type layers, const size_type nprocs,
+                         const size_type m, const size_type n) const {
+    const size_type max_memory = summa_max_memory();
+    if (!max_memory || (layers == 1ul)) return true;
+
+    // Memory required for the result on a 2D process grid
+    const double result_memory = double(m) * double(n) *
+                                 sizeof(numeric_t<value_type>) *
+                                 (1.0 - shape_.sparsity());
+    return (result_memory * layers / nprocs) <= (0.5 * max_memory);
+  }
+
+  /// Number of process grid layers for the contraction
+
+  /// The number of layers of a communication-avoiding (2.5D) SUMMA is taken
+  /// from the expression parameters (see \c Expr::set_summa_layers() ); by
+  /// default the standard 2D SUMMA (one layer) is used. If zero layers were
+  /// requested, the largest \f$ c \le P^{1/3} \f$ is selected such that the
+  /// \f$ c \f$ partial copies of the result fit in half of the SUMMA memory
+  /// limit, if any.
+  /// \param nprocs The number of processes
+  /// \param m The number of element rows of the result matrix
+  /// \param n The number of element columns of the result matrix
+  /// \return The number of process grid layers
+  size_type summa_layers(const size_type nprocs, const size_type m,
+                         const size_type n) const {
+    size_type layers = (ExprEngine_::override_ptr_
+                            ? ExprEngine_::override_ptr_->summa_layers
+                            : 1ul);
+
+    if (layers == 0ul) {
+      layers = std::cbrt(double(nprocs)) + 1.0e-6;
+      while ((layers > 1ul) && !layers_fit_memory(layers, nprocs, m, n))
+        --layers;
+    }
+
+    // Each layer needs at least one process and one inner tile
+    return std::max<size_type>(
+        1ul, std::min<size_type>(layers, std::min<size_type>(nprocs, K_)));
+  }
+
+  /// SUMMA memory limit
+
+  /// \return The memory limit set by \c Expr::set_summa_max_memory() , if
+  /// any, otherwise the default limit of \c summa_type
+  size_type summa_max_memory() const {
+    return (ExprEngine_::override_ptr_ &&
+                    ExprEngine_::override_ptr_->summa_max_memory
+                ? ExprEngine_::override_ptr_->summa_max_memory
+                : summa_type::max_memory());
+  }
+
+  /// Balance the estimated contraction work among the process grid
+
+  /// Selects the row and column phases of the process grid that balance the
+  /// estimated number of floating point operations of each process, given
+  /// the shapes of the arguments and of the result (see
+  /// \c TiledArray::detail::FlopWeightedPmap ). The process grid is left
+  /// unchanged if the cyclic distribution is already balanced.
+  /// \param M The number of tile rows of the result matrix
+  /// \param N The number of tile columns of the result matrix
+  void balance_proc_grid(const size_type M, const size_type N) {
+    typedef TiledArray::detail::FlopWeightedPmap pmap_type;
+
+    const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
+    const unsigned int left_rank = op_.gemm_helper().left_rank();
+    const unsigned int right_rank = op_.gemm_helper().right_rank();
+    const unsigned int left_outer_rank = left_rank - inner_rank;
+
+    // Compute the element extents of the tiles of the fused dimensions
+    const auto m_extents =
+        pmap_type::fused_extents(left_.trange(), 0u, left_outer_rank);
+    const auto k_extents =
+        pmap_type::fused_extents(left_.trange(), left_outer_rank, left_rank);
+    const auto n_extents =
+        pmap_type::fused_extents(right_.trange(), inner_rank, right_rank);
+    TA_ASSERT(m_extents.size() == M);
+    TA_ASSERT(n_extents.size() == N);
+
+    // The result shape in matrix layout
+    const shape_type shape = (perm_ ? shape_.perm(-perm_) : shape_);
+
+    const auto phases = pmap_type::make_phases(
+        proc_grid_.proc_rows(), proc_grid_.proc_cols(),
+        pmap_type::row_weights(left_.shape(), m_extents, k_extents),
+        pmap_type::col_weights(right_.shape(), k_extents, n_extents),
+        [&](const size_type i, const size_type j) {
+          return shape.is_zero(i * N + j);
+        });
+    if (phases.first) proc_grid_.set_phases(phases.first, phases.second);
+  }
+
   /// Tiled range factory function
 
   /// \param perm The permutation to be applied to the array
@@ -519,23 +909,128 @@ class ContEngine : public BinaryEngine<Derived> {
     return left_.shape().gemm(right_.shape(), factor_, shape_gemm_helper, perm);
   }
 
+  /// Accumulate the result into the tiles of an array
+
+  /// The result of this contraction is evaluated as the sum of \c array and
+  /// the contraction, where the tile contractions are added directly to the
+  /// tiles of \c array (see \c Summa::set_initial_tiles() ). This must be
+  /// called before \c init() , which then places all permutations on the
+  /// arguments and extends the result shape by the shape of \c array . The
+  /// eligibility only depends on the variable lists, so that a rejected
+  /// contraction leaves this engine and the placement log untouched: the
+  /// argument variable lists must be fixed (i.e. the arguments are arrays)
+  /// and the outer indices of the arguments must be partitioned in
+  /// \c target_vars as in the result of a matrix product.
+  /// \tparam A The array type
+  /// \param array The array that holds the initial result tiles; its tiled
+  /// range must be that of the result
+  /// \param target_vars The variable list of \c array
+  /// \param consume If \c true , the tiles of \c array are updated in place
+  /// \return \c true if the result will be accumulated into \c array ;
+  /// otherwise this engine is unchanged
+  template <typename A>
+  bool accumulate_to(const A& array, const VariableList& target_vars,
+                     const bool consume) {
+    if constexpr (std::is_same_v<typename A::value_type, value_type> &&
+                  TiledArray::detail::is_numeric_v<scalar_type>) {
+      const VariableList& left_vars = left_.vars();
+      const VariableList& right_vars = right_.vars();
+      if (!(left_vars.dim() && right_vars.dim())) return false;
+
+      // Count the outer indices of the left-hand argument, which must be
+      // the leading indices of the target
+      unsigned int left_outer_rank = 0u;
+      for (unsigned int i = 0u; i < left_vars.dim(); ++i)
+        if (find(right_vars, left_vars[i], 0u, right_vars.dim()) ==
+            right_vars.dim())
+          ++left_outer_rank;
+      const unsigned int inner_rank = left_vars.dim() - left_outer_rank;
+      if ((left_outer_rank + right_vars.dim() - inner_rank) !=
+          target_vars.dim())
+        return false;
+      for (unsigned int i = 0u; i < target_vars.dim(); ++i) {
+        const bool in_left = find(left_vars, target_vars[i], 0u,
+                                  left_vars.dim()) < left_vars.dim();
+        const bool in_right = find(right_vars, target_vars[i], 0u,
+                                   right_vars.dim()) < right_vars.dim();
+        if ((in_left == in_right) || (in_left != (i < left_outer_rank)))
+          return false;
+      }
+
+      accumulate_trange_ = array.trange();
+      accumulate_shape_ = array.shape();
+      accumulate_ = [array, consume](summa_type& summa) {
+        summa.set_initial_tiles(array, consume);
+      };
+      return true;
+    } else {
+      return false;
+    }
+  }
+
   dist_eval_type make_dist_eval() const {
-    // Define the impl type
-    typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
-                                      typename right_type::dist_eval_type,
-                                      op_type, typename Derived::policy>
-        impl_type;
+    return dist_eval_type(make_summa(shape_));
+  }
 
+  /// Construct the distributed evaluator of a term of a sum of contractions
+
+  /// The tile contractions of this term are added to the result tiles of
+  /// the preceding terms, which are evaluated with the same process grid by
+  /// the evaluator of this term (see \c Summa::set_preceding() ). The shape
+  /// of the evaluator is the sum of the shapes of all terms up to this one.
+  /// \param preceding The last of the preceding terms (empty for the first
+  /// term)
+  /// \param forward \c true if the result tiles are forwarded to a
+  /// subsequent term, \c false if this is the last term
+  /// \return The evaluator of the terms up to this one
+  /// \note This requires that \c can_chain() is \c true .
+  summa_link_type make_summa_link(const summa_link_type& preceding,
+                                  const bool forward) const {
+    TA_ASSERT(can_chain());
+    std::shared_ptr<summa_type> pimpl =
+        make_summa(preceding.eval ? shape_.add(preceding.eval->shape())
+                                  : shape_);
+
+    summa_link_type link;
+    if (preceding.eval) pimpl->set_preceding(preceding);
+    if (forward) link.tiles = pimpl->forward_tiles();
+    link.eval = pimpl;
+
+    return link;
+  }
+
+ private:
+  /// Construct the distributed contraction evaluator
+
+  /// \param shape The shape of the result
+  /// \return The distributed contraction evaluator
+  std::shared_ptr<summa_type> make_summa(const shape_type& shape) const {
     typename left_type::dist_eval_type left = left_.make_dist_eval();
     typename right_type::dist_eval_type right = right_.make_dist_eval();
 
-    std::shared_ptr<impl_type> pimpl =
-        std::make_shared<impl_type>(left, right, *world_, trange_, shape_,
-                                    pmap_, perm_, op_, K_, proc_grid_);
+    std::shared_ptr<summa_type> pimpl =
+        std::make_shared<summa_type>(left, right, *world_, trange_, shape,
+                                     pmap_, perm_, op_, K_, proc_grid_);
+
+    // Apply the memory, depth, batching, and screening parameters of this
+    // expression
+    if (ExprEngine_::override_ptr_) {
+      if (ExprEngine_::override_ptr_->summa_max_memory)
+        pimpl->set_max_memory(ExprEngine_::override_ptr_->summa_max_memory);
+      if (ExprEngine_::override_ptr_->summa_max_depth)
+        pimpl->set_max_depth(ExprEngine_::override_ptr_->summa_max_depth);
+      if (ExprEngine_::override_ptr_->summa_batch_tile_size >= 0l)
+        pimpl->set_batch_tile_size(
+            ExprEngine_::override_ptr_->summa_batch_tile_size);
+      if (ExprEngine_::override_ptr_->screening > 0.0f)
+        pimpl->set_screening(ExprEngine_::override_ptr_->screening);
+    }
+    if (accumulate_) accumulate_(*pimpl);
 
-    return dist_eval_type(pimpl);
+    return pimpl;
   }
 
+ public:
   /// Expression identification tag
 
   /// \return An expression tag used to identify this expression
@@ -0,0 +1,468 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  contraction_order.h
+ *  Oct 15, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/expressions/variable_list.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace TiledArray {
+namespace expressions {
+
+// Forward declaration
+template <typename, typename>
+class MultExpr;
+
+/// Association order of a chain of tensor contractions
+
+/// A product chain <tt>A * B * C * ...</tt> may be evaluated as any binary
+/// tree with the operands, in order, as leaves. This class selects the tree
+/// with the lowest estimated cost by dynamic programming over the intervals
+/// of the chain. The cost of a binary product is the number of floating
+/// point operations plus, for intermediate results, the number of elements
+/// of the result. Both are scaled by the estimated fraction of non-zero
+/// tiles: the product of \f$ X \f$ and \f$ Y \f$ has density
+/// \f$ d_X d_Y \f$ and its result has density
+/// \f$ 1 - (1 - d_X d_Y)^{K} \f$, where \f$ K \f$ is the number of
+/// contracted tiles.
+///
+/// Reassociation is only valid for tensor networks, i.e. if each index
+/// appears in at most two operands; indices that appear twice are
+/// contracted and the others are indices of the result. Trees that include
+/// outer or Hadamard products are not considered.
+class ContractionOrder {
+ public:
+  /// Operand of the chain
+  struct Operand {
+    std::vector<std::string> vars;  ///< Index labels
+    std::vector<double> extents;    ///< Element extent of each index
+    std::vector<double> tiles;      ///< Tile extent of each index
+    double density;                 ///< Fraction of non-zero tiles
+  };
+
+  /// A node of a product tree, i.e. <tt>{first, split, last}</tt>, which
+  /// multiplies the product of operands <tt>[first, split)</tt> with that of
+  /// operands <tt>[split, last)</tt>
+  typedef std::array<unsigned int, 3> node_type;
+
+ private:
+  typedef std::uint_fast64_t mask_type;
+
+  unsigned int size_;                 ///< Number of operands
+  std::vector<double> extents_;       ///< Element extent of each index
+  std::vector<double> tiles_;         ///< Tile extent of each index
+  std::vector<mask_type> masks_;      ///< Indices of each operand
+  std::vector<double> densities_;     ///< Density of each operand
+  std::vector<std::string> vars_;     ///< Index labels
+  std::vector<unsigned int> counts_;  ///< Number of operands of each index
+  std::vector<unsigned int> split_;   ///< Optimal split of each interval
+  std::vector<double> cost_;          ///< Optimal cost of each interval
+  std::vector<double> density_;       ///< Density of each interval
+  bool valid_;                        ///< The chain may be reassociated
+
+  std::size_t interval(const unsigned int first,
+                       const unsigned int last) const {
+    return first * (size_ + 1u) + last;
+  }
+
+  /// Indices that appear once in operands <tt>[first, last)</tt>
+  mask_type outer_mask(const unsigned int first,
+                       const unsigned int last) const {
+    mask_type mask = 0u;
+    for (unsigned int i = first; i < last; ++i) mask ^= masks_[i];
+    return mask;
+  }
+
+  double volume(mask_type mask, const std::vector<double>& extents) const {
+    double result = 1.0;
+    for (unsigned int i = 0u; mask; ++i, mask >>= 1)
+      if (mask & 1u) result *= extents[i];
+    return result;
+  }
+
+  /// Cost of a binary product
+
+  /// \param left The indices of the left-hand operand
+  /// \param left_density The density of the left-hand operand
+  /// \param right The indices of the right-hand operand
+  /// \param right_density The density of the right-hand operand
+  /// \param root \c true if the product is the root of the tree
+  /// \param[out] density The density of the result
+  /// \return The cost of the product, or infinity if it is not a contraction
+  double product_cost(const mask_type left, const double left_density,
+                      const mask_type right, const double right_density,
+                      const bool root, double& density) const {
+    const mask_type inner = left & right;
+    const mask_type outer = left ^ right;
+    if (!inner || !outer || (left == inner) || (right == inner))
+      return std::numeric_limits<double>::infinity();
+
+    const double product_density = left_density * right_density;
+    density = 1.0 - std::pow(1.0 - product_density, volume(inner, tiles_));
+
+    return 2.0 * volume(left | right, extents_) * product_density +
+           (root ? 0.0 : volume(outer, extents_) * density);
+  }
+
+ public:
+  /// Construct the optimal association order of a chain
+
+  /// \param operands The operands of the chain, in order
+  explicit ContractionOrder(const std::vector<Operand>& operands)
+      : size_(operands.size()),
+        split_((size_ + 1u) * (size_ + 1u), 0u),
+        cost_((size_ + 1u) * (size_ + 1u), 0.0),
+        density_((size_ + 1u) * (size_ + 1u), 1.0),
+        valid_(size_ > 1u) {
+    TA_ASSERT(size_ > 0u);
+
+    // Collect the indices of the operands
+    for (const Operand& operand : operands) {
+      TA_ASSERT(operand.vars.size() == operand.extents.size());
+      TA_ASSERT(operand.vars.size() == operand.tiles.size());
+      mask_type mask = 0u;
+      for (std::size_t i = 0ul; i < operand.vars.size(); ++i) {
+        std::size_t v = 0ul;
+        while ((v < vars_.size()) && (vars_[v] != operand.vars[i])) ++v;
+        if (v == vars_.size()) {
+          vars_.push_back(operand.vars[i]);
+          extents_.push_back(operand.extents[i]);
+          tiles_.push_back(operand.tiles[i]);
+          counts_.push_back(0u);
+        }
+        // Repeated indices within an operand are not supported
+        valid_ = valid_ && (v < 64ul) && !((mask >> v) & 1u) &&
+                 (extents_[v] == operand.extents[i]);
+        if (v < 64ul) mask |= (mask_type(1u) << v);
+        ++counts_[v];
+      }
+      masks_.push_back(mask);
+      densities_.push_back(operand.density);
+    }
+    for (const unsigned int count : counts_) valid_ = valid_ && (count <= 2u);
+    if (!valid_) return;
+
+    // Initialize the single operand intervals
+    for (unsigned int i = 0u; i < size_; ++i)
+      density_[interval(i, i + 1u)] = densities_[i];
+
+    // Find the optimal split of each interval
+    for (unsigned int length = 2u; length <= size_; ++length) {
+      for (unsigned int first = 0u; first + length <= size_; ++first) {
+        const unsigned int last = first + length;
+        const bool root = (length == size_);
+        double best = std::numeric_limits<double>::infinity();
+        for (unsigned int split = first + 1u; split < last; ++split) {
+          double density = 1.0;
+          const double cost =
+              cost_[interval(first, split)] + cost_[interval(split, last)] +
+              product_cost(outer_mask(first, split),
+                           density_[interval(first, split)],
+                           outer_mask(split, last),
+                           density_[interval(split, last)], root, density);
+          if (cost < best) {
+            best = cost;
+            split_[interval(first, last)] = split;
+            density_[interval(first, last)] = density;
+          }
+        }
+        cost_[interval(first, last)] = best;
+      }
+    }
+
+    valid_ = std::isfinite(cost());
+  }
+
+  /// Number of operands accessor
+
+  /// \return The number of operands of the chain
+  unsigned int size() const { return size_; }
+
+  /// Check that the chain may be reassociated
+
+  /// \return \c true if the chain is a tensor network that can be evaluated
+  /// as a sequence of contractions
+  bool valid() const { return valid_; }
+
+  /// Optimal split of an interval of the chain
+
+  /// \param first The first operand of the interval
+  /// \param last The end of the interval
+  /// \return The first operand of the right-hand factor of the product of
+  /// operands <tt>[first, last)</tt>
+  unsigned int split(const unsigned int first, const unsigned int last) const {
+    TA_ASSERT(valid_);
+    TA_ASSERT(first + 1u < last);
+    TA_ASSERT(last <= size_);
+    return split_[interval(first, last)];
+  }
+
+  /// Estimated cost of the optimal tree
+
+  /// \return The estimated cost of the optimal tree
+  double cost() const { return cost_[interval(0u, size_)]; }
+
+  /// Estimated cost of a tree
+
+  /// \param tree The nodes of the tree in post-order
+  /// \return The estimated cost of \c tree , or infinity if the chain cannot
+  /// be evaluated as \c tree
+  double cost(const std::vector<node_type>& tree) const {
+    if (masks_.size() != size_ || (tree.size() + 1u) != size_)
+      return std::numeric_limits<double>::infinity();
+
+    std::vector<double> density(density_);
+    double result = 0.0;
+    for (const node_type& node : tree) {
+      const unsigned int first = node[0], split = node[1], last = node[2];
+      TA_ASSERT(first < split && split < last && last <= size_);
+      result += product_cost(outer_mask(first, split),
+                             density[interval(first, split)],
+                             outer_mask(split, last),
+                             density[interval(split, last)],
+                             (first == 0u) && (last == size_),
+                             density[interval(first, last)]);
+    }
+    return result;
+  }
+
+  /// Result indices of the chain
+
+  /// \return The indices that appear in exactly one operand
+  std::vector<std::string> result_vars() const {
+    std::vector<std::string> result;
+    for (std::size_t v = 0ul; v < vars_.size(); ++v)
+      if (counts_[v] == 1u) result.push_back(vars_[v]);
+    return result;
+  }
+
+};  // class ContractionOrder
+
+namespace detail {
+
+/// The maximum number of operands of a reassociated product chain
+
+/// Every association order of a chain is instantiated at compile time, so
+/// the number of instantiations grows with the Catalan numbers.
+static constexpr const std::size_t max_chain_size = 4ul;
+
+/// Number of operands of a product chain
+template <typename E>
+struct chain_size : public std::integral_constant<std::size_t, 1ul> {};
+
+template <typename Left, typename Right>
+struct chain_size<MultExpr<Left, Right> >
+    : public std::integral_constant<std::size_t,
+                                    chain_size<Left>::value +
+                                        chain_size<Right>::value> {};
+
+/// Collect the operands of a product chain
+
+/// \param expr An operand
+/// \return A tuple with a pointer to \c expr
+template <typename E>
+inline std::tuple<const E*> chain_operands(const E& expr) {
+  return std::tuple<const E*>(&expr);
+}
+
+/// Collect the operands of a product chain
+
+/// \param expr A product chain
+/// \return A tuple with pointers to the operands of \c expr , in order
+template <typename Left, typename Right>
+inline auto chain_operands(const MultExpr<Left, Right>& expr) {
+  return std::tuple_cat(chain_operands(expr.left()),
+                        chain_operands(expr.right()));
+}
+
+/// Collect the tree of a product chain
+
+/// \param expr An operand
+/// \param first The position of \c expr in the chain
+/// \param[out] tree The nodes of the tree in post-order
+/// \param[out] has_params Set to \c true if engine parameters were set for
+/// a product of the chain
+/// \return The position of the next operand
+template <typename E>
+inline unsigned int chain_tree(const E&, const unsigned int first,
+                               std::vector<ContractionOrder::node_type>&,
+                               bool&) {
+  return first + 1u;
+}
+
+/// Collect the tree of a product chain
+
+/// \param expr A product chain
+/// \param first The position of the first operand of \c expr in the chain
+/// \param[out] tree The nodes of the tree in post-order
+/// \param[out] has_params Set to \c true if engine parameters were set for
+/// a product of the chain
+/// \return The position of the operand that follows \c expr
+template <typename Left, typename Right>
+inline unsigned int chain_tree(const MultExpr<Left, Right>& expr,
+                               const unsigned int first,
+                               std::vector<ContractionOrder::node_type>& tree,
+                               bool& has_params) {
+  has_params = has_params || expr.has_engine_params();
+  const unsigned int split =
+      chain_tree(expr.left(), first, tree, has_params);
+  const unsigned int last = chain_tree(expr.right(), split, tree, has_params);
+  tree.push_back({{first, split, last}});
+  return last;
+}
+
+/// Describe an operand of a product chain
+
+/// \param expr The operand
+/// \return The indices, extents, and density of \c expr
+template <typename E>
+inline ContractionOrder::Operand chain_operand(const E& expr) {
+  typename E::engine_type engine(expr);
+  engine.init_vars();
+  engine.init_struct(engine.vars());
+
+  const VariableList& vars = engine.vars();
+  ContractionOrder::Operand operand;
+  for (unsigned int i = 0u; i < vars.dim(); ++i) {
+    operand.vars.push_back(vars[i]);
+    operand.extents.push_back(
+        engine.trange().elements_range().extent_data()[i]);
+    operand.tiles.push_back(engine.trange().tiles_range().extent_data()[i]);
+  }
+  operand.density = 1.0 - engine.shape().sparsity();
+  return operand;
+}
+
+/// Visit a product chain in a given association order
+
+/// \tparam First The first operand of the visited interval
+/// \tparam Last The end of the visited interval
+/// \param operands The operands of the chain
+/// \param order The association order
+/// \param op The visitor, which is called with the product of operands
+/// <tt>[First, Last)</tt>
+template <std::size_t First, std::size_t Last, typename Operands,
+          typename Op>
+inline void visit_chain(const Operands& operands,
+                        const ContractionOrder& order, Op&& op);
+
+/// Visit a product chain in a given association order
+
+/// Selects the compile-time split that matches the runtime split
+/// \c split of interval <tt>[First, Last)</tt>.
+template <std::size_t First, std::size_t Split, std::size_t Last,
+          typename Operands, typename Op>
+inline void visit_chain_split(const Operands& operands,
+                              const ContractionOrder& order,
+                              const unsigned int split, Op&& op) {
+  if constexpr (Split + 1ul < Last) {
+    if (split != Split) {
+      visit_chain_split<First, Split + 1ul, Last>(operands, order, split,
+                                                  std::forward<Op>(op));
+      return;
+    }
+  }
+  TA_ASSERT(split == Split);
+  visit_chain<First, Split>(operands, order, [&](const auto& left) {
+    visit_chain<Split, Last>(operands, order, [&](const auto& right) {
+      op(left * right);
+    });
+  });
+}
+
+template <std::size_t First, std::size_t Last, typename Operands,
+          typename Op>
+inline void visit_chain(const Operands& operands,
+                        const ContractionOrder& order, Op&& op) {
+  if constexpr (Last - First == 1ul) {
+    op(*std::get<First>(operands));
+  } else {
+    visit_chain_split<First, First + 1ul, Last>(
+        operands, order, order.split(First, Last), std::forward<Op>(op));
+  }
+}
+
+/// Evaluate a product chain in the cheapest association order
+
+/// The operands of \c expr are described with their expression engines
+/// (see \c ContractionOrder ). If the estimated cost of the optimal tree is
+/// lower than that of \c expr , the chain is rebuilt in the optimal order
+/// and passed to \c op . Chains with engine parameters (see
+/// \c Expr::set_summa_layers() , etc.) are not reassociated.
+/// \param expr The product chain
+/// \param target_vars The indices of the result
+/// \param op The visitor that evaluates the rebuilt chain
+/// \return \c true if \c op was called, otherwise \c false
+template <typename Left, typename Right, typename Op>
+inline bool eval_chain(const MultExpr<Left, Right>& expr,
+                       const VariableList& target_vars, Op&& op) {
+  constexpr std::size_t size = chain_size<MultExpr<Left, Right> >::value;
+  if constexpr ((size > 2ul) && (size <= max_chain_size)) {
+    std::vector<ContractionOrder::node_type> tree;
+    bool has_params = false;
+    chain_tree(expr, 0u, tree, has_params);
+    if (has_params) return false;
+
+    const auto operands = chain_operands(expr);
+    std::vector<ContractionOrder::Operand> descriptions;
+    std::apply(
+        [&](const auto*... operand) {
+          (descriptions.push_back(chain_operand(*operand)), ...);
+        },
+        operands);
+
+    const ContractionOrder order(descriptions);
+    if (!order.valid()) return false;
+
+    // The result indices must be those of the tensor network
+    const auto result_vars = order.result_vars();
+    if (result_vars.size() != target_vars.dim()) return false;
+    for (const auto& var : result_vars)
+      if (std::find(target_vars.begin(), target_vars.end(), var) ==
+          target_vars.end())
+        return false;
+
+    if (!(order.cost() < order.cost(tree))) return false;
+
+    visit_chain<0ul, size>(operands, order, std::forward<Op>(op));
+    return true;
+  } else {
+    return false;
+  }
+}
+
+}  // namespace detail
+}  // namespace expressions
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
@@ -33,8 +33,10 @@
 #include "../tile_op/binary_reduction.h"
 #include "../tile_op/reduce_wrapper.h"
 #include "../tile_op/shift.h"
+#include "../tile_op/tuple_reduction.h"
 #include "../tile_op/unary_reduction.h"
 #include "../tile_op/unary_wrapper.h"
+#include "async_eval.h"
 #include "expr_engine.h"
 #ifdef TILEDARRAY_HAS_CUDA
 #include <TiledArray/cuda/cuda_task_fn.h>
@@ -54,9 +56,32 @@ class BlkTsrExpr;
 template <typename>
 struct is_aliased;
 
+/// The operand of a contraction that stays in place during SUMMA
+
+/// The arguments and the result of a distributed contraction are laid out
+/// on a (layered) process grid. SUMMA broadcasts the tiles of the operands
+/// that are not stationary and reduces the partial result tiles, if the
+/// result is not stationary (see \c ContEngine ).
+enum class SummaStationary {
+  automatic,  ///< Select the operand with a communication cost model
+  left,       ///< Keep the left-hand argument (A) in place
+  right,      ///< Keep the right-hand argument (B) in place
+  result      ///< Keep the result (C) in place
+};
+
 template <typename Engine>
 struct EngineParamOverride {
-  EngineParamOverride() : world(nullptr), pmap(), shape(nullptr) {}
+  EngineParamOverride()
+      : world(nullptr),
+        pmap(),
+        shape(nullptr),
+        summa_layers(1ul),
+        summa_max_memory(0ul),
+        summa_max_depth(0ul),
+        summa_batch_tile_size(-1l),
+        summa_stationary(SummaStationary::automatic),
+        screening(0.0f),
+        truncate(false) {}
 
   typedef
       typename EngineTrait<Engine>::policy policy;  ///< The result policy type
@@ -68,6 +93,14 @@ struct EngineParamOverride {
   World* world;
   std::shared_ptr<pmap_interface> pmap;
   const shape_type* shape;
+  std::size_t summa_layers;  ///< Number of SUMMA process layers (0 = auto)
+  std::size_t summa_max_memory;  ///< SUMMA memory limit in bytes (0 = default)
+  std::size_t summa_max_depth;   ///< SUMMA depth limit (0 = default)
+  long summa_batch_tile_size;  ///< SUMMA batched contraction tile size limit
+                               ///< (< 0 = default)
+  SummaStationary summa_stationary;  ///< SUMMA stationary operand
+  float screening;  ///< Tile contraction screening threshold (0 = none)
+  bool truncate;    ///< Truncate the result while it is evaluated
 };
 
 /// \brief type trait checks if T has array() member
@@ -144,6 +177,82 @@ class Expr {
     }
     return derived();
   }
+  /// \param layers the number of process grid layers (replication factor)
+  /// used by communication-avoiding (2.5D) SUMMA if this is a contraction
+  /// expression; \c layers=0 selects the number of layers automatically from
+  /// the number of processes and the SUMMA memory limit
+  Expr<Derived>& set_summa_layers(const std::size_t layers) {
+    if (override_ptr_ == nullptr)
+      override_ptr_ = std::make_shared<override_type>();
+    override_ptr_->summa_layers = layers;
+    return derived();
+  }
+  /// \param max_memory the maximum memory, in bytes, that the SUMMA
+  /// iterations of each process may use if this is a contraction expression;
+  /// overrides the \c TA_SUMMA_MAX_MEMORY environment variable, unless
+  /// \c max_memory=0
+  Expr<Derived>& set_summa_max_memory(const std::size_t max_memory) {
+    if (override_ptr_ == nullptr)
+      override_ptr_ = std::make_shared<override_type>();
+    override_ptr_->summa_max_memory = max_memory;
+    return derived();
+  }
+  /// \param max_depth the maximum number of concurrent SUMMA iterations if
+  /// this is a contraction expression; overrides the \c TA_SUMMA_MAX_DEPTH
+  /// environment variable, unless \c max_depth=0
+  Expr<Derived>& set_summa_max_depth(const std::size_t max_depth) {
+    if (override_ptr_ == nullptr)
+      override_ptr_ = std::make_shared<override_type>();
+    override_ptr_->summa_max_depth = max_depth;
+    return derived();
+  }
+  /// \param batch_tile_size the largest fused tile extent for which the
+  /// tile contractions of each SUMMA iteration are evaluated with a batched
+  /// GEMM if this is a contraction expression; overrides the
+  /// \c TA_SUMMA_BATCH_TILE_SIZE environment variable; \c batch_tile_size=0
+  /// disables batching, which is the default
+  Expr<Derived>& set_summa_batch_tile_size(const std::size_t batch_tile_size) {
+    if (override_ptr_ == nullptr)
+      override_ptr_ = std::make_shared<override_type>();
+    override_ptr_->summa_batch_tile_size = batch_tile_size;
+    return derived();
+  }
+  /// \return \c true if any engine parameter (shape, world, process map, or
+  /// SUMMA parameters) was set for this expression
+  bool has_engine_params() const { return override_ptr_ != nullptr; }
+  /// \param stationary the operand that stays in place during SUMMA if this
+  /// is a contraction expression; by default it is selected with a
+  /// communication cost model (see \c SummaStationary )
+  Expr<Derived>& set_summa_stationary(const SummaStationary stationary) {
+    if (override_ptr_ == nullptr)
+      override_ptr_ = std::make_shared<override_type>();
+    override_ptr_->summa_stationary = stationary;
+    return derived();
+  }
+  /// \param tau the screening threshold of the tile contractions if this is
+  /// a contraction expression with sparse arguments; the contraction of
+  /// tiles \f$ A_{ik} \f$ and \f$ B_{kj} \f$ is skipped if
+  /// \f$ ||A_{ik}|| ||B_{kj}|| V_k < \tau \f$, where the norms are the
+  /// per-element shape norms and \f$ V_k \f$ is the volume of inner tile
+  /// \f$ k \f$; \c tau=0 disables screening
+  Expr<Derived>& set_screening(const float tau) {
+    TA_ASSERT(tau >= 0.0f);
+    if (override_ptr_ == nullptr)
+      override_ptr_ = std::make_shared<override_type>();
+    override_ptr_->screening = tau;
+    return derived();
+  }
+  /// \param truncate if \c true and the result is sparse, the norms of the
+  /// result tiles are computed as the tiles are evaluated, and the result
+  /// shape is tightened to the actual norms, i.e. tiles whose norms are
+  /// below the shape threshold are dropped, without a separate
+  /// \c truncate() pass over the result
+  Expr<Derived>& set_truncate(const bool truncate = true) {
+    if (override_ptr_ == nullptr)
+      override_ptr_ = std::make_shared<override_type>();
+    override_ptr_->truncate = truncate;
+    return derived();
+  }
 
  private:
   /// Task function used to evaluate a lazy tile and apply an op
@@ -378,6 +487,59 @@ class Expr {
     static_assert(!is_lazy_tile<typename A::value_type>::value,
                   "Assignment to an array of lazy tiles is not supported.");
 
+    // Construct the expression engine
+    engine_type engine(derived());
+    init_engine(engine, tsr);
+    eval_engine(engine, tsr);
+  }
+
+  /// Add this object to \c tsr in place
+
+  /// If the result of this expression can be accumulated directly into the
+  /// tiles of \c tsr (see \c ContEngine::accumulate_to() ), this evaluates
+  /// <tt>tsr += *this</tt> without a temporary array for the result of this
+  /// expression.
+  /// \tparam A The array type
+  /// \tparam Alias Tile alias flag; if \c false the tiles of \c tsr are
+  /// updated in place, otherwise they are copied
+  /// \param tsr The tensor to which this expression is added
+  /// \return \c true if this expression was added to \c tsr ; otherwise
+  /// \c tsr is unchanged
+  template <typename A, bool Alias>
+  bool eval_add_to(TsrExpr<A, Alias>& tsr) const {
+    if constexpr (engine_type::accumulable) {
+      if (!tsr.array().is_initialized()) return false;
+
+      // The eligibility is checked before the engine is initialized, so
+      // that a rejected expression leaves no trace of its evaluation
+      engine_type engine(derived());
+      if (!engine.accumulate_to(tsr.array(), VariableList(tsr.vars()),
+                                !Alias))
+        return false;
+      init_engine(engine, tsr);
+
+      // Tiles that are updated in place must not be read by pending
+      // evaluations
+      if (!Alias && AsyncEval::enabled()) AsyncEval::wait(tsr.array());
+      eval_engine(engine, tsr);
+
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  /// Initialize an expression engine for the evaluation of this object
+
+  /// This function will initialize the variable lists, structure, and
+  /// distribution of the engine graph for an evaluation that is assigned to
+  /// \c tsr (see \c ExprEngine::init() ).
+  /// \tparam A The array type
+  /// \tparam Alias Tile alias flag
+  /// \param engine The engine of this expression
+  /// \param tsr The tensor to be assigned
+  template <typename A, bool Alias>
+  void init_engine(engine_type& engine, const TsrExpr<A, Alias>& tsr) const {
     // Get the target world
     // 1. result's world is assigned, use it
     // 2. if this expression's world was assigned by set_world(), use it
@@ -398,27 +560,50 @@ class Expr {
     // Get result variable list.
     VariableList target_vars(tsr.vars());
 
-    // Construct the expression engine
-    engine_type engine(derived());
     engine.init(world, pmap, target_vars);
+  }
 
+  /// Evaluate an initialized expression engine and assign the result
+
+  /// \tparam A The array type
+  /// \tparam Alias Tile alias flag
+  /// \param engine The engine of this expression, initialized by
+  /// \c init_engine()
+  /// \param tsr The tensor to be assigned
+  template <typename A, bool Alias>
+  void eval_engine(const engine_type& engine, TsrExpr<A, Alias>& tsr) const {
     // Create the distributed evaluator from this expression
     typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+    const bool truncate = override_ptr_ && override_ptr_->truncate;
+    if (truncate) dist_eval.set_truncate();
     dist_eval.eval();
 
-    // Create the result array
-    A result(dist_eval.world(), dist_eval.trange(), dist_eval.shape(),
+    // Create the result array; if the result is truncated, its shape is
+    // constructed from the norms of the evaluated tiles
+    A result(dist_eval.world(), dist_eval.trange(),
+             (truncate ? dist_eval.truncated_shape() : dist_eval.shape()),
              dist_eval.pmap());
 
     // Move the data from dist_eval into the result array. There is no
     // communication in this step.
     for (const auto index : *dist_eval.pmap()) {
-      if (!dist_eval.is_zero(index))
-        set_tile(result, index, dist_eval.get(index));
+      if (!dist_eval.is_zero(index)) {
+        if (result.is_zero(index))
+          dist_eval.discard(index);
+        else
+          set_tile(result, index, dist_eval.get(index));
+      }
     }
 
-    // Wait for child expressions of dist_eval
-    dist_eval.wait();
+    // Wait for child expressions of dist_eval, unless the evaluation is
+    // asynchronous
+    if (AsyncEval::enabled()) {
+      std::vector<const void*> reads;
+      engine.leaf_arrays(reads);
+      AsyncEval::record(dist_eval, result, std::move(reads));
+    } else {
+      dist_eval.wait();
+    }
     // Swap the new array with the result array object.
     result.swap(tsr.array());
   }
@@ -515,8 +700,15 @@ class Expr {
       }
     }
 
-    // Wait for child expressions of dist_eval
-    dist_eval.wait();
+    // Wait for child expressions of dist_eval, unless the evaluation is
+    // asynchronous
+    if (AsyncEval::enabled()) {
+      std::vector<const void*> reads{tsr.array().pimpl().get()};
+      engine.leaf_arrays(reads);
+      AsyncEval::record(dist_eval, result, std::move(reads));
+    } else {
+      dist_eval.wait();
+    }
     // Swap the new array with the result array object.
     result.swap(tsr.array());
   }
@@ -684,6 +876,152 @@ class Expr {
     return reduce(right_expr, op, default_world());
   }
 
+  /// Reduce this expression with several reductions in a single sweep
+
+  /// The expression is evaluated once, and each tile is reduced by all
+  /// reductions before the next tile, which is cheaper than calling
+  /// \c reduce() for each reduction, e.g. for convergence checks:
+  /// \code
+  /// typedef TA::Tensor<double> T;
+  /// auto [squared_norm, abs_max] =
+  ///     r("i,j")
+  ///         .reduce_all(TA::SquaredNormReduction<T>(),
+  ///                     TA::AbsMaxReduction<T>())
+  ///         .get();
+  /// \endcode
+  /// \tparam Ops The unary reduction operation types (see \c SumReduction )
+  /// \param world The world where the expression is evaluated
+  /// \param ops The reduction operations
+  /// \return A future to the tuple of the results of \c ops
+  template <typename... Ops>
+  Future<std::tuple<typename Ops::result_type...>> reduce_all(
+      World& world, const Ops&... ops) const {
+    typedef TiledArray::TupleReduction<
+        typename EngineTrait<engine_type>::eval_type, void, Ops...>
+        op_type;
+    return reduce(op_type(ops...), world);
+  }
+
+  template <typename... Ops>
+  Future<std::tuple<typename Ops::result_type...>> reduce_all(
+      const Ops&... ops) const {
+    return reduce_all(default_world(), ops...);
+  }
+
+  /// Reduce this and another expression with several reductions in a single
+  /// sweep
+
+  /// Both expressions are evaluated once. Binary reductions (e.g.
+  /// \c DotReduction ) are applied to the pairs of tiles of this and
+  /// \c right_expr , unary reductions (e.g. \c AbsMaxReduction ) to the
+  /// tiles of this expression:
+  /// \code
+  /// typedef TA::Tensor<double> T;
+  /// auto [squared_norm, abs_max, dot] =
+  ///     r("i,j")
+  ///         .reduce_all(z("i,j"), TA::SquaredNormReduction<T>(),
+  ///                     TA::AbsMaxReduction<T>(),
+  ///                     TA::DotReduction<T, T>())
+  ///         .get();
+  /// \endcode
+  /// \tparam D The right-hand expression type
+  /// \tparam Ops The reduction operation types
+  /// \param right_expr The right-hand expression
+  /// \param world The world where the expressions are evaluated
+  /// \param ops The reduction operations
+  /// \return A future to the tuple of the results of \c ops
+  template <typename D, typename... Ops>
+  Future<std::tuple<typename Ops::result_type...>> reduce_all(
+      const Expr<D>& right_expr, World& world, const Ops&... ops) const {
+    static_assert(
+        is_aliased<D>::value,
+        "no_alias() expressions are not allowed on the right-hand side of "
+        "the assignment operator.");
+
+    // Typedefs
+    typedef madness::TaggedKey<madness::uniqueidT, ExpressionReduceTag>
+        key_type;
+    typedef TiledArray::TupleReduction<
+        typename EngineTrait<engine_type>::eval_type,
+        typename EngineTrait<typename D::engine_type>::eval_type, Ops...>
+        op_type;
+    typedef TiledArray::math::UnaryReduceWrapper<
+        typename engine_type::value_type, op_type>
+        unary_op_type;
+    typedef TiledArray::math::BinaryReduceWrapper<
+        typename engine_type::value_type, typename D::engine_type::value_type,
+        op_type>
+        binary_op_type;
+
+    // Evaluate this expression
+    engine_type left_engine(derived());
+    left_engine.init(world,
+                     std::shared_ptr<typename engine_type::pmap_interface>(),
+                     VariableList());
+    typename engine_type::dist_eval_type left_dist_eval =
+        left_engine.make_dist_eval();
+    left_dist_eval.eval();
+
+    // Evaluate the right-hand expression
+    typename D::engine_type right_engine(right_expr.derived());
+    right_engine.init(world, left_engine.pmap(), left_engine.vars());
+    typename D::engine_type::dist_eval_type right_dist_eval =
+        right_engine.make_dist_eval();
+    right_dist_eval.eval();
+
+    TA_ASSERT(left_dist_eval.trange() == right_dist_eval.trange());
+
+    // Create the local reduction tasks. Pairs of non-zero tiles are reduced
+    // by all reductions, non-zero tiles of this expression that are paired
+    // with a zero tile by the unary reductions only.
+    const op_type op(ops...);
+    TiledArray::detail::ReducePairTask<binary_op_type> pair_reduce_task(
+        world, binary_op_type(op));
+    TiledArray::detail::ReduceTask<unary_op_type> left_reduce_task(
+        world, unary_op_type(op));
+
+    // Move the data from the distributed evaluators into the reduction tasks
+    for (const auto index : *left_dist_eval.pmap()) {
+      const bool left_not_zero = !left_dist_eval.is_zero(index);
+      const bool right_not_zero = !right_dist_eval.is_zero(index);
+
+      if (left_not_zero && right_not_zero) {
+        pair_reduce_task.add(left_dist_eval.get(index),
+                             right_dist_eval.get(index));
+      } else if (left_not_zero) {
+        left_reduce_task.add(left_dist_eval.get(index));
+      } else if (right_not_zero) {
+        right_dist_eval.get(index);
+      }
+    }
+
+    // Combine the local results, then all reduce them
+    Future<typename op_type::result_type> local_result = world.taskq.add(
+        &Expr_::template reduce_results<op_type>, op,
+        pair_reduce_task.submit(), left_reduce_task.submit());
+    auto result = world.gop.all_reduce(key_type(left_dist_eval.id()),
+                                       local_result, op);
+    left_dist_eval.wait();
+    right_dist_eval.wait();
+    return result;
+  }
+
+  template <typename D, typename... Ops>
+  Future<std::tuple<typename Ops::result_type...>> reduce_all(
+      const Expr<D>& right_expr, const Ops&... ops) const {
+    return reduce_all(right_expr, default_world(), ops...);
+  }
+
+ private:
+  template <typename Op>
+  static typename Op::result_type reduce_results(
+      const Op& op, typename Op::result_type result,
+      const typename Op::result_type& arg) {
+    op(result, arg);
+    return result;
+  }
+
+ public:
   Future<typename TiledArray::TraceReduction<
       typename EngineTrait<engine_type>::eval_type>::result_type>
   trace(World& world) const {
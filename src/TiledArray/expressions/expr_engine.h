@@ -27,7 +27,9 @@
 #define TILEDARRAY_EXPRESSIONS_EXPR_ENGINE_H__INCLUDED
 
 #include <TiledArray/expressions/expr_trace.h>
+#include <TiledArray/expressions/perm_placement.h>
 #include <TiledArray/external/madness.h>
+#include <TiledArray/type_traits.h>
 
 namespace TiledArray {
 namespace expressions {
@@ -40,6 +42,16 @@ class Expr;
 template <typename>
 struct EngineTrait;
 
+/// Change of the arguments of an expression engine
+
+/// The values are ordered by the amount of cached engine data that is
+/// invalidated by the change (see \c LeafEngine::rebind() ).
+enum class ArgChange {
+  none,      ///< The arguments are unchanged
+  shape,     ///< The shapes of the arguments changed
+  structure  ///< The tiled ranges or process maps of the arguments changed
+};
+
 /// Expression engine
 template <typename Derived>
 class ExprEngine : private NO_DEFAULTS {
@@ -66,6 +78,31 @@ class ExprEngine : private NO_DEFAULTS {
   typedef typename EngineTrait<Derived>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// Fused evaluation flag
+
+  /// \c true if this expression may be evaluated as part of a fused
+  /// element-wise tile operation (see \c BinaryEngine ). Engines that
+  /// support fused evaluation override this flag and \c fused_tile_type .
+  static constexpr bool fusable = false;
+  typedef void fused_tile_type;  ///< The tile type of fused evaluation
+
+  /// Accumulation flag
+
+  /// \c true if the result of this expression may be added directly to the
+  /// tiles of an existing array; engines that set this flag provide
+  /// <tt>bool accumulate_to(const A& array, const VariableList& target_vars,
+  /// const bool consume)</tt> (see \c ContEngine::accumulate_to() ).
+  static constexpr bool accumulable = false;
+
+  /// Contraction sum flag
+
+  /// \c true if this expression may be evaluated by SUMMA as a term of a sum
+  /// of contractions (see \c AddEngine ). Engines that set this flag provide
+  /// \c can_chain(), \c proc_grid(), an \c init_distribution() overload
+  /// that takes the process grid of the sum, and \c make_summa_link() (see
+  /// \c ContEngine ).
+  static constexpr bool chainable = false;
+
  protected:
   // The member variables of this class are protected because derived
   // classes will customize initialization.
@@ -134,6 +171,18 @@ class ExprEngine : private NO_DEFAULTS {
     derived().init_distribution(world_, pmap_);
   }
 
+  /// Reinitialize the result tensor structure
+
+  /// This function will recompute the structure of all expression engines in
+  /// the expression graph, after the shapes of the arguments changed. The
+  /// variable lists and distribution set by \c init() are kept, and so is
+  /// the process grid of contractions, which only depends on shapes through
+  /// load balancing.
+  /// \param target_vars The target variable list of the result tensor
+  void reinit_struct(const VariableList& target_vars) {
+    derived().init_struct(target_vars.dim() ? target_vars : vars_);
+  }
+
   /// Initialize result tensor structure
 
   /// This function will initialize the permutation, tiled range, and shape
@@ -177,6 +226,39 @@ class ExprEngine : private NO_DEFAULTS {
     pmap_ = pmap;
   }
 
+  /// Estimate the size of the result
+
+  /// The size is estimated from the element extents of the indices of the
+  /// result (see \c var_extent() ) and the estimated fraction of non-zero
+  /// tiles (see \c density_estimate() ) before the structure of the result
+  /// is initialized, i.e. after the variable list is initialized. It is
+  /// used to select the operands whose tiles are permuted (see
+  /// \c PermPlacement ).
+  /// \return The estimated size of the non-zero tiles of the result, in
+  /// bytes, or zero if it is unknown
+  double size_estimate() const {
+    double volume = derived().density_estimate();
+    for (const auto& var : vars_) {
+      const std::size_t extent = derived().var_extent(var);
+      if (extent == 0ul) return 0.0;
+      volume *= double(extent);
+    }
+    return volume * sizeof(TiledArray::detail::numeric_t<value_type>);
+  }
+
+  /// Element extent of an index of the result
+
+  /// \param var The index variable
+  /// \return The number of elements of the result along \c var , or zero if
+  /// it is unknown before the structure of the result is initialized
+  std::size_t var_extent(const std::string&) const { return 0ul; }
+
+  /// Estimate the fraction of non-zero tiles of the result
+
+  /// \return The estimated fraction of non-zero tiles; the result is assumed
+  /// to be dense unless the engine provides a better estimate
+  double density_estimate() const { return 1.0; }
+
   /// Permutation factory function
 
   /// This function will generate the permutation that will be applied to
@@ -0,0 +1,178 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  expressions/expr_plan.h
+ *  Nov 12, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+
+#include <memory>
+
+namespace TiledArray {
+namespace expressions {
+
+/// Reusable evaluation plan of an expression
+
+/// A plan binds an expression to the tensor it is assigned to, and keeps the
+/// expression engine graph between evaluations. The engine graph holds all
+/// data derived from the structure of the arguments: variable lists,
+/// permutations, tiled ranges, shapes, process maps, and the process grids
+/// of contractions. Each call to \c eval() is equivalent to
+/// <tt>result = expr</tt>, but the cached engine graph is reused as long as
+/// the tiled ranges, process maps, and shapes of the argument arrays are
+/// unchanged. If only the shapes changed, the tiled ranges and shapes of the
+/// graph are recomputed; any other change rebuilds the graph. Plans are
+/// intended for iterative solvers, where the same expressions are evaluated
+/// with arrays of fixed structure:
+/// \code
+/// auto plan = make_plan(2 * t("i,k") * f("k,j"), r("i,j"));
+/// for (...) {
+///   plan.eval();  // r("i,j") = 2 * t("i,k") * f("k,j")
+///   t("i,j") = ...;
+/// }
+/// \endcode
+/// The argument and result arrays are referenced by the plan, so they must
+/// outlive it. The distributed evaluators, including the broadcast groups of
+/// contractions, are constructed by every evaluation since they are bound to
+/// the tile data of the arguments. Chains of products are evaluated in the
+/// given association order (see \c MultExpr::eval_to() ).
+/// \note The engine graph holds copies of the argument arrays it was last
+/// evaluated with, which are released by the next evaluation or by
+/// \c invalidate().
+/// \tparam E The expression type
+/// \tparam A The result array type
+/// \tparam Alias Tile alias flag of the result
+template <typename E, typename A, bool Alias>
+class ExprPlan {
+ public:
+  typedef ExprPlan<E, A, Alias> ExprPlan_;  ///< This class type
+  typedef E expr_type;                      ///< The expression type
+  typedef TsrExpr<A, Alias> result_type;    ///< The result expression type
+  typedef typename E::engine_type engine_type;  ///< Expression engine type
+
+ private:
+  expr_type expr_;                       ///< The expression
+  result_type result_;                   ///< The result
+  std::unique_ptr<engine_type> engine_;  ///< The cached engine graph
+  std::size_t evals_;                    ///< The number of evaluations
+  std::size_t inits_;                    ///< The number of engine graphs
+  std::size_t struct_inits_;  ///< The number of structure updates
+
+ public:
+  ExprPlan() = delete;
+  ExprPlan(const ExprPlan_&) = delete;
+  ExprPlan(ExprPlan_&&) = default;
+  ExprPlan_& operator=(const ExprPlan_&) = delete;
+  ExprPlan_& operator=(ExprPlan_&&) = delete;
+
+  /// Constructor
+
+  /// The engine graph is constructed by the first evaluation.
+  /// \param expr The expression
+  /// \param result The tensor that \c expr is assigned to
+  ExprPlan(const expr_type& expr, const result_type& result)
+      : expr_(expr),
+        result_(result),
+        engine_(),
+        evals_(0ul),
+        inits_(0ul),
+        struct_inits_(0ul) {
+    static_assert(!is_lazy_tile<typename A::value_type>::value,
+                  "Assignment to an array of lazy tiles is not supported.");
+  }
+
+  /// Evaluate the expression and assign it to the result
+
+  /// This function must be called collectively by all processes in the
+  /// world of the result.
+  /// \return The result array
+  A& eval() {
+    const ArgChange change =
+        (engine_ ? engine_->rebind(expr_) : ArgChange::structure);
+    switch (change) {
+      case ArgChange::structure:
+        engine_.reset(new engine_type(expr_));
+        expr_.init_engine(*engine_, result_);
+        ++inits_;
+        break;
+      case ArgChange::shape:
+        engine_->reinit_struct(VariableList(result_.vars()));
+        ++struct_inits_;
+        break;
+      case ArgChange::none:
+        break;
+    }
+
+    expr_.eval_engine(*engine_, result_);
+    ++evals_;
+
+    return result_.array();
+  }
+
+  /// Discard the cached engine graph
+
+  /// The engine graph is rebuilt by the next evaluation. This is needed
+  /// when the result array was reassigned with a different process map,
+  /// which is not tracked by the plan.
+  void invalidate() { engine_.reset(); }
+
+  /// \return The number of evaluations of this plan
+  std::size_t evals() const { return evals_; }
+
+  /// \return The number of times the engine graph was constructed
+  std::size_t inits() const { return inits_; }
+
+  /// \return The number of times the structure of the engine graph was
+  /// updated for new argument shapes
+  std::size_t struct_inits() const { return struct_inits_; }
+
+  /// Expression print
+
+  /// \param os The output stream
+  void print(ExprOStream& os) const {
+    TA_ASSERT(engine_);
+    engine_->print(os, VariableList(result_.vars()));
+  }
+
+};  // class ExprPlan
+
+/// Evaluation plan factory function
+
+/// \tparam D The expression type
+/// \tparam A The result array type
+/// \tparam Alias Tile alias flag of the result
+/// \param expr The expression
+/// \param result The tensor that \c expr is assigned to
+/// \return The evaluation plan of <tt>result = expr</tt>
+template <typename D, typename A, bool Alias>
+inline ExprPlan<D, A, Alias> make_plan(const Expr<D>& expr,
+                                       const TsrExpr<A, Alias>& result) {
+  static_assert(TiledArray::expressions::is_aliased<D>::value,
+                "no_alias() expressions are not allowed on the right-hand "
+                "side of the assignment operator.");
+  return ExprPlan<D, A, Alias>(expr.derived(), result);
+}
+
+}  // namespace expressions
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
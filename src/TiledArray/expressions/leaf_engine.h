@@ -28,6 +28,7 @@
 
 #include <TiledArray/dist_eval/array_eval.h>
 #include <TiledArray/expressions/expr_engine.h>
+#include <TiledArray/tile_op/noop.h>
 
 namespace TiledArray {
 namespace expressions {
@@ -130,6 +131,54 @@ class LeafEngine : public ExprEngine<Derived> {
     ExprEngine_::init_distribution(world, (pmap ? pmap : array_.pmap()));
   }
 
+  /// Bind this engine to the current array of an expression
+
+  /// Arrays are assigned by swapping their implementation objects, so the
+  /// array of this engine is refreshed to the array currently held by
+  /// \c expr before an initialized engine is evaluated again.
+  /// \tparam D The expression type
+  /// \param expr The expression from which this engine was constructed
+  /// \return The change of the array since it was last bound to this engine
+  template <typename D>
+  ArgChange rebind(const Expr<D>& expr) {
+    const array_type& array = expr.derived().array();
+    TA_ASSERT(array.is_initialized());
+    if (array.pimpl() == array_.pimpl()) return ArgChange::none;
+
+    ArgChange change = ArgChange::none;
+    if ((array.pmap() != array_.pmap()) || (array.trange() != array_.trange()))
+      change = ArgChange::structure;
+    else if (!(array.shape() == array_.shape()))
+      change = ArgChange::shape;
+    array_ = array;
+
+    return change;
+  }
+
+  /// Collect the arrays read by this expression
+
+  /// \param ids The implementation object of the array is appended to this
+  /// list
+  void leaf_arrays(std::vector<const void*>& ids) const {
+    ids.push_back(array_.pimpl().get());
+  }
+
+  /// Element extent of an index of the array
+
+  /// \param var The index variable
+  /// \return The number of elements of the array along \c var , or zero if
+  /// \c var is not an index of the array
+  std::size_t var_extent(const std::string& var) const {
+    for (unsigned int i = 0u; i < vars_.dim(); ++i)
+      if (vars_[i] == var) return array_.trange().elements_range().extent(i);
+    return 0ul;
+  }
+
+  /// Estimate the fraction of non-zero tiles of the array
+
+  /// \return The fraction of non-zero tiles of the array shape
+  double density_estimate() const { return 1.0 - array_.shape().sparsity(); }
+
   /// Non-permuting tiled range factory function
 
   /// \return The result tiled range
@@ -169,6 +218,44 @@ class LeafEngine : public ExprEngine<Derived> {
     return dist_eval_type(pimpl);
   }
 
+  /// Check if this expression may be evaluated by a fused tile operation
+
+  /// \return \c true
+  bool can_fuse() const { return true; }
+
+  /// Initialize this leaf as an argument of a fused expression
+
+  /// The tiled range and shape are permuted to the index space of the
+  /// fused result tiles, while the tile data is left unpermuted.
+  /// \param target_vars The variable list of the result tile indices
+  void init_fused_struct(const VariableList& target_vars) {
+    perm_ = Permutation();
+    permute_tiles_ = false;
+    ExprEngine_::init_struct(target_vars);
+  }
+
+  /// Collect the arguments of a fused expression
+
+  /// \tparam Arg The argument distributed evaluator type
+  /// \param[out] args The distributed evaluators of the leaves, to which the
+  /// evaluator of this leaf is appended
+  /// \param[out] perms The permutations of the leaf tiles, to which the
+  /// permutation from the tiles of this leaf to the result tiles is appended
+  /// \param vars The variable list of the result tiles
+  template <typename Arg>
+  void make_fused_args(std::vector<Arg>& args, std::vector<Permutation>& perms,
+                       const VariableList& vars) const {
+    typedef typename array_type::value_type tile_type;
+    typedef typename Arg::value_type::op_type arg_op_type;
+    typedef TiledArray::detail::ArrayEvalImpl<array_type, arg_op_type, policy>
+        impl_type;
+
+    args.emplace_back(std::make_shared<impl_type>(
+        array_, *world_, trange_, shape_, pmap_, perm_,
+        arg_op_type(TiledArray::detail::Noop<tile_type, tile_type, true>())));
+    perms.emplace_back(vars.permutation(vars_));
+  }
+
 };  // class LeafEngine
 
 }  // namespace expressions
@@ -30,6 +30,8 @@
 #include <TiledArray/tile_op/binary_wrapper.h>
 #include <TiledArray/tile_op/mult.h>
 
+#include <functional>
+
 namespace TiledArray {
 namespace expressions {
 
@@ -173,6 +175,10 @@ class MultEngine : public ContEngine<MultEngine<Left, Right, Result> > {
   typedef typename EngineTrait<MultEngine_>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// \c true if this expression may be evaluated by a fused tile operation
+  static constexpr bool fusable = BinaryEngine_::fusable_args;
+  typedef value_type fused_tile_type;  ///< The tile type of fused evaluation
+
  private:
   bool contract_;  ///< Expression type flag (true == contraction, false ==
                    ///< coefficient-wise multiplication)
@@ -265,6 +271,18 @@ class MultEngine : public ContEngine<MultEngine<Left, Right, Result> > {
       BinaryEngine_::init_distribution(world, pmap);
   }
 
+  /// Initialize result tensor distribution with a given process grid
+
+  /// \param world The world were the result will be distributed
+  /// \param pmap The process map for the result tensor tiles
+  /// \param proc_grid The process grid of the contraction
+  /// \note This requires that \c can_chain() is \c true .
+  void init_distribution(World* world, std::shared_ptr<pmap_interface> pmap,
+                         const TiledArray::detail::ProcGrid& proc_grid) {
+    TA_ASSERT(contract_);
+    ContEngine_::init_distribution(world, pmap, proc_grid);
+  }
+
   /// Non-permuting tiled range factory function
 
   /// \return The result tiled range object
@@ -315,6 +333,45 @@ class MultEngine : public ContEngine<MultEngine<Left, Right, Result> > {
     return op_type(op_base_type(), perm);
   }
 
+  /// Fused element expression factory function
+
+  /// \tparam I The position of the first leaf of this expression
+  /// \return The element expression of this expression
+  template <std::size_t I>
+  auto make_fused_op() const {
+    return BinaryEngine_::template make_fused_binary<std::multiplies<>, I>();
+  }
+
+  /// Check if this expression may be evaluated by a fused tile operation
+
+  /// \return \c true if this is a coefficient-wise multiplication of
+  /// arguments that may be fused
+  bool can_fuse() const { return !contract_ && BinaryEngine_::can_fuse(); }
+
+  /// Accumulate the result into the tiles of an array
+
+  /// \tparam A The array type
+  /// \param array The array that holds the initial result tiles
+  /// \param target_vars The variable list of \c array
+  /// \param consume If \c true , the tiles of \c array are updated in place
+  /// \return \c true if this is a contraction whose result will be
+  /// accumulated into \c array (see \c ContEngine::accumulate_to() )
+  template <typename A>
+  bool accumulate_to(const A& array, const VariableList& target_vars,
+                     const bool consume) {
+    // This is a contraction if the arguments are not permutations of the
+    // target (see init_vars() )
+    const VariableList& left_vars = BinaryEngine_::left_.vars();
+    return left_vars.dim() && !left_vars.is_permutation(target_vars) &&
+           ContEngine_::accumulate_to(array, target_vars, consume);
+  }
+
+  /// Check if this expression may be evaluated as a term of a sum
+
+  /// \return \c true if this is a contraction that may be evaluated as a
+  /// term of a sum of contractions (see \c ContEngine::can_chain() )
+  bool can_chain() const { return contract_ && ContEngine_::can_chain(); }
+
   /// Construct the distributed evaluator for this expression
 
   /// \return The distributed evaluator that will evaluate this expression
@@ -393,6 +450,10 @@ class ScalMultEngine
   typedef typename EngineTrait<ScalMultEngine_>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// \c true if this expression may be evaluated by a fused tile operation
+  static constexpr bool fusable = BinaryEngine_::fusable_args;
+  typedef value_type fused_tile_type;  ///< The tile type of fused evaluation
+
  private:
   bool contract_;  ///< Expression type flag (true == contraction, false ==
                    ///< coefficient-wise multiplication)
@@ -482,6 +543,42 @@ class ScalMultEngine
       BinaryEngine_::init_distribution(world, pmap);
   }
 
+  /// Initialize result tensor distribution with a given process grid
+
+  /// \param world The world were the result will be distributed
+  /// \param pmap The process map for the result tensor tiles
+  /// \param proc_grid The process grid of the contraction
+  /// \note This requires that \c can_chain() is \c true .
+  void init_distribution(World* world, std::shared_ptr<pmap_interface> pmap,
+                         const TiledArray::detail::ProcGrid& proc_grid) {
+    TA_ASSERT(contract_);
+    ContEngine_::init_distribution(world, pmap, proc_grid);
+  }
+
+  /// Accumulate the result into the tiles of an array
+
+  /// \tparam A The array type
+  /// \param array The array that holds the initial result tiles
+  /// \param target_vars The variable list of \c array
+  /// \param consume If \c true , the tiles of \c array are updated in place
+  /// \return \c true if this is a contraction whose result will be
+  /// accumulated into \c array (see \c ContEngine::accumulate_to() )
+  template <typename A>
+  bool accumulate_to(const A& array, const VariableList& target_vars,
+                     const bool consume) {
+    // This is a contraction if the arguments are not permutations of the
+    // target (see init_vars() )
+    const VariableList& left_vars = BinaryEngine_::left_.vars();
+    return left_vars.dim() && !left_vars.is_permutation(target_vars) &&
+           ContEngine_::accumulate_to(array, target_vars, consume);
+  }
+
+  /// Check if this expression may be evaluated as a term of a sum
+
+  /// \return \c true if this is a contraction that may be evaluated as a
+  /// term of a sum of contractions (see \c ContEngine::can_chain() )
+  bool can_chain() const { return contract_ && ContEngine_::can_chain(); }
+
   /// Construct the distributed evaluator for this expression
 
   /// \return The distributed evaluator that will evaluate this expression
@@ -545,6 +642,22 @@ class ScalMultEngine
     return op_type(op_base_type(ContEngine_::factor_), perm);
   }
 
+  /// Fused element expression factory function
+
+  /// \tparam I The position of the first leaf of this expression
+  /// \return The element expression of this expression
+  template <std::size_t I>
+  auto make_fused_op() const {
+    return BinaryEngine_::template make_fused_binary<std::multiplies<>, I>(
+        ContEngine_::factor_);
+  }
+
+  /// Check if this expression may be evaluated by a fused tile operation
+
+  /// \return \c true if this is a coefficient-wise multiplication of
+  /// arguments that may be fused
+  bool can_fuse() const { return !contract_ && BinaryEngine_::can_fuse(); }
+
   /// Expression identification tag
 
   /// \return An expression tag used to identify this expression
@@ -27,6 +27,7 @@
 #define TILEDARRAY_EXPRESSIONS_MULT_EXPR_H__INCLUDED
 
 #include <TiledArray/expressions/binary_expr.h>
+#include <TiledArray/expressions/contraction_order.h>
 #include <TiledArray/expressions/mult_engine.h>
 
 namespace TiledArray {
@@ -110,6 +111,47 @@ class MultExpr : public BinaryExpr<MultExpr<Left, Right> > {
   MultExpr(const left_type& left, const right_type& right)
       : BinaryExpr_(left, right) {}
 
+  using BinaryExpr_::eval_to;
+
+  /// Evaluate this object and assign it to \c tsr
+
+  /// Chains of products, e.g. <tt>A * B * C</tt>, are evaluated in the
+  /// association order with the lowest estimated cost (see
+  /// \c ContractionOrder ).
+  /// \tparam A The array type
+  /// \tparam Alias Tile alias flag
+  /// \param tsr The tensor to be assigned
+  template <typename A, bool Alias>
+  void eval_to(TsrExpr<A, Alias>& tsr) const {
+    const bool reordered = detail::eval_chain(
+        *this, VariableList(tsr.vars()), [&](const auto& expr) {
+          typedef std::decay_t<decltype(expr)> expr_type;
+          static_cast<const Expr<expr_type>&>(expr).eval_to(tsr);
+        });
+    if (!reordered) BinaryExpr_::eval_to(tsr);
+  }
+
+  using BinaryExpr_::eval_add_to;
+
+  /// Add this object to \c tsr in place
+
+  /// Chains of products are reassociated as in \c eval_to() .
+  /// \tparam A The array type
+  /// \tparam Alias Tile alias flag
+  /// \param tsr The tensor to which this expression is added
+  /// \return \c true if this expression was added to \c tsr (see
+  /// \c Expr::eval_add_to() )
+  template <typename A, bool Alias>
+  bool eval_add_to(TsrExpr<A, Alias>& tsr) const {
+    bool result = false;
+    const bool reordered = detail::eval_chain(
+        *this, VariableList(tsr.vars()), [&](const auto& expr) {
+          typedef std::decay_t<decltype(expr)> expr_type;
+          result = static_cast<const Expr<expr_type>&>(expr).eval_add_to(tsr);
+        });
+    return (reordered ? result : BinaryExpr_::eval_add_to(tsr));
+  }
+
   /// Dot product
 
   /// \tparam Numeric A numeric type
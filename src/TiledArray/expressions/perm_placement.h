@@ -0,0 +1,164 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  expressions/perm_placement.h
+ *  Nov 16, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_PERM_PLACEMENT_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_PERM_PLACEMENT_H__INCLUDED
+
+#include <TiledArray/expressions/variable_list.h>
+#include <TiledArray/util/record_log.h>
+
+#include <ostream>
+#include <vector>
+
+namespace TiledArray {
+namespace expressions {
+
+/// Operand of a binary expression
+enum class PermOperand {
+  left,   ///< The left-hand argument
+  right,  ///< The right-hand argument
+  result  ///< The result
+};
+
+/// Permutation placement decision of an expression engine
+
+/// When the index order of the arguments of a binary expression does not
+/// match, the tiles of one of the operands must be permuted. The engine
+/// compares the estimated sizes of the candidate operands, i.e. the number
+/// of elements of their non-zero tiles (estimated with the tiled range
+/// volume and the fraction of non-zero tiles of the shape) times the size
+/// of an element, and permutes the smallest. If a size is unknown (e.g. for
+/// the index extents of nested contractions), the sizes are equal, or an
+/// argument is already in the target order, the placement is selected by
+/// fixed rules: the target order, then the rank and the number of leaves of
+/// the arguments.
+struct PermPlacement {
+  VariableList left_vars;   ///< The variable list of the left-hand argument
+  VariableList right_vars;  ///< The variable list of the right-hand argument
+  VariableList target_vars;  ///< The target variable list of the result
+  bool contraction;  ///< \c true for contractions, \c false for element-wise
+                     ///< expressions
+  PermOperand permuted;     ///< The permuted operand
+  PermOperand alternative;  ///< The operand that is not permuted instead
+  double permuted_size;     ///< The estimated size, in bytes, of the
+                            ///< permuted operand (zero if unknown)
+  double alternative_size;  ///< The estimated size, in bytes, of the
+                            ///< alternative operand (zero if unknown)
+  bool cost_based;  ///< \c true if the placement was selected by the sizes
+                    ///< of the operands, \c false if it was selected by the
+                    ///< fixed rules
+};
+
+/// Log of permutation placement decisions
+
+/// When enabled, the expression engines record the permutation placement
+/// decisions of this process (see \c PermPlacement ), e.g. to check that no
+/// large operand is permuted unnecessarily:
+/// \code
+/// PermPlacementLog::enable();
+/// c("i,j") = a("k,i") * b("j,k");
+/// for (const auto& placement : PermPlacementLog::placements())
+///   std::cout << placement << "\n";
+/// PermPlacementLog::disable();
+/// \endcode
+/// When the log is disabled, each decision costs a single relaxed atomic
+/// load.
+class PermPlacementLog {
+ public:
+  /// Check if the log is enabled
+
+  /// \return \c true if placement decisions are recorded
+  static bool enabled() { return log().enabled(); }
+
+  /// Enable the log
+
+  /// Decisions that were recorded before are kept.
+  static void enable() { log().enable(); }
+
+  /// Disable the log
+
+  /// Decisions that were recorded before are kept.
+  static void disable() { log().disable(); }
+
+  /// Record a placement decision, if the log is enabled
+
+  /// \param placement The placement decision
+  static void record(const PermPlacement& placement) {
+    if (enabled()) log().push(placement);
+  }
+
+  /// Recorded placement decisions
+
+  /// \return The placement decisions of this process, in the order they
+  /// were made
+  static std::vector<PermPlacement> placements() { return log().records(); }
+
+  /// Discard the recorded placement decisions
+  static void clear() { log().clear(); }
+
+ private:
+  static TiledArray::detail::RecordLog<PermPlacement>& log() {
+    static TiledArray::detail::RecordLog<PermPlacement> log;
+    return log;
+  }
+};  // class PermPlacementLog
+
+/// Permutation operand output operator
+
+/// \param os The output stream
+/// \param operand The operand
+/// \return \c os
+inline std::ostream& operator<<(std::ostream& os, const PermOperand operand) {
+  switch (operand) {
+    case PermOperand::left:
+      os << "left";
+      break;
+    case PermOperand::right:
+      os << "right";
+      break;
+    case PermOperand::result:
+      os << "result";
+      break;
+  }
+  return os;
+}
+
+/// Permutation placement output operator
+
+/// \param os The output stream
+/// \param placement The placement decision
+/// \return \c os
+inline std::ostream& operator<<(std::ostream& os,
+                                const PermPlacement& placement) {
+  os << placement.left_vars << (placement.contraction ? " * " : " . ")
+     << placement.right_vars << " -> " << placement.target_vars
+     << ": permute " << placement.permuted << " ("
+     << placement.permuted_size << " B) instead of "
+     << placement.alternative << " (" << placement.alternative_size << " B)"
+     << (placement.cost_based ? "" : " [by rule]");
+  return os;
+}
+
+}  // namespace expressions
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_EXPRESSIONS_PERM_PLACEMENT_H__INCLUDED
@@ -27,6 +27,7 @@
 #define TILEDARRAY_EXPRESSIONS_SCAL_TSR_ENGINE_H__INCLUDED
 
 #include <TiledArray/expressions/leaf_engine.h>
+#include <TiledArray/tile_op/fused.h>
 #include <TiledArray/tile_op/scal.h>
 #include <TiledArray/tile_op/unary_wrapper.h>
 
@@ -113,6 +114,12 @@ class ScalTsrEngine : public LeafEngine<ScalTsrEngine<Array, Scalar, Result> > {
   typedef typename EngineTrait<ScalTsrEngine_>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// \c true if the array tiles may be read by fused tile operations
+  static constexpr bool fusable =
+      std::is_same<Result, typename array_type::value_type>::value &&
+      TiledArray::detail::is_fusable_tile_v<Result>;
+  typedef Result fused_tile_type;  ///< The tile type of fused evaluation
+
  private:
   scalar_type factor_;  ///< The scaling factor
 
@@ -147,6 +154,15 @@ class ScalTsrEngine : public LeafEngine<ScalTsrEngine<Array, Scalar, Result> > {
     return op_type(op_base_type(factor_), perm);
   }
 
+  /// Fused element expression factory function
+
+  /// \tparam I The position of this leaf in the fused expression
+  /// \return The element expression of this leaf
+  template <std::size_t I>
+  auto make_fused_op() const {
+    return TiledArray::detail::make_fused_arg<I>(factor_);
+  }
+
   /// Expression identification tag
 
   /// \return An expression tag used to identify this expression
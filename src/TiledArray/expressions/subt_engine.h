@@ -30,6 +30,8 @@
 #include <TiledArray/tile_op/binary_wrapper.h>
 #include <TiledArray/tile_op/subt.h>
 
+#include <functional>
+
 namespace TiledArray {
 namespace expressions {
 
@@ -162,6 +164,10 @@ class SubtEngine : public BinaryEngine<SubtEngine<Left, Right, Result> > {
   typedef typename EngineTrait<SubtEngine_>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// \c true if this expression may be evaluated by a fused tile operation
+  static constexpr bool fusable = BinaryEngine_::fusable_args;
+  typedef value_type fused_tile_type;  ///< The tile type of fused evaluation
+
   /// Constructor
 
   /// \tparam L The left-hand argument expression type
@@ -199,6 +205,15 @@ class SubtEngine : public BinaryEngine<SubtEngine<Left, Right, Result> > {
     return op_type(op_base_type(), perm);
   }
 
+  /// Fused element expression factory function
+
+  /// \tparam I The position of the first leaf of this expression
+  /// \return The element expression of this expression
+  template <std::size_t I>
+  auto make_fused_op() const {
+    return BinaryEngine_::template make_fused_binary<std::minus<>, I>();
+  }
+
   /// Expression identification tag
 
   /// \return An expression tag used to identify this expression
@@ -254,6 +269,10 @@ class ScalSubtEngine
   typedef typename EngineTrait<ScalSubtEngine_>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// \c true if this expression may be evaluated by a fused tile operation
+  static constexpr bool fusable = BinaryEngine_::fusable_args;
+  typedef value_type fused_tile_type;  ///< The tile type of fused evaluation
+
  private:
   scalar_type factor_;  ///< Scaling factor
 
@@ -298,6 +317,16 @@ class ScalSubtEngine
     return op_type(op_base_type(factor_), perm);
   }
 
+  /// Fused element expression factory function
+
+  /// \tparam I The position of the first leaf of this expression
+  /// \return The element expression of this expression
+  template <std::size_t I>
+  auto make_fused_op() const {
+    return BinaryEngine_::template make_fused_binary<std::minus<>, I>(
+        factor_);
+  }
+
   /// Expression identification tag
 
   /// \return An expression tag used to identify this expression
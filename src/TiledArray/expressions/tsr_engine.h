@@ -27,6 +27,7 @@
 #define TILEDARRAY_EXPRESSIONS_TSR_ENGINE_H__INCLUDED
 
 #include <TiledArray/expressions/leaf_engine.h>
+#include <TiledArray/tile_op/fused.h>
 #include <TiledArray/tile_op/noop.h>
 #include <TiledArray/tile_op/unary_wrapper.h>
 
@@ -120,6 +121,12 @@ class TsrEngine : public LeafEngine<TsrEngine<Array, Result, Alias> > {
   typedef typename EngineTrait<TsrEngine_>::pmap_interface
       pmap_interface;  ///< Process map interface type
 
+  /// \c true if the array tiles may be read by fused tile operations
+  static constexpr bool fusable =
+      std::is_same<Result, typename array_type::value_type>::value &&
+      TiledArray::detail::is_fusable_tile_v<Result>;
+  typedef Result fused_tile_type;  ///< The tile type of fused evaluation
+
   template <typename A>
   TsrEngine(const TsrExpr<A, Alias>& expr) : LeafEngine_(expr) {}
 
@@ -136,6 +143,15 @@ class TsrEngine : public LeafEngine<TsrEngine<Array, Result, Alias> > {
     return op_type(op_base_type(), perm);
   }
 
+  /// Fused element expression factory function
+
+  /// \tparam I The position of this leaf in the fused expression
+  /// \return The element expression of this leaf
+  template <std::size_t I>
+  static auto make_fused_op() {
+    return TiledArray::detail::make_fused_arg<I>();
+  }
+
 };  // class TsrEngine
 
 }  // namespace expressions
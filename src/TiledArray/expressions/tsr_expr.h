@@ -132,6 +132,9 @@ class TsrExpr : public Expr<TsrExpr<Array, Alias>> {
 
   /// Expression plus-assignment operator
 
+  /// Contractions are accumulated directly into the tiles of this array
+  /// when possible (see \c Expr::eval_add_to() ), which are copied first
+  /// unless this expression is flagged with \c no_alias() .
   /// \tparam D The derived expression type
   /// \param other The expression that will be added to this array
   template <typename D>
@@ -140,6 +143,7 @@ class TsrExpr : public Expr<TsrExpr<Array, Alias>> {
         TiledArray::expressions::is_aliased<D>::value,
         "no_alias() expressions are not allowed on the right-hand side of "
         "the assignment operator.");
+    if (other.derived().eval_add_to(*this)) return array_;
     return operator=(AddExpr<TsrExpr_, D>(*this, other.derived()));
   }
 
@@ -91,6 +91,7 @@ class UnaryEngine : ExprEngine<Derived> {
 
   // Pull base class functions into this class.
   using ExprEngine_::derived;
+  using ExprEngine_::size_estimate;
   using ExprEngine_::vars;
 
   /// Set the variable list for this expression
@@ -141,6 +142,37 @@ class UnaryEngine : ExprEngine<Derived> {
     ExprEngine_::init_distribution(world, arg_.pmap());
   }
 
+  /// Bind the leaves of this engine to the current arrays of an expression
+
+  /// \tparam D The expression type
+  /// \param expr The expression from which this engine was constructed
+  /// \return The change of the arrays since they were last bound
+  template <typename D>
+  ArgChange rebind(const UnaryExpr<D>& expr) {
+    return arg_.rebind(expr.arg());
+  }
+
+  /// Collect the arrays read by this expression
+
+  /// \param ids The implementation objects of the arrays of the leaves are
+  /// appended to this list
+  void leaf_arrays(std::vector<const void*>& ids) const {
+    arg_.leaf_arrays(ids);
+  }
+
+  /// Element extent of an index of the result
+
+  /// \param var The index variable
+  /// \return The element extent of \c var in the argument
+  std::size_t var_extent(const std::string& var) const {
+    return arg_.var_extent(var);
+  }
+
+  /// Estimate the fraction of non-zero tiles of the result
+
+  /// \return The estimated fraction of non-zero tiles of the argument
+  double density_estimate() const { return arg_.density_estimate(); }
+
   /// Non-permuting tiled range factory function
 
   /// \return The result tiled range
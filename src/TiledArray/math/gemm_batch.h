@@ -0,0 +1,273 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  gemm_batch.h
+ *  Oct 15, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_GEMM_BATCH_H__INCLUDED
+#define TILEDARRAY_MATH_GEMM_BATCH_H__INCLUDED
+
+#include <TiledArray/math/blas.h>
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+#ifdef HAVE_INTEL_MKL
+#include <mkl_cblas.h>
+#endif  // HAVE_INTEL_MKL
+
+namespace TiledArray {
+namespace math {
+
+/// Block size of the small matrix multiplication kernel
+constexpr const integer small_gemm_block_size = 64;
+
+/// Matrix multiplication kernel for small matrices
+
+/// Computes \f$ C = \alpha\, {\rm op}(A)\, {\rm op}(B) + \beta C \f$ for
+/// row-major matrices, where \f$ C \f$ is an \c m by \c n matrix. The
+/// loops are blocked over the columns of \f$ C \f$ and over the inner
+/// dimension such that the working set of each block fits in the L1 cache,
+/// and the innermost loop runs over contiguous elements so it can be
+/// vectorized by the compiler. This avoids the dispatch overhead of BLAS for
+/// matrices with only a few dozen rows and columns.
+/// \note Conjugate-transpose operations are not supported.
+template <typename S1, typename T1, typename T2, typename S2, typename T3>
+inline void small_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+                       madness::cblas::CBLAS_TRANSPOSE op_b, const integer m,
+                       const integer n, const integer k, const S1 alpha,
+                       const T1* const a, const integer lda, const T2* const b,
+                       const integer ldb, const S2 beta, T3* const c,
+                       const integer ldc) {
+  TA_ASSERT(op_a != madness::cblas::ConjTrans);
+  TA_ASSERT(op_b != madness::cblas::ConjTrans);
+  constexpr integer block = small_gemm_block_size;
+
+  // Scale C
+  for (integer i = 0; i < m; ++i) {
+    T3* MADNESS_RESTRICT const c_i = c + i * ldc;
+    if (beta == S2(0))
+      std::fill_n(c_i, n, T3(0));
+    else if (beta != S2(1))
+      for (integer j = 0; j < n; ++j) c_i[j] *= beta;
+  }
+
+  if (op_b == madness::cblas::NoTrans) {
+    // C(i,j) += alpha * op(A)(i,l) * B(l,j), with contiguous rows of B
+    for (integer j0 = 0; j0 < n; j0 += block) {
+      const integer nj = std::min(block, n - j0);
+      for (integer l0 = 0; l0 < k; l0 += block) {
+        const integer nl = std::min(block, k - l0);
+        for (integer i = 0; i < m; ++i) {
+          T3* MADNESS_RESTRICT const c_i = c + i * ldc + j0;
+          for (integer l = l0; l < l0 + nl; ++l) {
+            const auto a_il = alpha * (op_a == madness::cblas::NoTrans
+                                           ? a[i * lda + l]
+                                           : a[l * lda + i]);
+            const T2* MADNESS_RESTRICT const b_l = b + l * ldb + j0;
+            for (integer j = 0; j < nj; ++j) c_i[j] += a_il * b_l[j];
+          }
+        }
+      }
+    }
+  } else {
+    // C(i,j) += alpha * op(A)(i,:) . B(j,:), with contiguous rows of B
+    for (integer i = 0; i < m; ++i) {
+      T3* MADNESS_RESTRICT const c_i = c + i * ldc;
+      for (integer j = 0; j < n; ++j) {
+        const T2* MADNESS_RESTRICT const b_j = b + j * ldb;
+        T3 c_ij = T3(0);
+        if (op_a == madness::cblas::NoTrans) {
+          const T1* MADNESS_RESTRICT const a_i = a + i * lda;
+          for (integer l = 0; l < k; ++l) c_ij += a_i[l] * b_j[l];
+        } else {
+          for (integer l = 0; l < k; ++l) c_ij += a[l * lda + i] * b_j[l];
+        }
+        c_i[j] += alpha * c_ij;
+      }
+    }
+  }
+}
+
+/// Batched matrix multiplication
+
+/// Computes \f$ C_p = \alpha\, {\rm op}(A_p)\, {\rm op}(B_p) + \beta C_p \f$
+/// for each of the \c count row-major matrix triplets. All products share the
+/// same transpose operations and scaling factors, but the matrix sizes may
+/// differ. If the BLAS library provides a batched GEMM (Intel MKL), the batch
+/// is evaluated with a single library call; otherwise each product is
+/// evaluated with \c small_gemm(), or with \c gemm() when it is too large to
+/// benefit from the small matrix kernel.
+/// \param op_a The operation applied to the \f$ A \f$ matrices
+/// \param op_b The operation applied to the \f$ B \f$ matrices
+/// \param count The number of matrix products
+/// \param m The number of rows of each \f$ C \f$
+/// \param n The number of columns of each \f$ C \f$
+/// \param k The inner dimension of each product
+/// \param alpha The scaling factor applied to the products
+/// \param a Pointers to the \f$ A \f$ matrices
+/// \param lda The leading dimension of each \f$ A \f$
+/// \param b Pointers to the \f$ B \f$ matrices
+/// \param ldb The leading dimension of each \f$ B \f$
+/// \param beta The scaling factor applied to \f$ C \f$
+/// \param c Pointers to the \f$ C \f$ matrices
+/// \param ldc The leading dimension of each \f$ C \f$
+template <typename S1, typename T1, typename T2, typename S2, typename T3>
+inline void gemm_batch(madness::cblas::CBLAS_TRANSPOSE op_a,
+                       madness::cblas::CBLAS_TRANSPOSE op_b,
+                       const std::size_t count, const integer* const m,
+                       const integer* const n, const integer* const k,
+                       const S1 alpha, const T1* const* const a,
+                       const integer* const lda, const T2* const* const b,
+                       const integer* const ldb, const S2 beta,
+                       T3* const* const c, const integer* const ldc) {
+  constexpr integer block = small_gemm_block_size;
+  for (std::size_t p = 0ul; p < count; ++p) {
+    if (std::max(m[p], std::max(n[p], k[p])) <= block)
+      small_gemm(op_a, op_b, m[p], n[p], k[p], alpha, a[p], lda[p], b[p],
+                 ldb[p], beta, c[p], ldc[p]);
+    else
+      gemm(op_a, op_b, m[p], n[p], k[p], alpha, a[p], lda[p], b[p], ldb[p],
+           beta, c[p], ldc[p]);
+  }
+}
+
+#ifdef HAVE_INTEL_MKL
+
+namespace detail {
+
+/// Evaluate a batch of matrix products with MKL
+
+/// \tparam T The matrix element type
+/// \tparam Batch The MKL batched GEMM function type
+template <typename T, typename Batch>
+inline void mkl_gemm_batch(const Batch& batch,
+                           madness::cblas::CBLAS_TRANSPOSE op_a,
+                           madness::cblas::CBLAS_TRANSPOSE op_b,
+                           const std::size_t count, const integer* const m,
+                           const integer* const n, const integer* const k,
+                           const T alpha, const T* const* const a,
+                           const integer* const lda, const T* const* const b,
+                           const integer* const ldb, const T beta,
+                           T* const* const c, const integer* const ldc) {
+  auto to_mkl = [](const madness::cblas::CBLAS_TRANSPOSE op) {
+    return (op == madness::cblas::NoTrans
+                ? CblasNoTrans
+                : (op == madness::cblas::Trans ? CblasTrans : CblasConjTrans));
+  };
+
+  // Each product is its own group, so the sizes may differ
+  const std::vector<CBLAS_TRANSPOSE> trans_a(count, to_mkl(op_a)),
+      trans_b(count, to_mkl(op_b));
+  const std::vector<MKL_INT> m_(m, m + count), n_(n, n + count),
+      k_(k, k + count), lda_(lda, lda + count), ldb_(ldb, ldb + count),
+      ldc_(ldc, ldc + count), group_size(count, 1);
+  const std::vector<T> alpha_(count, alpha), beta_(count, beta);
+
+  batch(CblasRowMajor, trans_a.data(), trans_b.data(), m_.data(), n_.data(),
+        k_.data(), alpha_.data(), const_cast<const T**>(a), lda_.data(),
+        const_cast<const T**>(b), ldb_.data(), beta_.data(),
+        const_cast<T**>(c), ldc_.data(), MKL_INT(count), group_size.data());
+}
+
+}  // namespace detail
+
+inline void gemm_batch(madness::cblas::CBLAS_TRANSPOSE op_a,
+                       madness::cblas::CBLAS_TRANSPOSE op_b,
+                       const std::size_t count, const integer* const m,
+                       const integer* const n, const integer* const k,
+                       const float alpha, const float* const* const a,
+                       const integer* const lda, const float* const* const b,
+                       const integer* const ldb, const float beta,
+                       float* const* const c, const integer* const ldc) {
+  detail::mkl_gemm_batch(
+      [](auto... args) { cblas_sgemm_batch(args...); }, op_a, op_b, count, m,
+      n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+inline void gemm_batch(madness::cblas::CBLAS_TRANSPOSE op_a,
+                       madness::cblas::CBLAS_TRANSPOSE op_b,
+                       const std::size_t count, const integer* const m,
+                       const integer* const n, const integer* const k,
+                       const double alpha, const double* const* const a,
+                       const integer* const lda, const double* const* const b,
+                       const integer* const ldb, const double beta,
+                       double* const* const c, const integer* const ldc) {
+  detail::mkl_gemm_batch(
+      [](auto... args) { cblas_dgemm_batch(args...); }, op_a, op_b, count, m,
+      n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+inline void gemm_batch(madness::cblas::CBLAS_TRANSPOSE op_a,
+                       madness::cblas::CBLAS_TRANSPOSE op_b,
+                       const std::size_t count, const integer* const m,
+                       const integer* const n, const integer* const k,
+                       const std::complex<float> alpha,
+                       const std::complex<float>* const* const a,
+                       const integer* const lda,
+                       const std::complex<float>* const* const b,
+                       const integer* const ldb,
+                       const std::complex<float> beta,
+                       std::complex<float>* const* const c,
+                       const integer* const ldc) {
+  detail::mkl_gemm_batch(
+      [](auto layout, auto trans_a, auto trans_b, auto m, auto n, auto k,
+         auto alpha, auto a, auto lda, auto b, auto ldb, auto beta, auto c,
+         auto ldc, auto group_count, auto group_size) {
+        cblas_cgemm_batch(layout, trans_a, trans_b, m, n, k, alpha,
+                          reinterpret_cast<const void**>(a), lda,
+                          reinterpret_cast<const void**>(b), ldb, beta,
+                          reinterpret_cast<void**>(c), ldc, group_count,
+                          group_size);
+      },
+      op_a, op_b, count, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+inline void gemm_batch(madness::cblas::CBLAS_TRANSPOSE op_a,
+                       madness::cblas::CBLAS_TRANSPOSE op_b,
+                       const std::size_t count, const integer* const m,
+                       const integer* const n, const integer* const k,
+                       const std::complex<double> alpha,
+                       const std::complex<double>* const* const a,
+                       const integer* const lda,
+                       const std::complex<double>* const* const b,
+                       const integer* const ldb,
+                       const std::complex<double> beta,
+                       std::complex<double>* const* const c,
+                       const integer* const ldc) {
+  detail::mkl_gemm_batch(
+      [](auto layout, auto trans_a, auto trans_b, auto m, auto n, auto k,
+         auto alpha, auto a, auto lda, auto b, auto ldb, auto beta, auto c,
+         auto ldc, auto group_count, auto group_size) {
+        cblas_zgemm_batch(layout, trans_a, trans_b, m, n, k, alpha,
+                          reinterpret_cast<const void**>(a), lda,
+                          reinterpret_cast<const void**>(b), ldb, beta,
+                          reinterpret_cast<void**>(c), ldc, group_count,
+                          group_size);
+      },
+      op_a, op_b, count, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+#endif  // HAVE_INTEL_MKL
+
+}  // namespace math
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_MATH_GEMM_BATCH_H__INCLUDED
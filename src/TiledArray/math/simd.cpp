@@ -0,0 +1,419 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math/simd.cpp
+ *  Nov 2, 2020
+ *
+ */
+
+#include "simd.h"
+#include "simd_kernels.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace TiledArray {
+namespace math {
+namespace simd {
+namespace detail {
+namespace {
+
+/// Portable vector type
+
+/// The operations are element-wise loops over a 16-byte register, which the
+/// compiler may vectorize with the baseline instruction set.
+template <typename T>
+struct Portable {
+  typedef T value_type;
+  static constexpr std::size_t width = 16ul / sizeof(T);
+  struct register_type {
+    T v[width];
+  };
+  typedef register_type R;
+
+  static R load(const T* const p) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = p[i];
+    return r;
+  }
+  static void store(T* const p, const R& a) {
+    for (std::size_t i = 0ul; i < width; ++i) p[i] = a.v[i];
+  }
+  static R broadcast(const T x) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = x;
+    return r;
+  }
+  static R zero() { return broadcast(T(0)); }
+  static R add(const R& a, const R& b) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = a.v[i] + b.v[i];
+    return r;
+  }
+  static R sub(const R& a, const R& b) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = a.v[i] - b.v[i];
+    return r;
+  }
+  static R mul(const R& a, const R& b) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = a.v[i] * b.v[i];
+    return r;
+  }
+  static R fmadd(const R& a, const R& b, const R& c) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = a.v[i] * b.v[i] + c.v[i];
+    return r;
+  }
+  static R abs(const R& a) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i)
+      r.v[i] = (a.v[i] < T(0) ? -a.v[i] : a.v[i]);
+    return r;
+  }
+  static R max(const R& a, const R& b) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i)
+      r.v[i] = (a.v[i] < b.v[i] ? b.v[i] : a.v[i]);
+    return r;
+  }
+  static T reduce_add(const R& a) {
+    T result = a.v[0];
+    for (std::size_t i = 1ul; i < width; ++i) result += a.v[i];
+    return result;
+  }
+  static T reduce_max(const R& a) {
+    T result = a.v[0];
+    for (std::size_t i = 1ul; i < width; ++i)
+      result = (result < a.v[i] ? a.v[i] : result);
+    return result;
+  }
+  static R swap_pairs(const R& a) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = a.v[i ^ 1ul];
+    return r;
+  }
+  static R dup_even(const R& a) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = a.v[i & ~1ul];
+    return r;
+  }
+  static R dup_odd(const R& a) {
+    R r;
+    for (std::size_t i = 0ul; i < width; ++i) r.v[i] = a.v[i | 1ul];
+    return r;
+  }
+};  // struct Portable
+
+/// The best instruction set supported by the CPU and the build
+Isa detect_isa() {
+#if defined(TILEDARRAY_HAS_SIMD_AVX512)
+  if (__builtin_cpu_supports("avx512f")) return Isa::avx512;
+#endif  // defined(TILEDARRAY_HAS_SIMD_AVX512)
+#if defined(TILEDARRAY_HAS_SIMD_AVX2)
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return Isa::avx2;
+#endif  // defined(TILEDARRAY_HAS_SIMD_AVX2)
+  return Isa::off;
+}
+
+/// Kernel table of an instruction set
+
+/// \tparam T The element type
+/// \param isa A supported instruction set
+/// \return The kernel table of \c isa
+template <typename T>
+const Kernels<T>* kernels(const Isa isa) {
+  switch (isa) {
+#if defined(TILEDARRAY_HAS_SIMD_AVX512)
+    case Isa::avx512:
+      return &avx512_kernels(T());
+#endif  // defined(TILEDARRAY_HAS_SIMD_AVX512)
+#if defined(TILEDARRAY_HAS_SIMD_AVX2)
+    case Isa::avx2:
+      return &avx2_kernels(T());
+#endif  // defined(TILEDARRAY_HAS_SIMD_AVX2)
+    default:
+      return &VectorKernels<Portable<T>>::kernels();
+  }
+}
+
+/// Dispatch state
+struct State {
+  const Isa supported = detect_isa();  ///< The best supported instruction set
+  std::atomic<Isa> isa{supported};     ///< The selected instruction set
+  std::atomic<const Kernels<double>*> double_kernels{kernels<double>(isa)};
+  std::atomic<const Kernels<float>*> float_kernels{kernels<float>(isa)};
+
+  State() {
+    const char* isa_env = std::getenv("TA_SIMD");
+    if (isa_env) {
+      if (std::strcmp(isa_env, "off") == 0)
+        select(Isa::off);
+      else if (std::strcmp(isa_env, "avx2") == 0)
+        select(Isa::avx2);
+      else if (std::strcmp(isa_env, "avx512") == 0)
+        select(Isa::avx512);
+    }
+  }
+
+  Isa select(Isa requested) {
+    if (requested > supported) requested = supported;
+    isa.store(requested);
+    double_kernels.store(kernels<double>(requested));
+    float_kernels.store(kernels<float>(requested));
+    return requested;
+  }
+};  // struct State
+
+State& state() {
+  static State s;
+  return s;
+}
+
+inline const Kernels<double>& active(double) {
+  return *state().double_kernels.load(std::memory_order_relaxed);
+}
+
+inline const Kernels<float>& active(float) {
+  return *state().float_kernels.load(std::memory_order_relaxed);
+}
+
+/// The real and imaginary parts of complex data
+template <typename T>
+inline const T* parts(const std::complex<T>* const p) {
+  return reinterpret_cast<const T*>(p);
+}
+
+template <typename T>
+inline T* parts(std::complex<T>* const p) {
+  return reinterpret_cast<T*>(p);
+}
+
+}  // namespace
+}  // namespace detail
+
+Isa supported_isa() { return detail::state().supported; }
+
+Isa isa() { return detail::state().isa.load(); }
+
+Isa set_isa(const Isa isa) { return detail::state().select(isa); }
+
+const char* name(const Isa isa) {
+  switch (isa) {
+    case Isa::avx2:
+      return "avx2";
+    case Isa::avx512:
+      return "avx512";
+    default:
+      return "off";
+  }
+}
+
+void add(const std::size_t n, const double* const left,
+         const double* const right, double* const result) {
+  detail::active(double()).add(n, left, right, result);
+}
+
+void add(const std::size_t n, const float* const left,
+         const float* const right, float* const result) {
+  detail::active(float()).add(n, left, right, result);
+}
+
+void subt(const std::size_t n, const double* const left,
+          const double* const right, double* const result) {
+  detail::active(double()).subt(n, left, right, result);
+}
+
+void subt(const std::size_t n, const float* const left,
+          const float* const right, float* const result) {
+  detail::active(float()).subt(n, left, right, result);
+}
+
+void mult(const std::size_t n, const double* const left,
+          const double* const right, double* const result) {
+  detail::active(double()).mult(n, left, right, result);
+}
+
+void mult(const std::size_t n, const float* const left,
+          const float* const right, float* const result) {
+  detail::active(float()).mult(n, left, right, result);
+}
+
+void scale(const std::size_t n, const double factor, const double* const arg,
+           double* const result) {
+  detail::active(double()).scale(n, factor, arg, result);
+}
+
+void scale(const std::size_t n, const float factor, const float* const arg,
+           float* const result) {
+  detail::active(float()).scale(n, factor, arg, result);
+}
+
+void axpy(const std::size_t n, const double alpha, const double* const x,
+          double* const y) {
+  detail::active(double()).axpy(n, alpha, x, y);
+}
+
+void axpy(const std::size_t n, const float alpha, const float* const x,
+          float* const y) {
+  detail::active(float()).axpy(n, alpha, x, y);
+}
+
+double dot(const std::size_t n, const double* const left,
+           const double* const right) {
+  return detail::active(double()).dot(n, left, right);
+}
+
+float dot(const std::size_t n, const float* const left,
+          const float* const right) {
+  return detail::active(float()).dot(n, left, right);
+}
+
+double abs_max(const std::size_t n, const double* const arg) {
+  return detail::active(double()).abs_max(n, arg);
+}
+
+float abs_max(const std::size_t n, const float* const arg) {
+  return detail::active(float()).abs_max(n, arg);
+}
+
+void add(const std::size_t n, const std::complex<double>* const left,
+         const std::complex<double>* const right,
+         std::complex<double>* const result) {
+  detail::active(double()).add(2ul * n, detail::parts(left),
+                               detail::parts(right), detail::parts(result));
+}
+
+void add(const std::size_t n, const std::complex<float>* const left,
+         const std::complex<float>* const right,
+         std::complex<float>* const result) {
+  detail::active(float()).add(2ul * n, detail::parts(left),
+                              detail::parts(right), detail::parts(result));
+}
+
+void subt(const std::size_t n, const std::complex<double>* const left,
+          const std::complex<double>* const right,
+          std::complex<double>* const result) {
+  detail::active(double()).subt(2ul * n, detail::parts(left),
+                                detail::parts(right), detail::parts(result));
+}
+
+void subt(const std::size_t n, const std::complex<float>* const left,
+          const std::complex<float>* const right,
+          std::complex<float>* const result) {
+  detail::active(float()).subt(2ul * n, detail::parts(left),
+                               detail::parts(right), detail::parts(result));
+}
+
+void mult(const std::size_t n, const std::complex<double>* const left,
+          const std::complex<double>* const right,
+          std::complex<double>* const result) {
+  detail::active(double()).cmult(n, detail::parts(left), detail::parts(right),
+                                 detail::parts(result));
+}
+
+void mult(const std::size_t n, const std::complex<float>* const left,
+          const std::complex<float>* const right,
+          std::complex<float>* const result) {
+  detail::active(float()).cmult(n, detail::parts(left), detail::parts(right),
+                                detail::parts(result));
+}
+
+void scale(const std::size_t n, const std::complex<double> factor,
+           const std::complex<double>* const arg,
+           std::complex<double>* const result) {
+  detail::active(double()).cscale(n, factor.real(), factor.imag(),
+                                  detail::parts(arg), detail::parts(result));
+}
+
+void scale(const std::size_t n, const std::complex<float> factor,
+           const std::complex<float>* const arg,
+           std::complex<float>* const result) {
+  detail::active(float()).cscale(n, factor.real(), factor.imag(),
+                                 detail::parts(arg), detail::parts(result));
+}
+
+void scale(const std::size_t n, const double factor,
+           const std::complex<double>* const arg,
+           std::complex<double>* const result) {
+  detail::active(double()).scale(2ul * n, factor, detail::parts(arg),
+                                 detail::parts(result));
+}
+
+void scale(const std::size_t n, const float factor,
+           const std::complex<float>* const arg,
+           std::complex<float>* const result) {
+  detail::active(float()).scale(2ul * n, factor, detail::parts(arg),
+                                detail::parts(result));
+}
+
+void axpy(const std::size_t n, const std::complex<double> alpha,
+          const std::complex<double>* const x, std::complex<double>* const y) {
+  detail::active(double()).caxpy(n, alpha.real(), alpha.imag(),
+                                 detail::parts(x), detail::parts(y));
+}
+
+void axpy(const std::size_t n, const std::complex<float> alpha,
+          const std::complex<float>* const x, std::complex<float>* const y) {
+  detail::active(float()).caxpy(n, alpha.real(), alpha.imag(),
+                                detail::parts(x), detail::parts(y));
+}
+
+void axpy(const std::size_t n, const double alpha,
+          const std::complex<double>* const x, std::complex<double>* const y) {
+  detail::active(double()).axpy(2ul * n, alpha, detail::parts(x),
+                                detail::parts(y));
+}
+
+void axpy(const std::size_t n, const float alpha,
+          const std::complex<float>* const x, std::complex<float>* const y) {
+  detail::active(float()).axpy(2ul * n, alpha, detail::parts(x),
+                               detail::parts(y));
+}
+
+std::complex<double> dot(const std::size_t n,
+                         const std::complex<double>* const left,
+                         const std::complex<double>* const right) {
+  double result[2];
+  detail::active(double()).cdot(n, detail::parts(left), detail::parts(right),
+                                result);
+  return std::complex<double>(result[0], result[1]);
+}
+
+std::complex<float> dot(const std::size_t n,
+                        const std::complex<float>* const left,
+                        const std::complex<float>* const right) {
+  float result[2];
+  detail::active(float()).cdot(n, detail::parts(left), detail::parts(right),
+                               result);
+  return std::complex<float>(result[0], result[1]);
+}
+
+double abs_max(const std::size_t n, const std::complex<double>* const arg) {
+  return std::sqrt(detail::active(double()).cnorm_max(n, detail::parts(arg)));
+}
+
+float abs_max(const std::size_t n, const std::complex<float>* const arg) {
+  return std::sqrt(detail::active(float()).cnorm_max(n, detail::parts(arg)));
+}
+
+}  // namespace simd
+}  // namespace math
+}  // namespace TiledArray
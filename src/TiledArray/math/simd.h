@@ -0,0 +1,174 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math/simd.h
+ *  Nov 2, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SIMD_H__INCLUDED
+#define TILEDARRAY_MATH_SIMD_H__INCLUDED
+
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+
+namespace TiledArray {
+namespace math {
+
+/// Explicitly vectorized kernels for contiguous real and complex data
+
+/// The kernels are compiled for each supported instruction set (AVX2+FMA and
+/// AVX-512F on x86-64, when the compiler supports them) and a portable
+/// baseline, and the instruction set is selected at runtime from the
+/// capabilities of the CPU. The \c TA_SIMD environment variable (\c off ,
+/// \c avx2 , or \c avx512 ) overrides the selection, e.g. for benchmarking;
+/// an instruction set that is not supported by the CPU or the build falls
+/// back to the best supported one below it. The result arrays may alias the
+/// argument arrays.
+///
+/// Complex numbers are processed as interleaved (real, imaginary) pairs of
+/// real numbers. Strided copies (\c scatter_vector() and \c gather_vector()
+/// of math/vector_op.h ) and operations with arbitrary element-wise
+/// functions are not covered: they keep the generic loops of
+/// math/vector_op.h , since they are limited by memory access rather than
+/// by arithmetic.
+namespace simd {
+
+/// Instruction sets of the kernels
+enum class Isa {
+  off,    ///< Portable baseline kernels
+  avx2,   ///< AVX2 and FMA kernels
+  avx512  ///< AVX-512F kernels
+};
+
+/// Checks if the kernels support the element type \c T
+template <typename T>
+constexpr bool is_simd_v =
+    std::is_same_v<T, double> || std::is_same_v<T, float> ||
+    std::is_same_v<T, std::complex<double>> ||
+    std::is_same_v<T, std::complex<float>>;
+
+/// The best instruction set supported by the CPU and the build
+
+/// \return The best instruction set of the kernels that may be used
+Isa supported_isa();
+
+/// The instruction set of the kernels
+
+/// \return The instruction set used by the kernels
+Isa isa();
+
+/// Select the instruction set of the kernels
+
+/// \param isa The requested instruction set
+/// \return The instruction set that is used, which is the best supported
+/// instruction set that is not above \c isa
+/// \note This should not be called while kernels are executed.
+Isa set_isa(Isa isa);
+
+/// Instruction set name
+
+/// \param isa An instruction set
+/// \return The name of \c isa , as used by the \c TA_SIMD environment
+/// variable
+const char* name(Isa isa);
+
+/// Element-wise sum: <tt>result[i] = left[i] + right[i]</tt>
+void add(std::size_t n, const double* left, const double* right,
+         double* result);
+void add(std::size_t n, const float* left, const float* right, float* result);
+
+/// Element-wise difference: <tt>result[i] = left[i] - right[i]</tt>
+void subt(std::size_t n, const double* left, const double* right,
+          double* result);
+void subt(std::size_t n, const float* left, const float* right,
+          float* result);
+
+/// Element-wise product: <tt>result[i] = left[i] * right[i]</tt>
+void mult(std::size_t n, const double* left, const double* right,
+          double* result);
+void mult(std::size_t n, const float* left, const float* right,
+          float* result);
+
+/// Scaling: <tt>result[i] = arg[i] * factor</tt>
+void scale(std::size_t n, double factor, const double* arg, double* result);
+void scale(std::size_t n, float factor, const float* arg, float* result);
+
+/// Scaled accumulation: <tt>y[i] += alpha * x[i]</tt>
+void axpy(std::size_t n, double alpha, const double* x, double* y);
+void axpy(std::size_t n, float alpha, const float* x, float* y);
+
+/// Dot product: the sum of <tt>left[i] * right[i]</tt>
+double dot(std::size_t n, const double* left, const double* right);
+float dot(std::size_t n, const float* left, const float* right);
+
+/// Absolute maximum: the maximum of <tt>|arg[i]|</tt> , or 0 if \c n is 0
+double abs_max(std::size_t n, const double* arg);
+float abs_max(std::size_t n, const float* arg);
+
+// Complex kernels: the operations above for complex numbers
+
+void add(std::size_t n, const std::complex<double>* left,
+         const std::complex<double>* right, std::complex<double>* result);
+void add(std::size_t n, const std::complex<float>* left,
+         const std::complex<float>* right, std::complex<float>* result);
+
+void subt(std::size_t n, const std::complex<double>* left,
+          const std::complex<double>* right, std::complex<double>* result);
+void subt(std::size_t n, const std::complex<float>* left,
+          const std::complex<float>* right, std::complex<float>* result);
+
+void mult(std::size_t n, const std::complex<double>* left,
+          const std::complex<double>* right, std::complex<double>* result);
+void mult(std::size_t n, const std::complex<float>* left,
+          const std::complex<float>* right, std::complex<float>* result);
+
+void scale(std::size_t n, std::complex<double> factor,
+           const std::complex<double>* arg, std::complex<double>* result);
+void scale(std::size_t n, std::complex<float> factor,
+           const std::complex<float>* arg, std::complex<float>* result);
+void scale(std::size_t n, double factor, const std::complex<double>* arg,
+           std::complex<double>* result);
+void scale(std::size_t n, float factor, const std::complex<float>* arg,
+           std::complex<float>* result);
+
+void axpy(std::size_t n, std::complex<double> alpha,
+          const std::complex<double>* x, std::complex<double>* y);
+void axpy(std::size_t n, std::complex<float> alpha,
+          const std::complex<float>* x, std::complex<float>* y);
+void axpy(std::size_t n, double alpha, const std::complex<double>* x,
+          std::complex<double>* y);
+void axpy(std::size_t n, float alpha, const std::complex<float>* x,
+          std::complex<float>* y);
+
+/// Dot product (not conjugated): the sum of <tt>left[i] * right[i]</tt>
+std::complex<double> dot(std::size_t n, const std::complex<double>* left,
+                         const std::complex<double>* right);
+std::complex<float> dot(std::size_t n, const std::complex<float>* left,
+                        const std::complex<float>* right);
+
+/// Absolute maximum: the maximum modulus of <tt>arg[i]</tt> , or 0 if \c n
+/// is 0
+double abs_max(std::size_t n, const std::complex<double>* arg);
+float abs_max(std::size_t n, const std::complex<float>* arg);
+
+}  // namespace simd
+}  // namespace math
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_MATH_SIMD_H__INCLUDED
@@ -0,0 +1,117 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math/simd_avx2.cpp
+ *  Nov 2, 2020
+ *
+ */
+
+// This file is compiled with AVX2 and FMA enabled; its kernels are only
+// called on CPUs that support them.
+
+#include "simd_kernels.h"
+
+#include <immintrin.h>
+
+namespace TiledArray {
+namespace math {
+namespace simd {
+namespace detail {
+namespace {
+
+struct Avx2Double {
+  typedef double value_type;
+  typedef __m256d register_type;
+  typedef __m256d R;
+  static constexpr std::size_t width = 4ul;
+
+  static R load(const double* const p) { return _mm256_loadu_pd(p); }
+  static void store(double* const p, const R a) { _mm256_storeu_pd(p, a); }
+  static R broadcast(const double x) { return _mm256_set1_pd(x); }
+  static R zero() { return _mm256_setzero_pd(); }
+  static R add(const R a, const R b) { return _mm256_add_pd(a, b); }
+  static R sub(const R a, const R b) { return _mm256_sub_pd(a, b); }
+  static R mul(const R a, const R b) { return _mm256_mul_pd(a, b); }
+  static R fmadd(const R a, const R b, const R c) {
+    return _mm256_fmadd_pd(a, b, c);
+  }
+  static R abs(const R a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+  static R max(const R a, const R b) { return _mm256_max_pd(a, b); }
+  static double reduce_add(const R a) {
+    const __m128d x = _mm_add_pd(_mm256_castpd256_pd128(a),
+                                 _mm256_extractf128_pd(a, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+  }
+  static double reduce_max(const R a) {
+    const __m128d x = _mm_max_pd(_mm256_castpd256_pd128(a),
+                                 _mm256_extractf128_pd(a, 1));
+    return _mm_cvtsd_f64(_mm_max_sd(x, _mm_unpackhi_pd(x, x)));
+  }
+  static R swap_pairs(const R a) { return _mm256_permute_pd(a, 0x5); }
+  static R dup_even(const R a) { return _mm256_movedup_pd(a); }
+  static R dup_odd(const R a) { return _mm256_permute_pd(a, 0xF); }
+};  // struct Avx2Double
+
+struct Avx2Float {
+  typedef float value_type;
+  typedef __m256 register_type;
+  typedef __m256 R;
+  static constexpr std::size_t width = 8ul;
+
+  static R load(const float* const p) { return _mm256_loadu_ps(p); }
+  static void store(float* const p, const R a) { _mm256_storeu_ps(p, a); }
+  static R broadcast(const float x) { return _mm256_set1_ps(x); }
+  static R zero() { return _mm256_setzero_ps(); }
+  static R add(const R a, const R b) { return _mm256_add_ps(a, b); }
+  static R sub(const R a, const R b) { return _mm256_sub_ps(a, b); }
+  static R mul(const R a, const R b) { return _mm256_mul_ps(a, b); }
+  static R fmadd(const R a, const R b, const R c) {
+    return _mm256_fmadd_ps(a, b, c);
+  }
+  static R abs(const R a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+  static R max(const R a, const R b) { return _mm256_max_ps(a, b); }
+  static float reduce_add(const R a) {
+    __m128 x =
+        _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    return _mm_cvtss_f32(_mm_add_ss(x, _mm_movehdup_ps(x)));
+  }
+  static float reduce_max(const R a) {
+    __m128 x =
+        _mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+    return _mm_cvtss_f32(_mm_max_ss(x, _mm_movehdup_ps(x)));
+  }
+  static R swap_pairs(const R a) { return _mm256_permute_ps(a, 0xB1); }
+  static R dup_even(const R a) { return _mm256_moveldup_ps(a); }
+  static R dup_odd(const R a) { return _mm256_movehdup_ps(a); }
+};  // struct Avx2Float
+
+}  // namespace
+
+const Kernels<double>& avx2_kernels(double) {
+  return VectorKernels<Avx2Double>::kernels();
+}
+
+const Kernels<float>& avx2_kernels(float) {
+  return VectorKernels<Avx2Float>::kernels();
+}
+
+}  // namespace detail
+}  // namespace simd
+}  // namespace math
+}  // namespace TiledArray
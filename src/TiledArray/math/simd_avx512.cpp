@@ -0,0 +1,99 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math/simd_avx512.cpp
+ *  Nov 2, 2020
+ *
+ */
+
+// This file is compiled with AVX-512F enabled; its kernels are only called on
+// CPUs that support it.
+
+#include "simd_kernels.h"
+
+#include <immintrin.h>
+
+namespace TiledArray {
+namespace math {
+namespace simd {
+namespace detail {
+namespace {
+
+struct Avx512Double {
+  typedef double value_type;
+  typedef __m512d register_type;
+  typedef __m512d R;
+  static constexpr std::size_t width = 8ul;
+
+  static R load(const double* const p) { return _mm512_loadu_pd(p); }
+  static void store(double* const p, const R a) { _mm512_storeu_pd(p, a); }
+  static R broadcast(const double x) { return _mm512_set1_pd(x); }
+  static R zero() { return _mm512_setzero_pd(); }
+  static R add(const R a, const R b) { return _mm512_add_pd(a, b); }
+  static R sub(const R a, const R b) { return _mm512_sub_pd(a, b); }
+  static R mul(const R a, const R b) { return _mm512_mul_pd(a, b); }
+  static R fmadd(const R a, const R b, const R c) {
+    return _mm512_fmadd_pd(a, b, c);
+  }
+  static R abs(const R a) { return _mm512_abs_pd(a); }
+  static R max(const R a, const R b) { return _mm512_max_pd(a, b); }
+  static double reduce_add(const R a) { return _mm512_reduce_add_pd(a); }
+  static double reduce_max(const R a) { return _mm512_reduce_max_pd(a); }
+  static R swap_pairs(const R a) { return _mm512_permute_pd(a, 0x55); }
+  static R dup_even(const R a) { return _mm512_movedup_pd(a); }
+  static R dup_odd(const R a) { return _mm512_permute_pd(a, 0xFF); }
+};  // struct Avx512Double
+
+struct Avx512Float {
+  typedef float value_type;
+  typedef __m512 register_type;
+  typedef __m512 R;
+  static constexpr std::size_t width = 16ul;
+
+  static R load(const float* const p) { return _mm512_loadu_ps(p); }
+  static void store(float* const p, const R a) { _mm512_storeu_ps(p, a); }
+  static R broadcast(const float x) { return _mm512_set1_ps(x); }
+  static R zero() { return _mm512_setzero_ps(); }
+  static R add(const R a, const R b) { return _mm512_add_ps(a, b); }
+  static R sub(const R a, const R b) { return _mm512_sub_ps(a, b); }
+  static R mul(const R a, const R b) { return _mm512_mul_ps(a, b); }
+  static R fmadd(const R a, const R b, const R c) {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+  static R abs(const R a) { return _mm512_abs_ps(a); }
+  static R max(const R a, const R b) { return _mm512_max_ps(a, b); }
+  static float reduce_add(const R a) { return _mm512_reduce_add_ps(a); }
+  static float reduce_max(const R a) { return _mm512_reduce_max_ps(a); }
+  static R swap_pairs(const R a) { return _mm512_permute_ps(a, 0xB1); }
+  static R dup_even(const R a) { return _mm512_moveldup_ps(a); }
+  static R dup_odd(const R a) { return _mm512_movehdup_ps(a); }
+};  // struct Avx512Float
+
+}  // namespace
+
+const Kernels<double>& avx512_kernels(double) {
+  return VectorKernels<Avx512Double>::kernels();
+}
+
+const Kernels<float>& avx512_kernels(float) {
+  return VectorKernels<Avx512Float>::kernels();
+}
+
+}  // namespace detail
+}  // namespace simd
+}  // namespace math
+}  // namespace TiledArray
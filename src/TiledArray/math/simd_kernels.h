@@ -0,0 +1,285 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math/simd_kernels.h
+ *  Nov 2, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SIMD_KERNELS_H__INCLUDED
+#define TILEDARRAY_MATH_SIMD_KERNELS_H__INCLUDED
+
+#include <cstddef>
+
+// This header is internal to the translation units that implement the
+// kernels of math/simd.h , each of which is compiled for one instruction set.
+
+namespace TiledArray {
+namespace math {
+namespace simd {
+namespace detail {
+
+/// Kernel table of one instruction set
+template <typename T>
+struct Kernels {
+  void (*add)(std::size_t, const T*, const T*, T*);
+  void (*subt)(std::size_t, const T*, const T*, T*);
+  void (*mult)(std::size_t, const T*, const T*, T*);
+  void (*scale)(std::size_t, T, const T*, T*);
+  void (*axpy)(std::size_t, T, const T*, T*);
+  T (*dot)(std::size_t, const T*, const T*);
+  T (*abs_max)(std::size_t, const T*);
+
+  // Kernels for complex numbers, stored as (real, imaginary) pairs; the size
+  // is the number of complex elements
+  void (*cmult)(std::size_t, const T*, const T*, T*);
+  void (*cscale)(std::size_t, T, T, const T*, T*);
+  void (*caxpy)(std::size_t, T, T, const T*, T*);
+  void (*cdot)(std::size_t, const T*, const T*, T*);
+  T (*cnorm_max)(std::size_t, const T*);
+};
+
+#ifdef TILEDARRAY_HAS_SIMD_AVX2
+const Kernels<double>& avx2_kernels(double);
+const Kernels<float>& avx2_kernels(float);
+#endif  // TILEDARRAY_HAS_SIMD_AVX2
+
+#ifdef TILEDARRAY_HAS_SIMD_AVX512
+const Kernels<double>& avx512_kernels(double);
+const Kernels<float>& avx512_kernels(float);
+#endif  // TILEDARRAY_HAS_SIMD_AVX512
+
+// The kernel implementations have internal linkage, so that code compiled
+// for one instruction set is never selected by the linker for another
+// translation unit. For the same reason they do not call inline library
+// functions.
+namespace {
+
+/// Kernels implemented with a vector type
+
+/// \tparam V The vector type, which provides the \c value_type and
+/// \c register_type types, the number of elements in a register,
+/// \c width , and the static register operations \c load , \c store ,
+/// \c broadcast , \c zero , \c add , \c sub , \c mul , \c fmadd (returns
+/// <tt>a * b + c</tt>), \c abs , \c max , \c reduce_add , \c reduce_max ,
+/// and, for complex numbers stored as (real, imaginary) pairs of elements,
+/// \c swap_pairs (swaps the elements of each pair), \c dup_even , and
+/// \c dup_odd (copy the first or second element of each pair to both). The
+/// width must be even.
+template <typename V>
+struct VectorKernels {
+  typedef typename V::value_type T;
+  typedef typename V::register_type R;
+  static constexpr std::size_t width = V::width;
+
+  static T abs(const T x) { return (x < T(0) ? -x : x); }
+  static T max(const T x, const T y) { return (x < y ? y : x); }
+
+  static void add(const std::size_t n, const T* const left,
+                  const T* const right, T* const result) {
+    std::size_t i = 0ul;
+    for (; i + width <= n; i += width)
+      V::store(result + i, V::add(V::load(left + i), V::load(right + i)));
+    for (; i < n; ++i) result[i] = left[i] + right[i];
+  }
+
+  static void subt(const std::size_t n, const T* const left,
+                   const T* const right, T* const result) {
+    std::size_t i = 0ul;
+    for (; i + width <= n; i += width)
+      V::store(result + i, V::sub(V::load(left + i), V::load(right + i)));
+    for (; i < n; ++i) result[i] = left[i] - right[i];
+  }
+
+  static void mult(const std::size_t n, const T* const left,
+                   const T* const right, T* const result) {
+    std::size_t i = 0ul;
+    for (; i + width <= n; i += width)
+      V::store(result + i, V::mul(V::load(left + i), V::load(right + i)));
+    for (; i < n; ++i) result[i] = left[i] * right[i];
+  }
+
+  static void scale(const std::size_t n, const T factor, const T* const arg,
+                    T* const result) {
+    const R f = V::broadcast(factor);
+    std::size_t i = 0ul;
+    for (; i + width <= n; i += width)
+      V::store(result + i, V::mul(V::load(arg + i), f));
+    for (; i < n; ++i) result[i] = arg[i] * factor;
+  }
+
+  static void axpy(const std::size_t n, const T alpha, const T* const x,
+                   T* const y) {
+    const R a = V::broadcast(alpha);
+    std::size_t i = 0ul;
+    for (; i + width <= n; i += width)
+      V::store(y + i, V::fmadd(a, V::load(x + i), V::load(y + i)));
+    for (; i < n; ++i) y[i] += alpha * x[i];
+  }
+
+  static T dot(const std::size_t n, const T* const left,
+               const T* const right) {
+    // Four independent accumulators hide the latency of the additions
+    R sum0 = V::zero(), sum1 = V::zero(), sum2 = V::zero(), sum3 = V::zero();
+    std::size_t i = 0ul;
+    for (; i + 4ul * width <= n; i += 4ul * width) {
+      sum0 = V::fmadd(V::load(left + i), V::load(right + i), sum0);
+      sum1 = V::fmadd(V::load(left + i + width), V::load(right + i + width),
+                      sum1);
+      sum2 = V::fmadd(V::load(left + i + 2ul * width),
+                      V::load(right + i + 2ul * width), sum2);
+      sum3 = V::fmadd(V::load(left + i + 3ul * width),
+                      V::load(right + i + 3ul * width), sum3);
+    }
+    for (; i + width <= n; i += width)
+      sum0 = V::fmadd(V::load(left + i), V::load(right + i), sum0);
+    T result = V::reduce_add(V::add(V::add(sum0, sum1), V::add(sum2, sum3)));
+    for (; i < n; ++i) result += left[i] * right[i];
+    return result;
+  }
+
+  static T abs_max(const std::size_t n, const T* const arg) {
+    R max0 = V::zero(), max1 = V::zero();
+    std::size_t i = 0ul;
+    for (; i + 2ul * width <= n; i += 2ul * width) {
+      max0 = V::max(max0, V::abs(V::load(arg + i)));
+      max1 = V::max(max1, V::abs(V::load(arg + i + width)));
+    }
+    for (; i + width <= n; i += width)
+      max0 = V::max(max0, V::abs(V::load(arg + i)));
+    T result = V::reduce_max(V::max(max0, max1));
+    for (; i < n; ++i) result = max(result, abs(arg[i]));
+    return result;
+  }
+
+  /// A register with the elements -1, 1, -1, 1, ...
+  static R alternate() {
+    T signs[width];
+    for (std::size_t i = 0ul; i < width; ++i) signs[i] = (i & 1ul ? 1 : -1);
+    return V::load(signs);
+  }
+
+  static void cmult(const std::size_t n, const T* const left,
+                    const T* const right, T* const result) {
+    const R sign = alternate();
+    const std::size_t m = 2ul * n;
+    std::size_t i = 0ul;
+    for (; i + width <= m; i += width) {
+      const R a = V::load(left + i);
+      const R b = V::load(right + i);
+      // (ar * br - ai * bi, ai * br + ar * bi)
+      const R t = V::mul(V::mul(V::swap_pairs(a), V::dup_odd(b)), sign);
+      V::store(result + i, V::fmadd(a, V::dup_even(b), t));
+    }
+    for (; i < m; i += 2ul) {
+      const T ar = left[i], ai = left[i + 1ul];
+      const T br = right[i], bi = right[i + 1ul];
+      result[i] = ar * br - ai * bi;
+      result[i + 1ul] = ai * br + ar * bi;
+    }
+  }
+
+  static void cscale(const std::size_t n, const T factor_r, const T factor_i,
+                     const T* const arg, T* const result) {
+    const R re = V::broadcast(factor_r);
+    const R im = V::mul(V::broadcast(factor_i), alternate());
+    const std::size_t m = 2ul * n;
+    std::size_t i = 0ul;
+    for (; i + width <= m; i += width) {
+      const R a = V::load(arg + i);
+      V::store(result + i, V::fmadd(a, re, V::mul(V::swap_pairs(a), im)));
+    }
+    for (; i < m; i += 2ul) {
+      const T ar = arg[i], ai = arg[i + 1ul];
+      result[i] = ar * factor_r - ai * factor_i;
+      result[i + 1ul] = ai * factor_r + ar * factor_i;
+    }
+  }
+
+  static void caxpy(const std::size_t n, const T alpha_r, const T alpha_i,
+                    const T* const x, T* const y) {
+    const R re = V::broadcast(alpha_r);
+    const R im = V::mul(V::broadcast(alpha_i), alternate());
+    const std::size_t m = 2ul * n;
+    std::size_t i = 0ul;
+    for (; i + width <= m; i += width) {
+      const R a = V::load(x + i);
+      V::store(y + i,
+               V::fmadd(a, re, V::fmadd(V::swap_pairs(a), im, V::load(y + i))));
+    }
+    for (; i < m; i += 2ul) {
+      const T xr = x[i], xi = x[i + 1ul];
+      y[i] += xr * alpha_r - xi * alpha_i;
+      y[i + 1ul] += xi * alpha_r + xr * alpha_i;
+    }
+  }
+
+  static void cdot(const std::size_t n, const T* const left,
+                   const T* const right, T* const result) {
+    // (ar * br, ai * bi) and (ar * bi, ai * br) are accumulated separately
+    R products = V::zero(), cross = V::zero();
+    const std::size_t m = 2ul * n;
+    std::size_t i = 0ul;
+    for (; i + width <= m; i += width) {
+      const R a = V::load(left + i);
+      const R b = V::load(right + i);
+      products = V::fmadd(a, b, products);
+      cross = V::fmadd(a, V::swap_pairs(b), cross);
+    }
+    T re = -V::reduce_add(V::mul(products, alternate()));
+    T im = V::reduce_add(cross);
+    for (; i < m; i += 2ul) {
+      const T ar = left[i], ai = left[i + 1ul];
+      const T br = right[i], bi = right[i + 1ul];
+      re += ar * br - ai * bi;
+      im += ar * bi + ai * br;
+    }
+    result[0] = re;
+    result[1] = im;
+  }
+
+  static T cnorm_max(const std::size_t n, const T* const arg) {
+    R max0 = V::zero();
+    const std::size_t m = 2ul * n;
+    std::size_t i = 0ul;
+    for (; i + width <= m; i += width) {
+      const R a = V::load(arg + i);
+      const R squares = V::mul(a, a);
+      max0 = V::max(max0, V::add(squares, V::swap_pairs(squares)));
+    }
+    T result = V::reduce_max(max0);
+    for (; i < m; i += 2ul)
+      result = max(result, arg[i] * arg[i] + arg[i + 1ul] * arg[i + 1ul]);
+    return result;
+  }
+
+  /// The kernel table
+  static const Kernels<T>& kernels() {
+    static const Kernels<T> table = {&add,   &subt,   &mult,  &scale,
+                                     &axpy,  &dot,    &abs_max, &cmult,
+                                     &cscale, &caxpy, &cdot,  &cnorm_max};
+    return table;
+  }
+};  // struct VectorKernels
+
+}  // namespace
+}  // namespace detail
+}  // namespace simd
+}  // namespace math
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_MATH_SIMD_KERNELS_H__INCLUDED
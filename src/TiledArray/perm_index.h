@@ -27,6 +27,7 @@
 #define TILEDARRAY_PERM_INDEX_H__INCLUDED
 
 #include <TiledArray/range.h>
+#include <TiledArray/util/static_rank.h>
 
 namespace TiledArray {
 namespace detail {
@@ -41,6 +42,34 @@ class PermIndex {
   unsigned int
       ndim_;  ///< The number of dimensions in the coordinate index space
 
+  /// Compute the permuted index
+
+  /// \tparam N The number of dimensions, or 0 if it is not known at compile
+  /// time (see \c with_static_rank() )
+  /// \param index The ordinal index to be permuted
+  /// \return The permuted ordinal index
+  template <unsigned int N>
+  std::size_t permute(std::size_t index) const {
+    TA_ASSERT(N == 0u || N == ndim_);
+    const unsigned int ndim = (N ? N : ndim_);
+
+    // Construct MADNESS_RESTRICTed pointers to data
+    const std::size_t* MADNESS_RESTRICT const input_weight = weights_;
+    const std::size_t* MADNESS_RESTRICT const output_weight = weights_ + ndim;
+
+    // create result index
+    std::size_t perm_index = 0ul;
+
+    for (unsigned int i = 0u; i < ndim; ++i) {
+      const std::size_t input_weight_i = input_weight[i];
+      const std::size_t output_weight_i = output_weight[i];
+      perm_index += index / input_weight_i * output_weight_i;
+      index %= input_weight_i;
+    }
+
+    return perm_index;
+  }
+
  public:
   /// Default constructor
   PermIndex() : weights_(NULL), ndim_(0) {}
@@ -141,21 +170,9 @@ class PermIndex {
     TA_ASSERT(ndim_);
     TA_ASSERT(weights_);
 
-    // Construct MADNESS_RESTRICTed pointers to data
-    const std::size_t* MADNESS_RESTRICT const input_weight = weights_;
-    const std::size_t* MADNESS_RESTRICT const output_weight = weights_ + ndim_;
-
-    // create result index
-    std::size_t perm_index = 0ul;
-
-    for (unsigned int i = 0u; i < ndim_; ++i) {
-      const std::size_t input_weight_i = input_weight[i];
-      const std::size_t output_weight_i = output_weight[i];
-      perm_index += index / input_weight_i * output_weight_i;
-      index %= input_weight_i;
-    }
-
-    return perm_index;
+    return with_static_rank(ndim_, [&](auto rank) {
+      return this->permute<decltype(rank)::value>(index);
+    });
   }
 
   // Check for valid permutation
@@ -0,0 +1,313 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  flop_weighted_pmap.h
+ *  Oct 15, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_FLOP_WEIGHTED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_FLOP_WEIGHTED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/layered_cyclic_pmap.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace TiledArray {
+namespace detail {
+
+/// Maps the tiles of a contraction result onto a 2-d process matrix such
+/// that the estimated work of each process is balanced
+
+/// The cyclic distribution used by SUMMA assigns result tile
+/// \f$ C_{ij} \f$ to process \f$ (i \% P_{\rm row}, j \% P_{\rm col}) \f$,
+/// which evaluates all tile contractions that contribute to \f$ C_{ij} \f$.
+/// For block-sparse arguments the work required by each result tile can vary
+/// by orders of magnitude, so some processes may do much more work than
+/// others. This process map keeps the SUMMA phase constraints, i.e. every
+/// tile of a row (column) of the result is held by the same process row
+/// (column), but chooses the process row of each row and the process column
+/// of each column to balance the estimated number of floating point
+/// operations (see \c make_phases() ).
+/// \note This class is used to map <em>tile</em> indices to processes.
+class FlopWeightedPmap : public LayeredCyclicPmap {
+ public:
+  typedef LayeredCyclicPmap::size_type size_type;      ///< Size type
+  typedef LayeredCyclicPmap::phases_type phases_type;  ///< Phases type
+
+  /// Construct process map
+
+  /// \param world The world where the tiles will be mapped
+  /// \param rows The number of tile rows to be mapped
+  /// \param cols The number of tile columns to be mapped
+  /// \param proc_rows The number of rows in the process matrix
+  /// \param proc_cols The number of columns in the process matrix
+  /// \param row_phases The process row of each row; if null, rows are
+  /// distributed cyclically
+  /// \param col_phases The process column of each column; if null, columns
+  /// are distributed cyclically
+  FlopWeightedPmap(World& world, size_type rows, size_type cols,
+                   size_type proc_rows, size_type proc_cols,
+                   const phases_type& row_phases,
+                   const phases_type& col_phases)
+      : LayeredCyclicPmap(world, rows, cols, proc_rows, proc_cols, 1ul,
+                          proc_rows * proc_cols, false, row_phases,
+                          col_phases) {}
+
+  virtual ~FlopWeightedPmap() {}
+
+  /// Flattened tile extents
+
+  /// \tparam TRange The tiled range type
+  /// \param trange The tiled range
+  /// \param first The first dimension to be fused
+  /// \param last The last dimension + 1 to be fused
+  /// \return The element extents of the tiles of the matrix dimension that
+  /// is formed by fusing dimensions [first, last) of \c trange , in
+  /// row-major order
+  template <typename TRange>
+  static std::vector<size_type> fused_extents(const TRange& trange,
+                                              const unsigned int first,
+                                              const unsigned int last) {
+    std::vector<size_type> result(1ul, 1ul);
+    for (unsigned int d = first; d < last; ++d) {
+      const auto& tr1 = trange.data()[d];
+      std::vector<size_type> extents;
+      extents.reserve(result.size() * (tr1.end() - tr1.begin()));
+      for (const size_type extent : result)
+        for (const auto& tile : tr1)
+          extents.push_back(extent * (tile.second - tile.first));
+      result.swap(extents);
+    }
+    return result;
+  }
+
+  /// Work weights of the rows of a contraction argument
+
+  /// For each row \f$ i \f$ of the left-hand argument, computes
+  /// \f$ m_i \sum_k \delta_{ik} k_k \f$, where \f$ \delta_{ik} \f$ is zero if
+  /// tile \f$ A_{ik} \f$ is zero and one otherwise.
+  /// \tparam Shape The shape type
+  /// \param shape The shape of the left-hand argument, a matrix of tiles
+  /// \param row_extents The element extents of the tile rows
+  /// \param inner_extents The element extents of the tile columns
+  /// \return The work weight of each row
+  template <typename Shape>
+  static std::vector<double> row_weights(
+      const Shape& shape, const std::vector<size_type>& row_extents,
+      const std::vector<size_type>& inner_extents) {
+    const size_type rows = row_extents.size();
+    const size_type inner = inner_extents.size();
+    std::vector<double> result(rows, 0.0);
+    for (size_type i = 0ul, ik = 0ul; i < rows; ++i) {
+      double weight = 0.0;
+      for (size_type k = 0ul; k < inner; ++k, ++ik)
+        if (!shape.is_zero(ik)) weight += inner_extents[k];
+      result[i] = weight * row_extents[i];
+    }
+    return result;
+  }
+
+  /// Work weights of the columns of a contraction argument
+
+  /// For each column \f$ j \f$ of the right-hand argument, computes
+  /// \f$ n_j \sum_k \delta_{kj} k_k \f$, where \f$ \delta_{kj} \f$ is zero
+  /// if tile \f$ B_{kj} \f$ is zero and one otherwise.
+  /// \tparam Shape The shape type
+  /// \param shape The shape of the right-hand argument, a matrix of tiles
+  /// \param inner_extents The element extents of the tile rows
+  /// \param col_extents The element extents of the tile columns
+  /// \return The work weight of each column
+  template <typename Shape>
+  static std::vector<double> col_weights(
+      const Shape& shape, const std::vector<size_type>& inner_extents,
+      const std::vector<size_type>& col_extents) {
+    const size_type inner = inner_extents.size();
+    const size_type cols = col_extents.size();
+    std::vector<double> result(cols, 0.0);
+    for (size_type k = 0ul, kj = 0ul; k < inner; ++k)
+      for (size_type j = 0ul; j < cols; ++j, ++kj)
+        if (!shape.is_zero(kj)) result[j] += inner_extents[k];
+    for (size_type j = 0ul; j < cols; ++j) result[j] *= col_extents[j];
+    return result;
+  }
+
+  /// Compute the row and column phases that balance the contraction work
+
+  /// The work required by result tile \f$ C_{ij} \f$ is estimated as
+  /// \f$ w_i v_j \f$, where \f$ w_i \f$ and \f$ v_j \f$ are the row and
+  /// column weights (see \c row_weights() and \c col_weights() ), or zero
+  /// if \f$ C_{ij} \f$ is zero. Starting from the cyclic distribution, the
+  /// rows are assigned to process rows with the column phases fixed, and
+  /// then the columns are assigned to process columns with the row phases
+  /// fixed; each assignment is done greedily, heaviest first, to the process
+  /// row (column) that minimizes the maximum work of its processes.
+  /// \tparam ZeroOp The result shape test type
+  /// \param proc_rows The number of rows in the process matrix
+  /// \param proc_cols The number of columns in the process matrix
+  /// \param row_weights The work weight of each row
+  /// \param col_weights The work weight of each column
+  /// \param is_zero A function, <tt>bool(size_type i, size_type j)</tt>,
+  /// that returns \c true if result tile \f$ C_{ij} \f$ is zero
+  /// \return The pair of row and column phases; both are null if the
+  /// balanced distribution does not reduce the maximum work of the cyclic
+  /// distribution by at least 5%
+  template <typename ZeroOp>
+  static std::pair<phases_type, phases_type> make_phases(
+      const size_type proc_rows, const size_type proc_cols,
+      const std::vector<double>& row_weights,
+      const std::vector<double>& col_weights, const ZeroOp& is_zero) {
+    TA_ASSERT(proc_rows >= 1ul);
+    TA_ASSERT(proc_cols >= 1ul);
+    const size_type rows = row_weights.size();
+    const size_type cols = col_weights.size();
+
+    // Start with the cyclic distribution
+    std::vector<size_type> row_phases(rows), col_phases(cols);
+    for (size_type i = 0ul; i < rows; ++i) row_phases[i] = i % proc_rows;
+    for (size_type j = 0ul; j < cols; ++j) col_phases[j] = j % proc_cols;
+    const double cyclic_work = max_work(proc_rows, proc_cols, row_weights,
+                                        col_weights, row_phases, col_phases,
+                                        is_zero);
+
+    for (unsigned int pass = 0u; pass < 2u; ++pass) {
+      assign_phases(proc_rows, proc_cols, row_weights, col_weights,
+                    col_phases, is_zero, row_phases);
+      assign_phases(proc_cols, proc_rows, col_weights, row_weights,
+                    row_phases,
+                    [&](const size_type j, const size_type i) {
+                      return is_zero(i, j);
+                    },
+                    col_phases);
+    }
+
+    const double balanced_work =
+        max_work(proc_rows, proc_cols, row_weights, col_weights, row_phases,
+                 col_phases, is_zero);
+    if (!(balanced_work < 0.95 * cyclic_work))
+      return std::pair<phases_type, phases_type>();
+
+    return std::make_pair(
+        std::make_shared<const std::vector<size_type> >(std::move(row_phases)),
+        std::make_shared<const std::vector<size_type> >(std::move(col_phases)));
+  }
+
+ private:
+  /// Maximum work of a process
+
+  /// \return The maximum estimated work assigned to a single process
+  template <typename ZeroOp>
+  static double max_work(const size_type proc_rows, const size_type proc_cols,
+                         const std::vector<double>& row_weights,
+                         const std::vector<double>& col_weights,
+                         const std::vector<size_type>& row_phases,
+                         const std::vector<size_type>& col_phases,
+                         const ZeroOp& is_zero) {
+    std::vector<double> work(proc_rows * proc_cols, 0.0);
+    for (size_type i = 0ul; i < row_weights.size(); ++i) {
+      double* MADNESS_RESTRICT const work_i =
+          work.data() + row_phases[i] * proc_cols;
+      for (size_type j = 0ul; j < col_weights.size(); ++j)
+        if (!is_zero(i, j))
+          work_i[col_phases[j]] += row_weights[i] * col_weights[j];
+    }
+    return *std::max_element(work.begin(), work.end());
+  }
+
+  /// Assign the rows of a matrix to process rows
+
+  /// The columns of the matrix are fixed to the process columns given by
+  /// \c col_phases . Rows are sorted by decreasing work and each is assigned
+  /// to the process row that minimizes the maximum work of its processes;
+  /// ties are broken in favor of the process row with the fewest rows.
+  /// \param proc_rows The number of rows in the process matrix
+  /// \param proc_cols The number of columns in the process matrix
+  /// \param row_weights The work weight of each row
+  /// \param col_weights The work weight of each column
+  /// \param col_phases The process column of each column
+  /// \param is_zero A function, <tt>bool(size_type i, size_type j)</tt>,
+  /// that returns \c true if tile \f$ (i,j) \f$ is zero
+  /// \param[out] row_phases The process row of each row
+  template <typename ZeroOp>
+  static void assign_phases(const size_type proc_rows,
+                            const size_type proc_cols,
+                            const std::vector<double>& row_weights,
+                            const std::vector<double>& col_weights,
+                            const std::vector<size_type>& col_phases,
+                            const ZeroOp& is_zero,
+                            std::vector<size_type>& row_phases) {
+    const size_type rows = row_weights.size();
+
+    // Compute the work of each row on each process column
+    std::vector<double> row_work(rows * proc_cols, 0.0);
+    std::vector<double> row_total(rows, 0.0);
+    for (size_type i = 0ul; i < rows; ++i) {
+      double* MADNESS_RESTRICT const row_work_i =
+          row_work.data() + i * proc_cols;
+      for (size_type j = 0ul; j < col_weights.size(); ++j) {
+        if (is_zero(i, j)) continue;
+        const double work = row_weights[i] * col_weights[j];
+        row_work_i[col_phases[j]] += work;
+        row_total[i] += work;
+      }
+    }
+
+    // Sort rows by decreasing work
+    std::vector<size_type> order(rows);
+    std::iota(order.begin(), order.end(), size_type(0));
+    std::stable_sort(order.begin(), order.end(),
+                     [&](const size_type left, const size_type right) {
+                       return row_total[left] > row_total[right];
+                     });
+
+    // Greedily assign rows to process rows
+    std::vector<double> work(proc_rows * proc_cols, 0.0);
+    std::vector<size_type> count(proc_rows, 0ul);
+    for (const size_type i : order) {
+      const double* MADNESS_RESTRICT const row_work_i =
+          row_work.data() + i * proc_cols;
+      size_type best = 0ul;
+      double best_work = std::numeric_limits<double>::max();
+      for (size_type p = 0ul; p < proc_rows; ++p) {
+        const double* MADNESS_RESTRICT const work_p =
+            work.data() + p * proc_cols;
+        double max_work = 0.0;
+        for (size_type q = 0ul; q < proc_cols; ++q)
+          max_work = std::max(max_work, work_p[q] + row_work_i[q]);
+        if ((max_work < best_work) ||
+            ((max_work == best_work) && (count[p] < count[best]))) {
+          best = p;
+          best_work = max_work;
+        }
+      }
+
+      double* MADNESS_RESTRICT const work_best =
+          work.data() + best * proc_cols;
+      for (size_type q = 0ul; q < proc_cols; ++q) work_best[q] += row_work_i[q];
+      ++count[best];
+      row_phases[i] = best;
+    }
+  }
+
+};  // class FlopWeightedPmap
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_PMAP_FLOP_WEIGHTED_PMAP_H__INCLUDED
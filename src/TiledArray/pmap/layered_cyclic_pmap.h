@@ -0,0 +1,271 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  layered_cyclic_pmap.h
+ *  Oct 15, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+namespace detail {
+
+/// Maps a matrix of indices onto a stack of 2-d process matrices
+
+/// The process set is divided into \c layers consecutive blocks of
+/// \c layer_stride processes. Each block (layer) holds a \f$ P_{\rm row}
+/// \times P_{\rm col} \f$ process matrix. The rows (or columns) of the index
+/// matrix are split into \c layers contiguous, balanced blocks, and block
+/// \f$ l \f$ is distributed cyclically, as in \c CyclicPmap, over the process
+/// matrix of layer \f$ l \f$. Index \f$ \{ k_{\rm row}, k_{\rm col} \} \f$
+/// therefore maps to process
+/// \f$ l \cdot {\rm layer\_stride} + (k_{\rm row} \% P_{\rm row}) P_{\rm col}
+/// + k_{\rm col} \% P_{\rm col} \f$.
+///
+/// The cyclic row and/or column phases may be replaced by explicit phases,
+/// i.e. lists of the process row (column) of each index row (column), as
+/// long as all indices of a row (column) map to the same process row
+/// (column).
+///
+/// This map is used to distribute the arguments of a communication-avoiding
+/// (2.5D) SUMMA, where each layer handles a contiguous block of the inner
+/// (contracted) dimension, and the arguments of SUMMA with non-cyclic
+/// phases (see \c FlopWeightedPmap ).
+/// \note This class is used to map <em>tile</em> indices to processes.
+class LayeredCyclicPmap : public Pmap {
+ protected:
+  // Import Pmap protected variables
+  using Pmap::local_;  ///< The list of local tiles
+  using Pmap::procs_;  ///< The number of processes
+  using Pmap::rank_;   ///< The rank of this process
+  using Pmap::size_;   ///< The number of tiles mapped among all processes
+
+ private:
+  const size_type rows_;          ///< Number of tile rows to be mapped
+  const size_type cols_;          ///< Number of tile columns to be mapped
+  const size_type proc_rows_;     ///< Number of process rows in a layer
+  const size_type proc_cols_;     ///< Number of process columns in a layer
+  const size_type layers_;        ///< Number of process layers
+  const size_type layer_stride_;  ///< Number of processes per layer
+  const bool split_cols_;  ///< \c true if columns are split among layers,
+                           ///< otherwise rows are split
+
+ public:
+  typedef Pmap::size_type size_type;  ///< Size type
+  typedef std::shared_ptr<const std::vector<size_type> >
+      phases_type;  ///< Explicit row or column phases
+
+ private:
+  const phases_type row_phases_;  ///< Process row of each row (null = cyclic)
+  const phases_type col_phases_;  ///< Process column of each column
+                                  ///< (null = cyclic)
+
+ public:
+  /// First index of a layer block
+
+  /// Splits \c n indices into \c layers contiguous blocks whose sizes differ
+  /// by at most one.
+  /// \param n The number of indices to be split
+  /// \param layers The number of layers
+  /// \param layer The layer index
+  /// \return The first index of the block that belongs to \c layer
+  static size_type layer_begin(const size_type n, const size_type layers,
+                               const size_type layer) {
+    TA_ASSERT(layers > 0ul);
+    TA_ASSERT(layer <= layers);
+    return layer * (n / layers) + std::min(layer, n % layers);
+  }
+
+  /// Layer that owns an index
+
+  /// \param n The number of indices that are split among layers
+  /// \param layers The number of layers
+  /// \param k The index to be queried
+  /// \return The layer that owns index \c k
+  static size_type layer_of(const size_type n, const size_type layers,
+                            const size_type k) {
+    TA_ASSERT(layers > 0ul);
+    TA_ASSERT(k < n);
+    const size_type block = n / layers;
+    const size_type remainder = n % layers;
+    const size_type fence = remainder * (block + 1ul);
+    return (k < fence ? k / (block + 1ul) : remainder + (k - fence) / block);
+  }
+
+  /// Construct process map
+
+  /// \param world The world where the tiles will be mapped
+  /// \param rows The number of tile rows to be mapped
+  /// \param cols The number of tile columns to be mapped
+  /// \param proc_rows The number of process rows in each layer
+  /// \param proc_cols The number of process columns in each layer
+  /// \param layers The number of process layers
+  /// \param layer_stride The number of processes in each layer
+  /// \param split_cols If \c true the columns of the index matrix are split
+  /// among layers, otherwise the rows are split
+  /// \param row_phases The process row of each row; if null, rows are
+  /// distributed cyclically
+  /// \param col_phases The process column of each column; if null, columns
+  /// are distributed cyclically
+  /// \throw TiledArray::Exception When <tt>proc_rows * proc_cols >
+  /// layer_stride</tt>
+  /// \throw TiledArray::Exception When <tt>layers * layer_stride >
+  /// world.size()</tt>
+  LayeredCyclicPmap(World& world, size_type rows, size_type cols,
+                    size_type proc_rows, size_type proc_cols, size_type layers,
+                    size_type layer_stride, bool split_cols,
+                    const phases_type& row_phases = phases_type(),
+                    const phases_type& col_phases = phases_type())
+      : Pmap(world, rows * cols),
+        rows_(rows),
+        cols_(cols),
+        proc_rows_(proc_rows),
+        proc_cols_(proc_cols),
+        layers_(layers),
+        layer_stride_(layer_stride),
+        split_cols_(split_cols),
+        row_phases_(row_phases),
+        col_phases_(col_phases) {
+    // Check that the size is non-zero
+    TA_ASSERT(rows_ >= 1ul);
+    TA_ASSERT(cols_ >= 1ul);
+
+    // Check limits of the process layers
+    TA_ASSERT(proc_rows_ >= 1ul);
+    TA_ASSERT(proc_cols_ >= 1ul);
+    TA_ASSERT(layers_ >= 1ul);
+    TA_ASSERT((proc_rows_ * proc_cols_) <= layer_stride_);
+    TA_ASSERT((layers_ * layer_stride_) <= procs_);
+    TA_ASSERT(layers_ <= (split_cols_ ? cols_ : rows_));
+    TA_ASSERT(!row_phases_ || (row_phases_->size() == rows_));
+    TA_ASSERT(!col_phases_ || (col_phases_->size() == cols_));
+
+    // Compute the list of local tiles, if any
+    const size_type layer = rank_ / layer_stride_;
+    const size_type layer_rank = rank_ % layer_stride_;
+    if ((layer < layers_) && (layer_rank < (proc_rows_ * proc_cols_))) {
+      const size_type rank_row = layer_rank / proc_cols_;
+      const size_type rank_col = layer_rank % proc_cols_;
+
+      // Compute the row and column ranges held by this layer
+      size_type row_begin = 0ul, row_end = rows_, col_begin = 0ul,
+                col_end = cols_;
+      if (split_cols_) {
+        col_begin = layer_begin(cols_, layers_, layer);
+        col_end = layer_begin(cols_, layers_, layer + 1ul);
+      } else {
+        row_begin = layer_begin(rows_, layers_, layer);
+        row_end = layer_begin(rows_, layers_, layer + 1ul);
+      }
+
+      // Collect the rows and columns with the phase of this process
+      std::vector<size_type> local_cols;
+      for (size_type col = col_begin; col < col_end; ++col)
+        if (col_phase(col) == rank_col) local_cols.push_back(col);
+
+      for (size_type row = row_begin; row < row_end; ++row)
+        if (row_phase(row) == rank_row)
+          for (const size_type col : local_cols)
+            local_.push_back(row * cols_ + col);
+    }
+    this->local_size_ = local_.size();
+  }
+
+  virtual ~LayeredCyclicPmap() {}
+
+  /// Access number of rows in the tile index matrix
+  size_type nrows() const { return rows_; }
+  /// Access number of columns in the tile index matrix
+  size_type ncols() const { return cols_; }
+  /// Access number of rows in the process matrix of each layer
+  size_type nrows_proc() const { return proc_rows_; }
+  /// Access number of columns in the process matrix of each layer
+  size_type ncols_proc() const { return proc_cols_; }
+  /// Access number of process layers
+  size_type nlayers() const { return layers_; }
+
+  /// Process row of a row
+
+  /// \param row The row to be queried
+  /// \return The row of the process matrix that holds \c row
+  size_type row_phase(const size_type row) const {
+    TA_ASSERT(row < rows_);
+    return (row_phases_ ? (*row_phases_)[row] : row % proc_rows_);
+  }
+
+  /// Process column of a column
+
+  /// \param col The column to be queried
+  /// \return The column of the process matrix that holds \c col
+  size_type col_phase(const size_type col) const {
+    TA_ASSERT(col < cols_);
+    return (col_phases_ ? (*col_phases_)[col] : col % proc_cols_);
+  }
+
+  /// Maps \c tile to the processor that owns it
+
+  /// \param tile The tile to be queried
+  /// \return Processor that logically owns \c tile
+  virtual size_type owner(const size_type tile) const {
+    TA_ASSERT(tile < size_);
+    // Compute tile coordinate in tile grid
+    const size_type tile_row = tile / cols_;
+    const size_type tile_col = tile % cols_;
+    // Compute the layer that holds the tile
+    const size_type layer =
+        (split_cols_ ? layer_of(cols_, layers_, tile_col)
+                     : layer_of(rows_, layers_, tile_row));
+    // Compute the process that owns tile
+    const size_type proc = layer * layer_stride_ +
+                           row_phase(tile_row) * proc_cols_ +
+                           col_phase(tile_col);
+
+    TA_ASSERT(proc < procs_);
+
+    return proc;
+  }
+
+  /// Check that the tile is owned by this process
+
+  /// \param tile The tile to be checked
+  /// \return \c true if \c tile is owned by this process, otherwise \c false .
+  virtual bool is_local(const size_type tile) const {
+    return (LayeredCyclicPmap::owner(tile) == rank_);
+  }
+
+  virtual const_iterator begin() const {
+    return local_.empty() ? Iterator(*this, 0, size_, size_, false)
+                          : Iterator(*this, local_.begin());
+  }
+  virtual const_iterator end() const {
+    return local_.empty() ? Iterator(*this, 0, size_, size_, false)
+                          : Iterator(*this, local_.end());
+  }
+
+};  // class LayeredCyclicPmap
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
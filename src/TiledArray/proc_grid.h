@@ -28,6 +28,8 @@
 
 #include <TiledArray/math/eigen.h>
 #include <TiledArray/pmap/cyclic_pmap.h>
+#include <TiledArray/pmap/flop_weighted_pmap.h>
+#include <TiledArray/pmap/layered_cyclic_pmap.h>
 
 namespace TiledArray {
 namespace detail {
@@ -56,9 +58,30 @@ namespace detail {
 /// \f]
 /// where the positive, real root of \f$P_{\rm{row}}\f$ give the optimal
 /// optimal communication time.
+///
+/// The process grid may also be replicated over \f$c\f$ layers for
+/// communication-avoiding (2.5D) SUMMA. In that case the processes are split
+/// into \f$c\f$ consecutive blocks of \f$P/c\f$ processes, each holding a 2D
+/// grid optimized as above, and layer \f$l\f$ handles a contiguous block of
+/// the inner dimension of the contraction. Broadcasts are confined to a layer
+/// and involve \f$1/c\f$ of the SUMMA iterations, at the cost of holding
+/// \f$c\f$ partial copies of the result that must be reduced at the end.
+///
+/// The number of process rows of each layer may also be fixed. With a
+/// single process row (column) the right-hand (left-hand) argument of the
+/// contraction is never broadcast, i.e. it remains stationary while the
+/// other argument and the partial results move (see \c ContEngine ).
+///
+/// By default tile row \f$i\f$ and column \f$j\f$ are held by process row
+/// \f$i \% P_{\rm{row}}\f$ and column \f$j \% P_{\rm{col}}\f$,
+/// respectively. These phases may be replaced by explicit row and column
+/// phases (see \c set_phases() ), e.g. to balance the work of a block-sparse
+/// contraction (see \c FlopWeightedPmap ).
 class ProcGrid {
  public:
   typedef uint_fast32_t size_type;
+  typedef LayeredCyclicPmap::phases_type
+      phases_type;  ///< Explicit row or column phases
 
  private:
   World* world_;         ///< The world where this process grid lives
@@ -75,6 +98,11 @@ class ProcGrid {
   size_type local_rows_;  ///< The number of local element rows
   size_type local_cols_;  ///< The number of local element columns
   size_type local_size_;  ///< Number of local elements
+  size_type layers_;      ///< Number of process grid layers
+  size_type layer_stride_;  ///< Number of processes in each layer
+  ProcessID rank_layer_;    ///< This process's layer
+  phases_type row_phases_;  ///< Process row of each row (null = cyclic)
+  phases_type col_phases_;  ///< Process column of each column (null = cyclic)
 
   /// Compute the number of process rows that minimizes communication
 
@@ -170,9 +198,12 @@ class ProcGrid {
   /// Member variable initialization
 
   /// This function initializes the member variables with with the optimal
-  /// sizes.
+  /// sizes, unless the number of process rows is given.
+  /// \param proc_rows The number of process rows; if zero, the number of
+  /// process rows is optimized
   void init(const size_type rank, const size_type nprocs,
-            const std::size_t row_size, const std::size_t col_size) {
+            const std::size_t row_size, const std::size_t col_size,
+            const size_type proc_rows) {
     // Check for the simple cases first ...
     if (nprocs == 1u) {  // Only one process
 
@@ -190,6 +221,26 @@ class ProcGrid {
       local_cols_ = cols_;
       local_size_ = size_;
 
+    } else if (proc_rows > 0u) {  // Fixed number of process rows
+
+      // Set process grid sizes
+      proc_rows_ = std::min<size_type>(std::min(proc_rows, nprocs), rows_);
+      proc_cols_ = std::min<size_type>(nprocs / proc_rows_, cols_);
+      proc_size_ = proc_rows_ * proc_cols_;
+
+      if (rank < proc_size_) {
+        // Set this process rank
+        rank_row_ = rank / proc_cols_;
+        rank_col_ = rank % proc_cols_;
+
+        // Set local counts
+        local_rows_ = (rows_ / proc_rows_) +
+                      (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
+        local_cols_ = (cols_ / proc_cols_) +
+                      (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
+        local_size_ = local_rows_ * local_cols_;
+      }
+
     } else if (size_ <= nprocs) {  // Max one tile per process
 
       // Set process grid sizes
@@ -247,6 +298,44 @@ class ProcGrid {
     }
   }
 
+  /// Process offset of this process's layer
+
+  /// \return The first process of the layer that includes this process
+  size_type layer_offset() const {
+    return (rank_layer_ > 0 ? rank_layer_ * layer_stride_ : 0u);
+  }
+
+  /// Member variable initialization for a layered process grid
+
+  /// The processes are divided into \c layers blocks and the 2D process grid
+  /// of each layer is initialized with \c init() .
+  void init(const size_type rank, const size_type nprocs,
+            const std::size_t row_size, const std::size_t col_size,
+            const size_type layers, const size_type proc_rows) {
+    TA_ASSERT(layers >= 1u);
+    TA_ASSERT(layers <= nprocs);
+
+    layers_ = layers;
+    layer_stride_ = nprocs / layers;
+    const size_type layer = rank / layer_stride_;
+
+    if (layer < layers_) {
+      rank_layer_ = layer;
+      init(rank % layer_stride_, layer_stride_, row_size, col_size,
+           proc_rows);
+    } else {
+      // This process is not included in any layer, but the process grid
+      // dimensions are still needed.
+      init(layer_stride_, layer_stride_, row_size, col_size, proc_rows);
+      rank_layer_ = -1;
+      rank_row_ = -1;
+      rank_col_ = -1;
+      local_rows_ = 0u;
+      local_cols_ = 0u;
+      local_size_ = 0u;
+    }
+  }
+
  public:
   /// Default constructor
 
@@ -263,7 +352,12 @@ class ProcGrid {
         rank_col_(0),
         local_rows_(0u),
         local_cols_(0u),
-        local_size_(0u) {}
+        local_size_(0u),
+        layers_(1u),
+        layer_stride_(0u),
+        rank_layer_(0),
+        row_phases_(),
+        col_phases_() {}
 
   /// Construct a process grid
 
@@ -275,8 +369,13 @@ class ProcGrid {
   /// \param cols The number of tile columns
   /// \param row_size The number of element rows
   /// \param col_size The number of element columns
+  /// \param layers The number of process grid layers (default = 1)
+  /// \param proc_rows The number of process rows of each layer, which is
+  /// limited by \c rows and the number of processes per layer; if zero, the
+  /// number of process rows is optimized (default = 0)
   ProcGrid(World& world, const size_type rows, const size_type cols,
-           const std::size_t row_size, const std::size_t col_size)
+           const std::size_t row_size, const std::size_t col_size,
+           const size_type layers = 1u, const size_type proc_rows = 0u)
       : world_(&world),
         rows_(rows),
         cols_(cols),
@@ -288,14 +387,20 @@ class ProcGrid {
         rank_col_(-1),
         local_rows_(0ul),
         local_cols_(0ul),
-        local_size_(0ul) {
+        local_size_(0ul),
+        layers_(1u),
+        layer_stride_(0u),
+        rank_layer_(-1),
+        row_phases_(),
+        col_phases_() {
     // Check for non-zero sizes
     TA_ASSERT(rows_ >= 1u);
     TA_ASSERT(cols_ >= 1u);
     TA_ASSERT(row_size >= 1ul);
     TA_ASSERT(col_size >= 1ul);
 
-    init(world_->rank(), world_->size(), row_size, col_size);
+    init(world_->rank(), world_->size(), row_size, col_size, layers,
+         proc_rows);
   }
 
 #ifdef TILEDARRAY_ENABLE_TEST_PROC_GRID
@@ -315,9 +420,13 @@ class ProcGrid {
   /// \param cols The number of tile columns
   /// \param row_size The number of element rows
   /// \param col_size The number of element columns
+  /// \param layers The number of process grid layers (default = 1)
+  /// \param proc_rows The number of process rows of each layer; if zero,
+  /// the number of process rows is optimized (default = 0)
   ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
            const size_type rows, const size_type cols,
-           const std::size_t row_size, const std::size_t col_size)
+           const std::size_t row_size, const std::size_t col_size,
+           const size_type layers = 1u, const size_type proc_rows = 0u)
       : world_(&world),
         rows_(rows),
         cols_(cols),
@@ -329,7 +438,12 @@ class ProcGrid {
         rank_col_(-1),
         local_rows_(0u),
         local_cols_(0u),
-        local_size_(0u) {
+        local_size_(0u),
+        layers_(1u),
+        layer_stride_(0u),
+        rank_layer_(-1),
+        row_phases_(),
+        col_phases_() {
     // Check for non-zero sizes
     TA_ASSERT(rows >= 1u);
     TA_ASSERT(cols >= 1u);
@@ -337,7 +451,7 @@ class ProcGrid {
     TA_ASSERT(col_size >= 1u);
     TA_ASSERT(test_rank < test_nprocs);
 
-    init(test_rank, test_nprocs, row_size, col_size);
+    init(test_rank, test_nprocs, row_size, col_size, layers, proc_rows);
   }
 #endif  // TILEDARRAY_ENABLE_TEST_PROC_GRID
 
@@ -359,7 +473,12 @@ class ProcGrid {
         rank_col_(other.rank_col_),
         local_rows_(other.local_rows_),
         local_cols_(other.local_cols_),
-        local_size_(other.local_size_) {}
+        local_size_(other.local_size_),
+        layers_(other.layers_),
+        layer_stride_(other.layer_stride_),
+        rank_layer_(other.rank_layer_),
+        row_phases_(other.row_phases_),
+        col_phases_(other.col_phases_) {}
 
   /// Copy assignment operator
 
@@ -377,6 +496,11 @@ class ProcGrid {
     local_rows_ = other.local_rows_;
     local_cols_ = other.local_cols_;
     local_size_ = other.local_size_;
+    layers_ = other.layers_;
+    layer_stride_ = other.layer_stride_;
+    rank_layer_ = other.rank_layer_;
+    row_phases_ = other.row_phases_;
+    col_phases_ = other.col_phases_;
 
     return *this;
   }
@@ -437,6 +561,89 @@ class ProcGrid {
   /// less than the number of process in world).
   size_type proc_size() const { return proc_size_; }
 
+  /// Process grid layer count accessor
+
+  /// \return The number of process grid layers
+  size_type layers() const { return layers_; }
+
+  /// Layer stride accessor
+
+  /// \return The number of processes assigned to each layer; the process
+  /// grid of layer \c l starts at process <tt>l * layer_stride()</tt>
+  size_type layer_stride() const { return layer_stride_; }
+
+  /// Rank layer accessor
+
+  /// \return The layer of this process, or -1 if this process is not
+  /// included in any layer
+  ProcessID rank_layer() const { return rank_layer_; }
+
+  /// Inner dimension range of this process's layer
+
+  /// \param k The number of tiles in the inner dimension of the contraction
+  /// \return The pair <tt>{begin, end}</tt> of inner tile indices that are
+  /// handled by the layer of this process
+  std::pair<size_type, size_type> layer_range(const size_type k) const {
+    if (rank_layer_ < 0) return {0u, 0u};
+    return {LayeredCyclicPmap::layer_begin(k, layers_, rank_layer_),
+            LayeredCyclicPmap::layer_begin(k, layers_, rank_layer_ + 1)};
+  }
+
+  /// Set the row and column phases of the process grid
+
+  /// \param row_phases The process row of each row; if null, rows are
+  /// distributed cyclically
+  /// \param col_phases The process column of each column; if null, columns
+  /// are distributed cyclically
+  void set_phases(const phases_type& row_phases,
+                  const phases_type& col_phases) {
+    TA_ASSERT(!row_phases || (row_phases->size() == rows_));
+    TA_ASSERT(!col_phases || (col_phases->size() == cols_));
+
+    row_phases_ = row_phases;
+    col_phases_ = col_phases;
+
+    // Recompute the local counts
+    if ((rank_row_ >= 0) && (rank_col_ >= 0)) {
+      local_rows_ = 0u;
+      for (size_type row = 0u; row < rows_; ++row)
+        if (row_phase(row) == size_type(rank_row_)) ++local_rows_;
+      local_cols_ = 0u;
+      for (size_type col = 0u; col < cols_; ++col)
+        if (col_phase(col) == size_type(rank_col_)) ++local_cols_;
+      local_size_ = local_rows_ * local_cols_;
+    }
+  }
+
+  /// Process row of a row
+
+  /// \param row The row to be queried
+  /// \return The row of the process grid that holds \c row
+  size_type row_phase(const size_type row) const {
+    TA_ASSERT(row < rows_);
+    return (row_phases_ ? (*row_phases_)[row] : row % proc_rows_);
+  }
+
+  /// Process column of a column
+
+  /// \param col The column to be queried
+  /// \return The column of the process grid that holds \c col
+  size_type col_phase(const size_type col) const {
+    TA_ASSERT(col < cols_);
+    return (col_phases_ ? (*col_phases_)[col] : col % proc_cols_);
+  }
+
+  /// Map a layer to the process with the same grid coordinate as this process
+
+  /// \param layer The layer to be mapped
+  /// \return The process that corresponds to the process coordinate
+  /// \c (rank_row,rank_col) in \c layer
+  ProcessID map_layer(const size_type layer) const {
+    TA_ASSERT(layer < layers_);
+    TA_ASSERT(rank_layer_ >= 0);
+    return layer * layer_stride_ + rank_row_ * proc_cols_ + rank_col_;
+  }
+
   /// Construct a row group
 
   /// \param did The distributed id for the result group
@@ -452,7 +659,7 @@ class ProcGrid {
       proc_list.reserve(proc_cols_);
 
       // Populate the row process list
-      size_type p = rank_row_ * proc_cols_;
+      size_type p = layer_offset() + rank_row_ * proc_cols_;
       const size_type row_end = p + proc_cols_;
       for (; p < row_end; ++p) proc_list.push_back(p);
 
@@ -478,8 +685,9 @@ class ProcGrid {
       proc_list.reserve(proc_rows_);
 
       // Populate the column process list
+      const size_type offset = layer_offset();
       for (size_type p = rank_col_; p < proc_size_; p += proc_cols_)
-        proc_list.push_back(p);
+        proc_list.push_back(offset + p);
 
       // Construct the group
       if (proc_list.size() != 0)
@@ -496,7 +704,7 @@ class ProcGrid {
   /// (row,rank_col)
   ProcessID map_row(const size_type row) const {
     TA_ASSERT(row < proc_rows_);
-    return rank_col_ + row * proc_cols_;
+    return layer_offset() + rank_col_ + row * proc_cols_;
   }
 
   /// Map a column to the process in this process's row
@@ -506,16 +714,23 @@ class ProcGrid {
   /// (rank_row,col)
   ProcessID map_col(const size_type col) const {
     TA_ASSERT(col < proc_cols_);
-    return rank_row_ * proc_cols_ + col;
+    return layer_offset() + rank_row_ * proc_cols_ + col;
   }
 
   /// Construct a cyclic process
 
   /// Construct a cyclic process map with the same phase as the process grid.
+  /// If explicit phases were set, a \c FlopWeightedPmap with these phases is
+  /// constructed instead.
   /// \return Cyclic process map
   std::shared_ptr<Pmap> make_pmap() const {
     TA_ASSERT(world_);
 
+    if (row_phases_ || col_phases_)
+      return std::make_shared<FlopWeightedPmap>(*world_, rows_, cols_,
+                                                proc_rows_, proc_cols_,
+                                                row_phases_, col_phases_);
+
     return std::make_shared<CyclicPmap>(*world_, rows_, cols_, proc_rows_,
                                         proc_cols_);
   }
@@ -524,11 +739,18 @@ class ProcGrid {
 
   /// Construct a cyclic process map where the column phase of the process
   /// matches that of this process grid.
+  /// If this grid has more than one layer, the rows of the process map are
+  /// split among the layers (see \c LayeredCyclicPmap ).
   /// \param rows The number of rows in the process map
   /// \return Cyclic process map with matching column phase
   std::shared_ptr<Pmap> make_col_phase_pmap(const size_type rows) const {
     TA_ASSERT(world_);
 
+    if ((layers_ > 1u) || col_phases_)
+      return std::make_shared<LayeredCyclicPmap>(
+          *world_, rows, cols_, proc_rows_, proc_cols_, layers_, layer_stride_,
+          false, phases_type(), col_phases_);
+
     return std::make_shared<CyclicPmap>(*world_, rows, cols_, proc_rows_,
                                         proc_cols_);
   }
@@ -537,11 +759,18 @@ class ProcGrid {
 
   /// Construct a cyclic process map where the column phase of the process
   /// matches that of this process grid.
+  /// If this grid has more than one layer, the columns of the process map
+  /// are split among the layers (see \c LayeredCyclicPmap ).
   /// \param cols The number of columns in the process map
   /// \return Cyclic process map with matching column phase
   std::shared_ptr<Pmap> make_row_phase_pmap(const size_type cols) const {
     TA_ASSERT(world_);
 
+    if ((layers_ > 1u) || row_phases_)
+      return std::make_shared<LayeredCyclicPmap>(
+          *world_, rows_, cols, proc_rows_, proc_cols_, layers_, layer_stride_,
+          true, row_phases_, phases_type());
+
     return std::make_shared<CyclicPmap>(*world_, rows_, cols, proc_rows_,
                                         proc_cols_);
   }
@@ -23,8 +23,11 @@
 #include <TiledArray/permutation.h>
 #include <TiledArray/range_iterator.h>
 #include <TiledArray/size_array.h>
+#include <TiledArray/util/static_rank.h>
 #include <TiledArray/util/vector.h>
 
+#include <iterator>
+
 namespace TiledArray {
 
 /// \brief A (hyperrectangular) interval on \f$ Z^n \f$, space of integer
@@ -59,6 +62,16 @@ class Range {
 
   static_assert(detail::is_range_v<index_type>);  // index is a Range
 
+  /// The maximum rank of ranges whose dimension information is inline
+
+  /// The dimension information of ranges up to this rank is stored in the
+  /// range object; that of higher-rank ranges is allocated on the heap.
+  /// The inline storage holds <tt>4 * max_inline_rank</tt> indices, so it
+  /// sets the size of every range (160 bytes with 64-bit indices) and of
+  /// every tile that holds one. Ranks above 4 are rare for tiles, and their
+  /// ranges pay one allocation per copy instead.
+  static constexpr unsigned int max_inline_rank = 4u;
+
  protected:
   index1_type* data_ = nullptr;
   ///< An array that holds the dimension information of the
@@ -69,11 +82,65 @@ class Range {
   ///<   extent[0],  ..., extent[rank_ - 1],
   ///<   stride[0],  ..., stride[rank_ - 1] }
   ///< \endcode
+  ///< It points to \c inline_data_ if \c rank_ is not larger than
+  ///< \c max_inline_rank .
   distance_type offset_ = 0l;  ///< Ordinal index offset correction
   ordinal_type volume_ = 0ul;  ///< Total number of elements
   unsigned int rank_ = 0u;  ///< The rank (or number of dimensions) in the range
 
+  /// Allocate the dimension information array
+
+  /// \pre \c data_ is \c nullptr
+  /// \param rank The rank of the range
+  /// \post \c data_ can hold 4*rank elements
+  void alloc_data(const unsigned int rank) {
+    TA_ASSERT(data_ == nullptr);
+    data_ = (rank <= max_inline_rank ? inline_data_
+                                     : new index1_type[std::size_t(rank) << 2]);
+  }
+
+  /// Free the dimension information array
+
+  /// \post \c data_ is \c nullptr
+  void free_data() {
+    if (data_ != inline_data_) delete[] data_;
+    data_ = nullptr;
+  }
+
+  /// Reallocate the dimension information array if the rank changes
+
+  /// \param rank The new rank of the range
+  /// \post \c data_ can hold 4*rank elements ( \c nullptr if \c rank is
+  /// zero) and \c rank_ is \c rank ; the contents of \c data_ are
+  /// unspecified
+  void realloc_data(const unsigned int rank) {
+    if (rank_ != rank) {
+      free_data();
+      if (rank > 0u) alloc_data(rank);
+      rank_ = rank;
+    }
+  }
+
+  /// Take the dimension information of another range
+
+  /// \pre \c data_ is \c nullptr
+  /// \param other The range whose data is taken; its \c data_ is
+  /// \c nullptr on return, all other members are left unchanged
+  void take_data(Range_& other) {
+    TA_ASSERT(data_ == nullptr);
+    if (other.data_ == other.inline_data_) {
+      data_ = inline_data_;
+      memcpy(data_, other.data_, (sizeof(index1_type) << 2) * other.rank_);
+    } else {
+      data_ = other.data_;
+    }
+    other.data_ = nullptr;
+  }
+
  private:
+  index1_type inline_data_[max_inline_rank << 2];  ///< Dimension information
+                                                   ///< of low-rank ranges
+
   /// Initialize range data from sequences of lower and upper bounds
 
   /// \tparam Index1 An integral range type
@@ -343,7 +410,7 @@ class Range {
     TA_ASSERT(n == size(upper_bound));
     if (n) {
       // Initialize array memory
-      data_ = new index1_type[n << 2];
+      alloc_data(n);
       rank_ = n;
       init_range_data(lower_bound, upper_bound);
     }
@@ -378,7 +445,7 @@ class Range {
     TA_ASSERT(n == size(upper_bound));
     if (n) {
       // Initialize array memory
-      data_ = new index1_type[n << 2];
+      alloc_data(n);
       rank_ = n;
       init_range_data(lower_bound, upper_bound);
     }
@@ -402,7 +469,7 @@ class Range {
     const auto n = size(extent);
     if (n) {
       // Initialize array memory
-      data_ = new index1_type[n << 2];
+      alloc_data(n);
       rank_ = n;
       init_range_data(extent);
     }
@@ -425,7 +492,7 @@ class Range {
     const auto n = size(extent);
     if (n) {
       // Initialize array memory
-      data_ = new index1_type[n << 2];
+      alloc_data(n);
       rank_ = n;
       init_range_data(extent);
     }
@@ -467,7 +534,7 @@ class Range {
     const auto n = std::size(bounds);
     if (n) {
       // Initialize array memory
-      data_ = new index1_type[n << 2];
+      alloc_data(n);
       rank_ = n;
       init_range_data(bounds);
     }
@@ -498,7 +565,7 @@ class Range {
     const auto n = size(bounds);
     if (n) {
       // Initialize array memory
-      data_ = new index1_type[n << 2];
+      alloc_data(n);
       rank_ = n;
       init_range_data(bounds);
     }
@@ -531,7 +598,7 @@ class Range {
       }
 #endif
       // Initialize array memory
-      data_ = new index1_type[n << 2];
+      alloc_data(n);
       rank_ = n;
       init_range_data(bounds);
     }
@@ -574,7 +641,7 @@ class Range {
   /// \param other The range to be copied
   Range(const Range_& other) {
     if (other.rank_ > 0ul) {
-      data_ = new index1_type[other.rank_ << 2];
+      alloc_data(other.rank_);
       offset_ = other.offset_;
       volume_ = other.volume_;
       rank_ = other.rank_;
@@ -586,11 +653,8 @@ class Range {
 
   /// \param other The range to be copied
   Range(Range_&& other)
-      : data_(other.data_),
-        offset_(other.offset_),
-        volume_(other.volume_),
-        rank_(other.rank_) {
-    other.data_ = nullptr;
+      : offset_(other.offset_), volume_(other.volume_), rank_(other.rank_) {
+    take_data(other);
     other.offset_ = 0ul;
     other.volume_ = 0ul;
     other.rank_ = 0u;
@@ -604,7 +668,7 @@ class Range {
     TA_ASSERT(perm.dim() == other.rank_);
 
     if (other.rank_ > 0ul) {
-      data_ = new index1_type[other.rank_ << 2];
+      alloc_data(other.rank_);
       rank_ = other.rank_;
 
       if (perm) {
@@ -619,18 +683,15 @@ class Range {
   }
 
   /// Destructor
-  ~Range() { delete[] data_; }
+  ~Range() { free_data(); }
 
   /// Copy assignment operator
 
   /// \param other The range to be copied
   /// \return A reference to this object
   Range_& operator=(const Range_& other) {
-    if (rank_ != other.rank_) {
-      delete[] data_;
-      data_ = (other.rank_ > 0ul ? new index1_type[other.rank_ << 2] : nullptr);
-      rank_ = other.rank_;
-    }
+    if (this == &other) return *this;
+    realloc_data(other.rank_);
     memcpy(data_, other.data_, (sizeof(index1_type) << 2) * rank_);
     offset_ = other.offset_;
     volume_ = other.volume_;
@@ -644,12 +705,13 @@ class Range {
   /// \return A reference to this object
   /// \throw nothing
   Range_& operator=(Range_&& other) {
-    data_ = other.data_;
+    if (this == &other) return *this;
+    free_data();
+    take_data(other);
     offset_ = other.offset_;
     volume_ = other.volume_;
     rank_ = other.rank_;
 
-    other.data_ = nullptr;
     other.offset_ = 0l;
     other.volume_ = 0ul;
     other.rank_ = 0u;
@@ -903,11 +965,7 @@ class Range {
     TA_ASSERT(n == size(upper_bound));
 
     // Reallocate memory for range arrays
-    if (rank_ != n) {
-      delete[] data_;
-      data_ = (n > 0ul ? new index1_type[n << 2] : nullptr);
-      rank_ = n;
-    }
+    realloc_data(n);
     if (n > 0ul)
       init_range_data(lower_bound, upper_bound);
     else
@@ -1015,19 +1073,9 @@ class Range {
   ordinal_type ordinal(const Index& index) const {
     TA_ASSERT(includes(index));
 
-    auto* MADNESS_RESTRICT const stride = data_ + rank_ + rank_ + rank_;
-
-    ordinal_type result = 0ul;
-    unsigned int d = 0;
-    for (auto&& index_d : index) {
-      TA_ASSERT(d < rank_);
-      const auto stride_d = stride[d];
-      result += index_d * stride_d;
-      ++d;
-    }
-    TA_ASSERT(d == rank_);
-
-    return result - offset_;
+    return detail::with_static_rank(rank_, [&](auto rank) {
+      return this->ordinal_<decltype(rank)::value>(index);
+    });
   }
 
   /// calculate the ordinal index of \p index
@@ -1074,23 +1122,9 @@ class Range {
     // Construct result coordinate index object and allocate its memory.
     Range_::index result(rank_, 0);
 
-    // Get pointers to the data
-    auto* MADNESS_RESTRICT const result_data = result.data();
-    const auto* MADNESS_RESTRICT const lower = data_;
-    const auto* MADNESS_RESTRICT const size = data_ + rank_ + rank_;
-
-    // Compute the coordinate index of index in range.
-    for (int i = int(rank_) - 1; i >= 0; --i) {
-      const auto lower_i = lower[i];
-      const auto size_i = size[i];
-
-      // Compute result index element i
-      const auto result_i = (index % size_i) + lower_i;
-      index /= size_i;
-
-      // Store result
-      result_data[i] = result_i;
-    }
+    detail::with_static_rank(rank_, [&](auto rank) {
+      this->idx_<decltype(rank)::value>(index, result.data());
+    });
 
     return result;
   }
@@ -1119,11 +1153,7 @@ class Range {
 
     // Reallocate the array
     const unsigned int four_x_rank = rank << 2;
-    if (rank_ != rank) {
-      delete[] data_;
-      data_ = (rank > 0u ? new index1_type[four_x_rank] : nullptr);
-      rank_ = rank;
-    }
+    realloc_data(rank);
 
     // Get range data
     ar& madness::archive::wrap(data_, four_x_rank) & offset_& volume_;
@@ -1137,11 +1167,11 @@ class Range {
   }
 
   void swap(Range_& other) {
-    // Get temp data
-    std::swap(data_, other.data_);
-    std::swap(offset_, other.offset_);
-    std::swap(volume_, other.volume_);
-    std::swap(rank_, other.rank_);
+    // The dimension information of low-rank ranges is stored in the range
+    // objects, so exchange the ranges by moves
+    Range_ temp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temp);
   }
 
  private:
@@ -1179,23 +1209,85 @@ class Range {
   void increment(index_type& i) const {
     TA_ASSERT(includes(i));
 
+    detail::with_static_rank(rank_, [&](auto rank) {
+      this->increment_<decltype(rank)::value>(i);
+    });
+  }
+
+  /// Compute the ordinal index of a coordinate index
+
+  /// \tparam N The rank of this range, or 0 if it is not known at compile
+  /// time (see \c detail::with_static_rank() )
+  /// \tparam Index An integral range type
+  /// \param index The coordinate index, which is included in this range
+  /// \return The ordinal index of \c index
+  template <unsigned int N, typename Index>
+  ordinal_type ordinal_(const Index& index) const {
+    TA_ASSERT(N == 0u || N == rank_);
+    const unsigned int rank = (N ? N : rank_);
+    const auto* MADNESS_RESTRICT const stride = data_ + 3u * rank;
+
+    using std::begin;
+    using std::end;
+    auto index_it = begin(index);
+    TA_ASSERT(std::distance(index_it, end(index)) == std::ptrdiff_t(rank_));
+    ordinal_type result = 0ul;
+    for (unsigned int d = 0u; d < rank; ++d, ++index_it)
+      result += *index_it * stride[d];
+
+    return result - offset_;
+  }
+
+  /// Compute the coordinate index of an ordinal index
+
+  /// \tparam N The rank of this range, or 0 if it is not known at compile
+  /// time (see \c detail::with_static_rank() )
+  /// \param index The ordinal index, which is included in this range
+  /// \param[out] result The coordinate index of \c index
+  template <unsigned int N>
+  void idx_(ordinal_type index,
+            index1_type* MADNESS_RESTRICT const result) const {
+    TA_ASSERT(N == 0u || N == rank_);
+    const unsigned int rank = (N ? N : rank_);
     const auto* MADNESS_RESTRICT const lower = data_;
-    const auto* MADNESS_RESTRICT const upper = data_ + rank_;
+    const auto* MADNESS_RESTRICT const size = data_ + rank + rank;
 
-    for (int d = int(rank_) - 1; d >= 0; --d) {
+    // Compute the coordinate index of index in range.
+    for (unsigned int i = rank; i > 0u; --i) {
+      const auto size_i = size[i - 1u];
+
+      // Compute result index element i
+      result[i - 1u] = (index % size_i) + lower[i - 1u];
+      index /= size_i;
+    }
+  }
+
+  /// Increment a coordinate index
+
+  /// \tparam N The rank of this range, or 0 if it is not known at compile
+  /// time (see \c detail::with_static_rank() )
+  /// \param[in,out] i The coordinate index to be incremented
+  template <unsigned int N>
+  void increment_(index_type& i) const {
+    TA_ASSERT(N == 0u || N == rank_);
+    const unsigned int rank = (N ? N : rank_);
+    const auto* MADNESS_RESTRICT const lower = data_;
+    const auto* MADNESS_RESTRICT const upper = data_ + rank;
+
+    for (unsigned int d = rank; d > 0u; --d) {
       // increment coordinate
-      ++i[d];
+      ++i[d - 1u];
 
       // break if done
-      if (i[d] < upper[d]) return;
+      if (i[d - 1u] < upper[d - 1u]) return;
 
       // Reset current index to lower bound.
-      i[d] = lower[d];
+      i[d - 1u] = lower[d - 1u];
     }
 
     // if the current location was set to lower then it was at the end and
     // needs to be reset to equal upper.
-    std::copy(upper, upper + rank_, i.begin());
+    std::copy(upper, upper + rank, i.begin());
   }
 
   /// Advance the coordinate index \c i by \c n in this range
@@ -1234,14 +1326,17 @@ inline Range& Range::operator*=(const Permutation& perm) {
   TA_ASSERT(perm.dim() == rank_);
   if (rank_ > 1ul) {
     // Copy the lower and upper bound data into a temporary array
-    auto* MADNESS_RESTRICT const temp_lower = new index1_type[rank_ << 1];
+    index1_type inline_temp[max_inline_rank << 1];
+    auto* MADNESS_RESTRICT const temp_lower =
+        (rank_ <= max_inline_rank ? inline_temp
+                                  : new index1_type[rank_ << 1]);
     const auto* MADNESS_RESTRICT const temp_upper = temp_lower + rank_;
     std::memcpy(temp_lower, data_, (sizeof(index1_type) << 1) * rank_);
 
     init_range_data(perm, temp_lower, temp_upper);
 
     // Cleanup old memory.
-    delete[] temp_lower;
+    if (temp_lower != inline_temp) delete[] temp_lower;
   }
   return *this;
 }
@@ -304,6 +304,40 @@ class ReduceTask {
 
     };  // class ReduceObject
 
+    /// Reduction result container
+
+    /// This object holds a partial result of the reduction that is computed
+    /// elsewhere (e.g. by a batch of tile operations). When the result is
+    /// ready, it is reduced with the other data held by the parent.
+    class ResultObject : public madness::CallbackInterface {
+     private:
+      ReduceTaskImpl* parent_;      ///< The parent task
+      Future<result_type> result_;  ///< The partial result
+
+     public:
+      /// Constructor
+
+      /// \param parent The owner of this object
+      /// \param result The partial result
+      ResultObject(ReduceTaskImpl* parent, const Future<result_type>& result)
+          : parent_(parent), result_(result) {
+        TA_ASSERT(parent_);
+        TA_ASSERT(!result_.probe());
+        result_.register_callback(this);
+      }
+
+      virtual ~ResultObject() {}
+
+      /// Callback function that is invoked when the result is ready
+      virtual void notify() {
+        ReduceTaskImpl* const parent = parent_;
+        auto result = std::make_shared<result_type>(result_.get());
+        delete this;
+        parent->reduce_result(result);
+      }
+
+    };  // class ResultObject
+
 #ifdef TILEDARRAY_HAS_CUDA
 
     static void CUDART_CB cuda_reduceobject_delete_callback(void* userData) {
@@ -566,6 +600,32 @@ class ReduceTask {
 #endif
     }
 
+    /// Reduce a partial result
+
+    /// \param result The partial result to be reduced
+    /// \note The dependency counter must be incremented for \c result before
+    /// this function is called.
+    void reduce_result(std::shared_ptr<result_type> result) {
+      // Check for more reductions
+      reduce(result);
+
+      // Decrement the dependency counter for the result. This must be done
+      // after the reduce call to avoid a race condition.
+      this->dec();
+    }
+
+    /// Take the partial result that is ready to be reduced
+
+    /// \return The result that was in the ready state, or a null pointer if
+    /// no result is ready, e.g. because it is being reduced
+    std::shared_ptr<result_type> take_ready_result() {
+      lock_.lock();  // <<< Begin critical section
+      std::shared_ptr<result_type> result = ready_result_;
+      ready_result_.reset();
+      lock_.unlock();  // <<< End critical section
+      return result;
+    }
+
     /// Reduce two reduction arguments
     void reduce_object_object(const ReduceObject* object1,
                               const ReduceObject* object2) {
@@ -730,6 +790,42 @@ class ReduceTask {
   std::size_t count_;      ///< Reduction argument counter
 
  public:
+  /// Accumulation target of a partial result
+
+  /// A target is added to the reduction task with \c add_target() . Its
+  /// owner accumulates data in place into the partial result that is ready
+  /// to be reduced, if there is one, and must return the accumulated result
+  /// with \c reduce() exactly once.
+  class ResultTarget {
+   private:
+    ReduceTaskImpl* pimpl_;  ///< The reduction task object
+
+   public:
+    /// Constructor
+
+    /// \param pimpl The reduction task object
+    explicit ResultTarget(ReduceTaskImpl* pimpl = nullptr) : pimpl_(pimpl) {}
+
+    /// Take the partial result that is ready to be reduced
+
+    /// \return The ready partial result, or a null pointer if no result is
+    /// ready
+    std::shared_ptr<result_type> take() const {
+      TA_ASSERT(pimpl_);
+      return pimpl_->take_ready_result();
+    }
+
+    /// Return an accumulated result to the reduction task
+
+    /// \param result The result that will be reduced; a null pointer
+    /// releases the target without a result
+    void reduce(std::shared_ptr<result_type> result) const {
+      TA_ASSERT(pimpl_);
+      pimpl_->reduce_result(std::move(result));
+    }
+
+  };  // class ResultTarget
+
   /// Default constructor
   ReduceTask() : pimpl_(nullptr), count_(0ul) {}
 
@@ -790,6 +886,35 @@ class ReduceTask {
     return ++count_;
   }
 
+  /// Add a partial result to the reduction task
+
+  /// \c result is reduced with the other arguments of this task, e.g. it may
+  /// be the result of a contraction that was evaluated together with other
+  /// contractions (see \c Summa ).
+  /// \param result The partial result that will be reduced
+  /// \note If \c result is ready, it is reduced by the calling thread.
+  int add_result(const Future<result_type>& result) {
+    TA_ASSERT(pimpl_);
+    pimpl_->inc();
+    if (result.probe())
+      pimpl_->reduce_result(std::make_shared<result_type>(result.get()));
+    else
+      new typename ReduceTaskImpl::ResultObject(pimpl_, result);
+    return ++count_;
+  }
+
+  /// Add an accumulation target to the reduction task
+
+  /// The target holds a dependency of this task until its result is
+  /// returned with \c ResultTarget::reduce() .
+  /// \return The accumulation target
+  ResultTarget add_target() {
+    TA_ASSERT(pimpl_);
+    pimpl_->inc();
+    ++count_;
+    return ResultTarget(pimpl_);
+  }
+
   /// Argument count
 
   /// \return The total number of arguments added to this task
@@ -27,11 +27,13 @@
 #define TILEDARRAY_TENSOR_H__INCLUDED
 
 #include <TiledArray/block_range.h>
+#include <TiledArray/tensor/gett.h>
 #include <TiledArray/tensor/operators.h>
 #include <TiledArray/tensor/shift_wrapper.h>
 #include <TiledArray/tensor/tensor.h>
 #include <TiledArray/tensor/tensor_interface.h>
 #include <TiledArray/tensor/tensor_map.h>
+#include <TiledArray/util/pool_allocator.h>
 
 namespace TiledArray {
 
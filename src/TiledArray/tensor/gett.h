@@ -0,0 +1,311 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  gett.h
+ *  Oct 15, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_GETT_H__INCLUDED
+#define TILEDARRAY_TENSOR_GETT_H__INCLUDED
+
+#include <TiledArray/math/blas.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <TiledArray/permutation.h>
+#include <TiledArray/range.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+
+template <typename, typename>
+class Tensor;
+
+namespace detail {
+
+/// Block size of the transpose-free contraction kernel
+static constexpr const integer gett_block_size = 128;
+
+/// Element offsets of a group of permuted tensor dimensions
+
+/// Computes the offsets, relative to the first element of a tensor with
+/// range \c range, of the elements of the fused dimension formed by
+/// dimensions <tt>[first, last)</tt> of the <em>permuted</em> tensor, in
+/// row-major order. Dimension \c i of the stored tensor is dimension
+/// <tt>perm[i]</tt> of the permuted tensor.
+/// \param range The range of the (unpermuted) tensor
+/// \param inv_perm The inverse of the permutation that is applied to the
+/// tensor
+/// \param first The first permuted dimension of the group
+/// \param last The end of the group of permuted dimensions
+/// \return The offsets of the elements of the fused dimension
+inline std::vector<std::size_t> gett_offsets(const Range& range,
+                                             const Permutation& inv_perm,
+                                             const unsigned int first,
+                                             const unsigned int last) {
+  std::vector<std::size_t> offsets(1ul, 0ul);
+  for (unsigned int d = first; d < last; ++d) {
+    const unsigned int dim = inv_perm[d];
+    const std::size_t extent = range.extent(dim);
+    const std::size_t stride = range.stride(dim);
+
+    std::vector<std::size_t> fused;
+    fused.reserve(offsets.size() * extent);
+    for (const std::size_t offset : offsets)
+      for (std::size_t x = 0ul; x < extent; ++x)
+        fused.push_back(offset + x * stride);
+    offsets.swap(fused);
+  }
+
+  return offsets;
+}
+
+/// Pack a block of a strided matrix into a contiguous row-major block
+
+/// \param rows The number of rows in the block
+/// \param cols The number of columns in the block
+/// \param src The first element of the strided matrix
+/// \param row_offsets The element offsets of the rows of the block
+/// \param col_offsets The element offsets of the columns of the block
+/// \param dst The contiguous block
+template <typename T>
+inline void gett_pack(const integer rows, const integer cols, const T* src,
+                      const std::size_t* row_offsets,
+                      const std::size_t* col_offsets, T* dst) {
+  for (integer i = 0; i < rows; ++i, dst += cols) {
+    const T* const src_i = src + row_offsets[i];
+    for (integer j = 0; j < cols; ++j) dst[j] = src_i[col_offsets[j]];
+  }
+}
+
+/// Transpose-free tensor contraction kernel (GETT)
+
+/// Computes <tt>C = alpha * A * B + beta * C</tt>, where the row-major
+/// \f$ m \times n \f$ matrix \c C is stored with leading dimension \c ldc
+/// and the \f$ m \times k \f$ (\f$ k \times n \f$) matrix \c A ( \c B ) is
+/// a tensor stored in an arbitrary dimension order. Element \f$ (i, l) \f$
+/// of \c A is <tt>a[a_row[i] + a_col[l]]</tt>. If \c a_row is \c nullptr ,
+/// \c A is a contiguous row-major matrix; \c B is described likewise. The
+/// matrices are contracted by blocks: blocks of the strided arguments are
+/// packed into cache-resident, contiguous buffers that are multiplied with
+/// \c math::gemm() , so that the arguments are never transposed in full.
+/// \param m The number of rows of \c C
+/// \param n The number of columns of \c C
+/// \param k The number of contracted elements
+/// \param alpha The scaling factor of the contraction
+/// \param a The left-hand tensor data
+/// \param a_row The element offsets of the rows of \c A
+/// \param a_col The element offsets of the columns of \c A
+/// \param b The right-hand tensor data
+/// \param b_row The element offsets of the rows of \c B
+/// \param b_col The element offsets of the columns of \c B
+/// \param beta The scaling factor of \c C
+/// \param c The result data
+/// \param ldc The leading dimension of \c C
+template <typename S1, typename T1, typename T2, typename S2, typename T3>
+inline void gett(const integer m, const integer n, const integer k,
+                 const S1 alpha, const T1* a, const std::size_t* a_row,
+                 const std::size_t* a_col, const T2* b,
+                 const std::size_t* b_row, const std::size_t* b_col,
+                 const S2 beta, T3* c, const integer ldc) {
+  // Without contracted elements, C = beta * C and the (possibly empty)
+  // arguments are not accessed
+  if (k == 0) {
+    for (integer i = 0; i < m; ++i)
+      for (integer j = 0; j < n; ++j)
+        c[i * ldc + j] =
+            (beta == S2(0) ? T3(0) : T3(c[i * ldc + j] * beta));
+    return;
+  }
+
+  TA_ASSERT((a_row == nullptr) == (a_col == nullptr));
+  TA_ASSERT((b_row == nullptr) == (b_col == nullptr));
+
+  const integer mb = std::min(m, gett_block_size);
+  const integer nb = std::min(n, gett_block_size);
+  const integer kb = std::min(k, gett_block_size);
+
+  std::unique_ptr<T1[]> a_pack(a_row ? new T1[mb * kb] : nullptr);
+  std::unique_ptr<T2[]> b_pack(b_row ? new T2[kb * nb] : nullptr);
+
+  for (integer l0 = 0; l0 < k; l0 += kb) {
+    const integer kl = std::min(kb, k - l0);
+    // Only the first block of the inner dimension is scaled by beta
+    const S2 beta_l = (l0 == 0 ? beta : S2(1));
+
+    for (integer j0 = 0; j0 < n; j0 += nb) {
+      const integer nj = std::min(nb, n - j0);
+
+      const T2* b_block = b + l0 * n + j0;
+      integer ldb = n;
+      if (b_row) {
+        gett_pack(kl, nj, b, b_row + l0, b_col + j0, b_pack.get());
+        b_block = b_pack.get();
+        ldb = nj;
+      }
+
+      for (integer i0 = 0; i0 < m; i0 += mb) {
+        const integer mi = std::min(mb, m - i0);
+
+        const T1* a_block = a + i0 * k + l0;
+        integer lda = k;
+        if (a_row) {
+          gett_pack(mi, kl, a, a_row + i0, a_col + l0, a_pack.get());
+          a_block = a_pack.get();
+          lda = kl;
+        }
+
+        math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, mi, nj,
+                   kl, alpha, a_block, lda, b_block, ldb, beta_l,
+                   c + i0 * ldc + j0, ldc);
+      }
+    }
+  }
+}
+
+}  // namespace detail
+
+/// Contract two tensors stored in an arbitrary dimension order
+
+/// Computes the contraction described by \c gemm_helper of the tensors
+/// <tt>left_perm * left</tt> and <tt>right_perm * right</tt>, without
+/// permuting \c left or \c right (see \c detail::gett() ). For example, the
+/// contraction
+/// \code
+/// C[a,b,i,j] = A[a,k,i,l] * B[k,b,l,j]
+/// \endcode
+/// is evaluated as <tt>C[a,i,b,j] = A'[a,i,k,l] * B'[k,l,b,j]</tt>, where
+/// \c A' ( \c B' ) is \c A ( \c B ) permuted with \c left_perm
+/// ( \c right_perm ). The scaled result is accumulated to \c result , or
+/// assigned to it if \c result is empty.
+/// \tparam T The result tensor element type
+/// \tparam A The result tensor allocator type
+/// \tparam U The left-hand tensor element type
+/// \tparam AU The left-hand tensor allocator type
+/// \tparam V The right-hand tensor element type
+/// \tparam AV The right-hand tensor allocator type
+/// \tparam W The type of the scaling factor
+/// \param[in,out] result The result tensor
+/// \param left The left-hand tensor that will be contracted
+/// \param left_perm The permutation that maps \c left to the matrix layout
+/// of the left-hand argument; an empty permutation is the identity
+/// \param right The right-hand tensor that will be contracted
+/// \param right_perm The permutation that maps \c right to the matrix layout
+/// of the right-hand argument; an empty permutation is the identity
+/// \param factor The contraction result will be scaling by this value
+/// \param gemm_helper The *GEMM operation meta data of the permuted
+/// arguments; both matrix operations must be \c NoTrans
+template <typename T, typename A, typename U, typename AU, typename V,
+          typename AV, typename W>
+inline void gett(Tensor<T, A>& result, const Tensor<U, AU>& left,
+                 const Permutation& left_perm, const Tensor<V, AV>& right,
+                 const Permutation& right_perm, const W factor,
+                 const math::GemmHelper& gemm_helper) {
+  typedef typename Tensor<T, A>::range_type range_type;
+  typedef typename Tensor<T, A>::numeric_type numeric_type;
+
+  TA_ASSERT(!left.empty());
+  TA_ASSERT(left.range().rank() == gemm_helper.left_rank());
+  TA_ASSERT(!right.empty());
+  TA_ASSERT(right.range().rank() == gemm_helper.right_rank());
+  TA_ASSERT(gemm_helper.left_op() == madness::cblas::NoTrans);
+  TA_ASSERT(gemm_helper.right_op() == madness::cblas::NoTrans);
+  TA_ASSERT(!left_perm || (left_perm.dim() == gemm_helper.left_rank()));
+  TA_ASSERT(!right_perm || (right_perm.dim() == gemm_helper.right_rank()));
+
+  // Compute the ranges of the arguments in matrix layout
+  const range_type left_range =
+      (left_perm ? left_perm * left.range() : left.range());
+  const range_type right_range =
+      (right_perm ? right_perm * right.range() : right.range());
+
+  TA_ASSERT(gemm_helper.left_right_congruent(left_range.extent_data(),
+                                             right_range.extent_data()));
+
+  numeric_type beta(1);
+  if (result.empty()) {
+    result = Tensor<T, A>(
+        gemm_helper.make_result_range<range_type>(left_range, right_range));
+    beta = numeric_type(0);
+  }
+  TA_ASSERT(result.range().rank() == gemm_helper.result_rank());
+
+  // Compute gemm dimensions
+  integer m = 1, n = 1, k = 1;
+  gemm_helper.compute_matrix_sizes(m, n, k, left_range, right_range);
+
+  // Compute the element offsets of the permuted arguments
+  const unsigned int inner_rank = gemm_helper.num_contract_ranks();
+  const unsigned int left_outer_rank = gemm_helper.left_rank() - inner_rank;
+  std::vector<std::size_t> a_row, a_col, b_row, b_col;
+  if (left_perm) {
+    const Permutation inv_perm = left_perm.inv();
+    a_row = detail::gett_offsets(left.range(), inv_perm, 0u, left_outer_rank);
+    a_col = detail::gett_offsets(left.range(), inv_perm, left_outer_rank,
+                                 gemm_helper.left_rank());
+  }
+  if (right_perm) {
+    const Permutation inv_perm = right_perm.inv();
+    b_row = detail::gett_offsets(right.range(), inv_perm, 0u, inner_rank);
+    b_col = detail::gett_offsets(right.range(), inv_perm, inner_rank,
+                                 gemm_helper.right_rank());
+  }
+
+  detail::gett(m, n, k, factor, left.data(),
+               (left_perm ? a_row.data() : nullptr),
+               (left_perm ? a_col.data() : nullptr), right.data(),
+               (right_perm ? b_row.data() : nullptr),
+               (right_perm ? b_col.data() : nullptr), beta, result.data(), n);
+}
+
+/// Contract two tensors stored in an arbitrary dimension order
+
+/// \tparam U The left-hand tensor element type
+/// \tparam AU The left-hand tensor allocator type
+/// \tparam V The right-hand tensor element type
+/// \tparam AV The right-hand tensor allocator type
+/// \tparam W The type of the scaling factor
+/// \param left The left-hand tensor that will be contracted
+/// \param left_perm The permutation that maps \c left to the matrix layout
+/// of the left-hand argument; an empty permutation is the identity
+/// \param right The right-hand tensor that will be contracted
+/// \param right_perm The permutation that maps \c right to the matrix layout
+/// of the right-hand argument; an empty permutation is the identity
+/// \param factor The contraction result will be scaling by this value
+/// \param gemm_helper The *GEMM operation meta data of the permuted
+/// arguments; both matrix operations must be \c NoTrans
+/// \return A new tensor which is the result of contracting \c left with
+/// \c right and scaled by \c factor
+/// \sa gett(Tensor<T, A>&, const Tensor<U, AU>&, const Permutation&,
+/// const Tensor<V, AV>&, const Permutation&, const W, const
+/// math::GemmHelper&)
+template <typename U, typename AU, typename V, typename AV, typename W>
+inline Tensor<U, AU> gett(const Tensor<U, AU>& left,
+                          const Permutation& left_perm,
+                          const Tensor<V, AV>& right,
+                          const Permutation& right_perm, const W factor,
+                          const math::GemmHelper& gemm_helper) {
+  Tensor<U, AU> result;
+  gett(result, left, left_perm, right, right_perm, factor, gemm_helper);
+  return result;
+}
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_TENSOR_GETT_H__INCLUDED
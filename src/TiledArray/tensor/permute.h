@@ -27,70 +27,330 @@
 #define TILEDARRAY_TENSOR_PERMUTE_H__INCLUDED
 
 #include <TiledArray/math/transpose.h>
-#include <TiledArray/perm_index.h>
+#include <TiledArray/permutation.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace TiledArray {
 namespace detail {
 
-/// Compute the fused dimensions for permutation
-
-/// This function will compute the fused dimensions of a tensor for use in
-/// permutation algorithms. The idea is to partition the stride 1 dimensions
-/// in both the input and output tensor, which yields a forth-order tensor
-/// (second- and third-order tensors have size of 1 and stride of 0 in the
-/// unused dimensions).
-/// \tparam SizeType An unsigned integral type
-/// \param[out] fused_size An array for the fused size output
-/// \param[out] fused_weight An array for the fused weight output
-/// \param[in] size An array that holds the unfused size information of the
-/// argument tensor
-/// \param[in] perm The permutation that will be applied to the argument
-/// tensor(s).
-template <typename SizeType, typename ExtentType>
-inline void fuse_dimensions(SizeType* MADNESS_RESTRICT const fused_size,
-                            SizeType* MADNESS_RESTRICT const fused_weight,
-                            const ExtentType* MADNESS_RESTRICT const size,
-                            const Permutation& perm) {
-  const unsigned int ndim1 = perm.dim() - 1u;
-
-  int i = ndim1;
-  fused_size[3] = size[i--];
-  while ((i >= 0) && (perm[i + 1u] == (perm[i] + 1u)))
-    fused_size[3] *= size[i--];
-  fused_weight[3] = 1u;
-
-  if ((i >= 0) && (perm[i] != ndim1)) {
-    fused_size[2] = size[i--];
-    while ((i >= 0) && (perm[i] != ndim1)) fused_size[2] *= size[i--];
-
-    fused_weight[2] = fused_size[3];
-
-    fused_size[1] = size[i--];
-    while ((i >= 0) && (perm[i + 1] == (perm[i] + 1u)))
-      fused_size[1] *= size[i--];
-
-    fused_weight[1] = fused_size[2] * fused_weight[2];
-  } else {
-    fused_size[2] = 1ul;
-    fused_weight[2] = 0ul;
-
-    fused_size[1] = size[i--];
-    while ((i >= 0) && (perm[i + 1] == (perm[i] + 1u)))
-      fused_size[1] *= size[i--];
-
-    fused_weight[1] = fused_size[3];
+/// Permutation plan
+
+/// A permutation plan describes how the elements of a tensor are copied to
+/// a permuted tensor, for a given argument range extent, permutation, and
+/// element size. Dimensions of unit extent are dropped, and dimensions that
+/// are contiguous in both the argument and the result are fused. The fused
+/// dimension that is contiguous in the argument, \c a , and the fused
+/// dimension that is contiguous in the result, \c b , form the kernel of the
+/// permutation: a contiguous copy, when \c a and \c b are the same dimension,
+/// or a matrix transpose that is blocked in panels that fit in the L1 cache,
+/// each of which is transposed in \c TILEDARRAY_LOOP_UNWIND square blocks by
+/// \c math::transpose . Kernels with short extents are copied directly. The
+/// remaining dimensions form the outer loops, which are ordered by
+/// decreasing result stride so that consecutive kernels write to nearby
+/// memory, and which update the argument and result offsets incrementally.
+///
+/// Plans are cached process-wide by \c instance() , so that the repeated
+/// permutation of tensors with the same extents (e.g. in every iteration of
+/// an iterative solver) is planned only once.
+class PermutePlan {
+ public:
+  typedef std::size_t size_type;  ///< Size type
+
+  /// Fused dimension
+  struct Dim {
+    size_type extent;         ///< Number of elements in the dimension
+    size_type arg_stride;     ///< Stride in the argument tensor
+    size_type result_stride;  ///< Stride in the result tensor
+  };
+
+  /// Construct a permutation plan
+
+  /// \tparam ExtentType The range extent type
+  /// \param extent The extent of the argument range
+  /// \param perm The permutation that will be applied to the argument
+  /// \param element_size The size of the tensor elements, in bytes
+  template <typename ExtentType>
+  PermutePlan(const ExtentType* const extent, const Permutation& perm,
+              const size_type element_size) {
+    const unsigned int ndim = perm.dim();
+
+    // Compute the argument strides and the result strides of the argument
+    // dimensions
+    std::vector<size_type> arg_stride(ndim), result_stride(ndim);
+    for (unsigned int i = ndim; i > 0u; --i) {
+      arg_stride[i - 1u] = volume_;
+      volume_ *= extent[i - 1u];
+    }
+    std::vector<size_type> result_extent(ndim), result_weight(ndim);
+    for (unsigned int i = 0u; i < ndim; ++i) result_extent[perm[i]] = extent[i];
+    size_type weight = 1ul;
+    for (unsigned int i = ndim; i > 0u; --i) {
+      result_weight[i - 1u] = weight;
+      weight *= result_extent[i - 1u];
+    }
+    for (unsigned int i = 0u; i < ndim; ++i)
+      result_stride[i] = result_weight[perm[i]];
+
+    // Select the panel size, such that the argument and result panels fit in
+    // a 32 KiB L1 data cache
+    panel_ = TILEDARRAY_LOOP_UNWIND;
+    while (2ul * (2ul * panel_) * (2ul * panel_) * element_size <= 32768ul)
+      panel_ *= 2ul;
+
+    if (volume_ == 0ul) return;
+
+    // Drop the unit dimensions and fuse the dimensions that are contiguous
+    // in both tensors, from the least significant dimension
+    std::vector<Dim> dims;
+    for (unsigned int i = ndim; i > 0u; --i) {
+      const size_type n = extent[i - 1u];
+      if (n == 1ul) continue;
+      if (!dims.empty() &&
+          dims.back().arg_stride * dims.back().extent == arg_stride[i - 1u] &&
+          dims.back().result_stride * dims.back().extent ==
+              result_stride[i - 1u])
+        dims.back().extent *= n;
+      else
+        dims.push_back(Dim{n, arg_stride[i - 1u], result_stride[i - 1u]});
+    }
+    if (dims.empty()) dims.push_back(Dim{1ul, 1ul, 1ul});
+
+    // Select the kernel dimensions
+    a_ = dims.front();
+    const auto b_it =
+        std::find_if(dims.begin(), dims.end(),
+                     [](const Dim& dim) { return dim.result_stride == 1ul; });
+    TA_ASSERT(b_it != dims.end());
+    transpose_ = (b_it != dims.begin());
+    if (transpose_) {
+      b_ = *b_it;
+      dims.erase(b_it);
+    }
+    dims.erase(dims.begin());
+
+    // Order the outer loops by decreasing result stride
+    std::sort(dims.begin(), dims.end(), [](const Dim& left, const Dim& right) {
+      return left.result_stride > right.result_stride;
+    });
+    outer_ = std::move(dims);
   }
 
-  if (i >= 0) {
-    fused_size[0] = size[i--];
-    while (i >= 0) fused_size[0] *= size[i--];
+  /// Find or create a cached permutation plan
 
-    fused_weight[0] = fused_size[1] * fused_weight[1];
-  } else {
-    fused_size[0] = 1ul;
-    fused_weight[0] = 0ul;
+  /// \tparam ExtentType The range extent type
+  /// \param extent The extent of the argument range
+  /// \param perm The permutation that will be applied to the argument
+  /// \param element_size The size of the tensor elements, in bytes
+  /// \return The plan for \c extent , \c perm , and \c element_size
+  template <typename ExtentType>
+  static std::shared_ptr<const PermutePlan> instance(
+      const ExtentType* const extent, const Permutation& perm,
+      const size_type element_size) {
+    const unsigned int ndim = perm.dim();
+    key_type key;
+    key.reserve(1u + 2u * ndim);
+    key.push_back(element_size);
+    key.insert(key.end(), extent, extent + ndim);
+    for (unsigned int i = 0u; i < ndim; ++i) key.push_back(perm[i]);
+
+    Cache& c = cache();
+    {
+      std::shared_lock<std::shared_mutex> lock(c.mutex);
+      const auto it = c.plans.find(key);
+      if (it != c.plans.end()) return it->second;
+    }
+
+    auto plan = std::make_shared<const PermutePlan>(extent, perm, element_size);
+    std::unique_lock<std::shared_mutex> lock(c.mutex);
+    if (c.plans.size() >= max_cache_size) c.plans.clear();
+    return c.plans.emplace(std::move(key), std::move(plan)).first->second;
   }
-}
+
+  /// The number of cached plans
+
+  /// \return The number of plans in the process-wide cache
+  static std::size_t cache_size() {
+    Cache& c = cache();
+    std::shared_lock<std::shared_mutex> lock(c.mutex);
+    return c.plans.size();
+  }
+
+  /// Remove all plans from the process-wide cache
+  static void clear_cache() {
+    Cache& c = cache();
+    std::unique_lock<std::shared_mutex> lock(c.mutex);
+    c.plans.clear();
+  }
+
+  /// The number of elements in the permuted tensors
+  size_type volume() const { return volume_; }
+
+  /// \return \c true if the kernel is a transpose, or \c false if it is a
+  /// contiguous copy
+  bool transpose() const { return transpose_; }
+
+  /// The kernel dimension that is contiguous in the argument
+  const Dim& arg_inner() const { return a_; }
+
+  /// The kernel dimension that is contiguous in the result
+
+  /// \return The dimension that is contiguous in the result, which has unit
+  /// extent if the kernel is a contiguous copy
+  const Dim& result_inner() const { return b_; }
+
+  /// The dimensions of the outer loops, from the outermost loop
+  const std::vector<Dim>& outer() const { return outer_; }
+
+  /// Execute the plan
+
+  /// The expected signature of the input operation is:
+  /// \code
+  /// Result input_op(const Args...)
+  /// \endcode
+  /// The expected signature of the output operation is:
+  /// \code
+  /// void output_op(Result*, const Result)
+  /// \endcode
+  /// \tparam InputOp The input operation type
+  /// \tparam OutputOp The output operation type
+  /// \tparam Result The result element type
+  /// \tparam Args The argument element types
+  /// \param input_op The operation that is used to generate the output value
+  /// from the input arguments
+  /// \param output_op The operation that is used to set the value of the
+  /// result tensor given the element pointer and the result value
+  /// \param result A pointer to the first element of the result tensor
+  /// \param args Pointers to the first element of the argument tensors
+  template <typename InputOp, typename OutputOp, typename Result,
+            typename... Args>
+  void operator()(InputOp&& input_op, OutputOp&& output_op,
+                  Result* const result, const Args* const... args) const {
+    if (volume_ == 0ul) return;
+
+    if (transpose_) {
+      auto kernel = [&](const size_type arg_offset,
+                        const size_type result_offset) {
+        for (size_type j = 0ul; j < b_.extent; j += panel_) {
+          const size_type m = std::min(panel_, b_.extent - j);
+          for (size_type i = 0ul; i < a_.extent; i += panel_) {
+            const size_type n = std::min(panel_, a_.extent - i);
+            const size_type arg_ij = arg_offset + i + j * b_.arg_stride;
+            Result* const result_ij =
+                result + (result_offset + j + i * a_.result_stride);
+            if ((m < TILEDARRAY_LOOP_UNWIND) || (n < TILEDARRAY_LOOP_UNWIND))
+              transpose_small(input_op, output_op, m, n, result_ij,
+                              (args + arg_ij)...);
+            else
+              math::transpose(input_op, output_op, m, n, a_.result_stride,
+                              result_ij, b_.arg_stride, (args + arg_ij)...);
+          }
+        }
+      };
+      for_each_kernel(kernel, 0u, 0ul, 0ul);
+    } else {
+      auto op = [&](Result* const res, param_type<Args>... a) {
+        output_op(res, input_op(a...));
+      };
+      auto kernel = [&](const size_type arg_offset,
+                        const size_type result_offset) {
+        if (a_.extent < TILEDARRAY_LOOP_UNWIND) {
+          for (size_type i = 0ul; i < a_.extent; ++i)
+            op(result + (result_offset + i), args[arg_offset + i]...);
+        } else {
+          math::vector_ptr_op(op, a_.extent, result + result_offset,
+                              (args + arg_offset)...);
+        }
+      };
+      for_each_kernel(kernel, 0u, 0ul, 0ul);
+    }
+  }
+
+ private:
+  typedef std::vector<size_type> key_type;  ///< Cache key type
+
+  /// Cache key hasher
+  struct KeyHash {
+    std::size_t operator()(const key_type& key) const {
+      std::size_t seed = key.size();
+      for (const size_type k : key)
+        seed ^= std::hash<size_type>()(k) + 0x9e3779b9 + (seed << 6) +
+                (seed >> 2);
+      return seed;
+    }
+  };
+
+  /// Process-wide plan cache
+  struct Cache {
+    std::shared_mutex mutex;  ///< Guards the plans
+    std::unordered_map<key_type, std::shared_ptr<const PermutePlan>, KeyHash>
+        plans;  ///< The cached plans
+  };
+
+  /// The maximum number of cached plans; the cache is cleared when it is full
+  static constexpr std::size_t max_cache_size = 4096ul;
+
+  static Cache& cache() {
+    static Cache c;
+    return c;
+  }
+
+  /// Transpose a panel with a short extent
+
+  /// \param m The number of argument rows in the panel
+  /// \param n The number of argument columns in the panel
+  /// \param result A pointer to the first result element of the panel
+  /// \param args Pointers to the first argument elements of the panel
+  template <typename InputOp, typename OutputOp, typename Result,
+            typename... Args>
+  void transpose_small(InputOp& input_op, OutputOp& output_op,
+                       const size_type m, const size_type n,
+                       Result* const result, const Args* const... args) const {
+    for (size_type i = 0ul; i < n; ++i) {
+      Result* const result_i = result + i * a_.result_stride;
+      for (size_type j = 0ul, offset = i; j < m;
+           ++j, offset += b_.arg_stride)
+        output_op(result_i + j, input_op(args[offset]...));
+    }
+  }
+
+  /// Apply a kernel for each element of the outer loops
+
+  /// \param kernel The kernel, which is called with the argument and result
+  /// offsets of the kernel
+  /// \param d The outer loop
+  /// \param arg_offset The argument offset of the loop
+  /// \param result_offset The result offset of the loop
+  template <typename Kernel>
+  void for_each_kernel(Kernel& kernel, const unsigned int d,
+                       size_type arg_offset, size_type result_offset) const {
+    if (d == outer_.size()) {
+      kernel(arg_offset, result_offset);
+      return;
+    }
+
+    const Dim& dim = outer_[d];
+    for (size_type i = 0ul; i < dim.extent; ++i,
+                   arg_offset += dim.arg_stride,
+                   result_offset += dim.result_stride)
+      for_each_kernel(kernel, d + 1u, arg_offset, result_offset);
+  }
+
+  size_type volume_ = 1ul;  ///< The number of elements
+  Dim a_{1ul, 1ul, 1ul};  ///< The kernel dimension that is contiguous in the
+                          ///< argument
+  Dim b_{1ul, 0ul, 0ul};  ///< The kernel dimension that is contiguous in the
+                          ///< result
+  bool transpose_ = false;  ///< The kernel is a transpose
+  std::vector<Dim> outer_;  ///< The outer loop dimensions
+  size_type panel_;         ///< The panel size of transpose kernels
+
+};  // class PermutePlan
 
 /// Construct a permuted tensor copy
 
@@ -110,94 +370,17 @@ inline void fuse_dimensions(SizeType* MADNESS_RESTRICT const fused_size,
 /// result tensor given the element pointer and the result value
 /// \param args The data pointers of the tensors to be permuted
 /// \param perm The permutation that will be applied to the copy
+/// \note The permutation is executed with a cached \c PermutePlan .
 template <typename InputOp, typename OutputOp, typename Result, typename Arg0,
           typename... Args>
 inline void permute(InputOp&& input_op, OutputOp&& output_op, Result& result,
                     const Permutation& perm, const Arg0& arg0,
                     const Args&... args) {
-  detail::PermIndex perm_index_op(arg0.range(), perm);
-
-  // Cache constants
-  const unsigned int ndim = arg0.range().rank();
-  const unsigned int ndim1 = ndim - 1;
-  const auto volume = arg0.range().volume();
-
-  // Get pointer to arg extent
-  const auto* MADNESS_RESTRICT const arg0_extent = arg0.range().extent_data();
-
-  if (perm[ndim1] == ndim1) {
-    // This is the simple case where the last dimension is not permuted.
-    // Therefore, it can be shuffled in chunks.
-
-    // Determine which dimensions can be permuted with the least significant
-    // dimension.
-    typename Result::ordinal_type block_size = arg0_extent[ndim1];
-    for (int i = int(ndim1) - 1; i >= 0; --i) {
-      if (int(perm[i]) != i) break;
-      block_size *= arg0_extent[i];
-    }
-
-    // Combine the input and output operations
-    auto op = [=](typename Result::pointer result,
-                  typename Arg0::const_reference a0,
-                  typename Args::const_reference... as) {
-      output_op(result, input_op(a0, as...));
-    };
-
-    // Permute the data
-    for (typename Result::ordinal_type index = 0ul; index < volume;
-         index += block_size) {
-      const typename Result::ordinal_type perm_index = perm_index_op(index);
-
-      // Copy the block
-      math::vector_ptr_op(op, block_size, result.data() + perm_index,
-                          arg0.data() + index, (args.data() + index)...);
-    }
-
-  } else {
-    // This is the more complicated case. Here we permute in terms of matrix
-    // transposes. The data layout of the input and output matrices are
-    // chosen such that they both contain stride one dimensions.
-
-    // Here we partition the n dimensional index space, I, of the permute
-    // tensor with up to four parts
-    // {I_1, ..., I_i, I_i+1, ..., I_j, I_j+1, ..., I_k, I_k+1, ..., I_n}
-    // where the subrange {I_k+1, ..., I_n} is the (fused) inner dimension
-    // in the input tensor, and the subrange {I_i+1, ..., I_j} is the
-    // (fused) inner dimension in the output tensor that has been mapped to
-    // the input tensor. These ranges are used to form a set of matrices in
-    // the input tensor that are transposed and copied to the output tensor.
-    // The remaining (fused) index ranges {I_1, ..., I_i} and
-    // {I_j+1, ..., I_k} are used to form the outer loop around the matrix
-    // transpose operations. These outer ranges may or may not be zero size.
-    typename Result::ordinal_type other_fused_size[4];
-    typename Result::ordinal_type other_fused_weight[4];
-    fuse_dimensions(other_fused_size, other_fused_weight,
-                    arg0.range().extent_data(), perm);
-
-    // Compute the fused stride for the result matrix transpose.
-    const auto* MADNESS_RESTRICT const result_extent =
-        result.range().extent_data();
-    typename Result::ordinal_type result_outer_stride = 1ul;
-    for (unsigned int i = perm[ndim1] + 1u; i < ndim; ++i)
-      result_outer_stride *= result_extent[i];
-
-    // Copy data from the input to the output matrix via a series of matrix
-    // transposes.
-    for (typename Result::ordinal_type i = 0ul; i < other_fused_size[0]; ++i) {
-      typename Result::ordinal_type index = i * other_fused_weight[0];
-      for (typename Result::ordinal_type j = 0ul; j < other_fused_size[2];
-           ++j, index += other_fused_weight[2]) {
-        // Compute the ordinal index of the input and output matrices.
-        typename Result::ordinal_type perm_index = perm_index_op(index);
-
-        math::transpose(input_op, output_op, other_fused_size[1],
-                        other_fused_size[3], result_outer_stride,
-                        result.data() + perm_index, other_fused_weight[1],
-                        arg0.data() + index, (args.data() + index)...);
-      }
-    }
-  }
+  TA_ASSERT(perm.dim() == arg0.range().rank());
+  const auto plan = PermutePlan::instance(
+      arg0.range().extent_data(), perm,
+      sizeof(typename Result::value_type));
+  (*plan)(input_op, output_op, result.data(), arg0.data(), args.data()...);
 }
 
 }  // namespace detail
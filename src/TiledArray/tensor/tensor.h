@@ -22,6 +22,7 @@
 
 #include <TiledArray/math/blas.h>
 #include <TiledArray/math/gemm_helper.h>
+#include <TiledArray/math/simd.h>
 #include <TiledArray/tensor/complex.h>
 #include <TiledArray/tensor/kernels.h>
 #include <TiledArray/util/logger.h>
@@ -96,15 +97,33 @@ class Tensor {
       data_ = allocator_type::allocate(range.volume());
     }
 
+    /// Construct with range and the data of another tensor
+
+    /// \param range The N-dimensional range for this tensor, which has the
+    /// same volume as that of \c owner
+    /// \param owner The implementation object that owns the data
+    Impl(const range_type& range, const std::shared_ptr<Impl>& owner)
+        : allocator_type(*owner),
+          range_(range),
+          data_(owner->data_),
+          owner_(owner->owner_ ? owner->owner_ : owner) {
+      TA_ASSERT(range.volume() == owner->range_.volume());
+    }
+
     ~Impl() {
-      math::destroy_vector(range_.volume(), data_);
-      allocator_type::deallocate(data_, range_.volume());
+      if (!owner_) {
+        math::destroy_vector(range_.volume(), data_);
+        allocator_type::deallocate(data_, range_.volume());
+      }
       data_ = NULL;
     }
 
     range_type range_;  ///< Tensor size info
     pointer data_;      ///< Tensor data
-  };                    // class Impl
+    std::shared_ptr<Impl>
+        owner_;  ///< The owner of the data, if it is shared with another
+                 ///< tensor (see \c shallow_shift() )
+  };             // class Impl
 
   template <typename... Ts>
   struct is_tensor {
@@ -122,6 +141,30 @@ class Tensor {
     math::uninitialized_fill_vector(n, U(), u);
   }
 
+  /// Checks if the vectorized kernels of math/simd.h apply to this tensor
+  /// and a \c Right tensor
+  template <typename Right>
+  static constexpr bool is_simd_v =
+      math::simd::is_simd_v<value_type> && std::is_same_v<Right, Tensor_>;
+
+  /// Checks if the vectorized kernels of math/simd.h apply to this tensor
+  /// and a \c Scalar factor, i.e. if the factor is converted to
+  /// \c value_type , or is the real type of complex elements
+  template <typename Scalar>
+  static constexpr bool is_simd_scalar_v =
+      math::simd::is_simd_v<value_type> &&
+      (std::is_same_v<Scalar, value_type> ||
+       std::is_same_v<Scalar, scalar_type> || std::is_integral_v<Scalar>);
+
+  /// Check the tensor argument of a vectorized kernel
+
+  /// \param right The argument
+  void simd_assert(const Tensor_& right) const {
+    TA_ASSERT(pimpl_);
+    TA_ASSERT(right.pimpl_);
+    TA_ASSERT(detail::is_range_congruent(*this, right));
+  }
+
   std::shared_ptr<Impl> pimpl_;  ///< Shared pointer to implementation object
   static const range_type empty_range_;  ///< Empty range
 
@@ -548,6 +591,22 @@ class Tensor {
   /// data), otherwise \c false.
   bool empty() const { return !pimpl_; }
 
+  /// Number of tensors that share the data of this tensor
+
+  /// The data is shared by shallow copies of this tensor and by tensors
+  /// created with \c shallow_shift() . If the result is 1, this tensor is the
+  /// only reference to its data and may be modified in place without
+  /// affecting other tensors (see \c TiledArray::is_unique() ).
+  /// \return The number of tensors that share the data of this tensor, or 0
+  /// if this tensor is empty
+  long use_count() const {
+    if (!pimpl_) return 0l;
+    // Tensors that share the data through another implementation object
+    // hold references to the owner of the data
+    return pimpl_.use_count() +
+           (pimpl_->owner_ ? pimpl_->owner_.use_count() - 1l : 0l);
+  }
+
   /// Output serialization function
 
   /// This function enables serialization within MADNESS
@@ -805,6 +864,27 @@ class Tensor {
     return result;
   }
 
+  /// Shift the lower and upper bound of this range without copying the data
+
+  /// Unlike \c shift(), the result aliases the data of this tensor; only the
+  /// range is copied. The result holds a reference to the owner of the data,
+  /// which therefore lives as long as either tensor. Changes to the elements
+  /// of either tensor are visible in both, as with shallow copies of tensors,
+  /// while the range of the result may be changed (e.g. with \c shift_to() )
+  /// without affecting this tensor. Use \c shift() , or \c clone() the
+  /// result, for an independent copy; \c use_count() counts both tensors.
+  /// \tparam Index The shift array type
+  /// \param bound_shift The shift to be applied to the tensor range
+  /// \return A shifted tensor that shares the data of this tensor
+  template <typename Index>
+  Tensor_ shallow_shift(const Index& bound_shift) const {
+    TA_ASSERT(pimpl_);
+    Tensor_ result;
+    result.pimpl_ = std::make_shared<Impl>(pimpl_->range_, pimpl_);
+    result.shift_to(bound_shift);
+    return result;
+  }
+
   // Generic vector operations
 
   /// Use a binary, element wise operation to construct a new tensor
@@ -904,8 +984,16 @@ class Tensor {
   template <typename Scalar, typename std::enable_if<
                                  detail::is_numeric_v<Scalar>>::type* = nullptr>
   Tensor_ scale(const Scalar factor) const {
-    return unary(
-        [factor](const numeric_type a) -> numeric_type { return a * factor; });
+    if constexpr (is_simd_scalar_v<Scalar>) {
+      TA_ASSERT(pimpl_);
+      Tensor_ result(pimpl_->range_);
+      math::simd::scale(size(), factor, data(), result.data());
+      return result;
+    } else {
+      return unary([factor](const numeric_type a) -> numeric_type {
+        return a * factor;
+      });
+    }
   }
 
   /// Construct a scaled and permuted copy of this tensor
@@ -931,8 +1019,14 @@ class Tensor {
   template <typename Scalar, typename std::enable_if<
                                  detail::is_numeric_v<Scalar>>::type* = nullptr>
   Tensor_& scale_to(const Scalar factor) {
-    return inplace_unary(
-        [factor](numeric_type& MADNESS_RESTRICT res) { res *= factor; });
+    if constexpr (is_simd_scalar_v<Scalar>) {
+      TA_ASSERT(pimpl_);
+      math::simd::scale(size(), factor, data(), data());
+      return *this;
+    } else {
+      return inplace_unary(
+          [factor](numeric_type& MADNESS_RESTRICT res) { res *= factor; });
+    }
   }
 
   // Addition operations
@@ -946,11 +1040,18 @@ class Tensor {
   template <typename Right,
             typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
   Tensor_ add(const Right& right) const {
-    return binary(
-        right,
-        [](const numeric_type l, const numeric_t<Right> r) -> numeric_type {
-          return l + r;
-        });
+    if constexpr (is_simd_v<Right>) {
+      simd_assert(right);
+      Tensor_ result(pimpl_->range_);
+      math::simd::add(size(), data(), right.data(), result.data());
+      return result;
+    } else {
+      return binary(
+          right,
+          [](const numeric_type l, const numeric_t<Right> r) -> numeric_type {
+            return l + r;
+          });
+    }
   }
 
   /// Add this and \c other to construct a new, permuted tensor
@@ -1041,8 +1142,14 @@ class Tensor {
   template <typename Right,
             typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
   Tensor_& add_to(const Right& right) {
-    return inplace_binary(right, [](numeric_type& MADNESS_RESTRICT l,
-                                    const numeric_t<Right> r) { l += r; });
+    if constexpr (is_simd_v<Right>) {
+      simd_assert(right);
+      math::simd::add(size(), data(), right.data(), data());
+      return *this;
+    } else {
+      return inplace_binary(right, [](numeric_type& MADNESS_RESTRICT l,
+                                      const numeric_t<Right> r) { l += r; });
+    }
   }
 
   /// Add \c other to this tensor, and scale the result
@@ -1071,6 +1178,29 @@ class Tensor {
         [value](numeric_type& MADNESS_RESTRICT res) { res += value; });
   }
 
+  /// Add \c right scaled by \c factor to this tensor
+
+  /// \tparam Right The right-hand tensor type
+  /// \tparam Scalar A scalar type
+  /// \param right The tensor that will be scaled and added to this tensor
+  /// \param factor The scaling factor
+  /// \return A reference to this tensor
+  template <
+      typename Right, typename Scalar,
+      typename std::enable_if<is_tensor<Right>::value &&
+                              detail::is_numeric_v<Scalar>>::type* = nullptr>
+  Tensor_& axpy_to(const Right& right, const Scalar factor) {
+    if constexpr (is_simd_v<Right> && is_simd_scalar_v<Scalar>) {
+      simd_assert(right);
+      math::simd::axpy(size(), factor, right.data(), data());
+      return *this;
+    } else {
+      return inplace_binary(
+          right, [factor](numeric_type& MADNESS_RESTRICT l,
+                          const numeric_t<Right> r) { l += r * factor; });
+    }
+  }
+
   // Subtraction operations
 
   /// Subtract \c right from this and return the result
@@ -1082,11 +1212,18 @@ class Tensor {
   template <typename Right,
             typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
   Tensor_ subt(const Right& right) const {
-    return binary(
-        right,
-        [](const numeric_type l, const numeric_t<Right> r) -> numeric_type {
-          return l - r;
-        });
+    if constexpr (is_simd_v<Right>) {
+      simd_assert(right);
+      Tensor_ result(pimpl_->range_);
+      math::simd::subt(size(), data(), right.data(), result.data());
+      return result;
+    } else {
+      return binary(
+          right,
+          [](const numeric_type l, const numeric_t<Right> r) -> numeric_type {
+            return l - r;
+          });
+    }
   }
 
   /// Subtract \c right from this and return the result permuted by \c perm
@@ -1173,8 +1310,14 @@ class Tensor {
   template <typename Right,
             typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
   Tensor_& subt_to(const Right& right) {
-    return inplace_binary(right, [](numeric_type& MADNESS_RESTRICT l,
-                                    const numeric_t<Right> r) { l -= r; });
+    if constexpr (is_simd_v<Right>) {
+      simd_assert(right);
+      math::simd::subt(size(), data(), right.data(), data());
+      return *this;
+    } else {
+      return inplace_binary(right, [](numeric_type& MADNESS_RESTRICT l,
+                                      const numeric_t<Right> r) { l -= r; });
+    }
   }
 
   /// Subtract \c right from and scale this tensor
@@ -1210,11 +1353,18 @@ class Tensor {
   template <typename Right,
             typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
   Tensor_ mult(const Right& right) const {
-    return binary(
-        right,
-        [](const numeric_type l, const numeric_t<Right> r) -> numeric_type {
-          return l * r;
-        });
+    if constexpr (is_simd_v<Right>) {
+      simd_assert(right);
+      Tensor_ result(pimpl_->range_);
+      math::simd::mult(size(), data(), right.data(), result.data());
+      return result;
+    } else {
+      return binary(
+          right,
+          [](const numeric_type l, const numeric_t<Right> r) -> numeric_type {
+            return l * r;
+          });
+    }
   }
 
   /// Multiply this by \c right to create a new, permuted tensor
@@ -1283,8 +1433,14 @@ class Tensor {
   template <typename Right,
             typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
   Tensor_& mult_to(const Right& right) {
-    return inplace_binary(right, [](numeric_type& MADNESS_RESTRICT l,
-                                    const numeric_t<Right> r) { l *= r; });
+    if constexpr (is_simd_v<Right>) {
+      simd_assert(right);
+      math::simd::mult(size(), data(), right.data(), data());
+      return *this;
+    } else {
+      return inplace_binary(right, [](numeric_type& MADNESS_RESTRICT l,
+                                      const numeric_t<Right> r) { l *= r; });
+    }
   }
 
   /// Scale and multiply this tensor by \c right
@@ -1833,6 +1989,10 @@ class Tensor {
 
   /// \return The maximum elements of this tensor
   scalar_type abs_max() const {
+    if constexpr (math::simd::is_simd_v<value_type>) {
+      TA_ASSERT(pimpl_);
+      return math::simd::abs_max(size(), data());
+    }
     auto abs_max_op = [](scalar_type& MADNESS_RESTRICT res,
                          const numeric_type arg) {
       res = std::max(res, std::abs(arg));
@@ -1853,6 +2013,10 @@ class Tensor {
   template <typename Right,
             typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
   numeric_type dot(const Right& other) const {
+    if constexpr (is_simd_v<Right>) {
+      simd_assert(other);
+      return math::simd::dot(size(), data(), other.data());
+    }
     auto mult_add_op = [](numeric_type& res, const numeric_type l,
                           const numeric_t<Right> r) { res += l * r; };
     auto add_op = [](numeric_type& MADNESS_RESTRICT res,
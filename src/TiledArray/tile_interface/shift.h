@@ -85,8 +85,29 @@ inline auto shift_to(Arg& arg,
   return arg.shift_to(range_shift);
 }
 
+/// Shift the range of \c arg without copying its data
+
+/// \tparam Arg The tile argument type
+/// \tparam Index An integral range type
+/// \param arg The tile argument to be shifted
+/// \param range_shift The offset to be applied to the argument range
+/// \return A tile with a new range that aliases the data of \c arg ;
+/// changes to the elements of either tile are visible in both
+template <typename Arg, typename Index,
+          typename = std::enable_if_t<detail::is_integral_range_v<Index>>>
+inline auto shallow_shift(const Arg& arg, const Index& range_shift) {
+  return arg.shallow_shift(range_shift);
+}
+
+namespace detail {
+
+GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(shallow_shift)
+
+}  // namespace detail
+
 namespace tile_interface {
 
+using TiledArray::shallow_shift;
 using TiledArray::shift;
 using TiledArray::shift_to;
 
@@ -182,6 +203,35 @@ struct shift_trait<Arg, typename std::enable_if<TiledArray::detail::is_type<
 template <typename Result, typename Arg>
 class Shift : public TiledArray::tile_interface::Shift<Result, Arg> {};
 
+/// Shift the range of tile without copying its data
+
+/// This operation shifts the lower and upper bounds of the range of a tile
+/// that shares the data of the argument, if the tile type supports it (i.e.
+/// provides a \c shallow_shift member function, see \c Tensor ). Otherwise,
+/// the tile is deep copied as with \c Shift .
+/// \tparam Result The result tile type
+/// \tparam Argument The argument tile type
+template <typename Result, typename Arg, typename Enabler = void>
+class ShallowShift : public Shift<Result, Arg> {};
+
+template <typename Result, typename Arg>
+class ShallowShift<
+    Result, Arg,
+    typename std::enable_if<
+        std::is_same<Result, Arg>::value &&
+        detail::has_member_function_shallow_shift_anyreturn_v<
+            const Arg, const std::vector<long>&>>::type> {
+ public:
+  typedef Result result_type;  ///< Result tile type
+  typedef Arg argument_type;   ///< Argument tile type
+
+  template <typename Index>
+  result_type operator()(const argument_type& arg,
+                         const Index& range_shift) const {
+    return shallow_shift(arg, range_shift);
+  }
+};
+
 /// Shift the range of tile in place
 
 /// This operation shifts the range of a tile without copying or otherwise
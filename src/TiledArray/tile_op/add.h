@@ -164,6 +164,17 @@ class Add {
   /// \return The scaled sum of `left` and `right`.
   template <typename L, typename R>
   result_type operator()(L&& left, R&& right) const {
+    // Reuse temporary arguments whose data is not shared
+    if constexpr (!left_is_consumable &&
+                  is_unique_consumable_v<L, left_type, result_type>) {
+      if (TiledArray::is_unique(left))
+        return consume_left(left, std::forward<R>(right));
+    }
+    if constexpr (!right_is_consumable &&
+                  is_unique_consumable_v<R, right_type, result_type>) {
+      if (TiledArray::is_unique(right))
+        return consume_right(std::forward<L>(left), right);
+    }
     return Add_::template eval<left_is_consumable, right_is_consumable>(
         std::forward<L>(left), std::forward<R>(right));
   }
@@ -358,6 +369,17 @@ class ScalAdd {
   /// \return The scaled sum of `left` and `right`.
   template <typename L, typename R>
   result_type operator()(L&& left, R&& right) const {
+    // Reuse temporary arguments whose data is not shared
+    if constexpr (!left_is_consumable &&
+                  is_unique_consumable_v<L, left_type, result_type>) {
+      if (TiledArray::is_unique(left))
+        return consume_left(left, std::forward<R>(right));
+    }
+    if constexpr (!right_is_consumable &&
+                  is_unique_consumable_v<R, right_type, result_type>) {
+      if (TiledArray::is_unique(right))
+        return consume_right(std::forward<L>(left), right);
+    }
     return ScalAdd_::template eval<left_is_consumable, right_is_consumable>(
         std::forward<L>(left), std::forward<R>(right));
   }
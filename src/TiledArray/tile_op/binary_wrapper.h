@@ -241,7 +241,7 @@ class BinaryWrapper {
                                               right_is_consumable)>* = nullptr>
   auto operator()(L&& left, R&& right) const {
     auto eval_left = invoke_cast(std::forward<L>(left));
-    auto continuation = [this](decltype(eval_left)& l, R&& r) {
+    auto continuation = [this](decltype(eval_left)& l, R& r) {
       return BinaryWrapper_::operator()(l, std::forward<R>(r));
     };
     return meta::invoke(continuation, eval_left, right);
@@ -293,10 +293,13 @@ class BinaryWrapper {
     auto op_right = [=](eval_t<L>& _left, eval_t<R>& _right) {
       return op_.consume_right(_left, _right);
     };
-    // Override consumable
-    if (is_consumable_tile<eval_t<L> >::value && left.is_consumable())
+    // Override consumable, also if the evaluated tile is not shared (e.g. a
+    // clone of an array tile)
+    if (is_consumable_tile<eval_t<L> >::value &&
+        (left.is_consumable() || TiledArray::is_unique(eval_left)))
       return meta::invoke(op_left, eval_left, eval_right);
-    if (is_consumable_tile<eval_t<R> >::value && right.is_consumable())
+    if (is_consumable_tile<eval_t<R> >::value &&
+        (right.is_consumable() || TiledArray::is_unique(eval_right)))
       return meta::invoke(op_right, eval_left, eval_right);
 
     return meta::invoke(op_, eval_left, eval_right);
@@ -312,8 +315,10 @@ class BinaryWrapper {
 
     if (perm_) return op_(eval_left, std::forward<R>(right), perm_);
 
-    // Override consumable
-    if (is_consumable_tile<eval_t<L> >::value && left.is_consumable())
+    // Override consumable, also if the evaluated tile is not shared (e.g. a
+    // clone of an array tile)
+    if (is_consumable_tile<eval_t<L> >::value &&
+        (left.is_consumable() || TiledArray::is_unique(eval_left)))
       return op_.consume_left(eval_left, std::forward<R>(right));
 
     return op_(eval_left, std::forward<R>(right));
@@ -329,8 +334,10 @@ class BinaryWrapper {
 
     if (perm_) return op_(eval_left, eval_right, perm_);
 
-    // Override consumable
-    if (is_consumable_tile<eval_t<L> >::value && left.is_consumable())
+    // Override consumable, also if the evaluated tile is not shared (e.g. a
+    // clone of an array tile)
+    if (is_consumable_tile<eval_t<L> >::value &&
+        (left.is_consumable() || TiledArray::is_unique(eval_left)))
       return op_.consume_left(eval_left, eval_right);
 
     return op_(eval_left, eval_right);
@@ -345,8 +352,10 @@ class BinaryWrapper {
 
     if (perm_) return op_(std::forward<L>(left), eval_right, perm_);
 
-    // Override consumable
-    if (is_consumable_tile<eval_t<R> >::value && right.is_consumable())
+    // Override consumable, also if the evaluated tile is not shared (e.g. a
+    // clone of an array tile)
+    if (is_consumable_tile<eval_t<R> >::value &&
+        (right.is_consumable() || TiledArray::is_unique(eval_right)))
       return op_.consume_right(std::forward<L>(left), eval_right);
 
     return op_(std::forward<L>(left), eval_right);
@@ -362,8 +371,10 @@ class BinaryWrapper {
 
     if (perm_) return op_(eval_left, eval_right, perm_);
 
-    // Override consumable
-    if (is_consumable_tile<eval_t<R> >::value && right.is_consumable())
+    // Override consumable, also if the evaluated tile is not shared (e.g. a
+    // clone of an array tile)
+    if (is_consumable_tile<eval_t<R> >::value &&
+        (right.is_consumable() || TiledArray::is_unique(eval_right)))
       return op_.consume_right(eval_left, eval_right);
 
     return op_(eval_left, eval_right);
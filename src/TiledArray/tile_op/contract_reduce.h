@@ -26,10 +26,14 @@
 #ifndef TILEDARRAY_TILE_OP_CONTRACT_REDUCE_H__INCLUDED
 #define TILEDARRAY_TILE_OP_CONTRACT_REDUCE_H__INCLUDED
 
+#include <TiledArray/config.h>
+#include <TiledArray/math/gemm_batch.h>
 #include <TiledArray/math/gemm_helper.h>
 #include <TiledArray/permutation.h>
 #include <TiledArray/tensor/complex.h>
+#include <TiledArray/tensor/type_traits.h>
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/util/summa_trace.h>
 #include "../tile_interface/add.h"
 #include "../tile_interface/permute.h"
 
@@ -162,6 +166,26 @@ class ContractReduceBase {
 
 };  // class ContractReduceBase
 
+template <typename Result, typename Left, typename Right, typename Scalar>
+class ContractReduce;
+
+/// Batched contraction trait
+
+/// \c value is \c true if the tile contractions of operation \c Op can be
+/// evaluated in batches (see \c ContractReduce::batch() ), i.e. if the tiles
+/// are \c TiledArray::Tensor objects of the same numeric type and the
+/// scaling factor is numeric.
+/// \tparam Op The contraction operation type
+template <typename Op>
+struct is_batchable_contract : public std::false_type {};
+
+template <typename T, typename AResult, typename ALeft, typename ARight,
+          typename Scalar>
+struct is_batchable_contract<ContractReduce<
+    Tensor<T, AResult>, Tensor<T, ALeft>, Tensor<T, ARight>, Scalar> >
+    : public std::integral_constant<bool, is_numeric_v<T> &&
+                                              is_numeric_v<Scalar> > {};
+
 /// Contract and (sum) reduce operation
 
 /// This encodes a binary tensor contraction mapped to a GEMM, as well as the
@@ -233,8 +257,87 @@ class ContractReduce : public ContractReduceBase<Result, Left, Right, Scalar> {
   /// target
   /// \param[in] arg The argument that will be added to \c result
   void operator()(result_type& result, const result_type& arg) const {
+    SummaTrace::Scope trace(SummaTrace::Event::reduce);
     using TiledArray::add_to;
-    add_to(result, arg);
+    using TiledArray::empty;
+    // Partial results of batched contractions may be reduced with the empty
+    // initial result
+    if (empty(arg)) return;
+    if (empty(result))
+      result = arg;
+    else
+      add_to(result, arg);
+  }
+
+  /// Contract a batch of tile pairs
+
+  /// Computes <tt>*result[p] += factor * left[p] * right[p]</tt> for each of
+  /// the \c count tile pairs with batched GEMMs (see \c math::gemm_batch() ).
+  /// Empty result tiles are initialized with the product. This is only
+  /// available if \c is_batchable_contract is \c true for this operation.
+  /// \param[in] count The number of tile pairs
+  /// \param[in] left The left-hand tiles to be contracted
+  /// \param[in] right The right-hand tiles to be contracted
+  /// \param[in,out] result The result tiles
+  template <typename R = Result,
+            typename std::enable_if<is_batchable_contract<
+                ContractReduce<R, Left, Right, Scalar> >::value>::type* =
+                nullptr>
+  void batch(const std::size_t count, const Left* const* left,
+             const Right* const* right, result_type* const* result) const {
+    SummaTrace::Scope trace(SummaTrace::Event::gemm, count);
+    typedef typename result_type::value_type numeric_type;
+    using TiledArray::empty;
+    const math::GemmHelper& gemm_helper = ContractReduceBase_::gemm_helper();
+
+    // Products are written to new result tiles with beta = 0, and added to
+    // the other result tiles with beta = 1
+    std::vector<integer> m, n, k, lda, ldb;
+    std::vector<const numeric_type*> a, b;
+    std::vector<numeric_type*> c;
+    for (const bool accumulate : {false, true}) {
+      m.clear();
+      n.clear();
+      k.clear();
+      lda.clear();
+      ldb.clear();
+      a.clear();
+      b.clear();
+      c.clear();
+      for (std::size_t p = 0ul; p < count; ++p) {
+        if (empty(*result[p]) == accumulate) continue;
+
+        integer m_p = 0, n_p = 0, k_p = 0;
+        gemm_helper.compute_matrix_sizes(m_p, n_p, k_p, left[p]->range(),
+                                         right[p]->range());
+        m.push_back(m_p);
+        n.push_back(n_p);
+        k.push_back(k_p);
+        lda.push_back(gemm_helper.left_op() == madness::cblas::NoTrans ? k_p
+                                                                       : m_p);
+        ldb.push_back(gemm_helper.right_op() == madness::cblas::NoTrans ? n_p
+                                                                        : k_p);
+
+        if (accumulate) {
+          TA_ASSERT(result[p]->range().volume() ==
+                    std::size_t(m_p) * std::size_t(n_p));
+        } else {
+          *result[p] = result_type(
+              gemm_helper.make_result_range<typename result_type::range_type>(
+                  left[p]->range(), right[p]->range()));
+        }
+        a.push_back(left[p]->data());
+        b.push_back(right[p]->data());
+        c.push_back(result[p]->data());
+      }
+
+      if (!c.empty())
+        math::gemm_batch(gemm_helper.left_op(), gemm_helper.right_op(),
+                         c.size(), m.data(), n.data(), k.data(),
+                         numeric_type(ContractReduceBase_::factor()), a.data(),
+                         lda.data(), b.data(), ldb.data(),
+                         numeric_type(accumulate ? 1 : 0), c.data(), n.data());
+    }
   }
 
   /// Contract a pair of tiles and add to a target tile
@@ -246,6 +349,7 @@ class ContractReduce : public ContractReduceBase<Result, Left, Right, Scalar> {
   /// \param[in] right The right-hand tile to be contracted
   void operator()(result_type& result, first_argument_type left,
                   second_argument_type right) const {
+    SummaTrace::Scope trace(SummaTrace::Event::gemm, 1ul);
     using TiledArray::empty;
     using TiledArray::gemm;
     if (empty(result))
@@ -338,6 +442,7 @@ class ContractReduce<Result, Left, Right,
   /// target
   /// \param[in] arg The argument that will be added to \c result
   void operator()(result_type& result, const result_type& arg) const {
+    SummaTrace::Scope trace(SummaTrace::Event::reduce);
     using TiledArray::add_to;
     add_to(result, arg);
   }
@@ -351,6 +456,7 @@ class ContractReduce<Result, Left, Right,
   /// \param[in] right The right-hand tile to be contracted
   void operator()(result_type& result, first_argument_type left,
                   second_argument_type right) const {
+    SummaTrace::Scope trace(SummaTrace::Event::gemm, 1ul);
     using TiledArray::empty;
     using TiledArray::gemm;
     if (empty(result))
@@ -443,6 +549,7 @@ class ContractReduce<Result, Left, Right,
   /// target
   /// \param[in] arg The argument that will be added to \c result
   void operator()(result_type& result, const result_type& arg) const {
+    SummaTrace::Scope trace(SummaTrace::Event::reduce);
     using TiledArray::add_to;
     add_to(result, arg);
   }
@@ -456,6 +563,7 @@ class ContractReduce<Result, Left, Right,
   /// \param[in] right The right-hand tile to be contracted
   void operator()(result_type& result, first_argument_type left,
                   second_argument_type right) const {
+    SummaTrace::Scope trace(SummaTrace::Event::gemm, 1ul);
     using TiledArray::empty;
     using TiledArray::gemm;
     if (empty(result))
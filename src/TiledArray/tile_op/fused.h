@@ -0,0 +1,308 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_op/fused.h
+ *  Nov 9, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_OP_FUSED_H__INCLUDED
+#define TILEDARRAY_TILE_OP_FUSED_H__INCLUDED
+
+#include "../error.h"
+#include "../permutation.h"
+#include "../tensor/type_traits.h"
+#include "../type_traits.h"
+
+#include <array>
+#include <vector>
+
+namespace TiledArray {
+namespace detail {
+
+/// Checks if tiles of type \c T may be evaluated by fused tile operations
+
+/// Fused tile operations are supported for \c TiledArray::Tensor tiles of
+/// numeric elements.
+template <typename T>
+struct is_fusable_tile : public std::false_type {};
+
+template <typename T, typename A>
+struct is_fusable_tile<Tensor<T, A>> : public is_numeric<T> {};
+
+/// \c is_fusable_tile_v<T> is an alias for \c is_fusable_tile<T>::value
+template <typename T>
+constexpr const bool is_fusable_tile_v = is_fusable_tile<T>::value;
+
+/// Element expression of an argument of a fused tile operation
+
+/// \tparam I The position of the argument
+template <std::size_t I>
+struct FusedArg {
+  static constexpr std::size_t size = I + 1ul;  ///< Number of arguments
+
+  /// \tparam Reader The argument element reader type
+  /// \param reader The reader of the argument elements, where
+  /// <tt>reader(i)</tt> returns the current element of argument \c i
+  /// \return The current element of argument \c I
+  template <typename Reader>
+  auto operator()(const Reader& reader) const {
+    return reader(I);
+  }
+};  // struct FusedArg
+
+/// Element expression of a scaled argument of a fused tile operation
+
+/// \tparam I The position of the argument
+/// \tparam Scalar The scaling factor type
+template <std::size_t I, typename Scalar>
+struct ScalFusedArg {
+  static constexpr std::size_t size = I + 1ul;  ///< Number of arguments
+
+  Scalar factor;  ///< The scaling factor
+
+  /// \tparam Reader The argument element reader type
+  /// \param reader The reader of the argument elements
+  /// \return The current element of argument \c I scaled by \c factor
+  template <typename Reader>
+  auto operator()(const Reader& reader) const {
+    return reader(I) * factor;
+  }
+};  // struct ScalFusedArg
+
+/// Element expression of a binary operation of a fused tile operation
+
+/// \tparam Op The element operation type
+/// \tparam Left The left-hand element expression type
+/// \tparam Right The right-hand element expression type, which reads the
+/// arguments that follow those of \c Left
+template <typename Op, typename Left, typename Right>
+struct FusedBinary {
+  static constexpr std::size_t size = Right::size;  ///< Number of arguments
+
+  Left left;    ///< The left-hand element expression
+  Right right;  ///< The right-hand element expression
+
+  /// \tparam Reader The argument element reader type
+  /// \param reader The reader of the argument elements
+  /// \return <tt>Op()(left(reader), right(reader))</tt>
+  template <typename Reader>
+  auto operator()(const Reader& reader) const {
+    return Op()(left(reader), right(reader));
+  }
+};  // struct FusedBinary
+
+/// Element expression of a scaled binary operation of a fused tile operation
+
+/// \tparam Op The element operation type
+/// \tparam Left The left-hand element expression type
+/// \tparam Right The right-hand element expression type, which reads the
+/// arguments that follow those of \c Left
+/// \tparam Scalar The scaling factor type
+template <typename Op, typename Left, typename Right, typename Scalar>
+struct ScalFusedBinary {
+  static constexpr std::size_t size = Right::size;  ///< Number of arguments
+
+  Left left;      ///< The left-hand element expression
+  Right right;    ///< The right-hand element expression
+  Scalar factor;  ///< The scaling factor
+
+  /// \tparam Reader The argument element reader type
+  /// \param reader The reader of the argument elements
+  /// \return <tt>Op()(left(reader), right(reader)) * factor</tt>
+  template <typename Reader>
+  auto operator()(const Reader& reader) const {
+    return Op()(left(reader), right(reader)) * factor;
+  }
+};  // struct ScalFusedBinary
+
+/// Argument element expression factory function
+
+/// \tparam I The position of the argument
+template <std::size_t I>
+inline FusedArg<I> make_fused_arg() {
+  return FusedArg<I>();
+}
+
+/// Scaled argument element expression factory function
+
+/// \tparam I The position of the argument
+/// \tparam Scalar The scaling factor type
+/// \param factor The scaling factor
+template <std::size_t I, typename Scalar>
+inline ScalFusedArg<I, Scalar> make_fused_arg(const Scalar factor) {
+  return ScalFusedArg<I, Scalar>{factor};
+}
+
+/// Binary element expression factory function
+
+/// \tparam Op The element operation type
+/// \tparam Left The left-hand element expression type
+/// \tparam Right The right-hand element expression type
+/// \param left The left-hand element expression
+/// \param right The right-hand element expression
+template <typename Op, typename Left, typename Right>
+inline FusedBinary<Op, Left, Right> make_fused_binary(const Left& left,
+                                                      const Right& right) {
+  return FusedBinary<Op, Left, Right>{left, right};
+}
+
+/// Scaled binary element expression factory function
+
+/// \tparam Op The element operation type
+/// \tparam Left The left-hand element expression type
+/// \tparam Right The right-hand element expression type
+/// \tparam Scalar The scaling factor type
+/// \param left The left-hand element expression
+/// \param right The right-hand element expression
+/// \param factor The scaling factor
+template <typename Op, typename Left, typename Right, typename Scalar>
+inline ScalFusedBinary<Op, Left, Right, Scalar> make_fused_binary(
+    const Left& left, const Right& right, const Scalar factor) {
+  return ScalFusedBinary<Op, Left, Right, Scalar>{left, right, factor};
+}
+
+/// Fused element-wise tile operation
+
+/// This operation evaluates a tree of element-wise additions,
+/// subtractions, products, and scalings of its argument tiles in a single
+/// pass over the result tile: each argument element is read once, the
+/// permutations of the arguments are applied by strided reads, and no
+/// intermediate tiles are allocated. Zero (empty) argument tiles are read as
+/// zeros.
+/// \tparam Result The result tile type
+/// \tparam Expr The element expression type (see \c FusedArg ,
+/// \c ScalFusedArg , \c FusedBinary , and \c ScalFusedBinary ), which reads
+/// the arguments of the operation by position
+template <typename Result, typename Expr>
+class Fused {
+ public:
+  typedef Fused<Result, Expr> Fused_;  ///< This class type
+  typedef Result result_type;          ///< The result tile type
+  typedef Expr expr_type;              ///< The element expression type
+  typedef typename result_type::value_type value_type;  ///< Element type
+
+  static_assert(is_fusable_tile_v<result_type>,
+                "The result tile type does not support fused evaluation");
+
+  /// The number of arguments
+  static constexpr std::size_t size = expr_type::size;
+
+ private:
+  expr_type expr_;  ///< The element expression
+  std::vector<Permutation>
+      perms_;  ///< The permutation from each argument to the result
+
+ public:
+  /// Constructor
+
+  /// \param expr The element expression
+  /// \param perms The permutations that map the argument tiles to the
+  /// result tile (an empty permutation denotes the identity)
+  Fused(const expr_type& expr, const std::vector<Permutation>& perms)
+      : expr_(expr), perms_(perms) {
+    TA_ASSERT(perms_.size() == size);
+  }
+
+  /// Evaluate the result tile
+
+  /// \param args The argument tiles, where empty tiles denote zero tiles;
+  /// at least one argument must be non-empty
+  /// \return The result tile
+  result_type operator()(const std::vector<const result_type*>& args) const {
+    TA_ASSERT(args.size() == size);
+
+    // The result range is the permuted range of a non-zero argument
+    std::size_t first = 0ul;
+    while (first < size && args[first]->empty()) ++first;
+    TA_ASSERT(first < size);
+    result_type result(perms_[first] ? perms_[first] * args[first]->range()
+                                     : args[first]->range());
+
+    const unsigned int rank = result.range().rank();
+    TA_ASSERT(rank > 0u);
+    const auto* const extent = result.range().extent_data();
+
+    // Gather the argument data and strides in the order of the result
+    // dimensions; zero arguments read a single zero with zero strides.
+    static const value_type zero = value_type(0);
+    std::array<const value_type*, size> data;
+    std::vector<std::size_t> strides(size * rank, 0ul);
+    bool contiguous = true;
+    for (std::size_t a = 0ul; a < size; ++a) {
+      if (args[a]->empty()) {
+        data[a] = &zero;
+        contiguous = false;
+        continue;
+      }
+      data[a] = args[a]->data();
+      const auto* const stride =
+          args[a]->range().stride_data();
+      std::size_t* const arg_strides = &strides[a * rank];
+      for (unsigned int i = 0u; i < rank; ++i)
+        arg_strides[(perms_[a] ? perms_[a][i] : i)] = stride[i];
+      TA_ASSERT((perms_[a] ? perms_[a] * args[a]->range()
+                           : args[a]->range()) == result.range());
+      contiguous = contiguous && (arg_strides[rank - 1u] == 1ul);
+    }
+
+    // Evaluate the result, one run of the innermost dimension at a time
+    const std::size_t n = extent[rank - 1u];
+    const std::size_t volume = result.range().volume();
+    value_type* result_data = result.data();
+    std::array<std::size_t, size> offset;
+    std::array<std::size_t, size> inner;
+    offset.fill(0ul);
+    for (std::size_t a = 0ul; a < size; ++a)
+      inner[a] = strides[a * rank + rank - 1u];
+    std::vector<std::size_t> index(rank, 0ul);
+
+    for (std::size_t run = 0ul; run < volume; run += n) {
+      std::array<const value_type*, size> arg;
+      for (std::size_t a = 0ul; a < size; ++a) arg[a] = data[a] + offset[a];
+
+      if (contiguous) {
+        for (std::size_t j = 0ul; j < n; ++j)
+          result_data[j] =
+              expr_([&](const std::size_t a) { return arg[a][j]; });
+      } else {
+        for (std::size_t j = 0ul; j < n; ++j)
+          result_data[j] = expr_(
+              [&](const std::size_t a) { return arg[a][j * inner[a]]; });
+      }
+      result_data += n;
+
+      // Advance the outer dimensions
+      for (int d = int(rank) - 2; d >= 0; --d) {
+        for (std::size_t a = 0ul; a < size; ++a)
+          offset[a] += strides[a * rank + d];
+        if (++index[d] < extent[d]) break;
+        for (std::size_t a = 0ul; a < size; ++a)
+          offset[a] -= strides[a * rank + d] * extent[d];
+        index[d] = 0ul;
+      }
+    }
+
+    return result;
+  }
+
+};  // class Fused
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_TILE_OP_FUSED_H__INCLUDED
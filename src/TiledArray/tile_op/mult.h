@@ -158,6 +158,17 @@ class Mult {
   /// \return The scaled product of `left` and `right`.
   template <typename L, typename R>
   result_type operator()(L&& left, R&& right) const {
+    // Reuse temporary arguments whose data is not shared
+    if constexpr (!left_is_consumable &&
+                  is_unique_consumable_v<L, left_type, result_type>) {
+      if (TiledArray::is_unique(left))
+        return consume_left(left, std::forward<R>(right));
+    }
+    if constexpr (!right_is_consumable &&
+                  is_unique_consumable_v<R, right_type, result_type>) {
+      if (TiledArray::is_unique(right))
+        return consume_right(std::forward<L>(left), right);
+    }
     return Mult_::template eval<left_is_consumable, right_is_consumable>(
         std::forward<L>(left), std::forward<R>(right));
   }
@@ -344,6 +355,17 @@ class ScalMult {
   /// \return The scaled product of `left` and `right`.
   template <typename L, typename R>
   result_type operator()(L&& left, R&& right) const {
+    // Reuse temporary arguments whose data is not shared
+    if constexpr (!left_is_consumable &&
+                  is_unique_consumable_v<L, left_type, result_type>) {
+      if (TiledArray::is_unique(left))
+        return consume_left(left, std::forward<R>(right));
+    }
+    if constexpr (!right_is_consumable &&
+                  is_unique_consumable_v<R, right_type, result_type>) {
+      if (TiledArray::is_unique(right))
+        return consume_right(std::forward<L>(left), right);
+    }
     return ScalMult_::template eval<left_is_consumable, right_is_consumable>(
         std::forward<L>(left), std::forward<R>(right));
   }
@@ -112,6 +112,11 @@ class Scal {
   /// \return A scaled copy of `arg`
   template <typename A>
   result_type operator()(A&& arg) const {
+    // Reuse a temporary argument whose data is not shared
+    if constexpr (!is_consumable &&
+                  is_unique_consumable_v<A, argument_type, result_type>) {
+      if (TiledArray::is_unique(arg)) return consume(arg);
+    }
     return Scal_::template eval<is_consumable>(std::forward<A>(arg));
   }
 
@@ -40,14 +40,19 @@ namespace detail {
 /// \tparam Arg The argument type
 /// \tparam Consumable If `true`, the tile is a temporary and may be
 /// consumed
+/// \tparam Shallow If `true`, a tile that is not consumed or permuted shares
+/// its data with the result, if the tile type supports it (see
+/// \c ShallowShift ); the result must then not be modified in place
 /// \note Input tiles can be consumed only if their type matches the result
 /// type.
-template <typename Result, typename Arg, bool Consumable>
+template <typename Result, typename Arg, bool Consumable,
+          bool Shallow = false>
 class Shift {
  public:
-  typedef Shift<Result, Arg, Consumable> Shift_;  ///< This object type
-  typedef Arg argument_type;                      ///< The argument type
-  typedef Result result_type;                     ///< The result tile type
+  typedef Shift<Result, Arg, Consumable, Shallow>
+      Shift_;                  ///< This object type
+  typedef Arg argument_type;   ///< The argument type
+  typedef Result result_type;  ///< The result tile type
 
   /// Indicates whether it is *possible* to consume the left tile
   static constexpr bool is_consumable =
@@ -70,11 +75,15 @@ class Shift {
 
   // Non-permuting tile evaluation functions
   // The compiler will select the correct functions based on the
-  // consumability of the arguments.
+  // consumability of the arguments. Arguments that cannot be consumed are
+  // copied, or share their data with the result if Shallow is true.
 
   template <bool C, typename = void>
   auto eval(const argument_type& arg) const {
-    TiledArray::Shift<result_type, argument_type> shift;
+    std::conditional_t<Shallow,
+                       TiledArray::ShallowShift<result_type, argument_type>,
+                       TiledArray::Shift<result_type, argument_type> >
+        shift;
     return shift(arg, range_shift_);
   }
 
@@ -263,6 +263,55 @@ class LazyArrayTile;
 
 using std::empty;
 
+// Ownership operations ------------------------------------------------------
+
+namespace detail {
+
+/// Checks if the data of \c T tiles may be owned by a single tile
+
+/// \c true if \c T has a \c use_count() member and numeric elements;
+/// tensors of tensors are excluded, since their elements are shallow-copy
+/// objects that may be shared even if the outer tensor is not.
+template <typename T, typename Enabler = void>
+struct has_tile_use_count : public std::false_type {};
+
+template <typename T>
+struct has_tile_use_count<
+    T, std::void_t<decltype(std::declval<const T&>().use_count()),
+                   typename T::value_type>>
+    : public std::bool_constant<is_numeric_v<typename T::value_type>> {};
+
+/// Checks if an argument of a tile operation may be consumed at runtime
+
+/// \c true if the deduced forwarding-reference type \c Arg is a non-const
+/// rvalue of the parameter type \c Param , which is also the result type
+/// \c Result of the operation, i.e. if the caller gave up the argument and
+/// it may be reused for the result when \c is_unique() is \c true .
+template <typename Arg, typename Param, typename Result>
+constexpr const bool is_unique_consumable_v =
+    std::is_same<Arg, Param>::value && std::is_same<Param, Result>::value &&
+    is_consumable_tile<Param>::value;
+
+}  // namespace detail
+
+/// Check if the data of a tile is not shared with another tile
+
+/// Tiles are shallow-copy objects, so a tile that is not consumable by
+/// construction may still be modified in place if no other tile references
+/// its data, e.g. a tile that was cloned from an array tile.
+/// \tparam Arg The tile argument type
+/// \param arg The tile argument
+/// \return \c true if \c arg.use_count() is 1 (e.g.
+/// \c Tensor::use_count() ), \c false if it is larger or if \c Arg does not
+/// provide \c use_count()
+template <typename Arg>
+inline bool is_unique(const Arg& arg) {
+  if constexpr (detail::has_tile_use_count<Arg>::value)
+    return arg.use_count() == 1l;
+  else
+    return false;
+}
+
 // Subtraction ---------------------------------------------------------------
 
 /// Subtract tile arguments
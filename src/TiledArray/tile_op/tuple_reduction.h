@@ -0,0 +1,167 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_op/tuple_reduction.h
+ *  Nov 17, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_OP_TUPLE_REDUCTION_H__INCLUDED
+#define TILEDARRAY_TILE_OP_TUPLE_REDUCTION_H__INCLUDED
+
+#include <TiledArray/type_traits.h>
+
+#include <tuple>
+#include <utility>
+
+namespace TiledArray {
+namespace detail {
+
+/// Checks if a reduction operation reduces pairs of tiles
+
+/// \c true if \c Op provides \c first_argument_type , i.e. it is a binary
+/// reduction (see \c DotReduction ), \c false if it is a unary reduction
+/// (see \c SumReduction ).
+template <typename Op, typename Enabler = void>
+struct is_binary_reduction : public std::false_type {};
+
+template <typename Op>
+struct is_binary_reduction<Op, std::void_t<typename Op::first_argument_type>>
+    : public std::true_type {};
+
+template <typename Op>
+constexpr const bool is_binary_reduction_v = is_binary_reduction<Op>::value;
+
+}  // namespace detail
+
+/// Tuple of tile reductions
+
+/// This reduction operation applies several reductions to each tile in a
+/// single sweep, so that the tiles are evaluated only once. The result is
+/// the tuple of the results of \c Ops . Unary reductions (e.g.
+/// \c SquaredNormReduction ) are applied to the left-hand tiles, binary
+/// reductions (e.g. \c DotReduction ) to pairs of left- and right-hand tiles.
+/// Since pairs are reduced only if both tiles are non-zero, left-hand tiles
+/// that are reduced without a right-hand tile (see
+/// <tt>operator()(result_type&, const argument_type&)</tt> ) are reduced by
+/// the unary reductions only.
+/// \tparam Left The left-hand tile type
+/// \tparam Right The right-hand tile type, or \c void if all reductions are
+/// unary
+/// \tparam Ops The reduction operation types
+template <typename Left, typename Right, typename... Ops>
+class TupleReduction {
+  static_assert(sizeof...(Ops) > 0ul,
+                "TupleReduction requires at least one reduction operation");
+
+ public:
+  // typedefs
+  typedef std::tuple<typename Ops::result_type...> result_type;
+  typedef Left argument_type;
+  typedef Left first_argument_type;
+  typedef Right second_argument_type;
+
+ private:
+  std::tuple<Ops...> ops_;  ///< The reduction operations
+
+  typedef std::index_sequence_for<Ops...> indices;
+
+  template <std::size_t... Is>
+  result_type init(std::index_sequence<Is...>) const {
+    return result_type(std::get<Is>(ops_)()...);
+  }
+
+  template <std::size_t... Is>
+  result_type post_process(const result_type& result,
+                           std::index_sequence<Is...>) const {
+    return result_type(std::get<Is>(ops_)(std::get<Is>(result))...);
+  }
+
+  template <std::size_t... Is>
+  void reduce_results(result_type& result, const result_type& arg,
+                      std::index_sequence<Is...>) const {
+    (std::get<Is>(ops_)(std::get<Is>(result), std::get<Is>(arg)), ...);
+  }
+
+  template <typename Op>
+  static void reduce_left(const Op& op, typename Op::result_type& result,
+                          const argument_type& left) {
+    if constexpr (!detail::is_binary_reduction_v<Op>) op(result, left);
+  }
+
+  template <std::size_t... Is>
+  void reduce_lefts(result_type& result, const argument_type& left,
+                    std::index_sequence<Is...>) const {
+    (reduce_left(std::get<Is>(ops_), std::get<Is>(result), left), ...);
+  }
+
+  template <typename Op, typename R>
+  static void reduce_pair(const Op& op, typename Op::result_type& result,
+                          const argument_type& left, const R& right) {
+    if constexpr (detail::is_binary_reduction_v<Op>)
+      op(result, left, right);
+    else
+      op(result, left);
+  }
+
+  template <typename R, std::size_t... Is>
+  void reduce_pairs(result_type& result, const argument_type& left,
+                    const R& right, std::index_sequence<Is...>) const {
+    (reduce_pair(std::get<Is>(ops_), std::get<Is>(result), left, right), ...);
+  }
+
+ public:
+  TupleReduction() = default;
+
+  /// Constructor
+
+  /// \param ops The reduction operations
+  explicit TupleReduction(const Ops&... ops) : ops_(ops...) {}
+
+  // Reduction functions
+
+  // Make an empty result object
+  result_type operator()() const { return init(indices{}); }
+
+  // Post process the result
+  result_type operator()(const result_type& result) const {
+    return post_process(result, indices{});
+  }
+
+  // Reduce two result objects
+  void operator()(result_type& result, const result_type& arg) const {
+    reduce_results(result, arg, indices{});
+  }
+
+  // Reduce a left-hand argument with the unary reductions
+  void operator()(result_type& result, const argument_type& left) const {
+    reduce_lefts(result, left, indices{});
+  }
+
+  // Reduce an argument pair with all reductions
+  template <typename R, typename = std::enable_if_t<
+                            std::is_same<R, second_argument_type>::value>>
+  void operator()(result_type& result, const argument_type& left,
+                  const R& right) const {
+    reduce_pairs(result, left, right, indices{});
+  }
+
+};  // class TupleReduction
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_TILE_OP_TUPLE_REDUCTION_H__INCLUDED
@@ -141,6 +141,17 @@ class UnaryWrapper {
     return (perm_ ? op_(arg, perm_) : op_(arg));
   }
 
+  /// Apply operator to `arg` and possibly permute the result
+
+  /// The operation may reuse `arg` for the result if its data is not
+  /// shared.
+  /// \param arg The argument
+  /// \return The result tile from the unary operation applied to the
+  /// \c arg .
+  auto operator()(argument_type&& arg) const {
+    return (perm_ ? op_(std::move(arg), perm_) : op_(std::move(arg)));
+  }
+
   /// Evaluate a lazy tile
 
   /// This function will evaluate `arg`, then pass the evaluated tile to
@@ -176,7 +187,7 @@ class UnaryWrapper {
     //        };
     auto op_consume = [this](eval_t<A>& arg) { return op_.consume(arg); };
     return (perm_ ? meta::invoke(op_, std::move(cast_arg), perm_)
-                  : (arg.is_consumable()
+                  : (arg.is_consumable() || TiledArray::is_unique(cast_arg)
                          ? meta::invoke(op_consume, cast_arg)
                          : meta::invoke(op_, std::move(cast_arg))));
   }
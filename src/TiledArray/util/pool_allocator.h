@@ -0,0 +1,449 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util/pool_allocator.h
+ *  Nov 20, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_UTIL_POOL_ALLOCATOR_H__INCLUDED
+#define TILEDARRAY_UTIL_POOL_ALLOCATOR_H__INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <ostream>
+
+namespace TiledArray {
+
+/// Statistics of the pooled allocator of this process (see \c PoolAllocator )
+struct PoolAllocatorStats {
+  std::size_t allocations;    ///< Number of allocations
+  std::size_t deallocations;  ///< Number of deallocations
+  std::size_t thread_hits;    ///< Allocations served by the free lists of the
+                              ///< allocating thread
+  std::size_t shared_hits;    ///< Allocations served by the shared free lists
+  std::size_t system_allocations;  ///< Blocks allocated from the system
+  std::size_t large_allocations;   ///< Allocations larger than the largest
+                                   ///< size class, which are not pooled
+  std::size_t bytes_in_use;       ///< Size of the allocated blocks, in bytes
+  std::size_t peak_bytes_in_use;  ///< Maximum of \c bytes_in_use
+  std::size_t bytes_cached;  ///< Size of the blocks in the free lists, in
+                             ///< bytes
+};
+
+/// Pooled memory allocator
+
+/// Blocks are rounded up to size classes, which are spaced by a quarter of a
+/// power of two from 64 bytes to 64 MiB, so that tiles of the same volume
+/// share a size class and the size of a block exceeds the requested size by
+/// at most 25%. Freed blocks are kept in the free lists of the freeing
+/// thread, up to \c thread_cache_limit() bytes per thread; the excess, and
+/// the free lists of exiting threads, are moved to free lists that are
+/// shared by all threads, up to \c shared_cache_limit() bytes. Allocations
+/// are served by the free lists of the allocating thread, then by the shared
+/// free lists, and only then by the system. Blocks are aligned to 64 bytes.
+/// Larger allocations are passed to the system directly.
+///
+/// The allocator is used by the Tensor typedefs (e.g. \c TensorD ) if
+/// TiledArray is configured with \c TA_TENSOR_POOL_ALLOCATOR , or by
+/// \c Tensor<T,pool_allocator<T>> explicitly.
+class PoolAllocator {
+ public:
+  static constexpr std::size_t alignment = 64ul;  ///< Block alignment
+  static constexpr std::size_t min_block_size = 64ul;  ///< Smallest class
+  static constexpr std::size_t max_block_size = 64ul << 20;  ///< Largest class
+
+  /// Allocate a block
+
+  /// \param bytes The size of the block, in bytes
+  /// \return A pointer to the block
+  /// \throw std::bad_alloc if the block cannot be allocated
+  static void* allocate(const std::size_t bytes) {
+    Pool& pool = instance();
+    pool.allocations.fetch_add(1ul, std::memory_order_relaxed);
+
+    if (bytes > max_block_size) {
+      pool.large_allocations.fetch_add(1ul, std::memory_order_relaxed);
+      pool.system_allocations.fetch_add(1ul, std::memory_order_relaxed);
+      add_in_use(pool, bytes);
+      return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    const std::size_t c = size_class(bytes);
+    const std::size_t size = class_size(c);
+    add_in_use(pool, size);
+
+    // Free list of this thread
+    ThreadCache& cache = thread_cache();
+    if (void* block = cache.lists[c].pop()) {
+      cache.bytes -= size;
+      pool.bytes_cached.fetch_sub(size, std::memory_order_relaxed);
+      pool.thread_hits.fetch_add(1ul, std::memory_order_relaxed);
+      return block;
+    }
+
+    // Shared free list
+    {
+      std::lock_guard<std::mutex> lock(pool.mutexes[c]);
+      if (void* block = pool.lists[c].pop()) {
+        pool.shared_bytes -= size;
+        pool.bytes_cached.fetch_sub(size, std::memory_order_relaxed);
+        pool.shared_hits.fetch_add(1ul, std::memory_order_relaxed);
+        return block;
+      }
+    }
+
+    pool.system_allocations.fetch_add(1ul, std::memory_order_relaxed);
+    return ::operator new(size, std::align_val_t(alignment));
+  }
+
+  /// Deallocate a block
+
+  /// \param block The block, allocated by \c allocate() , or \c nullptr
+  /// \param bytes The size of the block, as passed to \c allocate()
+  static void deallocate(void* const block, const std::size_t bytes) {
+    if (block == nullptr) return;
+    Pool& pool = instance();
+    pool.deallocations.fetch_add(1ul, std::memory_order_relaxed);
+
+    if (bytes > max_block_size) {
+      pool.bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+      ::operator delete(block, std::align_val_t(alignment));
+      return;
+    }
+
+    const std::size_t c = size_class(bytes);
+    const std::size_t size = class_size(c);
+    pool.bytes_in_use.fetch_sub(size, std::memory_order_relaxed);
+    pool.bytes_cached.fetch_add(size, std::memory_order_relaxed);
+
+    ThreadCache& cache = thread_cache();
+    if (!cache.alive) {  // the thread is exiting
+      pool.bytes_cached.fetch_sub(size, std::memory_order_relaxed);
+      ::operator delete(block, std::align_val_t(alignment));
+      return;
+    }
+    cache.lists[c].push(block);
+    cache.bytes += size;
+    if (cache.bytes > thread_cache_limit()) cache.trim(c);
+  }
+
+  /// Statistics of this process
+
+  /// \return The statistics since the last \c reset_stats()
+  static PoolAllocatorStats stats() {
+    const Pool& pool = instance();
+    auto load = [](const std::atomic<std::size_t>& value) {
+      return value.load(std::memory_order_relaxed);
+    };
+    return PoolAllocatorStats{load(pool.allocations),
+                              load(pool.deallocations),
+                              load(pool.thread_hits),
+                              load(pool.shared_hits),
+                              load(pool.system_allocations),
+                              load(pool.large_allocations),
+                              load(pool.bytes_in_use),
+                              load(pool.peak_bytes_in_use),
+                              load(pool.bytes_cached)};
+  }
+
+  /// Reset the event counters of the statistics
+
+  /// The counts of allocations and hits are reset, and the peak size is set
+  /// to the current size of the allocated blocks.
+  static void reset_stats() {
+    Pool& pool = instance();
+    pool.allocations = 0ul;
+    pool.deallocations = 0ul;
+    pool.thread_hits = 0ul;
+    pool.shared_hits = 0ul;
+    pool.system_allocations = 0ul;
+    pool.large_allocations = 0ul;
+    pool.peak_bytes_in_use = pool.bytes_in_use.load();
+  }
+
+  /// Return cached blocks to the system
+
+  /// The blocks in the free lists of the calling thread and in the shared
+  /// free lists are freed; those of other threads are kept.
+  static void release() {
+    Pool& pool = instance();
+    ThreadCache& cache = thread_cache();
+    for (std::size_t c = 0ul; c < num_classes; ++c) {
+      while (void* block = cache.lists[c].pop()) {
+        pool.bytes_cached.fetch_sub(class_size(c), std::memory_order_relaxed);
+        ::operator delete(block, std::align_val_t(alignment));
+      }
+    }
+    cache.bytes = 0ul;
+
+    for (std::size_t c = 0ul; c < num_classes; ++c) {
+      std::lock_guard<std::mutex> lock(pool.mutexes[c]);
+      while (void* block = pool.lists[c].pop()) {
+        pool.shared_bytes -= class_size(c);
+        pool.bytes_cached.fetch_sub(class_size(c), std::memory_order_relaxed);
+        ::operator delete(block, std::align_val_t(alignment));
+      }
+    }
+  }
+
+  /// Maximum size of the free lists of a thread
+
+  /// \return The maximum size, in bytes, of the blocks kept by a thread
+  static std::size_t thread_cache_limit() {
+    return instance().thread_limit.load(std::memory_order_relaxed);
+  }
+
+  /// Set the maximum size of the free lists of a thread
+
+  /// \param bytes The maximum size, in bytes (default: 64 MiB)
+  static void set_thread_cache_limit(const std::size_t bytes) {
+    instance().thread_limit.store(bytes, std::memory_order_relaxed);
+  }
+
+  /// Maximum size of the shared free lists
+
+  /// \return The maximum size, in bytes, of the blocks kept by the shared
+  /// free lists
+  static std::size_t shared_cache_limit() {
+    return instance().shared_limit.load(std::memory_order_relaxed);
+  }
+
+  /// Set the maximum size of the shared free lists
+
+  /// \param bytes The maximum size, in bytes (default: 1 GiB)
+  static void set_shared_cache_limit(const std::size_t bytes) {
+    instance().shared_limit.store(bytes, std::memory_order_relaxed);
+  }
+
+  /// Size class of a block
+
+  /// \param bytes The size of the block, in bytes, which must not be larger
+  /// than \c max_block_size
+  /// \return The index of the smallest size class that fits \c bytes
+  static std::size_t size_class(const std::size_t bytes) {
+    if (bytes <= min_block_size) return 0ul;
+    const std::size_t k = log2_floor(bytes - 1ul);  // 2^k < bytes <= 2^(k+1)
+    const std::size_t quarter = (std::size_t(1) << k) >> 2;
+    const std::size_t j = (bytes - (std::size_t(1) << k) + quarter - 1ul) /
+                          quarter;  // 1 <= j <= 4
+    return (k - log2_min_block_size) * 4ul + j;
+  }
+
+  /// Size of the blocks of a size class
+
+  /// \param c The index of the size class
+  /// \return The size of the blocks of class \c c , in bytes
+  static std::size_t class_size(const std::size_t c) {
+    if (c == 0ul) return min_block_size;
+    const std::size_t k = (c - 1ul) / 4ul + log2_min_block_size;
+    const std::size_t j = (c - 1ul) % 4ul + 1ul;
+    return (std::size_t(1) << k) + j * ((std::size_t(1) << k) >> 2);
+  }
+
+ private:
+  static constexpr std::size_t log2_min_block_size = 6ul;
+  static constexpr std::size_t num_classes =
+      (26ul - log2_min_block_size) * 4ul + 1ul;
+
+  static std::size_t log2_floor(std::size_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * 8ul - 1ul -
+           std::size_t(__builtin_clzll(x));
+#else
+    std::size_t result = 0ul;
+    while (x >>= 1) ++result;
+    return result;
+#endif
+  }
+
+  /// Intrusive list of free blocks
+  struct FreeList {
+    void* head = nullptr;  ///< The first block
+
+    void push(void* const block) {
+      *static_cast<void**>(block) = head;
+      head = block;
+    }
+
+    void* pop() {
+      void* const block = head;
+      if (block) head = *static_cast<void**>(block);
+      return block;
+    }
+  };
+
+  /// Allocator state of this process
+  struct Pool {
+    std::array<FreeList, num_classes> lists;   ///< Shared free lists
+    std::array<std::mutex, num_classes> mutexes;  ///< Guard the shared lists
+    std::size_t shared_bytes = 0ul;  ///< Size of the shared lists (guarded by
+                                     ///< the mutex of the modified list)
+    std::atomic<std::size_t> thread_limit{64ul << 20};
+    std::atomic<std::size_t> shared_limit{1ul << 30};
+    std::atomic<std::size_t> allocations{0ul};
+    std::atomic<std::size_t> deallocations{0ul};
+    std::atomic<std::size_t> thread_hits{0ul};
+    std::atomic<std::size_t> shared_hits{0ul};
+    std::atomic<std::size_t> system_allocations{0ul};
+    std::atomic<std::size_t> large_allocations{0ul};
+    std::atomic<std::size_t> bytes_in_use{0ul};
+    std::atomic<std::size_t> peak_bytes_in_use{0ul};
+    std::atomic<std::size_t> bytes_cached{0ul};
+  };
+
+  /// Free lists of a thread
+  struct ThreadCache {
+    std::array<FreeList, num_classes> lists;  ///< The free lists
+    std::size_t bytes = 0ul;                   ///< Size of the free lists
+    bool alive = true;  ///< \c false once the thread cache was destroyed
+
+    /// Move the blocks of a size class to the shared free lists
+
+    /// Blocks that do not fit the shared free lists are freed.
+    /// \param c The size class
+    void trim(const std::size_t c) {
+      Pool& pool = instance();
+      const std::size_t size = class_size(c);
+      std::lock_guard<std::mutex> lock(pool.mutexes[c]);
+      while (void* block = lists[c].pop()) {
+        bytes -= size;
+        if (pool.shared_bytes + size <= shared_cache_limit()) {
+          pool.lists[c].push(block);
+          pool.shared_bytes += size;
+        } else {
+          pool.bytes_cached.fetch_sub(size, std::memory_order_relaxed);
+          ::operator delete(block, std::align_val_t(alignment));
+        }
+      }
+    }
+
+    ~ThreadCache() {
+      alive = false;
+      for (std::size_t c = 0ul; c < num_classes; ++c) trim(c);
+    }
+  };
+
+  /// Allocator state accessor
+
+  /// The state is never destroyed, so that blocks may be deallocated by
+  /// static objects and exiting threads.
+  static Pool& instance() {
+    static Pool* const pool = new Pool;
+    return *pool;
+  }
+
+  /// Free lists of the calling thread
+  static ThreadCache& thread_cache() {
+    thread_local ThreadCache cache;
+    return cache;
+  }
+
+  static void add_in_use(Pool& pool, const std::size_t size) {
+    const std::size_t in_use =
+        pool.bytes_in_use.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = pool.peak_bytes_in_use.load(std::memory_order_relaxed);
+    while (in_use > peak && !pool.peak_bytes_in_use.compare_exchange_weak(
+                                peak, in_use, std::memory_order_relaxed)) {
+    }
+  }
+};  // class PoolAllocator
+
+/// Pooled allocator
+
+/// A standard allocator that allocates from \c PoolAllocator , e.g. for
+/// the elements of \c Tensor :
+/// \code
+/// TiledArray::Tensor<double, TiledArray::pool_allocator<double>> t(range);
+/// \endcode
+/// \tparam T The element type
+template <typename T>
+class pool_allocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef pool_allocator<U> other;
+  };
+
+  static_assert(alignof(T) <= PoolAllocator::alignment,
+                "pool_allocator: the alignment of T is not supported");
+
+  pool_allocator() noexcept = default;
+
+  template <typename U>
+  pool_allocator(const pool_allocator<U>&) noexcept {}
+
+  /// Allocate elements
+
+  /// \param n The number of elements
+  /// \return A pointer to uninitialized storage for \c n elements
+  pointer allocate(const size_type n) {
+    return static_cast<pointer>(PoolAllocator::allocate(n * sizeof(T)));
+  }
+
+  /// Deallocate elements
+
+  /// \param p The storage, allocated by \c allocate(n)
+  /// \param n The number of elements
+  void deallocate(pointer p, const size_type n) {
+    PoolAllocator::deallocate(p, n * sizeof(T));
+  }
+};  // class pool_allocator
+
+template <typename T, typename U>
+inline bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) {
+  return false;
+}
+
+/// Pooled allocator statistics output operator
+
+/// \param os The output stream
+/// \param stats The statistics
+/// \return \c os
+inline std::ostream& operator<<(std::ostream& os,
+                                const PoolAllocatorStats& stats) {
+  os << "allocations=" << stats.allocations
+     << " deallocations=" << stats.deallocations
+     << " thread_hits=" << stats.thread_hits
+     << " shared_hits=" << stats.shared_hits
+     << " system_allocations=" << stats.system_allocations
+     << " large_allocations=" << stats.large_allocations
+     << " bytes_in_use=" << stats.bytes_in_use
+     << " peak_bytes_in_use=" << stats.peak_bytes_in_use
+     << " bytes_cached=" << stats.bytes_cached;
+  return os;
+}
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_UTIL_POOL_ALLOCATOR_H__INCLUDED
@@ -0,0 +1,115 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util/record_log.h
+ *  Oct 16, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_UTIL_RECORD_LOG_H__INCLUDED
+#define TILEDARRAY_UTIL_RECORD_LOG_H__INCLUDED
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+namespace detail {
+
+/// Records of a process that are collected while a switch is on
+
+/// This is the state shared by the process-wide logs and trackers (e.g.
+/// \c SummaTrace , \c expressions::PermPlacementLog and
+/// \c expressions::AsyncEval ), which hold a single instance each: a flag
+/// that is checked with a relaxed atomic load, and a list of records that
+/// is guarded by a mutex.
+/// \tparam Record The record type
+template <typename Record>
+class RecordLog {
+ public:
+  /// \param enabled The initial state of the switch
+  explicit RecordLog(const bool enabled = false) : enabled_(enabled) {}
+
+  RecordLog(const RecordLog&) = delete;
+  RecordLog& operator=(const RecordLog&) = delete;
+
+  /// \return \c true if the switch is on
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /// Turn the switch on
+  void enable() { enabled_.store(true); }
+
+  /// Turn the switch off
+
+  /// Records that were added before are kept.
+  void disable() { enabled_.store(false); }
+
+  /// Append a record
+
+  /// \param record The record
+  void push(Record record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.push_back(std::move(record));
+  }
+
+  /// \return A copy of the records, in the order they were added
+  std::vector<Record> records() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+  }
+
+  /// Discard the records
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.clear();
+  }
+
+  /// Apply an operation to the records while they are locked
+
+  /// \tparam Op The operation type
+  /// \param op The operation, which is called with a reference to the
+  /// vector of records
+  /// \return The result of \c op
+  template <typename Op>
+  decltype(auto) locked(Op&& op) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::forward<Op>(op)(records_);
+  }
+
+  /// Apply an operation to the records while they are locked
+
+  /// \tparam Op The operation type
+  /// \param op The operation, which is called with a const reference to
+  /// the vector of records
+  /// \return The result of \c op
+  template <typename Op>
+  decltype(auto) locked(Op&& op) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::forward<Op>(op)(records_);
+  }
+
+ private:
+  std::atomic<bool> enabled_;    ///< The switch
+  mutable std::mutex mutex_;     ///< Guards the records
+  std::vector<Record> records_;  ///< The records
+};  // class RecordLog
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_UTIL_RECORD_LOG_H__INCLUDED
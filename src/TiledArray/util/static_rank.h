@@ -0,0 +1,78 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util/static_rank.h
+ *  Oct 16, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_UTIL_STATIC_RANK_H__INCLUDED
+#define TILEDARRAY_UTIL_STATIC_RANK_H__INCLUDED
+
+#include <type_traits>
+#include <utility>
+
+namespace TiledArray {
+namespace detail {
+
+/// The largest rank for which index computations are specialized
+constexpr const unsigned int max_static_rank = 4u;
+
+/// Compile-time rank tag
+
+/// \c static_rank<0> denotes a rank that is only known at runtime.
+template <unsigned int N>
+using static_rank = std::integral_constant<unsigned int, N>;
+
+/// Call a function with a compile-time rank
+
+/// Index computations (e.g. \c Range::ordinal() ) are written once, with a
+/// loop bound of \c N if \c N is non-zero and of the runtime rank otherwise,
+/// and called through this function, so that the loops of the most common
+/// ranks are fully unrolled by the compiler:
+/// \code
+/// const unsigned int n = (N ? N : rank);  // N is the static rank
+/// for (unsigned int d = 0u; d < n; ++d) ...
+/// \endcode
+/// \tparam Op The function type
+/// \param rank The runtime rank
+/// \param op The function, which is called with \c static_rank<rank> if
+/// \c rank is in [1, \c max_static_rank ], or with \c static_rank<0>
+/// otherwise
+/// \return The result of \c op
+template <typename Op>
+inline decltype(auto) with_static_rank(const unsigned int rank, Op&& op) {
+  static_assert(max_static_rank == 4u,
+                "with_static_rank: update the cases for max_static_rank");
+  switch (rank) {
+    case 1u:
+      return std::forward<Op>(op)(static_rank<1u>{});
+    case 2u:
+      return std::forward<Op>(op)(static_rank<2u>{});
+    case 3u:
+      return std::forward<Op>(op)(static_rank<3u>{});
+    case 4u:
+      return std::forward<Op>(op)(static_rank<4u>{});
+    default:
+      return std::forward<Op>(op)(static_rank<0u>{});
+  }
+}
+
+}  // namespace detail
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_UTIL_STATIC_RANK_H__INCLUDED
@@ -0,0 +1,333 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  util/summa_trace.h
+ *  Oct 27, 2020
+ *
+ */
+
+#ifndef TILEDARRAY_UTIL_SUMMA_TRACE_H__INCLUDED
+#define TILEDARRAY_UTIL_SUMMA_TRACE_H__INCLUDED
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <TiledArray/error.h>
+#include <TiledArray/util/record_log.h>
+#include <TiledArray/util/time.h>
+
+namespace TiledArray {
+
+/// Runtime tracer of SUMMA evaluation events
+
+/// When enabled, the SUMMA evaluator records timestamped events (evaluation,
+/// initialization, SUMMA iterations and their pipeline depth, broadcasts,
+/// tile GEMMs, reductions, and finalization) in per-thread buffers of each
+/// process. The events of a process are written with \c write() , which
+/// must not be called while SUMMA evaluations are in progress (i.e. call it
+/// after a fence), or when the program exits.
+///
+/// Tracing is enabled at runtime with \c enable() , or by setting the
+/// \c TA_SUMMA_TRACE environment variable to the output file prefix; the
+/// \c TA_SUMMA_TRACE_FORMAT environment variable selects the output format
+/// ( \c json , the default, or \c binary ). The events of process \c rank
+/// are written to <tt>prefix.rank.json</tt> in the Chrome trace event format
+/// (viewable with \c chrome://tracing or Perfetto), or to
+/// <tt>prefix.rank.bin</tt> in a compact binary format: the 8-byte magic
+/// string <tt>"TASUMMA1"</tt>, the rank and the number of records as 64-bit
+/// integers, followed by the records, each made of the time (ns, int64), the
+/// argument (uint64), the id (uint64), the thread (uint32), the event
+/// (uint8), and the phase (char) in native byte order. When tracing is
+/// disabled, each trace point costs a relaxed atomic load.
+class SummaTrace {
+ public:
+  /// Traced events
+  enum class Event : std::uint8_t {
+    eval,        ///< Evaluation of a contraction (argument = 0)
+    initialize,  ///< Initialization of the reduce tasks (argument = 0)
+    step,        ///< SUMMA iteration (argument = k)
+    depth,       ///< Number of SUMMA iterations in flight (argument = depth)
+    bcast,       ///< Broadcast of the argument tiles of an iteration
+                 ///< (argument = k)
+    gemm,        ///< Tile contraction (argument = number of tile pairs)
+    reduce,      ///< Reduction of partial result tiles (argument = 0)
+    finalize     ///< Finalization of the result tiles (argument = 0)
+  };
+
+  /// Event phases, with the Chrome trace event phase characters
+  enum class Phase : char {
+    begin = 'B',        ///< Begin of a duration on the recording thread
+    end = 'E',          ///< End of a duration on the recording thread
+    async_begin = 'b',  ///< Begin of a duration that may end on any thread
+    async_end = 'e',    ///< End of a duration that began on any thread
+    counter = 'C'       ///< Counter value
+  };
+
+  /// Output formats
+  enum class Format { json, binary };
+
+  /// Trace record
+  struct Record {
+    std::int64_t time;    ///< Time since the start of the trace (ns)
+    std::uint64_t arg;    ///< Event argument
+    std::uint64_t id;     ///< Event id, used to match asynchronous events
+    std::uint32_t thread;  ///< The recording thread
+    Event event;           ///< The event
+    Phase phase;           ///< The event phase
+  };
+
+  /// Trace duration
+
+  /// Records the begin and end events of a duration on construction and
+  /// destruction, if tracing is enabled.
+  class Scope {
+    const Event event_;  ///< The traced event
+    const bool enabled_;  ///< \c true if the begin event was recorded
+
+   public:
+    /// \param event The traced event
+    /// \param arg The event argument
+    explicit Scope(const Event event, const std::uint64_t arg = 0ul)
+        : event_(event), enabled_(SummaTrace::enabled()) {
+      if (enabled_) record(event_, Phase::begin, arg);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() {
+      if (enabled_) record(event_, Phase::end);
+    }
+  };  // class Scope
+
+  /// Check if tracing is enabled
+
+  /// \return \c true if SUMMA events are recorded
+  static bool enabled() { return state().buffers.enabled(); }
+
+  /// Enable tracing
+
+  /// \param prefix The prefix of the output file names
+  /// \param format The output format
+  static void enable(const std::string& prefix,
+                     const Format format = Format::json) {
+    TA_USER_ASSERT(!prefix.empty(),
+                   "The SUMMA trace file prefix must not be empty");
+    State& s = state();
+    s.buffers.locked([&](auto&) {
+      s.prefix = prefix;
+      s.format = format;
+    });
+    s.buffers.enable();
+  }
+
+  /// Disable tracing
+
+  /// Events that were already recorded are kept until they are written.
+  static void disable() { state().buffers.disable(); }
+
+  /// Set the rank of this process, which names the output file
+  static void set_rank(const int rank) { state().rank = rank; }
+
+  /// Record an event
+
+  /// \param event The event
+  /// \param phase The event phase
+  /// \param arg The event argument
+  /// \param id The event id, which matches the begin and end of
+  /// asynchronous events
+  static void record(const Event event, const Phase phase,
+                     const std::uint64_t arg = 0ul,
+                     const std::uint64_t id = 0ul) {
+    Buffer& buffer = thread_buffer();
+    buffer.records.push_back(
+        Record{duration_in_ns(state().start, now()), arg, id, buffer.thread,
+               event, phase});
+  }
+
+  /// Write the recorded events of this process and clear them
+
+  /// \return The name of the file that was written, or an empty string if
+  /// there were no events to write
+  /// \note This function must not be called while events are recorded.
+  static std::string write() { return write(state()); }
+
+  /// Event name
+
+  /// \param event The event
+  /// \return The name of \c event in the trace
+  static const char* name(const Event event) {
+    switch (event) {
+      case Event::eval:
+        return "eval";
+      case Event::initialize:
+        return "initialize";
+      case Event::step:
+        return "step";
+      case Event::depth:
+        return "depth";
+      case Event::bcast:
+        return "bcast";
+      case Event::gemm:
+        return "gemm";
+      case Event::reduce:
+        return "reduce";
+      case Event::finalize:
+        return "finalize";
+    }
+    return "";
+  }
+
+ private:
+  /// Records of a thread
+  struct Buffer {
+    std::uint32_t thread;         ///< The recording thread
+    std::vector<Record> records;  ///< The records of the thread
+  };
+
+  /// Tracer state of this process
+  struct State {
+    /// Per-thread buffers; the tracing switch is initialized by the
+    /// \c TA_SUMMA_TRACE environment variable, and the lock of the buffers
+    /// also guards the output parameters
+    detail::RecordLog<std::unique_ptr<Buffer>> buffers{
+        std::getenv("TA_SUMMA_TRACE") != nullptr};
+    std::string prefix;  ///< Output file prefix (empty = no output)
+    Format format = Format::json;  ///< Output format
+    int rank = 0;                  ///< Rank of this process
+    const time_point start = now();  ///< Start time of the trace
+
+    State() {
+      const char* prefix_env = std::getenv("TA_SUMMA_TRACE");
+      if (prefix_env) prefix = prefix_env;
+      const char* format_env = std::getenv("TA_SUMMA_TRACE_FORMAT");
+      if (format_env && std::string(format_env) == "binary")
+        format = Format::binary;
+    }
+
+    ~State() {
+      // Write the events that were not written by the program
+      try {
+        write(*this);
+      } catch (...) {
+      }
+    }
+  };
+
+  /// Tracer state accessor
+  static State& state() {
+    static State s;
+    return s;
+  }
+
+  /// Buffer of the calling thread
+
+  /// \return The record buffer of the calling thread, which is created and
+  /// registered on first use
+  static Buffer& thread_buffer() {
+    thread_local Buffer* buffer = nullptr;
+    if (!buffer) {
+      state().buffers.locked([](auto& buffers) {
+        buffers.emplace_back(std::make_unique<Buffer>());
+        buffer = buffers.back().get();
+        buffer->thread = buffers.size() - 1ul;
+      });
+    }
+    return *buffer;
+  }
+
+  /// Write the recorded events of a process and clear them
+
+  /// \param s The tracer state of the process
+  /// \return The name of the file that was written, or an empty string if
+  /// there were no events to write
+  static std::string write(State& s) {
+    return s.buffers.locked([&s](auto& buffers) {
+      std::vector<Record> records;
+      for (const auto& buffer : buffers) {
+        records.insert(records.end(), buffer->records.begin(),
+                       buffer->records.end());
+        buffer->records.clear();
+      }
+      if (records.empty() || s.prefix.empty()) return std::string();
+
+      const std::string file_name =
+          s.prefix + "." + std::to_string(s.rank) +
+          (s.format == Format::json ? ".json" : ".bin");
+      if (s.format == Format::json)
+        write_json(file_name, s.rank, records);
+      else
+        write_binary(file_name, s.rank, records);
+      return file_name;
+    });
+  }
+
+  /// Write records in the Chrome trace event format
+  static void write_json(const std::string& file_name, const int rank,
+                         const std::vector<Record>& records) {
+    std::ofstream os(file_name);
+    TA_USER_ASSERT(os, "Unable to open the SUMMA trace file");
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const Record& r : records) {
+      if (!first) os << ",";
+      first = false;
+      os << "\n{\"name\":\"" << name(r.event)
+         << "\",\"cat\":\"summa\",\"ph\":\"" << static_cast<char>(r.phase)
+         << "\",\"ts\":" << (r.time / 1000) << "." << std::setw(3)
+         << std::setfill('0') << (r.time % 1000) << ",\"pid\":" << rank
+         << ",\"tid\":" << r.thread;
+      if (r.phase == Phase::async_begin || r.phase == Phase::async_end)
+        os << ",\"id\":" << r.id;
+      if (r.phase != Phase::end)
+        os << ",\"args\":{\"" << (r.phase == Phase::counter ? name(r.event)
+                                                              : "arg")
+           << "\":" << r.arg << "}";
+      os << "}";
+    }
+    os << "\n]}\n";
+  }
+
+  /// Write records in the binary trace format
+  static void write_binary(const std::string& file_name, const int rank,
+                           const std::vector<Record>& records) {
+    std::ofstream os(file_name, std::ios::binary);
+    TA_USER_ASSERT(os, "Unable to open the SUMMA trace file");
+    const std::int64_t header[2] = {rank,
+                                    static_cast<std::int64_t>(records.size())};
+    os.write("TASUMMA1", 8);
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const Record& r : records) {
+      os.write(reinterpret_cast<const char*>(&r.time), sizeof(r.time));
+      os.write(reinterpret_cast<const char*>(&r.arg), sizeof(r.arg));
+      os.write(reinterpret_cast<const char*>(&r.id), sizeof(r.id));
+      os.write(reinterpret_cast<const char*>(&r.thread), sizeof(r.thread));
+      os.write(reinterpret_cast<const char*>(&r.event), sizeof(r.event));
+      os.write(reinterpret_cast<const char*>(&r.phase), sizeof(r.phase));
+    }
+  }
+
+};  // class SummaTrace
+
+}  // namespace TiledArray
+
+#endif  // TILEDARRAY_UTIL_SUMMA_TRACE_H__INCLUDED
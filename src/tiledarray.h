@@ -41,9 +41,13 @@
 #include <TiledArray/conversions/sparse_to_dense.h>
 #include <TiledArray/conversions/to_new_tile_type.h>
 #include <TiledArray/conversions/truncate.h>
+#include <TiledArray/expressions/expr_plan.h>
 #include <TiledArray/expressions/scal_expr.h>
 #include <TiledArray/expressions/tsr_expr.h>
 
+// Einstein summation
+#include <TiledArray/einsum.h>
+
 // Special Arrays
 #include <TiledArray/special/diagonal_array.h>
 
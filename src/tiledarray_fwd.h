@@ -20,6 +20,8 @@
 #ifndef TILEDARRAY_FWD_H__INCLUDED
 #define TILEDARRAY_FWD_H__INCLUDED
 
+#include <TiledArray/config.h>
+
 #include <complex>
 
 namespace Eigen {  // fwd define Eigen's aligned allocator for
@@ -42,15 +44,28 @@ class SparsePolicy;
 template <typename, typename>
 class Tensor;
 
-typedef Tensor<double, Eigen::aligned_allocator<double> > TensorD;
-typedef Tensor<int, Eigen::aligned_allocator<int> > TensorI;
-typedef Tensor<float, Eigen::aligned_allocator<float> > TensorF;
-typedef Tensor<long, Eigen::aligned_allocator<long> > TensorL;
+// Allocators
+template <typename>
+class pool_allocator;
+
+/// The allocator of the Tensor and Array typedefs (e.g. \c TensorD )
+#ifdef TA_TENSOR_POOL_ALLOCATOR
+template <typename T>
+using default_tensor_allocator = pool_allocator<T>;
+#else
+template <typename T>
+using default_tensor_allocator = Eigen::aligned_allocator<T>;
+#endif  // TA_TENSOR_POOL_ALLOCATOR
+
+typedef Tensor<double, default_tensor_allocator<double> > TensorD;
+typedef Tensor<int, default_tensor_allocator<int> > TensorI;
+typedef Tensor<float, default_tensor_allocator<float> > TensorF;
+typedef Tensor<long, default_tensor_allocator<long> > TensorL;
 typedef Tensor<std::complex<double>,
-               Eigen::aligned_allocator<std::complex<double> > >
+               default_tensor_allocator<std::complex<double> > >
     TensorZ;
 typedef Tensor<std::complex<float>,
-               Eigen::aligned_allocator<std::complex<float> > >
+               default_tensor_allocator<std::complex<float> > >
     TensorC;
 
 // TiledArray Arrays
@@ -59,7 +74,8 @@ class DistArray;
 
 // Dense Array Typedefs
 template <typename T>
-using TArray = DistArray<Tensor<T, Eigen::aligned_allocator<T> >, DensePolicy>;
+using TArray =
+    DistArray<Tensor<T, default_tensor_allocator<T> >, DensePolicy>;
 typedef TArray<double> TArrayD;
 typedef TArray<int> TArrayI;
 typedef TArray<float> TArrayF;
@@ -70,7 +86,7 @@ typedef TArray<std::complex<float> > TArrayC;
 // Sparse Array Typedefs
 template <typename T>
 using TSpArray =
-    DistArray<Tensor<T, Eigen::aligned_allocator<T> >, SparsePolicy>;
+    DistArray<Tensor<T, default_tensor_allocator<T> >, SparsePolicy>;
 typedef TSpArray<double> TSpArrayD;
 typedef TSpArray<int> TSpArrayI;
 typedef TSpArray<float> TSpArrayF;
@@ -0,0 +1,104 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/expressions/contraction_order.h"
+#include "global_fixture.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+using TiledArray::expressions::ContractionOrder;
+
+struct ContractionOrderFixture {
+  ContractionOrderFixture() {}
+
+  // Make a dense matrix operand with one tile per 10 elements
+  static ContractionOrder::Operand make_matrix(const std::string& row,
+                                               const std::string& col,
+                                               const double rows,
+                                               const double cols) {
+    ContractionOrder::Operand operand;
+    operand.vars = {row, col};
+    operand.extents = {rows, cols};
+    operand.tiles = {std::ceil(rows / 10.0), std::ceil(cols / 10.0)};
+    operand.density = 1.0;
+    return operand;
+  }
+};
+
+// =============================================================================
+// ContractionOrder Test Suite
+
+BOOST_FIXTURE_TEST_SUITE(contraction_order_suite, ContractionOrderFixture)
+
+BOOST_AUTO_TEST_CASE(matrix_chain) {
+  // (A * B) * C is cheaper
+  {
+    const ContractionOrder order({make_matrix("i", "j", 10, 100),
+                                  make_matrix("j", "k", 100, 5),
+                                  make_matrix("k", "l", 5, 50)});
+    BOOST_REQUIRE(order.valid());
+    BOOST_CHECK_EQUAL(order.split(0u, 3u), 2u);
+    // 2*10*100*5 + 10*5 + 2*10*5*50
+    BOOST_CHECK_CLOSE(order.cost(), 15050.0, 1.0e-10);
+    BOOST_CHECK_CLOSE(order.cost({{{0u, 1u, 2u}}, {{0u, 2u, 3u}}}),
+                      order.cost(), 1.0e-10);
+    BOOST_CHECK_GT(order.cost({{{1u, 2u, 3u}}, {{0u, 1u, 3u}}}), order.cost());
+  }
+
+  // A * (B * C) is cheaper
+  {
+    const ContractionOrder order({make_matrix("i", "j", 50, 5),
+                                  make_matrix("j", "k", 5, 100),
+                                  make_matrix("k", "l", 100, 10)});
+    BOOST_REQUIRE(order.valid());
+    BOOST_CHECK_EQUAL(order.split(0u, 3u), 1u);
+    BOOST_CHECK(order.result_vars() == (std::vector<std::string>{"i", "l"}));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sparsity) {
+  // With a very sparse A, contracting it first is cheaper
+  std::vector<ContractionOrder::Operand> operands = {
+      make_matrix("i", "j", 100, 100), make_matrix("j", "k", 100, 100),
+      make_matrix("k", "l", 100, 100)};
+  const ContractionOrder dense_order(operands);
+  BOOST_REQUIRE(dense_order.valid());
+
+  operands[0].density = 0.01;
+  const ContractionOrder sparse_order(operands);
+  BOOST_REQUIRE(sparse_order.valid());
+  BOOST_CHECK_EQUAL(sparse_order.split(0u, 3u), 2u);
+  BOOST_CHECK_LT(sparse_order.cost(), dense_order.cost());
+}
+
+BOOST_AUTO_TEST_CASE(invalid) {
+  // Index j appears in three operands
+  const ContractionOrder hyper({make_matrix("i", "j", 10, 10),
+                                make_matrix("j", "k", 10, 10),
+                                make_matrix("j", "l", 10, 10)});
+  BOOST_CHECK(!hyper.valid());
+
+  // The only trees include an outer product
+  const ContractionOrder outer({make_matrix("i", "j", 10, 10),
+                                make_matrix("k", "l", 10, 10),
+                                make_matrix("m", "n", 10, 10)});
+  BOOST_CHECK(!outer.valid());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
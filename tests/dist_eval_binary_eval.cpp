@@ -26,14 +26,51 @@
 #include <array_fixture.h>
 
 #include "TiledArray/dist_eval/binary_eval.h"
+#include "TiledArray/dist_eval/unary_eval.h"
+#include "TiledArray/util/record_log.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
 
 using TiledArray::detail::Add;
 using TiledArray::detail::BinaryWrapper;
 using TiledArray::detail::Noop;
+using TiledArray::detail::Scal;
 using TiledArray::detail::UnaryWrapper;
 
+// Binary tile operation that records the data of the argument and result
+// tiles
+template <typename Op>
+class BinaryDataRecorder {
+ public:
+  typedef typename Op::left_type left_type;
+  typedef typename Op::right_type right_type;
+  typedef typename Op::result_type result_type;
+  typedef std::array<const void*, 3> record_type;  // left, right, result
+
+  static constexpr bool left_is_consumable = Op::left_is_consumable;
+  static constexpr bool right_is_consumable = Op::right_is_consumable;
+
+  BinaryDataRecorder(const Op& op)
+      : op_(op),
+        log_(std::make_shared<TiledArray::detail::RecordLog<record_type> >(
+            true)) {}
+
+  template <typename L, typename R>
+  result_type operator()(L&& left, R&& right) const {
+    const void* const left_data = left.data();
+    const void* const right_data = right.data();
+    result_type result = op_(std::forward<L>(left), std::forward<R>(right));
+    log_->push(record_type{{left_data, right_data, result.data()}});
+    return result;
+  }
+
+  std::vector<record_type> records() const { return log_->records(); }
+
+ private:
+  Op op_;
+  std::shared_ptr<TiledArray::detail::RecordLog<record_type> > log_;
+};  // class BinaryDataRecorder
+
 struct BinaryEvalFixture : public TiledRangeFixture {
   BinaryEvalFixture()
       : left(*GlobalFixture::world, tr), right(*GlobalFixture::world, tr) {
@@ -74,6 +111,12 @@ struct BinaryEvalFixture : public TiledRangeFixture {
         perm);
   }
 
+  static UnaryWrapper<Scal<TensorI, TensorI, int, false> > make_scal(
+      const int factor) {
+    return UnaryWrapper<Scal<TensorI, TensorI, int, false> >(
+        Scal<TensorI, TensorI, int, false>(factor));
+  }
+
   template <typename Tile, typename Policy, typename Op>
   static TiledArray::detail::DistEval<
       TiledArray::detail::LazyArrayTile<
@@ -98,6 +141,26 @@ struct BinaryEvalFixture : public TiledRangeFixture {
         pmap, perm, op)));
   }
 
+  template <typename Tile, typename Policy, typename Op>
+  static TiledArray::detail::DistEval<typename Op::result_type, Policy>
+  make_unary_eval(
+      const TiledArray::detail::DistEval<Tile, Policy>& arg,
+      TiledArray::World& world,
+      const typename TiledArray::detail::DistEval<Tile, Policy>::shape_type&
+          shape,
+      const std::shared_ptr<
+          typename TiledArray::detail::DistEval<Tile, Policy>::pmap_interface>&
+          pmap,
+      const Permutation& perm, const Op& op) {
+    typedef TiledArray::detail::UnaryEvalImpl<
+        TiledArray::detail::DistEval<Tile, Policy>, Op, Policy>
+        impl_type;
+    return TiledArray::detail::DistEval<typename Op::result_type, Policy>(
+        std::shared_ptr<impl_type>(new impl_type(
+            arg, world, (perm ? perm * arg.trange() : arg.trange()), shape,
+            pmap, perm, op)));
+  }
+
   template <typename LeftTile, typename RightTile, typename Policy, typename Op>
   static TiledArray::detail::DistEval<typename Op::result_type, Policy>
   make_binary_eval(const TiledArray::detail::DistEval<LeftTile, Policy>& left,
@@ -238,4 +301,50 @@ BOOST_AUTO_TEST_CASE(perm_eval) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(reuse_unique_tiles) {
+  // The tiles of the scaling evaluators are not shared with other tiles
+  auto left_arg = make_unary_eval(
+      make_array_eval(left, left.world(), DenseShape(), left.pmap(),
+                      Permutation(), make_array_noop()),
+      left.world(), DenseShape(), left.pmap(), Permutation(), make_scal(2));
+  auto right_arg = make_unary_eval(
+      make_array_eval(right, right.world(), DenseShape(), left.pmap(),
+                      Permutation(), make_array_noop()),
+      right.world(), DenseShape(), left.pmap(), Permutation(), make_scal(3));
+
+  // The operation does not consume its arguments by construction
+  BinaryDataRecorder<decltype(make_add())> op(make_add());
+  BOOST_CHECK(!op.left_is_consumable);
+  BOOST_CHECK(!op.right_is_consumable);
+
+  auto dist_eval =
+      make_binary_eval(left_arg, right_arg, left_arg.world(), DenseShape(),
+                       left_arg.pmap(), Permutation(), op);
+  using dist_eval_type = decltype(dist_eval);
+
+  BOOST_REQUIRE_NO_THROW(dist_eval.eval());
+  BOOST_REQUIRE_NO_THROW(dist_eval.wait());
+
+  std::size_t tile_count = 0ul;
+  for (auto index : *dist_eval.pmap()) {
+    const TArrayI::value_type left_tile = left.find(index);
+    const TArrayI::value_type right_tile = right.find(index);
+
+    dist_eval_type::eval_type eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = dist_eval.get(index).get());
+    for (std::size_t i = 0ul; i < eval_tile.size(); ++i) {
+      BOOST_CHECK_EQUAL(eval_tile[i], 2 * left_tile[i] + 3 * right_tile[i]);
+    }
+    ++tile_count;
+  }
+
+  // Check that each result tile holds the data of an argument tile
+  const auto records = op.records();
+  BOOST_CHECK_EQUAL(records.size(), tile_count);
+  for (const auto& record : records) {
+    BOOST_CHECK(record[0] != record[1]);
+    BOOST_CHECK(record[2] == record[0] || record[2] == record[1]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
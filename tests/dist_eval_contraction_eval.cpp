@@ -30,6 +30,9 @@
 #include "sparse_shape_fixture.h"
 #include "unit_test_config.h"
 
+#include <cstdio>
+#include <fstream>
+
 using namespace TiledArray;
 using TiledArray::detail::ContractReduce;
 using TiledArray::detail::Noop;
@@ -471,4 +474,35 @@ BOOST_AUTO_TEST_CASE(sparse_eval) {
   do_sparse_eval(true);
 }
 
+BOOST_AUTO_TEST_CASE(trace) {
+  auto contract = make_contract_eval(
+      left_arg, right_arg, left_arg.world(), DenseShape(), pmap, Permutation(),
+      make_contract(2u, left_arg.trange().tiles_range().rank(),
+                    right_arg.trange().tiles_range().rank()));
+
+  // Record the events of the evaluation
+  const bool enabled = SummaTrace::enabled();
+  SummaTrace::enable("summa_trace_test");
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+  for (auto index : *contract.pmap()) contract.get(index).get();
+  GlobalFixture::world->gop.fence();
+  if (!enabled) SummaTrace::disable();
+
+  // Check the trace file
+  const std::string file_name = SummaTrace::write();
+  BOOST_REQUIRE(!file_name.empty());
+  std::ifstream file(file_name);
+  const std::string trace((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  BOOST_CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+  BOOST_CHECK(trace.find("\"eval\"") != std::string::npos);
+  if (contract.pmap()->local_size() > 0ul) {
+    for (const char* event :
+         {"\"initialize\"", "\"step\"", "\"gemm\"", "\"finalize\""})
+      BOOST_CHECK(trace.find(event) != std::string::npos);
+  }
+  std::remove(file_name.c_str());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -26,6 +26,7 @@
 #include <array_fixture.h>
 
 #include "TiledArray/dist_eval/unary_eval.h"
+#include "TiledArray/util/record_log.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
 
@@ -35,6 +36,37 @@ using TiledArray::detail::Noop;
 using TiledArray::detail::Scal;
 using TiledArray::detail::UnaryWrapper;
 
+// Unary tile operation that records the data of the argument and result
+// tiles
+template <typename Op>
+class UnaryDataRecorder {
+ public:
+  typedef typename Op::argument_type argument_type;
+  typedef typename Op::result_type result_type;
+  typedef std::array<const void*, 2> record_type;  // argument, result
+
+  static constexpr bool is_consumable = Op::is_consumable;
+
+  UnaryDataRecorder(const Op& op)
+      : op_(op),
+        log_(std::make_shared<TiledArray::detail::RecordLog<record_type> >(
+            true)) {}
+
+  template <typename A>
+  result_type operator()(A&& arg) const {
+    const void* const arg_data = arg.data();
+    result_type result = op_(std::forward<A>(arg));
+    log_->push(record_type{{arg_data, result.data()}});
+    return result;
+  }
+
+  std::vector<record_type> records() const { return log_->records(); }
+
+ private:
+  Op op_;
+  std::shared_ptr<TiledArray::detail::RecordLog<record_type> > log_;
+};  // class UnaryDataRecorder
+
 // Array evaluator fixture
 struct UnaryEvalImplFixture : public TiledRangeFixture {
   typedef Noop<TArrayI::value_type, TArrayI::value_type, true>
@@ -275,4 +307,37 @@ BOOST_AUTO_TEST_CASE(perm_eval) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(reuse_unique_tiles) {
+  // The tiles of the scaling evaluator are not shared with other tiles
+  auto dist_eval = make_unary_eval(arg, arg.world(), DenseShape(), arg.pmap(),
+                                   Permutation(), make_scal0(3));
+
+  // The operation does not consume its argument by construction
+  UnaryDataRecorder<decltype(make_scal0(5))> op(make_scal0(5));
+  BOOST_CHECK(!op.is_consumable);
+
+  auto dist_eval2 = make_unary_eval(dist_eval, dist_eval.world(), DenseShape(),
+                                    dist_eval.pmap(), Permutation(), op);
+
+  BOOST_REQUIRE_NO_THROW(dist_eval2.eval());
+  BOOST_REQUIRE_NO_THROW(dist_eval2.wait());
+
+  std::size_t tile_count = 0ul;
+  for (auto index : *dist_eval2.pmap()) {
+    TensorI array_tile = array.find(index);
+
+    TensorI eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = dist_eval2.get(index).get());
+    for (std::size_t i = 0ul; i < eval_tile.size(); ++i) {
+      BOOST_CHECK_EQUAL(eval_tile[i], 5 * 3 * array_tile[i]);
+    }
+    ++tile_count;
+  }
+
+  // Check that each result tile holds the data of the argument tile
+  const auto records = op.records();
+  BOOST_CHECK_EQUAL(records.size(), tile_count);
+  for (const auto& record : records) BOOST_CHECK(record[1] == record[0]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
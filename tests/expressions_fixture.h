@@ -190,6 +190,19 @@ struct ExpressionsFixture : public TiledRangeFixture {
     return matrix;
   }
 
+  /// check that two arrays have the same shape and tile elements
+  static void check_equal(const TArray& x, const TArray& y) {
+    for (std::size_t i = 0ul; i < x.size(); ++i) {
+      BOOST_CHECK_EQUAL(x.is_zero(i), y.is_zero(i));
+      if (!x.is_zero(i) && !y.is_zero(i)) {
+        auto x_tile = x.find(i).get();
+        auto y_tile = y.find(i).get();
+        for (std::size_t j = 0ul; j < x_tile.size(); ++j)
+          BOOST_CHECK_EQUAL(x_tile[j], y_tile[j]);
+      }
+    }
+  }
+
   /// make a shape with approximate half dense and half sparse
   static SparseShape<float> make_random_sparseshape(const TiledRange& tr) {
     std::size_t n = tr.tiles_range().volume();
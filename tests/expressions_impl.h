@@ -227,6 +227,35 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(reduce_factories, F, Fixtures, F) {
   BOOST_CHECK_NO_THROW(a("a,b,c").abs_max().get());
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(reduce_all, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  typedef typename F::TArray::value_type T;
+
+  // Unary reductions of a single sweep match the individual reductions
+  const auto [sum, squared_norm, abs_max] =
+      (2 * a("a,b,c"))
+          .reduce_all(TiledArray::SumReduction<T>(),
+                      TiledArray::SquaredNormReduction<T>(),
+                      TiledArray::AbsMaxReduction<T>())
+          .get();
+  BOOST_CHECK_EQUAL(sum, (2 * a("a,b,c")).sum().get());
+  BOOST_CHECK_EQUAL(squared_norm, (2 * a("a,b,c")).squared_norm().get());
+  BOOST_CHECK_EQUAL(abs_max, (2 * a("a,b,c")).abs_max().get());
+
+  // Unary and binary reductions are combined, where the unary reductions
+  // include the tiles that are paired with zero tiles
+  const auto [left_squared_norm, left_abs_max, dot] =
+      a("a,b,c")
+          .reduce_all(b("c,b,a"), TiledArray::SquaredNormReduction<T>(),
+                      TiledArray::AbsMaxReduction<T>(),
+                      TiledArray::DotReduction<T, T>())
+          .get();
+  BOOST_CHECK_EQUAL(left_squared_norm, a("a,b,c").squared_norm().get());
+  BOOST_CHECK_EQUAL(left_abs_max, a("a,b,c").abs_max().get());
+  BOOST_CHECK_EQUAL(dot, a("a,b,c").dot(b("c,b,a")).get());
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(permute, F, Fixtures, F) {
   auto& a = F::a;
   auto& b = F::b;
@@ -306,6 +335,15 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(block, F, Fixtures, F) {
       for (std::size_t j = 0ul; j < result_tile.range().volume(); ++j) {
         BOOST_CHECK_EQUAL(result_tile[j], arg_tile[j]);
       }
+
+      // Check that local tiles share the data of the argument tiles
+      if constexpr (TiledArray::detail::
+                        has_member_function_shallow_shift_anyreturn_v<
+                            const typename F::TArray::value_type,
+                            const std::vector<long>&>) {
+        if (GlobalFixture::world->size() == 1)
+          BOOST_CHECK_EQUAL(result_tile.data(), arg_tile.data());
+      }
     } else {
       BOOST_CHECK(c.is_zero(index));
     }
@@ -1673,6 +1711,124 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(scale_mult_permute, F, Fixtures, F) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(fused_elementwise, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+
+  Permutation perm({2, 1, 0});
+
+  // Nested element-wise expression with permuted and scaled leaves
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = 2 * a("a,b,c") - b("c,b,a") +
+                                      3 * (a("a,b,c") * b("a,b,c")));
+
+  for (std::size_t i = 0ul; i < c.size(); ++i) {
+    const size_t perm_index = c.range().ordinal(perm * a.range().idx(i));
+    if (!c.is_zero(i)) {
+      auto c_tile = c.find(i).get();
+      auto a_tile =
+          a.is_zero(i) ? F::make_zero_tile(c_tile.range()) : a.find(i).get();
+      auto b_tile =
+          b.is_zero(i) ? F::make_zero_tile(c_tile.range()) : b.find(i).get();
+      auto b_perm_tile = b.is_zero(perm_index)
+                             ? F::make_zero_tile(c_tile.range())
+                             : perm * b.find(perm_index).get();
+
+      for (std::size_t j = 0ul; j < c_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(c_tile[j], 2 * a_tile[j] - b_perm_tile[j] +
+                                         3 * (a_tile[j] * b_tile[j]));
+    } else {
+      BOOST_CHECK(a.is_zero(i) && b.is_zero(perm_index));
+    }
+  }
+
+  // Nested element-wise expression with a permuted result
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = (a("c,b,a") + b("c,b,a")) *
+                                      (2 * b("c,b,a") - a("c,b,a")));
+
+  for (std::size_t i = 0ul; i < c.size(); ++i) {
+    const size_t perm_index = c.range().ordinal(perm * a.range().idx(i));
+    if (!c.is_zero(i)) {
+      auto c_tile = c.find(i).get();
+      auto a_tile = a.is_zero(perm_index) ? F::make_zero_tile(c_tile.range())
+                                          : perm * a.find(perm_index).get();
+      auto b_tile = b.is_zero(perm_index) ? F::make_zero_tile(c_tile.range())
+                                          : perm * b.find(perm_index).get();
+
+      for (std::size_t j = 0ul; j < c_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(c_tile[j], (a_tile[j] + b_tile[j]) *
+                                         (2 * b_tile[j] - a_tile[j]));
+    }
+  }
+
+  // Nested element-wise expression as an argument of a contraction
+  auto& w = F::w;
+  typename F::TArray w_ref;
+  w_ref("i,j") = b("i,b,k") * b("j,b,k");
+  BOOST_REQUIRE_NO_THROW(w("i,j") = (a("i,b,k") + b("i,b,k") - a("i,b,k")) *
+                                    b("j,b,k"));
+
+  for (std::size_t i = 0ul; i < w.size(); ++i) {
+    if (!w.is_zero(i) && !w_ref.is_zero(i)) {
+      auto w_tile = w.find(i).get();
+      auto w_ref_tile = w_ref.find(i).get();
+      for (std::size_t j = 0ul; j < w_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(w_tile[j], w_ref_tile[j]);
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(plan, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& w = F::w;
+
+  typename F::TArray x = a;
+  typename F::TArray w_ref;
+
+  auto check = [&]() {
+    w_ref("i,j") = 2 * x("i,b,k") * b("j,b,k");
+    for (std::size_t i = 0ul; i < w.size(); ++i) {
+      BOOST_CHECK_EQUAL(w.is_zero(i), w_ref.is_zero(i));
+      if (!w.is_zero(i) && !w_ref.is_zero(i)) {
+        auto w_tile = w.find(i).get();
+        auto w_ref_tile = w_ref.find(i).get();
+        for (std::size_t j = 0ul; j < w_tile.size(); ++j)
+          BOOST_CHECK_EQUAL(w_tile[j], w_ref_tile[j]);
+      }
+    }
+  };
+
+  auto plan = make_plan(2 * x("i,b,k") * b("j,b,k"), w("i,j"));
+  BOOST_CHECK_EQUAL(plan.evals(), 0ul);
+
+  // The first evaluation constructs the engine graph
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_CHECK_EQUAL(plan.inits(), 1ul);
+
+  // Unchanged arguments reuse the engine graph
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_CHECK_EQUAL(plan.evals(), 2ul);
+  BOOST_CHECK_EQUAL(plan.inits(), 1ul);
+  BOOST_CHECK_EQUAL(plan.struct_inits(), 0ul);
+
+  // Reassigned arguments with the same tiled range and process map reuse
+  // the engine graph
+  x("a,b,c") = 3 * a("a,b,c");
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_CHECK_EQUAL(plan.inits(), 1ul);
+
+  // An invalidated plan rebuilds the engine graph
+  plan.invalidate();
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  check();
+  BOOST_CHECK_EQUAL(plan.evals(), 4ul);
+  BOOST_CHECK_EQUAL(plan.inits(), 2ul);
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont, F, Fixtures, F) {
   auto& a = F::a;
   auto& b = F::b;
@@ -1802,6 +1958,198 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont, F, Fixtures, F) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_add_to, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& w = F::w;
+
+  typename F::TArray w_prod;
+  typename F::TArray w_ref;
+  w_prod("i,j") = a("i,b,c") * b("j,b,c");
+
+  // The contraction is accumulated into copies of the result tiles
+  w("i,j") = w_prod("i,j");
+  w_ref("i,j") = w("i,j") + a("i,b,c") * b("j,b,c");
+  BOOST_REQUIRE_NO_THROW(w("i,j") += a("i,b,c") * b("j,b,c"));
+  F::check_equal(w, w_ref);
+
+  // The tiles of the original array are unchanged
+  typename F::TArray w_prod_ref;
+  w_prod_ref("i,j") = a("i,b,c") * b("j,b,c");
+  F::check_equal(w_prod, w_prod_ref);
+
+  // The contraction is accumulated in place
+  w_ref("i,j") = w("i,j") + 2 * a("i,b,c") * b("j,b,c");
+  BOOST_REQUIRE_NO_THROW(w("i,j").no_alias() += 2 * a("i,b,c") * b("j,b,c"));
+  F::check_equal(w, w_ref);
+
+  // A contraction with a permuted result is evaluated as a sum, and the
+  // rejected accumulation records no permutation placements of its own
+  using TiledArray::expressions::PermPlacementLog;
+  PermPlacementLog::clear();
+  PermPlacementLog::enable();
+  w_ref("i,j") = w("i,j") + a("j,b,c") * b("i,b,c");
+  const std::size_t sum_placements = PermPlacementLog::placements().size();
+  PermPlacementLog::clear();
+  BOOST_REQUIRE_NO_THROW(w("i,j") += a("j,b,c") * b("i,b,c"));
+  PermPlacementLog::disable();
+  BOOST_CHECK_EQUAL(PermPlacementLog::placements().size(), sum_placements);
+  PermPlacementLog::clear();
+  F::check_equal(w, w_ref);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_sum, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+  auto& w = F::w;
+
+  F::random_fill(c);
+  GlobalFixture::world->gop.fence();
+
+  typename F::TArray ab, ac, bc, w_ref;
+  ab("i,j") = a("i,b,c") * b("j,b,c");
+  ac("i,j") = a("i,b,c") * c("j,b,c");
+  bc("i,j") = b("i,b,c") * c("j,b,c");
+
+  // The contractions are summed by a single evaluator
+  w_ref("i,j") = ab("i,j") + 2 * ac("i,j");
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c") +
+                                    2 * a("i,b,c") * c("j,b,c"));
+  F::check_equal(w, w_ref);
+
+  w_ref("i,j") = ab("i,j") + 2 * ac("i,j") + bc("i,j");
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c") +
+                                    2 * a("i,b,c") * c("j,b,c") +
+                                    b("i,b,c") * c("j,b,c"));
+  F::check_equal(w, w_ref);
+
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c") +
+                                    (2 * a("i,b,c") * c("j,b,c") +
+                                     b("i,b,c") * c("j,b,c")));
+  F::check_equal(w, w_ref);
+
+  // Sums with a transposed contraction
+  w_ref("i,j") = ab("i,j") + ac("j,i");
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c") +
+                                    a("j,b,c") * c("i,b,c"));
+  F::check_equal(w, w_ref);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_perm_placement, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& w = F::w;
+
+  using TiledArray::expressions::PermPlacementLog;
+
+  // A matrix with the tiling of a and b
+  typename F::TArray m;
+  m("i,j") = a("i,b,c") * b("j,b,c");
+
+  // Reference results, computed without permuted contraction arguments
+  typename F::TArray abm, b_perm, x, x_ref, w_ref;
+  abm("i,k,j") = a("i,k,c") * m("j,c");
+  x_ref("k,i,j") = abm("i,k,j");
+  b_perm("j,b,c") = b("j,c,b");
+  w_ref("i,j") = a("i,b,c") * b_perm("j,b,c");
+
+  PermPlacementLog::clear();
+  PermPlacementLog::enable();
+
+  // Either the left-hand argument or the result is permuted
+  BOOST_REQUIRE_NO_THROW(x("k,i,j") = a("i,k,c") * m("j,c"));
+  F::check_equal(x, x_ref);
+
+  // Either argument is permuted to match the inner indices of the other
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,c,b"));
+  F::check_equal(w, w_ref);
+
+  PermPlacementLog::disable();
+  const auto placements = PermPlacementLog::placements();
+  PermPlacementLog::clear();
+
+  // No operand is permuted if a smaller one could be permuted instead
+  BOOST_CHECK_EQUAL(placements.size(), 2ul);
+  for (const auto& placement : placements) {
+    BOOST_CHECK(placement.contraction);
+    if (placement.cost_based)
+      BOOST_CHECK(placement.permuted_size <= placement.alternative_size);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(async_eval, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& w = F::w;
+
+  using TiledArray::expressions::AsyncEval;
+
+  // The fixture does not fill w, and its tiling differs from that of a * b
+  w("i,j") = a("i,b,c") * a("j,b,c");
+
+  // Reference results of synchronous evaluation
+  typename F::TArray x_ref, y_ref, z_ref, w_ref;
+  x_ref("i,j") = a("i,b,c") * b("j,b,c");
+  y_ref("i,j") = 2 * w("i,j");
+  z_ref("i,j") = x_ref("i,j") + y_ref("i,j");
+  w_ref("i,j") = w("i,j") + a("i,b,c") * b("j,b,c");
+
+  typename F::TArray x, y, z;
+  BOOST_CHECK(AsyncEval::completion(x).probe());
+  AsyncEval::enable();
+
+  // Independent statements and a statement that depends on both
+  BOOST_REQUIRE_NO_THROW(x("i,j") = a("i,b,c") * b("j,b,c"));
+  BOOST_REQUIRE_NO_THROW(y("i,j") = 2 * w("i,j"));
+  BOOST_REQUIRE_NO_THROW(z("i,j") = x("i,j") + y("i,j"));
+  auto z_done = AsyncEval::completion(z);
+
+  // The tiles of w are updated in place after the pending evaluation of y,
+  // which reads them
+  BOOST_REQUIRE_NO_THROW(w("i,j").no_alias() += a("i,b,c") * b("j,b,c"));
+
+  AsyncEval::wait_all();
+  AsyncEval::disable();
+  BOOST_CHECK(z_done.probe());
+
+  F::check_equal(x, x_ref);
+  F::check_equal(y, y_ref);
+  F::check_equal(z, z_ref);
+  F::check_equal(w, w_ref);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(reuse_unique_tiles, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+
+  const typename F::TArray a_ref = TiledArray::clone(a);
+  const typename F::TArray b_ref = TiledArray::clone(b);
+
+  // The evaluated copies of array tiles are reused by the tile operations,
+  // the tiles of the arguments must not change
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c") + b("a,b,c"));
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = 2 * a("a,b,c") - b("a,b,c"));
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c") * b("a,b,c"));
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = -a("a,b,c"));
+  F::check_equal(a, a_ref);
+  F::check_equal(b, b_ref);
+
+  // The tiles of block expressions share the data of the array tiles and
+  // must never be consumed by the tile operations
+  typename F::TArray d;
+  BOOST_REQUIRE_NO_THROW(d("a,b,c") = a("a,b,c").block({3, 3, 3}, {5, 5, 5}) +
+                                      b("a,b,c").block({3, 3, 3}, {5, 5, 5}));
+  BOOST_REQUIRE_NO_THROW(d("a,b,c") = a("a,b,c").block({3, 3, 3}, {5, 5, 5}) -
+                                      b("a,b,c").block({3, 3, 3}, {5, 5, 5}));
+  BOOST_REQUIRE_NO_THROW(d("a,b,c") = a("a,b,c").block({3, 3, 3}, {5, 5, 5}) *
+                                      b("a,b,c").block({3, 3, 3}, {5, 5, 5}));
+
+  F::check_equal(a, a_ref);
+  F::check_equal(b, b_ref);
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_permute, F, Fixtures, F) {
   auto& a = F::a;
   auto& b = F::b;
@@ -2453,6 +2801,59 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(scale_cont_permute_permute, F, Fixtures, F) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_chain_order, F, Fixtures, F) {
+  // Construct the tiled ranges of a matrix chain for which (A * B) * C is
+  // much cheaper than A * (B * C)
+  auto make_tr1 = [](const std::size_t extent, const std::size_t tile) {
+    std::vector<std::size_t> tiling;
+    for (std::size_t i = 0ul; i < extent; i += tile) tiling.push_back(i);
+    tiling.push_back(extent);
+    return TiledRange1(tiling.begin(), tiling.end());
+  };
+  const TiledRange1 tr_i = make_tr1(10, 4), tr_j = make_tr1(100, 30),
+                    tr_k = make_tr1(5, 2), tr_l = make_tr1(50, 20);
+  TiledRange trange_a({tr_i, tr_j}), trange_b({tr_j, tr_k}),
+      trange_c({tr_k, tr_l});
+
+  auto a = F::make_array(trange_a);
+  auto b = F::make_array(trange_b);
+  auto c = F::make_array(trange_c);
+  F::random_fill(a);
+  F::random_fill(b);
+  F::random_fill(c);
+  GlobalFixture::world->gop.fence();
+
+  // Compute the reference in the cheap order
+  typename F::TArray ab, result_ref;
+  ab("i,k") = a("i,j") * b("j,k");
+  result_ref("i,l") = ab("i,k") * c("k,l");
+
+  // The chain is reassociated
+  typename F::TArray result;
+  BOOST_REQUIRE_NO_THROW(result("i,l") = a("i,j") * (b("j,k") * c("k,l")));
+
+  for (auto it = result.begin(); it != result.end(); ++it) {
+    typename F::TArray::value_type tile = *it;
+    typename F::TArray::value_type tile_ref =
+        result_ref.find(it.index()).get();
+    for (Range::const_iterator rit = tile.range().begin();
+         rit != tile.range().end(); ++rit)
+      BOOST_CHECK_EQUAL(tile[*rit], tile_ref[*rit]);
+  }
+
+  // A permuted result
+  BOOST_REQUIRE_NO_THROW(result("l,i") = a("i,j") * b("j,k") * c("k,l"));
+  result_ref("l,i") = result_ref("i,l");
+  for (auto it = result.begin(); it != result.end(); ++it) {
+    typename F::TArray::value_type tile = *it;
+    typename F::TArray::value_type tile_ref =
+        result_ref.find(it.index()).get();
+    for (Range::const_iterator rit = tile.range().begin();
+         rit != tile.range().end(); ++rit)
+      BOOST_CHECK_EQUAL(tile[*rit], tile_ref[*rit]);
+  }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_non_uniform1, F, Fixtures, F) {
   // Construct the tiled range
   std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
@@ -2541,6 +2942,396 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_non_uniform2, F, Fixtures, F) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_gett, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 4> tiling1 = {{0, 2, 5, 6}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_1, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+  F::random_fill(left);
+  F::random_fill(right);
+  GlobalFixture::world->gop.fence();
+
+  // Compute the reference result with explicitly permuted arguments
+  typename F::TArray left_perm, right_perm, result_ref, result;
+  left_perm("a,i,k,l") = left("a,k,i,l");
+  right_perm("k,l,b,j") = right("k,b,l,j");
+  result_ref("a,b,i,j") = left_perm("a,i,k,l") * right_perm("k,l,b,j");
+
+  // Compute the result to be tested, where neither argument is in matrix
+  // layout
+  BOOST_REQUIRE_NO_THROW(result("a,b,i,j") =
+                             left("a,k,i,l") * right("k,b,l,j"));
+
+  // Check the result
+  for (auto it = result.begin(); it != result.end(); ++it) {
+    typename F::TArray::value_type tile = *it;
+    typename F::TArray::value_type tile_ref =
+        result_ref.find(it.index()).get();
+    BOOST_CHECK_EQUAL(tile.range(), tile_ref.range());
+    for (Range::const_iterator rit = tile.range().begin();
+         rit != tile.range().end(); ++rit)
+      BOOST_CHECK_EQUAL(tile[*rit], tile_ref[*rit]);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_summa_layers, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
+  std::array<std::size_t, 2> tiling2 = {{0, 40}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_2, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  const std::size_t m = 5;
+  const std::size_t k = 40 * 5 * 5;
+  const std::size_t n = 5;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = left_ref * right_ref.transpose();
+
+  // Check explicit and automatic selection of the number of layers
+  for (std::size_t layers : {2ul, 0ul}) {
+    // Compute the result to be tested
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(
+        result("x,y") =
+            (left("x,i,j,k") * right("y,i,j,k")).set_summa_layers(layers));
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_summa_stationary, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
+  std::array<std::size_t, 2> tiling2 = {{0, 40}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_2, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  const std::size_t m = 5;
+  const std::size_t k = 40 * 5 * 5;
+  const std::size_t n = 5;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = left_ref * right_ref.transpose();
+
+  // Check each stationary operand and the automatic selection
+  using TiledArray::expressions::SummaStationary;
+  for (auto stationary :
+       {SummaStationary::left, SummaStationary::right,
+        SummaStationary::result, SummaStationary::automatic}) {
+    // Compute the result to be tested
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(
+        result("x,y") = (left("x,i,j,k") * right("y,i,j,k"))
+                            .set_summa_stationary(stationary));
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_summa_default_layers, F, Fixtures,
+                                 F) {
+  auto& a = F::a;
+  auto& b = F::b;
+
+  // Without a request for 2.5D SUMMA or a memory limit, the automatic
+  // selection of the stationary operand does not add process layers
+  auto expr = a("a,i,j") * b("b,i,j");
+  typename decltype(expr)::engine_type engine(expr);
+  engine.init(*GlobalFixture::world, nullptr,
+              TiledArray::expressions::VariableList("a,b"));
+  BOOST_CHECK_EQUAL(engine.proc_grid().layers(), 1ul);
+  BOOST_CHECK_LE(engine.proc_grid().proc_size(),
+                 std::size_t(GlobalFixture::world->size()));
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_screening, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
+  std::array<std::size_t, 2> tiling2 = {{0, 40}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_2, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  const std::size_t m = 5;
+  const std::size_t k = 40 * 5 * 5;
+  const std::size_t n = 5;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = left_ref * right_ref.transpose();
+
+  // Only sparse arrays of tensor tiles are screened
+  constexpr bool screened =
+      !TiledArray::is_dense_v<typename F::TArray> &&
+      TiledArray::detail::is_tensor_v<typename F::TArray::value_type>;
+  auto& counter = TiledArray::detail::summa_screened_contractions();
+
+  // A threshold below every contribution does not change the result
+  std::size_t count = counter;
+  typename F::TArray result;
+  BOOST_REQUIRE_NO_THROW(result("x,y") =
+                             (left("x,i,j,k") * right("y,i,j,k"))
+                                 .set_screening(1.0e-30f));
+  count = counter - count;
+  GlobalFixture::world->gop.sum(count);
+  BOOST_CHECK_EQUAL(count, 0ul);
+
+  for (auto it = result.begin(); it != result.end(); ++it) {
+    typename F::TArray::value_type tile = *it;
+    for (Range::const_iterator rit = tile.range().begin();
+         rit != tile.range().end(); ++rit) {
+      const std::size_t elem_index = result.elements_range().ordinal(*rit);
+      BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+    }
+  }
+
+  // A threshold above every contribution skips all tile contractions
+  count = counter;
+  BOOST_REQUIRE_NO_THROW(result("x,y") =
+                             (left("x,i,j,k") * right("y,i,j,k"))
+                                 .set_screening(1.0e30f));
+  count = counter - count;
+  GlobalFixture::world->gop.sum(count);
+  if (screened)
+    BOOST_CHECK(count > 0ul);
+  else
+    BOOST_CHECK_EQUAL(count, 0ul);
+
+  for (auto it = result.begin(); it != result.end(); ++it) {
+    typename F::TArray::value_type tile = *it;
+    for (Range::const_iterator rit = tile.range().begin();
+         rit != tile.range().end(); ++rit) {
+      const std::size_t elem_index = result.elements_range().ordinal(*rit);
+      if constexpr (screened)
+        BOOST_CHECK_EQUAL(tile[*rit], 0);
+      else
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(truncate_eval, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  auto& c = F::c;
+
+  // All tiles of a sparse result vanish
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") =
+                             (a("a,b,c") - a("a,b,c")).set_truncate());
+
+  for (std::size_t i = 0ul; i < c.size(); ++i) {
+    if (TiledArray::is_dense_v<typename F::TArray>) {
+      auto c_tile = c.find(i).get();
+      for (std::size_t j = 0ul; j < c_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(c_tile[j], a.find(i).get()[j] - a.find(i).get()[j]);
+    } else {
+      BOOST_CHECK(c.is_zero(i));
+    }
+  }
+
+  // Truncation keeps the non-zero tiles
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") =
+                             (a("a,b,c") + b("a,b,c")).set_truncate());
+
+  for (std::size_t i = 0ul; i < c.size(); ++i) {
+    if (!c.is_zero(i)) {
+      auto c_tile = c.find(i).get();
+      auto a_tile =
+          a.is_zero(i) ? F::make_zero_tile(c_tile.range()) : a.find(i).get();
+      auto b_tile =
+          b.is_zero(i) ? F::make_zero_tile(c_tile.range()) : b.find(i).get();
+
+      for (std::size_t j = 0ul; j < c_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(c_tile[j], a_tile[j] + b_tile[j]);
+    } else {
+      BOOST_CHECK(a.is_zero(i) && b.is_zero(i));
+    }
+  }
+
+  // The truncated contraction result matches the truncated reference
+  typename F::TArray w_ref;
+  w_ref("i,j") = a("i,b,k") * b("j,b,k");
+  w_ref.truncate();
+  auto& w = F::w;
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+                             (a("i,b,k") * b("j,b,k")).set_truncate());
+
+  for (std::size_t i = 0ul; i < w.size(); ++i) {
+    BOOST_CHECK_EQUAL(w.is_zero(i), w_ref.is_zero(i));
+    if (!w.is_zero(i)) {
+      auto w_tile = w.find(i).get();
+      auto w_ref_tile = w_ref.find(i).get();
+      for (std::size_t j = 0ul; j < w_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(w_tile[j], w_ref_tile[j]);
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_summa_limits, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
+  std::array<std::size_t, 2> tiling2 = {{0, 40}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_2, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  const std::size_t m = 5;
+  const std::size_t k = 40 * 5 * 5;
+  const std::size_t n = 5;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = left_ref * right_ref.transpose();
+
+  // The largest SUMMA iteration needs at most 2 * 15000 elements, the
+  // smallest 2 * 600 elements, so this memory limit adapts the depth as the
+  // iterations progress
+  const std::size_t max_memory =
+      2ul * 16000ul * sizeof(typename F::TArray::element_type);
+
+  for (std::size_t max_depth : {0ul, 1ul, 3ul}) {
+    // Compute the result to be tested
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(result("x,y") =
+                               (left("x,i,j,k") * right("y,i,j,k"))
+                                   .set_summa_max_memory(max_memory)
+                                   .set_summa_max_depth(max_depth));
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_summa_batch, F, Fixtures, F) {
+  // Construct the tiled range
+  std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
+  std::array<std::size_t, 2> tiling2 = {{0, 40}};
+  TiledRange1 tr1_1(tiling1.begin(), tiling1.end());
+  TiledRange1 tr1_2(tiling2.begin(), tiling2.end());
+  std::array<TiledRange1, 4> tiling4 = {{tr1_1, tr1_2, tr1_1, tr1_1}};
+  TiledRange trange(tiling4.begin(), tiling4.end());
+
+  const std::size_t m = 5;
+  const std::size_t k = 40 * 5 * 5;
+  const std::size_t n = 5;
+
+  // Construct the test arguments
+  auto left = F::make_array(trange);
+  auto right = F::make_array(trange);
+
+  // Construct the reference matrices
+  typename F::Matrix left_ref(m, k);
+  typename F::Matrix right_ref(n, k);
+
+  // Initialize input
+  F::rand_fill_matrix_and_array(left_ref, left, 23);
+  F::rand_fill_matrix_and_array(right_ref, right, 42);
+
+  // Compute the reference result
+  typename F::Matrix result_ref = left_ref * right_ref.transpose();
+
+  // The largest fused tile extent is 40, so tile contractions are batched
+  // only with the larger limit
+  for (std::size_t batch_tile_size : {0ul, 8ul, 64ul}) {
+    // Compute the result to be tested
+    typename F::TArray result;
+    BOOST_REQUIRE_NO_THROW(result("x,y") =
+                               (left("x,i,j,k") * right("y,i,j,k"))
+                                   .set_summa_batch_tile_size(batch_tile_size));
+
+    // Check the result
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      typename F::TArray::value_type tile = *it;
+      for (Range::const_iterator rit = tile.range().begin();
+           rit != tile.range().end(); ++rit) {
+        const std::size_t elem_index = result.elements_range().ordinal(*rit);
+        BOOST_CHECK_EQUAL(result_ref.array()(elem_index), tile[*rit]);
+      }
+    }
+  }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(cont_plus_reduce, F, Fixtures, F) {
   // Construct the tiled range
   std::array<std::size_t, 6> tiling1 = {{0, 1, 2, 3, 4, 5}};
@@ -2678,6 +3469,106 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(outer_product, F, Fixtures, F) {
   BOOST_CHECK_EQUAL(ew, ew_test);
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(einsum, F, Fixtures, F) {
+  auto& a = F::a;
+  auto& b = F::b;
+  typedef typename F::TArray TArray;
+  typedef typename F::element_type T;
+
+  // Random arrays without zero tiles, so that the estimated sizes of the
+  // intermediates do not depend on random shapes
+  auto make = [](const std::vector<TiledRange1>& dims) {
+    return TiledArray::make_array<TArray>(
+        *GlobalFixture::world, TiledRange(dims.begin(), dims.end()),
+        [](typename TArray::value_type& tile, const Range& range) {
+          tile = F::make_rand_tile(range);
+          return TiledArray::norm(tile);
+        });
+  };
+  const TiledRange1 tr_a = a.trange().dim(0);
+  const TArray w = make({tr_a, tr_a});
+
+  // Contraction
+  TArray x, x_ref;
+  BOOST_REQUIRE_NO_THROW(x = TiledArray::einsum("abc,dbc->ad", a, b));
+  x_ref("a,d") = a("a,b,c") * b("d,b,c");
+  BOOST_CHECK_EQUAL(F::make_matrix(x), F::make_matrix(x_ref));
+
+  // Chain of contractions, evaluated along the cheapest path
+  const auto path = TiledArray::einsum_path("abc,dbc,de->ae", a, b, w);
+  BOOST_CHECK_EQUAL(path.steps.size(), 2ul);
+  BOOST_CHECK_EQUAL(path.steps.back().indices, "ae");
+  BOOST_CHECK(path.flops > 0.0);
+  BOOST_REQUIRE_NO_THROW(x = TiledArray::einsum("abc,dbc,de->ae", a, b, w));
+  x_ref("a,e") = (a("a,b,c") * b("d,b,c")) * w("d,e");
+  BOOST_CHECK_EQUAL(F::make_matrix(x), F::make_matrix(x_ref));
+
+  // The size of the intermediates is bounded, if possible. The cheapest
+  // path of this chain, (pq * qr) * rs , has a larger intermediate than
+  // pq * (qr * rs) .
+  const TiledRange1 tr_p{0, 2}, tr_q{0, 3, 7};
+  const TArray pq = make({tr_p, tr_q});
+  const TArray qr = make({tr_q, tr_a});
+  const TArray rs = make({tr_a, tr_q});
+  const auto chain = TiledArray::einsum_path("pq,qr,rs->ps", pq, qr, rs);
+  BOOST_CHECK_EQUAL(chain.steps.front().indices, "pr");
+  TiledArray::EinsumOptions options;
+  options.max_intermediate_size = 0.95 * chain.peak_size;
+  const auto bounded =
+      TiledArray::einsum_path("pq,qr,rs->ps", options, pq, qr, rs);
+  BOOST_CHECK_EQUAL(bounded.steps.front().indices, "qs");
+  BOOST_CHECK(bounded.peak_size <= options.max_intermediate_size);
+  BOOST_CHECK(bounded.flops > chain.flops);
+  BOOST_REQUIRE_NO_THROW(
+      x = TiledArray::einsum("pq,qr,rs->ps", options, pq, qr, rs));
+  x_ref("p,s") = pq("p,q") * (qr("q,r") * rs("r,s"));
+  BOOST_CHECK_EQUAL(F::make_matrix(x), F::make_matrix(x_ref));
+
+  // Invalid expressions
+  BOOST_CHECK_THROW(TiledArray::einsum("abc,dbc->a", a, b),
+                    TiledArray::Exception);
+  BOOST_CHECK_THROW(TiledArray::einsum("ab,dbc->ad", a, b),
+                    TiledArray::Exception);
+  BOOST_CHECK_THROW(TiledArray::einsum("abc,dbc", a, b),
+                    TiledArray::Exception);
+
+  // Batch (Hadamard) index that is contracted with other indices
+  if constexpr (TiledArray::detail::is_einsum_batch_tile<
+                    typename TArray::value_type>::value) {
+    TArray y;
+    BOOST_REQUIRE_NO_THROW(y = TiledArray::einsum("abc,dbc->abd", a, b));
+
+    // Gather the elements of an array of extent n along each dimension
+    const std::size_t n = a.trange().elements_range().extent(0);
+    auto gather = [n](const TArray& array) {
+      std::vector<T> result(n * n * n, T(0));
+      for (std::size_t i = 0ul; i < array.size(); ++i) {
+        if (array.is_zero(i)) continue;
+        auto tile = array.find(i).get();
+        for (auto&& idx : tile.range())
+          result[(idx[0] * n + idx[1]) * n + idx[2]] = tile[idx];
+      }
+      return result;
+    };
+    const auto ea = gather(a);
+    const auto eb = gather(b);
+    const auto ey = gather(y);
+    std::size_t mismatches = 0ul;
+    for (std::size_t i = 0ul; i < n; ++i)
+      for (std::size_t j = 0ul; j < n; ++j)
+        for (std::size_t k = 0ul; k < n; ++k) {
+          T expected(0);
+          for (std::size_t l = 0ul; l < n; ++l)
+            expected += ea[(i * n + j) * n + l] * eb[(k * n + j) * n + l];
+          if (ey[(i * n + j) * n + k] != expected) ++mismatches;
+        }
+    BOOST_CHECK_EQUAL(mismatches, 0ul);
+  } else {
+    BOOST_CHECK_THROW(TiledArray::einsum("abc,dbc->abd", a, b),
+                      TiledArray::Exception);
+  }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(dot, F, Fixtures, F) {
   auto& a = F::a;
   auto& b = F::b;
@@ -0,0 +1,118 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/flop_weighted_pmap.h"
+#include "global_fixture.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct FlopWeightedPmapFixture {
+  FlopWeightedPmapFixture() {}
+};
+
+// =============================================================================
+// FlopWeightedPmap Test Suite
+
+BOOST_FIXTURE_TEST_SUITE(flop_weighted_pmap_suite, FlopWeightedPmapFixture)
+
+BOOST_AUTO_TEST_CASE(balance) {
+  typedef detail::FlopWeightedPmap::size_type size_type;
+
+  // Rows 0 and 2 are heavy, so the cyclic distribution puts all of the work
+  // on process row 0
+  const std::vector<double> row_weights = {100.0, 1.0, 100.0, 1.0,
+                                           1.0,   1.0, 1.0,   1.0};
+  const std::vector<double> col_weights(8, 1.0);
+  auto is_zero = [](const size_type, const size_type) { return false; };
+
+  const auto phases = detail::FlopWeightedPmap::make_phases(
+      2ul, 2ul, row_weights, col_weights, is_zero);
+  BOOST_REQUIRE(phases.first);
+  BOOST_REQUIRE(phases.second);
+  BOOST_CHECK_EQUAL(phases.first->size(), row_weights.size());
+  BOOST_CHECK_EQUAL(phases.second->size(), col_weights.size());
+
+  // The heavy rows must be held by different process rows
+  BOOST_CHECK_NE((*phases.first)[0], (*phases.first)[2]);
+  for (const size_type p : *phases.first) BOOST_CHECK_LT(p, 2ul);
+  for (const size_type q : *phases.second) BOOST_CHECK_LT(q, 2ul);
+
+  // A uniform workload is not rebalanced
+  const std::vector<double> uniform(8, 1.0);
+  const auto cyclic = detail::FlopWeightedPmap::make_phases(
+      2ul, 2ul, uniform, col_weights, is_zero);
+  BOOST_CHECK(!cyclic.first);
+  BOOST_CHECK(!cyclic.second);
+}
+
+BOOST_AUTO_TEST_CASE(owner) {
+  typedef detail::FlopWeightedPmap::size_type size_type;
+  const std::size_t size = GlobalFixture::world->size();
+  const std::size_t p_rows =
+      std::max<std::size_t>(1ul, std::sqrt(double(size)));
+  const std::size_t p_cols = size / p_rows;
+  ProcessID tile_owners[100];
+
+  for (std::size_t x = 1ul; x < 10ul; ++x) {
+    for (std::size_t y = 1ul; y < 10ul; ++y) {
+      // Assign the rows and columns in reverse cyclic order
+      std::vector<size_type> row_phases(x), col_phases(y);
+      for (std::size_t i = 0ul; i < x; ++i)
+        row_phases[i] = (x - i - 1ul) % p_rows;
+      for (std::size_t j = 0ul; j < y; ++j)
+        col_phases[j] = (y - j - 1ul) % p_cols;
+
+      const std::size_t tiles = x * y;
+      detail::FlopWeightedPmap pmap(
+          *GlobalFixture::world, x, y, p_rows, p_cols,
+          std::make_shared<const std::vector<size_type> >(row_phases),
+          std::make_shared<const std::vector<size_type> >(col_phases));
+
+      BOOST_CHECK_EQUAL(pmap.size(), tiles);
+
+      // Check that tiles map to the process with the given phases
+      for (std::size_t tile = 0ul; tile < tiles; ++tile)
+        BOOST_CHECK_EQUAL(pmap.owner(tile),
+                          row_phases[tile / y] * p_cols + col_phases[tile % y]);
+
+      // Check that all local elements map to this rank
+      std::size_t local_size = 0ul;
+      for (auto it = pmap.begin(); it != pmap.end(); ++it, ++local_size) {
+        BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+      }
+      BOOST_CHECK_EQUAL(local_size, pmap.local_size());
+
+      // Check that each tile is owned by exactly one process
+      std::fill_n(tile_owners, tiles, 0);
+      for (auto it = pmap.begin(); it != pmap.end(); ++it) {
+        tile_owners[*it] += GlobalFixture::world->rank();
+      }
+
+      GlobalFixture::world->gop.sum(tile_owners, tiles);
+      GlobalFixture::world->gop.sum(local_size);
+      BOOST_CHECK_EQUAL(local_size, tiles);
+      for (std::size_t tile = 0; tile < tiles; ++tile) {
+        BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/layered_cyclic_pmap.h"
+#include "global_fixture.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct LayeredCyclicPmapFixture {
+  LayeredCyclicPmapFixture() {}
+};
+
+// =============================================================================
+// LayeredCyclicPmap Test Suite
+
+BOOST_FIXTURE_TEST_SUITE(layered_cyclic_pmap_suite, LayeredCyclicPmapFixture)
+
+BOOST_AUTO_TEST_CASE(layer_blocks) {
+  for (std::size_t n = 1ul; n < 20ul; ++n) {
+    for (std::size_t layers = 1ul; layers <= n; ++layers) {
+      // Check that the blocks are contiguous and cover [0,n)
+      BOOST_CHECK_EQUAL(
+          detail::LayeredCyclicPmap::layer_begin(n, layers, 0ul), 0ul);
+      BOOST_CHECK_EQUAL(
+          detail::LayeredCyclicPmap::layer_begin(n, layers, layers), n);
+
+      for (std::size_t k = 0ul; k < n; ++k) {
+        const std::size_t layer =
+            detail::LayeredCyclicPmap::layer_of(n, layers, k);
+        BOOST_CHECK_LT(layer, layers);
+        BOOST_CHECK_LE(detail::LayeredCyclicPmap::layer_begin(n, layers, layer),
+                       k);
+        BOOST_CHECK_GT(
+            detail::LayeredCyclicPmap::layer_begin(n, layers, layer + 1ul), k);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(local_group) {
+  const std::size_t size = GlobalFixture::world->size();
+  ProcessID tile_owners[100];
+
+  for (std::size_t layers = 1ul; layers <= std::min<std::size_t>(size, 3ul);
+       ++layers) {
+    const std::size_t layer_stride = size / layers;
+    const std::size_t p_rows = std::max<std::size_t>(
+        1ul, std::sqrt(double(layer_stride)));
+    const std::size_t p_cols = layer_stride / p_rows;
+
+    for (std::size_t x = layers; x < 10ul; ++x) {
+      for (std::size_t y = layers; y < 10ul; ++y) {
+        for (bool split_cols : {true, false}) {
+          const std::size_t tiles = x * y;
+          detail::LayeredCyclicPmap pmap(*GlobalFixture::world, x, y, p_rows,
+                                         p_cols, layers, layer_stride,
+                                         split_cols);
+
+          BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+          BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+          BOOST_CHECK_EQUAL(pmap.size(), tiles);
+
+          // Check that all local elements map to this rank
+          std::size_t local_size = 0ul;
+          for (auto it = pmap.begin(); it != pmap.end(); ++it, ++local_size) {
+            BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+          }
+          BOOST_CHECK_EQUAL(local_size, pmap.local_size());
+
+          // Check that each tile is owned by exactly one process
+          std::fill_n(tile_owners, tiles, 0);
+          for (auto it = pmap.begin(); it != pmap.end(); ++it) {
+            tile_owners[*it] += GlobalFixture::world->rank();
+          }
+
+          GlobalFixture::world->gop.sum(tile_owners, tiles);
+          GlobalFixture::world->gop.sum(local_size);
+          BOOST_CHECK_EQUAL(local_size, tiles);
+          for (std::size_t tile = 0; tile < tiles; ++tile) {
+            BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
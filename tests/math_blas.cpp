@@ -24,6 +24,7 @@
  */
 
 #include "TiledArray/math/blas.h"
+#include "TiledArray/math/gemm_batch.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
 
@@ -346,4 +347,60 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(complex_gemm_ld, T, floating_point_types) {
   delete[] c;
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(gemm_batch, T, floating_point_types) {
+  // Small matrices of different sizes
+  const std::size_t count = 4ul;
+  const integer mb[count] = {5, 20, 1, 33};
+  const integer nb[count] = {7, 20, 9, 70};
+  const integer kb[count] = {3, 20, 40, 65};
+
+  for (auto op_a : {madness::cblas::NoTrans, madness::cblas::Trans}) {
+    for (auto op_b : {madness::cblas::NoTrans, madness::cblas::Trans}) {
+      std::vector<std::vector<T> > a(count), b(count), c(count);
+      std::vector<const T*> a_ptr(count), b_ptr(count);
+      std::vector<T*> c_ptr(count);
+      integer lda[count], ldb[count], ldc[count];
+      for (std::size_t p = 0ul; p < count; ++p) {
+        a[p].resize(mb[p] * kb[p]);
+        b[p].resize(kb[p] * nb[p]);
+        c[p].resize(mb[p] * nb[p]);
+        rand_fill(a[p].data(), a[p].size(), 29 + p);
+        rand_fill(b[p].data(), b[p].size(), 47 + p);
+        rand_fill(c[p].data(), c[p].size(), 99 + p);
+        lda[p] = (op_a == madness::cblas::NoTrans ? kb[p] : mb[p]);
+        ldb[p] = (op_b == madness::cblas::NoTrans ? nb[p] : kb[p]);
+        ldc[p] = nb[p];
+        a_ptr[p] = a[p].data();
+        b_ptr[p] = b[p].data();
+        c_ptr[p] = c[p].data();
+      }
+      const std::vector<std::vector<T> > c0 = c;
+
+      // Test the batched gemm operation
+      BOOST_REQUIRE_NO_THROW(TiledArray::math::gemm_batch(
+          op_a, op_b, count, mb, nb, kb, T(3), a_ptr.data(), lda,
+          b_ptr.data(), ldb, T(2), c_ptr.data(), ldc));
+
+      for (std::size_t p = 0ul; p < count; ++p) {
+        for (integer i = 0; i < mb[p]; ++i) {
+          for (integer j = 0; j < nb[p]; ++j) {
+            // Compute the expected value
+            T expected = 0.0;
+            for (integer x = 0; x < kb[p]; ++x)
+              expected += (op_a == madness::cblas::NoTrans
+                               ? a[p][i * lda[p] + x]
+                               : a[p][x * lda[p] + i]) *
+                          (op_b == madness::cblas::NoTrans
+                               ? b[p][x * ldb[p] + j]
+                               : b[p][j * ldb[p] + x]);
+            expected = 3.0 * expected + 2.0 * c0[p][i * ldc[p] + j];
+
+            BOOST_CHECK_CLOSE(c[p][i * ldc[p] + j], expected, tol);
+          }
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,228 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2014  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  math_simd.cpp
+ *  Nov 2, 2020
+ *
+ */
+
+#include "TiledArray/math/simd.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray::math;
+
+struct SimdFixture {
+  SimdFixture() : isa(simd::isa()) {}
+
+  ~SimdFixture() { simd::set_isa(isa); }
+
+  template <typename T>
+  static std::vector<T> rand_vector(const std::size_t n, const int seed) {
+    GlobalFixture::world->srand(seed);
+    std::vector<T> result(n);
+    for (std::size_t i = 0ul; i < n; ++i)
+      result[i] = T(GlobalFixture::world->rand() % 101 - 50) / T(8);
+    return result;
+  }
+
+  /// The instruction sets that are supported, including the baseline
+  static std::vector<simd::Isa> isas() {
+    std::vector<simd::Isa> result;
+    for (auto isa : {simd::Isa::off, simd::Isa::avx2, simd::Isa::avx512})
+      if (isa <= simd::supported_isa()) result.push_back(isa);
+    return result;
+  }
+
+  /// Vector sizes that exercise the vectorized loops and their remainders
+  static constexpr std::size_t sizes[] = {0ul, 1ul, 7ul, 16ul, 37ul, 130ul};
+
+  const simd::Isa isa;  ///< The instruction set selected before the test
+
+};  // SimdFixture
+
+constexpr std::size_t SimdFixture::sizes[];
+
+BOOST_FIXTURE_TEST_SUITE(simd_suite, SimdFixture)
+
+typedef boost::mpl::list<double, float> simd_types;
+
+BOOST_AUTO_TEST_CASE(set_isa) {
+  for (auto isa : {simd::Isa::off, simd::Isa::avx2, simd::Isa::avx512}) {
+    const simd::Isa selected = simd::set_isa(isa);
+    BOOST_CHECK(selected <= isa);
+    BOOST_CHECK(selected <= simd::supported_isa());
+    BOOST_CHECK(simd::isa() == selected);
+  }
+  BOOST_CHECK_EQUAL(simd::name(simd::Isa::avx512), "avx512");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(elementwise, T, simd_types) {
+  for (auto isa : isas()) {
+    simd::set_isa(isa);
+    for (auto n : sizes) {
+      const auto left = rand_vector<T>(n, 23);
+      const auto right = rand_vector<T>(n, 42);
+      std::vector<T> result(n);
+
+      simd::add(n, left.data(), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] + right[i]);
+
+      simd::subt(n, left.data(), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] - right[i]);
+
+      simd::mult(n, left.data(), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] * right[i]);
+
+      simd::scale(n, T(3), left.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] * T(3));
+
+      // The result may alias the arguments
+      result = left;
+      simd::add(n, result.data(), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] + right[i]);
+
+      // The arguments are multiples of 1/8 , so the sums below are exact
+      result = left;
+      simd::axpy(n, T(2), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] + T(2) * right[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(reductions, T, simd_types) {
+  for (auto isa : isas()) {
+    simd::set_isa(isa);
+    for (auto n : sizes) {
+      const auto left = rand_vector<T>(n, 23);
+      const auto right = rand_vector<T>(n, 42);
+
+      T dot = 0, abs_max = 0;
+      for (std::size_t i = 0ul; i < n; ++i) {
+        dot += left[i] * right[i];
+        abs_max = std::max(abs_max, std::abs(left[i]));
+      }
+
+      BOOST_CHECK_EQUAL(simd::dot(n, left.data(), right.data()), dot);
+      BOOST_CHECK_EQUAL(simd::abs_max(n, left.data()), abs_max);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(complex_ops, T, simd_types) {
+  typedef std::complex<T> C;
+  for (auto isa : isas()) {
+    simd::set_isa(isa);
+    for (auto n : sizes) {
+      const auto left_re = rand_vector<T>(n, 23);
+      const auto left_im = rand_vector<T>(n, 42);
+      const auto right_re = rand_vector<T>(n, 7);
+      const auto right_im = rand_vector<T>(n, 11);
+      std::vector<C> left(n), right(n), result(n);
+      for (std::size_t i = 0ul; i < n; ++i) {
+        left[i] = C(left_re[i], left_im[i]);
+        right[i] = C(right_re[i], right_im[i]);
+      }
+      const C factor(T(2), T(-3));
+
+      // The arguments are multiples of 1/8 , so the results below are exact
+      simd::add(n, left.data(), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] + right[i]);
+
+      simd::subt(n, left.data(), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] - right[i]);
+
+      simd::mult(n, left.data(), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] * right[i]);
+
+      simd::scale(n, factor, left.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] * factor);
+
+      simd::scale(n, T(3), left.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] * T(3));
+
+      result = left;
+      simd::axpy(n, factor, right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] + factor * right[i]);
+
+      result = left;
+      simd::axpy(n, T(2), right.data(), result.data());
+      for (std::size_t i = 0ul; i < n; ++i)
+        BOOST_CHECK_EQUAL(result[i], left[i] + T(2) * right[i]);
+
+      C dot = 0;
+      T abs_max = 0;
+      for (std::size_t i = 0ul; i < n; ++i) {
+        dot += left[i] * right[i];
+        abs_max = std::max(abs_max, std::abs(left[i]));
+      }
+      BOOST_CHECK_EQUAL(simd::dot(n, left.data(), right.data()), dot);
+      // The modulus is not exact
+      BOOST_CHECK_CLOSE(simd::abs_max(n, left.data()), abs_max, 1e-4);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(tensor_ops, T, simd_types) {
+  const TiledArray::Range range(5, 7, 3);
+  TiledArray::Tensor<T> left(range), right(range);
+  const auto left_data = rand_vector<T>(range.volume(), 23);
+  const auto right_data = rand_vector<T>(range.volume(), 42);
+  std::copy(left_data.begin(), left_data.end(), left.data());
+  std::copy(right_data.begin(), right_data.end(), right.data());
+
+  for (auto isa : isas()) {
+    simd::set_isa(isa);
+
+    const auto sum = left.add(right);
+    const auto difference = left.subt(right);
+    const auto product = left.mult(right);
+    const auto scaled = left.scale(2);
+    auto axpy = left.clone();
+    axpy.axpy_to(right, T(2));
+    for (std::size_t i = 0ul; i < range.volume(); ++i) {
+      BOOST_CHECK_EQUAL(sum[i], left[i] + right[i]);
+      BOOST_CHECK_EQUAL(difference[i], left[i] - right[i]);
+      BOOST_CHECK_EQUAL(product[i], left[i] * right[i]);
+      BOOST_CHECK_EQUAL(scaled[i], left[i] * 2);
+      BOOST_CHECK_EQUAL(axpy[i], left[i] + right[i] * T(2));
+    }
+
+    T dot = 0, abs_max = 0;
+    for (std::size_t i = 0ul; i < range.volume(); ++i) {
+      dot += left[i] * right[i];
+      abs_max = std::max(abs_max, std::abs(left[i]));
+    }
+    BOOST_CHECK_EQUAL(left.dot(right), dot);
+    BOOST_CHECK_EQUAL(left.abs_max(), abs_max);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2020  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  pool_allocator.cpp
+ *  Nov 20, 2020
+ *
+ */
+
+#include "TiledArray/util/pool_allocator.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+#include <cstdint>
+#include <sstream>
+
+using TiledArray::PoolAllocator;
+
+struct PoolAllocatorFixture {
+  PoolAllocatorFixture() { PoolAllocator::release(); }
+
+  ~PoolAllocatorFixture() { PoolAllocator::release(); }
+
+};  // PoolAllocatorFixture
+
+BOOST_FIXTURE_TEST_SUITE(pool_allocator_suite, PoolAllocatorFixture)
+
+BOOST_AUTO_TEST_CASE(size_classes) {
+  BOOST_CHECK_EQUAL(PoolAllocator::size_class(1ul), 0ul);
+  BOOST_CHECK_EQUAL(PoolAllocator::class_size(0ul),
+                    PoolAllocator::min_block_size);
+
+  std::size_t last = 0ul;
+  for (std::size_t bytes = 1ul; bytes <= PoolAllocator::max_block_size;
+       bytes += 1ul + bytes / 7ul) {
+    const std::size_t c = PoolAllocator::size_class(bytes);
+    const std::size_t size = PoolAllocator::class_size(c);
+
+    // the class fits the block and wastes at most a quarter of it
+    BOOST_CHECK_GE(size, bytes);
+    if (bytes > PoolAllocator::min_block_size)
+      BOOST_CHECK_LE(size, bytes + bytes / 4ul);
+
+    // the class is the smallest that fits the block
+    if (c > 0ul) BOOST_CHECK_LT(PoolAllocator::class_size(c - 1ul), bytes);
+
+    BOOST_CHECK_GE(c, last);
+    last = c;
+  }
+
+  BOOST_CHECK_EQUAL(PoolAllocator::class_size(PoolAllocator::size_class(
+                        PoolAllocator::max_block_size)),
+                    PoolAllocator::max_block_size);
+}
+
+BOOST_AUTO_TEST_CASE(reuse) {
+  PoolAllocator::reset_stats();
+
+  void* block = PoolAllocator::allocate(1000ul);
+  BOOST_REQUIRE(block != nullptr);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(block) %
+                        PoolAllocator::alignment,
+                    0ul);
+  BOOST_CHECK_EQUAL(PoolAllocator::stats().system_allocations, 1ul);
+  BOOST_CHECK_EQUAL(PoolAllocator::stats().bytes_in_use,
+                    PoolAllocator::class_size(PoolAllocator::size_class(1000)));
+  PoolAllocator::deallocate(block, 1000ul);
+  BOOST_CHECK_EQUAL(PoolAllocator::stats().bytes_in_use, 0ul);
+  BOOST_CHECK_GT(PoolAllocator::stats().bytes_cached, 0ul);
+
+  // a block of the same class is taken from the free list of this thread
+  void* other = PoolAllocator::allocate(1010ul);
+  BOOST_CHECK_EQUAL(other, block);
+  PoolAllocator::deallocate(other, 1010ul);
+
+  const auto stats = PoolAllocator::stats();
+  BOOST_CHECK_EQUAL(stats.allocations, 2ul);
+  BOOST_CHECK_EQUAL(stats.deallocations, 2ul);
+  BOOST_CHECK_EQUAL(stats.thread_hits, 1ul);
+  BOOST_CHECK_EQUAL(stats.system_allocations, 1ul);
+  BOOST_CHECK_EQUAL(stats.peak_bytes_in_use,
+                    PoolAllocator::class_size(PoolAllocator::size_class(1000)));
+
+  PoolAllocator::release();
+  BOOST_CHECK_EQUAL(PoolAllocator::stats().bytes_cached, 0ul);
+
+  // null pointers are ignored
+  BOOST_CHECK_NO_THROW(PoolAllocator::deallocate(nullptr, 1000ul));
+}
+
+BOOST_AUTO_TEST_CASE(thread_cache_limit) {
+  const std::size_t limit = PoolAllocator::thread_cache_limit();
+  PoolAllocator::set_thread_cache_limit(0ul);
+  PoolAllocator::reset_stats();
+
+  // blocks that exceed the free lists of this thread are shared
+  void* block = PoolAllocator::allocate(4096ul);
+  PoolAllocator::deallocate(block, 4096ul);
+  void* other = PoolAllocator::allocate(4096ul);
+  PoolAllocator::deallocate(other, 4096ul);
+
+  PoolAllocator::set_thread_cache_limit(limit);
+  BOOST_CHECK_EQUAL(other, block);
+  BOOST_CHECK_EQUAL(PoolAllocator::stats().thread_hits, 0ul);
+  BOOST_CHECK_EQUAL(PoolAllocator::stats().shared_hits, 1ul);
+}
+
+BOOST_AUTO_TEST_CASE(large_allocation) {
+  PoolAllocator::reset_stats();
+
+  const std::size_t bytes = PoolAllocator::max_block_size + 1ul;
+  void* block = PoolAllocator::allocate(bytes);
+  BOOST_REQUIRE(block != nullptr);
+  BOOST_CHECK_EQUAL(PoolAllocator::stats().bytes_in_use, bytes);
+  PoolAllocator::deallocate(block, bytes);
+
+  const auto stats = PoolAllocator::stats();
+  BOOST_CHECK_EQUAL(stats.large_allocations, 1ul);
+  BOOST_CHECK_EQUAL(stats.bytes_in_use, 0ul);
+  BOOST_CHECK_EQUAL(stats.bytes_cached, 0ul);
+
+  std::stringstream ss;
+  BOOST_CHECK_NO_THROW(ss << stats);
+  BOOST_CHECK(ss.str().find("large_allocations=1") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(tensor) {
+  typedef TiledArray::Tensor<int, TiledArray::pool_allocator<int>> tensor_type;
+  const TiledArray::Range range(10, 20, 30);
+
+  PoolAllocator::reset_stats();
+  {
+    tensor_type t(range, 1);
+    tensor_type u = t.add(t);
+    for (std::size_t i = 0ul; i < u.size(); ++i) BOOST_CHECK_EQUAL(u[i], 2);
+  }
+  BOOST_CHECK_EQUAL(PoolAllocator::stats().bytes_in_use, 0ul);
+
+  // the storage of the released tensors is reused
+  {
+    tensor_type t(range, 3);
+    BOOST_CHECK_EQUAL(t[0], 3);
+  }
+  const auto stats = PoolAllocator::stats();
+  BOOST_CHECK_EQUAL(stats.allocations, 3ul);
+  BOOST_CHECK_EQUAL(stats.system_allocations, 2ul);
+  BOOST_CHECK_EQUAL(stats.thread_hits, 1ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
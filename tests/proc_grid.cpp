@@ -154,6 +154,98 @@ BOOST_AUTO_TEST_CASE(random_constructor_test) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(layered_constructor_test) {
+  const std::size_t rows = 37, cols = 29, k = 11;
+  const std::size_t row_size = rows * 16, col_size = cols * 24;
+
+  for (ProcessID nprocs = 1; nprocs <= 64; ++nprocs) {
+    for (std::size_t layers = 1; layers <= std::min<std::size_t>(nprocs, 4);
+         ++layers) {
+      const std::size_t layer_stride = nprocs / layers;
+
+      // The process grid of each layer is identical to that of a 2D grid with
+      // nprocs / layers processes.
+      TiledArray::detail::ProcGrid proc_grid2d(
+          *GlobalFixture::world, 0, layer_stride, rows, cols, row_size,
+          col_size);
+
+      std::size_t local_size = 0ul;
+      std::vector<std::size_t> k_count(k, 0ul);
+      for (ProcessID rank = 0; rank < nprocs; ++rank) {
+        TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, rank,
+                                               nprocs, rows, cols, row_size,
+                                               col_size, layers);
+
+        BOOST_CHECK_EQUAL(proc_grid.layers(), layers);
+        BOOST_CHECK_EQUAL(proc_grid.layer_stride(), layer_stride);
+        BOOST_CHECK_EQUAL(proc_grid.proc_rows(), proc_grid2d.proc_rows());
+        BOOST_CHECK_EQUAL(proc_grid.proc_cols(), proc_grid2d.proc_cols());
+
+        if (std::size_t(rank) < layers * layer_stride) {
+          BOOST_CHECK_EQUAL(proc_grid.rank_layer(),
+                            ProcessID(rank / layer_stride));
+        } else {
+          BOOST_CHECK_EQUAL(proc_grid.rank_layer(), -1);
+          BOOST_CHECK_EQUAL(proc_grid.local_size(), 0ul);
+        }
+
+        local_size += proc_grid.local_size();
+
+        // Check that the layers of the grid cover the inner dimension
+        if (proc_grid.local_size() > 0ul) {
+          BOOST_CHECK_EQUAL(proc_grid.map_layer(proc_grid.rank_layer()),
+                            rank);
+          if (proc_grid.rank_row() == 0 && proc_grid.rank_col() == 0) {
+            const auto range = proc_grid.layer_range(k);
+            for (auto i = range.first; i < range.second; ++i) ++k_count[i];
+          }
+        }
+      }
+
+      // Each layer holds a copy of the result
+      BOOST_CHECK_EQUAL(local_size, rows * cols * layers);
+      for (std::size_t i = 0ul; i < k; ++i) BOOST_CHECK_EQUAL(k_count[i], 1ul);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fixed_proc_rows_test) {
+  const std::size_t rows = 37, cols = 29;
+  const std::size_t row_size = rows * 16, col_size = cols * 24;
+
+  for (ProcessID nprocs = 2; nprocs <= 64; ++nprocs) {
+    for (std::size_t layers = 1; layers <= std::min<std::size_t>(nprocs, 4);
+         ++layers) {
+      const std::size_t layer_stride = nprocs / layers;
+
+      // A single process row (column) in each layer
+      TiledArray::detail::ProcGrid row_grid(*GlobalFixture::world, 0, nprocs,
+                                            rows, cols, row_size, col_size,
+                                            layers, 1ul);
+      BOOST_CHECK_EQUAL(row_grid.proc_rows(), 1ul);
+      BOOST_CHECK_EQUAL(row_grid.proc_cols(),
+                        std::min<std::size_t>(layer_stride, cols));
+
+      TiledArray::detail::ProcGrid col_grid(*GlobalFixture::world, 0, nprocs,
+                                            rows, cols, row_size, col_size,
+                                            layers, layer_stride);
+      BOOST_CHECK_EQUAL(col_grid.proc_rows(),
+                        std::min<std::size_t>(layer_stride, rows));
+      if (layer_stride <= rows) BOOST_CHECK_EQUAL(col_grid.proc_cols(), 1ul);
+
+      // Check that each layer holds a copy of the result
+      std::size_t local_size = 0ul;
+      for (ProcessID rank = 0; rank < nprocs; ++rank) {
+        TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, rank,
+                                               nprocs, rows, cols, row_size,
+                                               col_size, layers, 1ul);
+        local_size += proc_grid.local_size();
+      }
+      BOOST_CHECK_EQUAL(local_size, rows * cols * layers);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(make_groups) {
   madness::DistributedID did_row(madness::uniqueidT(), 0);
   madness::DistributedID did_col(madness::uniqueidT(), 1);
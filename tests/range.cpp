@@ -677,4 +677,111 @@ BOOST_AUTO_TEST_CASE(swap) {
   BOOST_CHECK_EQUAL(r.volume(), volume);
 }
 
+BOOST_AUTO_TEST_CASE(static_rank) {
+  // index computations are specialized for low ranks, check them against
+  // the row-major order of the iteration for ranks with and without
+  // specializations
+  for (unsigned int rank = 1u; rank <= TiledArray::detail::max_static_rank + 2u;
+       ++rank) {
+    std::vector<long> lobound(rank), upbound(rank);
+    for (unsigned int d = 0u; d < rank; ++d) {
+      lobound[d] = long(d) - 1l;
+      upbound[d] = lobound[d] + 2l + long(d % 2u);
+    }
+    const Range range(lobound, upbound);
+
+    std::size_t ord = 0ul;
+    for (auto&& index : range) {
+      BOOST_CHECK_EQUAL(range.ordinal(index), ord);
+      const auto idx = range.idx(ord);
+      BOOST_CHECK_EQUAL_COLLECTIONS(idx.begin(), idx.end(), index.begin(),
+                                    index.end());
+      ++ord;
+    }
+    BOOST_CHECK_EQUAL(ord, range.volume());
+
+    // ordinal indices of a block
+    std::vector<long> block_upbound(upbound);
+    for (auto& upbound_d : block_upbound) upbound_d -= 1l;
+    const BlockRange block(range, lobound, block_upbound);
+    ord = 0ul;
+    for (auto&& index : block) {
+      BOOST_CHECK_EQUAL(block.ordinal(ord), range.ordinal(index));
+      ++ord;
+    }
+    BOOST_CHECK_EQUAL(ord, block.volume());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(inline_storage) {
+  // the dimension information of low-rank ranges is stored in the range
+  auto is_inline = [](const Range& range) {
+    const char* const data =
+        reinterpret_cast<const char*>(range.lobound_data());
+    const char* const begin = reinterpret_cast<const char*>(&range);
+    return data >= begin && data < begin + sizeof(Range);
+  };
+  auto check_equal = [](const Range& x, const Range& y) {
+    BOOST_CHECK_EQUAL(x.rank(), y.rank());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        x.lobound_data(), x.lobound_data() + x.rank(), y.lobound_data(),
+        y.lobound_data() + y.rank());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        x.upbound_data(), x.upbound_data() + x.rank(), y.upbound_data(),
+        y.upbound_data() + y.rank());
+    BOOST_CHECK_EQUAL_COLLECTIONS(x.stride_data(), x.stride_data() + x.rank(),
+                                  y.stride_data(), y.stride_data() + y.rank());
+    BOOST_CHECK_EQUAL(x.volume(), y.volume());
+    BOOST_CHECK_EQUAL(x.offset(), y.offset());
+  };
+
+  const unsigned int max_rank = Range::max_inline_rank;
+  const Range low(std::vector<std::size_t>(max_rank, 2ul));
+  const Range high(std::vector<std::size_t>(max_rank + 1u, 2ul));
+  BOOST_CHECK(is_inline(r));
+  BOOST_CHECK(is_inline(low));
+  BOOST_CHECK(!is_inline(high));
+
+  for (const Range* range : {&r, &low, &high}) {
+    // copy
+    Range x(*range);
+    BOOST_CHECK_EQUAL(is_inline(x), is_inline(*range));
+    check_equal(x, *range);
+
+    // move
+    Range y(std::move(x));
+    BOOST_CHECK_EQUAL(x.rank(), 0u);
+    BOOST_CHECK(x.lobound_data() == nullptr);
+    BOOST_CHECK_EQUAL(is_inline(y), is_inline(*range));
+    check_equal(y, *range);
+
+    // assignment between ranges with inline and heap storage
+    for (const Range* other : {&r, &low, &high}) {
+      Range z(*other);
+      z = y;
+      BOOST_CHECK_EQUAL(is_inline(z), is_inline(*range));
+      check_equal(z, *range);
+
+      Range w(*other);
+      w = Range(y);
+      BOOST_CHECK_EQUAL(is_inline(w), is_inline(*range));
+      check_equal(w, *range);
+
+      Range v(*other);
+      v.swap(w);
+      check_equal(v, *range);
+      check_equal(w, *other);
+      BOOST_CHECK_EQUAL(is_inline(w), is_inline(*other));
+    }
+
+    // permutation
+    std::vector<std::size_t> p(range->rank());
+    for (std::size_t d = 0ul; d < p.size(); ++d) p[d] = p.size() - 1ul - d;
+    const Permutation perm(p);
+    Range u(*range);
+    u *= perm;
+    check_equal(u, perm * *range);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
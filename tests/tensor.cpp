@@ -177,6 +177,53 @@ BOOST_AUTO_TEST_CASE(permute_constructor_tensor) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(permute_plan) {
+  // Rank-6 tensor with short extents, some of which are unit
+  const std::array<std::size_t, 6> start = {{0ul, 0ul, 0ul, 0ul, 0ul, 0ul}};
+  const std::array<std::size_t, 6> finish = {{3ul, 1ul, 4ul, 2ul, 5ul, 3ul}};
+  TensorN x(range_type(start, finish));
+  rand_fill(431, x.size(), x.data());
+
+  const std::array<Permutation, 4> perms = {
+      {Permutation({5, 4, 3, 2, 1, 0}), Permutation({1, 0, 2, 3, 5, 4}),
+       Permutation({2, 3, 0, 1, 4, 5}), Permutation({3, 5, 1, 4, 0, 2})}};
+
+  for (const auto& perm : perms) {
+    TensorN px;
+    BOOST_REQUIRE_NO_THROW(px = TensorN(x, perm));
+    BOOST_CHECK_EQUAL(px.range(), perm * x.range());
+    for (std::size_t i = 0ul; i < x.size(); ++i) {
+      std::size_t pi = px.range().ordinal(perm * x.range().idx(i));
+      BOOST_CHECK_EQUAL(px[pi], x[i]);
+    }
+
+    // The plan is cached
+    const auto plan = detail::PermutePlan::instance(
+        x.range().extent_data(), perm, sizeof(value_type));
+    BOOST_CHECK_EQUAL(plan->volume(), x.size());
+    const auto cached = detail::PermutePlan::instance(
+        x.range().extent_data(), perm, sizeof(value_type));
+    BOOST_CHECK_EQUAL(cached.get(), plan.get());
+  }
+
+  // Transposes that span more than one panel
+  const std::array<std::size_t, 3> finish3 = {{70ul, 3ul, 90ul}};
+  TensorN y(range_type(std::array<std::size_t, 3>{{0ul, 0ul, 0ul}}, finish3));
+  rand_fill(432, y.size(), y.data());
+  const Permutation perm({2, 1, 0});
+  const TensorN py = y.permute(perm);
+  BOOST_CHECK(detail::PermutePlan::instance(y.range().extent_data(), perm,
+                                            sizeof(value_type))
+                  ->transpose());
+  for (std::size_t i = 0ul; i < y.size(); ++i) {
+    std::size_t pi = py.range().ordinal(perm * y.range().idx(i));
+    BOOST_CHECK_EQUAL(py[pi], y[i]);
+  }
+
+  detail::PermutePlan::clear_cache();
+  BOOST_CHECK_EQUAL(detail::PermutePlan::cache_size(), 0ul);
+}
+
 BOOST_AUTO_TEST_CASE(unary_constructor) {
   // check constructor
   BOOST_REQUIRE_NO_THROW(TensorN x(t, [](const int arg) { return arg * 83; }));
@@ -290,6 +337,70 @@ BOOST_AUTO_TEST_CASE(clone) {
   BOOST_CHECK_EQUAL_COLLECTIONS(tc.begin(), tc.end(), t.begin(), t.end());
 }
 
+BOOST_AUTO_TEST_CASE(shallow_shift) {
+  const std::vector<long> bound_shift(t.range().rank(), 2l);
+  TensorN ts;
+  BOOST_REQUIRE_NO_THROW(ts = t.shallow_shift(bound_shift));
+
+  // Check that the data is shared and the range is shifted
+  auto range = t.range();
+  BOOST_CHECK_EQUAL(ts.data(), t.data());
+  BOOST_CHECK_EQUAL(ts.range(), range.shift(bound_shift));
+
+  // Check that shifting the result does not change the argument range
+  BOOST_REQUIRE_NO_THROW(ts.shift_to(bound_shift));
+  BOOST_CHECK_EQUAL(t.range(), range);
+
+  // Check that the data outlives the argument
+  TensorN tc = t.clone();
+  TensorN tcs = tc.shallow_shift(bound_shift).shallow_shift(bound_shift);
+  tc = TensorN();
+  BOOST_CHECK_EQUAL_COLLECTIONS(tcs.begin(), tcs.end(), t.begin(), t.end());
+}
+
+BOOST_AUTO_TEST_CASE(use_count) {
+  BOOST_CHECK_EQUAL(TensorN().use_count(), 0l);
+  BOOST_CHECK(!TiledArray::is_unique(TensorN()));
+
+  TensorN x = t.clone();
+  BOOST_CHECK_EQUAL(x.use_count(), 1l);
+  BOOST_CHECK(TiledArray::is_unique(x));
+  {
+    // shallow copies and shifts share the data
+    TensorN y = x;
+    BOOST_CHECK_EQUAL(x.use_count(), 2l);
+    BOOST_CHECK(!TiledArray::is_unique(y));
+    y = TensorN();
+    TensorN z = x.shallow_shift(std::vector<long>(x.range().rank(), 1l));
+    BOOST_CHECK_EQUAL(x.use_count(), 2l);
+    BOOST_CHECK_EQUAL(z.use_count(), 2l);
+    x = TensorN();
+    BOOST_CHECK(TiledArray::is_unique(z));
+  }
+
+  // temporary arguments are reused by tile operations if they are unique
+  TiledArray::detail::Add<TensorN, TensorN, TensorN, false, false> add;
+  TensorN u = t.clone();
+  const auto* const data = u.data();
+  TensorN sum = add(std::move(u), t);
+  BOOST_CHECK_EQUAL(sum.data(), data);
+  for (std::size_t i = 0ul; i < sum.size(); ++i)
+    BOOST_CHECK_EQUAL(sum[i], 2 * t[i]);
+
+  // ... but not if their data is shared
+  TensorN v = t.clone();
+  const TensorN w = v;
+  sum = add(std::move(v), t);
+  BOOST_CHECK(sum.data() != w.data());
+  BOOST_CHECK_EQUAL_COLLECTIONS(w.begin(), w.end(), t.begin(), t.end());
+
+  // ... or if they are not temporaries
+  TensorN s = t.clone();
+  sum = add(s, t);
+  BOOST_CHECK(sum.data() != s.data());
+  BOOST_CHECK_EQUAL_COLLECTIONS(s.begin(), s.end(), t.begin(), t.end());
+}
+
 BOOST_AUTO_TEST_CASE(range_accessor) {
   BOOST_CHECK_EQUAL_COLLECTIONS(
       t.range().lobound_data(), t.range().lobound_data() + t.range().rank(),
@@ -565,6 +676,49 @@ BOOST_AUTO_TEST_CASE(inplace_conj_scal_op) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(gett) {
+  // C[a,b,i,j] = A[a,k,i,l] * B[k,b,l,j]; the extents are chosen such that
+  // the contraction spans more than one block of the kernel
+  const std::array<std::size_t, 4> zero = {{0ul, 0ul, 0ul, 0ul}};
+  const std::array<std::size_t, 4> a_finish = {{3ul, 20ul, 4ul, 9ul}};
+  const std::array<std::size_t, 4> b_finish = {{20ul, 5ul, 9ul, 30ul}};
+  TensorN a(range_type(zero, a_finish));
+  rand_fill(1, a.size(), a.data());
+  TensorN b(range_type(zero, b_finish));
+  rand_fill(2, b.size(), b.data());
+
+  // Permutations that map the arguments to A[a,i,k,l] and B[k,l,b,j]
+  const Permutation perm({0, 2, 1, 3});
+  const math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+                                     madness::cblas::NoTrans, 4u, 4u, 4u);
+
+  // Compute the reference by permuting the arguments
+  const TensorN reference =
+      a.permute(perm).gemm(b.permute(perm), 3, gemm_helper);
+
+  TensorN c;
+  BOOST_REQUIRE_NO_THROW(c = gett(a, perm, b, perm, 3, gemm_helper));
+  BOOST_CHECK_EQUAL(c.range(), reference.range());
+  for (std::size_t i = 0ul; i < c.size(); ++i)
+    BOOST_CHECK_EQUAL(c[i], reference[i]);
+
+  // Check accumulation with only one argument in stored order
+  const TensorN b_perm = b.permute(perm);
+  BOOST_REQUIRE_NO_THROW(gett(c, a, perm, b_perm, Permutation(), 3,
+                              gemm_helper));
+  for (std::size_t i = 0ul; i < c.size(); ++i)
+    BOOST_CHECK_EQUAL(c[i], 2 * reference[i]);
+
+  // Check that the result is zero if no elements are contracted
+  const std::array<std::size_t, 4> a0_finish = {{3ul, 0ul, 4ul, 9ul}};
+  const std::array<std::size_t, 4> b0_finish = {{0ul, 5ul, 9ul, 30ul}};
+  const TensorN a0(range_type(zero, a0_finish));
+  const TensorN b0(range_type(zero, b0_finish));
+  BOOST_REQUIRE_NO_THROW(c = gett(a0, perm, b0, perm, 3, gemm_helper));
+  BOOST_CHECK_EQUAL(c.range(), reference.range());
+  for (std::size_t i = 0ul; i < c.size(); ++i) BOOST_CHECK_EQUAL(c[i], 0);
+}
+
 BOOST_AUTO_TEST_CASE(block) {
   TensorZ s(r);
   auto lobound = r.lobound();